@@ -33,6 +33,8 @@ namespace clients::dns {
 /// cache-size-per-way | size of each way of network cache | 256
 /// cache-max-reply-ttl | TTL limit for network replies caching | 5m
 /// cache-failure-ttl | TTL for network failures caching | 5s
+/// cache-prefetch-ratio | part of the reply TTL after which the record is updated in background | 0.9
+/// cache-max-stale | how long an expired record may be returned while it is being updated | 24h
 ///
 /// ## Static configuration example:
 ///
@@ -39,6 +39,12 @@ struct ResolverConfig {
 
   /// Network cache failure TTL
   std::chrono::milliseconds cache_failure_ttl{std::chrono::seconds{5}};
+
+  /// Part of the reply TTL after which the record is updated in background
+  double cache_prefetch_ratio{0.9};
+
+  /// How long an expired record may be returned while it is being updated
+  std::chrono::milliseconds cache_max_stale{std::chrono::hours{24}};
 };
 
 }  // namespace clients::dns
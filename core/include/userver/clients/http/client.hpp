@@ -7,11 +7,14 @@
 #error Use clients::Http from clients/http.hpp instead
 #endif
 
+#include <cstdint>
+#include <functional>
 #include <memory>
 
 #include <userver/moodycamel/concurrentqueue_fwd.h>
 
 #include <userver/clients/dns/resolver_fwd.hpp>
+#include <userver/clients/http/hedging.hpp>
 #include <userver/clients/http/impl/config.hpp>
 #include <userver/clients/http/plugin.hpp>
 #include <userver/clients/http/request.hpp>
@@ -50,6 +53,7 @@ class EasyWrapper;
 
 struct TestsuiteConfig;
 class Statistics;
+class RequestStats;
 struct PoolStatistics;
 struct InstanceStatistics;
 class DestinationStatistics;
@@ -83,6 +87,20 @@ class Client final {
   /// @note This method is thread-safe despite being non-const.
   Request CreateNotSignedRequest() { return CreateRequest(); }
 
+  /// @brief Performs the request made by @a factory and, if there is no
+  /// response after the hedging delay, a duplicate made by another @a factory
+  /// call, e.g. to another replica of the upstream. The first successful
+  /// response is returned, the other request is cancelled.
+  ///
+  /// @param factory is called with 0 for the original request and with 1 for
+  /// the hedged one.
+  ///
+  /// The responses with 5xx status codes and the exceptions are not
+  /// successful, the result of the other request is waited for them.
+  std::shared_ptr<Response> PerformHedged(
+      const HedgingSettings& settings,
+      const std::function<Request(std::size_t attempt)>& factory);
+
   /// @cond
   // For internal use only.
   void SetMultiplexingEnabled(bool enabled);
@@ -146,9 +164,28 @@ class Client final {
 
   std::shared_ptr<curl::easy> TryDequeueIdle() noexcept;
 
+  void PrepareEasy(curl::easy& easy) const;
+
+  // The budget is refilled by budget_ratio of a hedge for every request
+  // performed with hedging
+  void AddHedgingBudget(double budget_ratio) noexcept;
+  bool TryAcquireHedge() noexcept;
+
+  // Moves the easy to the multi of its destination to reuse the connections
+  // of that multi. Returns nullptr if the multi was not changed.
+  std::shared_ptr<RequestStats> BindToDestination(curl::easy& easy);
+
   std::atomic<std::size_t> pending_tasks_{0};
+  std::atomic<bool> multiplexing_enabled_{false};
+
+  std::atomic<std::int64_t> hedging_budget_{0};
+  std::atomic<std::uint64_t> hedges_issued_{0};
+  std::atomic<std::uint64_t> hedges_won_{0};
+  std::atomic<std::uint64_t> hedges_cancelled_{0};
 
   const impl::DeadlinePropagationConfig deadline_propagation_config_;
+  const bool destination_affinity_;
+  const size_t destination_affinity_spillover_;
 
   std::shared_ptr<DestinationStatistics> destination_statistics_;
   std::unique_ptr<engine::ev::ThreadPool> thread_pool_;
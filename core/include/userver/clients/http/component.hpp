@@ -38,6 +38,10 @@ namespace components {
 /// thread-name-prefix | set OS thread name to this value | ''
 /// threads | number of threads to process low level HTTP related IO system calls | 8
 /// defer-events | whether to defer events execution to a periodic timer; might affect timings a bit, might boost performance, use with care | false
+/// destination-affinity | whether to perform the requests to the same scheme and host in the same IO thread to reuse its connections | true
+/// destination-affinity-spillover | how many more pending requests than the least loaded IO thread the IO thread of a destination may have before the requests go to the least loaded one | 16
+/// http2-multiplexing | whether to perform the requests over HTTPS as HTTP/2 streams of the shared connections to the destination, HTTP/1.1 is used if the server does not support HTTP/2 | false
+/// http2-max-concurrent-streams | max number of concurrent HTTP/2 streams over a single connection, a new connection is opened if all of them are busy | 100
 /// fs-task-processor | task processor to run blocking HTTP related calls, like DNS resolving or hosts reading | -
 /// destination-metrics-auto-max-size | set max number of automatically created destination metrics | 100
 /// user-agent | User-Agent HTTP header to show on all requests, result of utils::GetUserverIdentifier() if empty | empty
@@ -0,0 +1,34 @@
+#pragma once
+
+/// @file userver/clients/http/hedging.hpp
+/// @brief @copybrief clients::http::HedgingSettings
+
+#include <chrono>
+#include <optional>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace clients::http {
+
+/// @brief Settings of the hedged requests, see
+/// clients::http::Client::PerformHedged()
+struct HedgingSettings final {
+  /// Time to wait for a response before sending the hedged request. Used if
+  /// delay_percentile is not set or there are no timings of the destination
+  /// yet.
+  std::chrono::milliseconds delay{50};
+
+  /// If set, the percentile of the destination timings for the last minute
+  /// is used as the delay, e.g. 95 for p95
+  std::optional<double> delay_percentile;
+
+  /// Max ratio of the hedged requests to all the requests performed with
+  /// hedging, the hedges are not sent when the budget is exhausted so that
+  /// hedging does not amplify an overload of the upstream. The budget of a
+  /// client starts full and allows a burst of up to 10 hedges.
+  double budget_ratio{0.1};
+};
+
+}  // namespace clients::http
+
+USERVER_NAMESPACE_END
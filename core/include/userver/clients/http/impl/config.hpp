@@ -28,6 +28,10 @@ struct ClientSettings final {
   std::string thread_name_prefix{};
   size_t io_threads{8};
   bool defer_events{false};
+  bool destination_affinity{true};
+  size_t destination_affinity_spillover{16};
+  bool http2_multiplexing{false};
+  size_t http2_max_concurrent_streams{100};
   DeadlinePropagationConfig deadline_propagation{};
   const tracing::TracingManagerBase* tracing_manager{nullptr};
   const server::http::HeadersPropagator* headers_propagator{nullptr};
@@ -286,6 +286,12 @@ class Request final {
       const impl::DeadlinePropagationConfig& deadline_propagation_config) &;
 
   void SetHeadersPropagator(const server::http::HeadersPropagator*) &;
+
+  // Returns the percentile of the destination timings for the last minute
+  // or zero if there are no timings. Must be called before async_perform().
+  // For internal use only.
+  std::chrono::milliseconds GetDestinationTimingsPercentile(
+      double percent) const;
   /// @endcond
 
   /// Disable auto-decoding of received replies.
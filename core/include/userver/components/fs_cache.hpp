@@ -6,6 +6,7 @@
 #include <unordered_map>
 #include <userver/components/loggable_component_base.hpp>
 #include <userver/fs/fs_cache_client.hpp>
+#include <userver/utils/statistics/entry.hpp>
 #include <userver/yaml_config/fwd.hpp>
 
 USERVER_NAMESPACE_BEGIN
@@ -34,12 +35,15 @@ class FsCache final : public components::LoggableComponentBase {
   FsCache(const components::ComponentConfig& config,
           const components::ComponentContext& context);
 
+  ~FsCache() override;
+
   static yaml_config::Schema GetStaticConfigSchema();
 
   const Client& GetClient() const;
 
  private:
   Client client_;
+  utils::statistics::Entry statistics_holder_;
 };
 
 template <>
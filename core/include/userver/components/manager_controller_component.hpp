@@ -33,7 +33,13 @@ class Manager;
 /// coro_pool.initial_size | amount of coroutines to preallocate on startup | -
 /// coro_pool.max_size | max amount of coroutines to keep preallocated | -
 /// coro_pool.stack_size | size of a single coroutine | 256 * 1024
+/// coro_pool.small_stack_size | stack size of the coroutines of task processors with `coro-stack-size-class: small`, such coroutines are not preallocated | 64 * 1024
+/// coro_pool.large_stack_size | stack size of the coroutines of task processors with `coro-stack-size-class: large`, such coroutines are not preallocated | 1024 * 1024
+/// coro_pool.stack_reclaim_threshold | if a coroutine has touched more stack than that, the pages below are returned to the OS when the coroutine goes back to the pool; 0 disables, values below 16 KiB are rounded up to 16 KiB | 0
 /// event_thread_pool.threads | number of threads to process low level IO system calls (number of ev loops to start in libev) | -
+/// event_thread_pool.poll_backend | libev backend the ev loops wait for IO readiness with: `default` (epoll on Linux) or `io_uring` (libev's EVBACKEND_IOURING, falls back to `default` if unsupported). Only the readiness polling is affected, sockets still perform their IO with regular system calls | default
+/// event_thread_pool.cpu_affinity | CPUs to pin the ev threads to, in the Linux cpulist format, e.g. `0-7,16-23` | all CPUs
+/// event_thread_pool.numa_node | NUMA node to pin the ev threads to, the memory is preferably allocated from that node | -
 /// components | dictionary of "component name": "options" | -
 /// default_task_processor | name of the default task processor to use in components | -
 /// task_processors.*NAME*.*OPTIONS* | dictionary of task processors to create and their options. See description below | -
@@ -46,7 +52,12 @@ class Manager;
 /// thread_name | set OS thread name to this value | -
 /// worker_threads | threads count for the task processor | -
 /// os-scheduling | OS scheduling mode for the task processor threads. 'idle' sets the lowest priority. 'low-priority' sets the priority below 'normal' but higher than 'idle'. | normal
-/// spinning-iterations | tunes the number of spin-wait iterations in case of an empty task queue before threads go to sleep | 10000
+/// spinning-iterations | tunes the number of spin-wait iterations in case of an empty task queue before threads go to sleep. With `spinning-mode: adaptive` it is the upper bound of the spin-wait | 10000
+/// spinning-mode | `fixed` always spins `spinning-iterations` times. `adaptive` makes each worker learn from its recent idle periods and spin longer only when a task is likely to arrive soon, going to sleep almost immediately on a mostly idle task processor | fixed
+/// task-processor-queue | Task queue mode for the task processor. `global-task-queue` is a single queue shared by all the worker threads. `work-stealing-task-queue` gives each worker its own run queue and lets idle workers steal tasks from the siblings, which scales better with many worker threads. | global-task-queue
+/// cpu-affinity | CPUs to pin the worker threads to, in the Linux cpulist format, e.g. `0-7,16-23` | all CPUs
+/// numa-node | NUMA node to pin the worker threads to, the memory is preferably allocated from that node. Use the same node for the task processor and the `event_thread_pool` to keep the connections, their handlers and the coroutine stacks on a single node | -
+/// coro-stack-size-class | stack size class of the task processor coroutines: `small`, `normal` or `large`, see `coro_pool.*stack_size` | normal
 /// task-trace | optional dictionary of tracing options | empty (disabled)
 /// task-trace.every | set N to trace each Nth task | 1000
 /// task-trace.max-context-switch-count | set upper limit of context switches to trace for a single task | 1000
@@ -3,7 +3,11 @@
 /// @file userver/engine/async.hpp
 /// @brief TaskWithResult creation helpers
 
+#include <cstddef>
+#include <vector>
+
 #include <userver/engine/deadline.hpp>
+#include <userver/engine/impl/task_batch.hpp>
 #include <userver/engine/impl/task_context_factory.hpp>
 #include <userver/engine/task/shared_task_with_result.hpp>
 #include <userver/engine/task/task_processor_fwd.hpp>
@@ -20,6 +24,7 @@ template <template <typename> typename TaskType, typename Function,
           typename... Args>
 [[nodiscard]] auto MakeTaskWithResult(TaskProcessor& task_processor,
                                       Task::Importance importance,
+                                      Task::Priority priority,
                                       Deadline deadline, Function&& f,
                                       Args&&... args) {
   using ResultType =
@@ -27,10 +32,15 @@ template <template <typename> typename TaskType, typename Function,
   constexpr auto kWaitMode = TaskType<ResultType>::kWaitMode;
 
   return TaskType<ResultType>{
-      MakeTask({task_processor, importance, kWaitMode, deadline},
+      MakeTask({task_processor, importance, kWaitMode, deadline, priority},
                std::forward<Function>(f), std::forward<Args>(args)...)};
 }
 
+// Type of the tasks calling `f(index)` started by AsyncBatch functions
+template <typename Function>
+using BatchTaskType = TaskWithResult<typename utils::impl::WrappedCallImplType<
+    const Function&, std::size_t&>::ResultType>;
+
 }  // namespace impl
 
 /// Runs an asynchronous function call using specified task processor
@@ -38,8 +48,8 @@ template <typename Function, typename... Args>
 [[nodiscard]] auto AsyncNoSpan(TaskProcessor& task_processor, Function&& f,
                                Args&&... args) {
   return impl::MakeTaskWithResult<TaskWithResult>(
-      task_processor, Task::Importance::kNormal, {}, std::forward<Function>(f),
-      std::forward<Args>(args)...);
+      task_processor, Task::Importance::kNormal, Task::Priority::kNormal, {},
+      std::forward<Function>(f), std::forward<Args>(args)...);
 }
 
 /// Runs an asynchronous function call using specified task processor
@@ -47,8 +57,8 @@ template <typename Function, typename... Args>
 [[nodiscard]] auto SharedAsyncNoSpan(TaskProcessor& task_processor,
                                      Function&& f, Args&&... args) {
   return impl::MakeTaskWithResult<SharedTaskWithResult>(
-      task_processor, Task::Importance::kNormal, {}, std::forward<Function>(f),
-      std::forward<Args>(args)...);
+      task_processor, Task::Importance::kNormal, Task::Priority::kNormal, {},
+      std::forward<Function>(f), std::forward<Args>(args)...);
 }
 
 /// Runs an asynchronous function call with deadline using specified task
@@ -57,8 +67,8 @@ template <typename Function, typename... Args>
 [[nodiscard]] auto AsyncNoSpan(TaskProcessor& task_processor, Deadline deadline,
                                Function&& f, Args&&... args) {
   return impl::MakeTaskWithResult<TaskWithResult>(
-      task_processor, Task::Importance::kNormal, deadline,
-      std::forward<Function>(f), std::forward<Args>(args)...);
+      task_processor, Task::Importance::kNormal, Task::Priority::kNormal,
+      deadline, std::forward<Function>(f), std::forward<Args>(args)...);
 }
 
 /// Runs an asynchronous function call with deadline using specified task
@@ -68,7 +78,19 @@ template <typename Function, typename... Args>
                                      Deadline deadline, Function&& f,
                                      Args&&... args) {
   return impl::MakeTaskWithResult<SharedTaskWithResult>(
-      task_processor, Task::Importance::kNormal, deadline,
+      task_processor, Task::Importance::kNormal, Task::Priority::kNormal,
+      deadline, std::forward<Function>(f), std::forward<Args>(args)...);
+}
+
+/// @brief Runs an asynchronous function call with the specified priority
+/// class using specified task processor
+/// @see Task::Priority
+template <typename Function, typename... Args>
+[[nodiscard]] auto AsyncNoSpan(TaskProcessor& task_processor,
+                               Task::Priority priority, Function&& f,
+                               Args&&... args) {
+  return impl::MakeTaskWithResult<TaskWithResult>(
+      task_processor, Task::Importance::kNormal, priority, {},
       std::forward<Function>(f), std::forward<Args>(args)...);
 }
 
@@ -106,6 +128,16 @@ template <typename Function, typename... Args>
                            std::forward<Args>(args)...);
 }
 
+/// @brief Runs an asynchronous function call with the specified priority
+/// class using task processor of the caller
+/// @see Task::Priority
+template <typename Function, typename... Args>
+[[nodiscard]] auto AsyncNoSpan(Task::Priority priority, Function&& f,
+                               Args&&... args) {
+  return AsyncNoSpan(current_task::GetTaskProcessor(), priority,
+                     std::forward<Function>(f), std::forward<Args>(args)...);
+}
+
 /// @brief Runs an asynchronous function call that will start regardless of
 /// cancellations using specified task processor
 /// @see Task::Importance::Critical
@@ -113,7 +145,7 @@ template <typename Function, typename... Args>
 [[nodiscard]] auto CriticalAsyncNoSpan(TaskProcessor& task_processor,
                                        Function&& f, Args&&... args) {
   return impl::MakeTaskWithResult<TaskWithResult>(
-      task_processor, Task::Importance::kCritical, {},
+      task_processor, Task::Importance::kCritical, Task::Priority::kNormal, {},
       std::forward<Function>(f), std::forward<Args>(args)...);
 }
 
@@ -124,7 +156,7 @@ template <typename Function, typename... Args>
 [[nodiscard]] auto SharedCriticalAsyncNoSpan(TaskProcessor& task_processor,
                                              Function&& f, Args&&... args) {
   return impl::MakeTaskWithResult<SharedTaskWithResult>(
-      task_processor, Task::Importance::kCritical, {},
+      task_processor, Task::Importance::kCritical, Task::Priority::kNormal, {},
       std::forward<Function>(f), std::forward<Args>(args)...);
 }
 
@@ -155,8 +187,39 @@ template <typename Function, typename... Args>
 [[nodiscard]] auto CriticalAsyncNoSpan(Deadline deadline, Function&& f,
                                        Args&&... args) {
   return impl::MakeTaskWithResult<TaskWithResult>(
-      current_task::GetTaskProcessor(), Task::Importance::kCritical, deadline,
-      std::forward<Function>(f), std::forward<Args>(args)...);
+      current_task::GetTaskProcessor(), Task::Importance::kCritical,
+      Task::Priority::kNormal, deadline, std::forward<Function>(f),
+      std::forward<Args>(args)...);
+}
+
+/// @brief Runs `count` asynchronous function calls `f(index)` for `index` in
+/// `[0, count)` using specified task processor
+///
+/// The tasks are pushed into the task queue all at once, and exactly as many
+/// sleeping workers are woken up as needed to run them. This is cheaper than
+/// `count` separate engine::AsyncNoSpan calls for large fan-outs.
+///
+/// `f` is copied into each of the tasks.
+/// @returns std::vector of engine::TaskWithResult
+template <typename Function>
+[[nodiscard]] auto AsyncBatchNoSpan(TaskProcessor& task_processor,
+                                    std::size_t count, const Function& f) {
+  using TaskType = impl::BatchTaskType<Function>;
+  return impl::MakeTaskBatch<TaskType>(
+      task_processor, count, [&task_processor, &f](std::size_t index) {
+        return impl::MakeTask(
+            {task_processor, Task::Importance::kNormal, TaskType::kWaitMode,
+             {}, Task::Priority::kNormal},
+            f, index);
+      });
+}
+
+/// @brief Runs `count` asynchronous function calls `f(index)` for `index` in
+/// `[0, count)` using task processor of the caller
+/// @see engine::AsyncBatchNoSpan
+template <typename Function>
+[[nodiscard]] auto AsyncBatchNoSpan(std::size_t count, const Function& f) {
+  return AsyncBatchNoSpan(current_task::GetTaskProcessor(), count, f);
 }
 
 }  // namespace engine
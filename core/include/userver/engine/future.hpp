@@ -11,6 +11,7 @@
 #include <userver/engine/deadline.hpp>
 #include <userver/engine/future_status.hpp>
 #include <userver/engine/impl/future_state.hpp>
+#include <userver/engine/impl/slab_allocator.hpp>
 
 // TODO remove extra includes
 #include <userver/utils/assert.hpp>
@@ -232,7 +233,9 @@ void Future<T>::CheckValid() const {
 }
 
 template <typename T>
-Promise<T>::Promise() : state_(std::make_shared<impl::FutureState<T>>()) {}
+Promise<T>::Promise()
+    : state_(std::allocate_shared<impl::FutureState<T>>(
+          impl::SlabAllocator<impl::FutureState<T>>{})) {}
 
 template <typename T>
 Promise<T>::~Promise() {
@@ -267,7 +270,8 @@ void Promise<T>::set_exception(std::exception_ptr ex) {
 }
 
 inline Promise<void>::Promise()
-    : state_(std::make_shared<impl::FutureState<void>>()) {}
+    : state_(std::allocate_shared<impl::FutureState<void>>(
+          impl::SlabAllocator<impl::FutureState<void>>{})) {}
 
 inline Promise<void>::~Promise() {
   if (state_ && !state_->IsReady()) {
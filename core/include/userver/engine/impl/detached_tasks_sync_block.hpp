@@ -26,8 +26,18 @@ class DetachedTasksSyncBlock final {
   void Add(TaskContext& context);
   void Add(Task&& task);
 
+  // Cancels the tasks and, for StopMode::kCancelAndWait, waits for them.
+  // Should be called no more than once.
   void RequestCancellation(TaskCancellationReason reason) noexcept;
 
+  // Cancels the tasks, including the ones added later, without waiting for
+  // them. May be called concurrently with Add and from the tasks themselves.
+  void CancelTasks(TaskCancellationReason reason) noexcept;
+
+  // Calls CancelTasks as soon as the current task is cancelled, until the
+  // destruction. Does nothing outside of a coroutine.
+  void CancelTasksWithCurrentTask();
+
   std::int64_t ActiveTasksApprox() const noexcept;
 
   struct Token;
@@ -36,7 +46,7 @@ class DetachedTasksSyncBlock final {
 
  private:
   struct Impl;
-  utils::FastPimpl<Impl, 48, 8> impl_;
+  utils::FastPimpl<Impl, 96, 8> impl_;
 };
 
 }  // namespace engine::impl
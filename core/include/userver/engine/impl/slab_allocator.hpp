@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine::impl {
+
+inline constexpr std::size_t kSlabAlignment = 16;
+
+// Allocates `size` bytes aligned to kSlabAlignment. Small allocations are
+// served from the fixed-size blocks cached by the current thread.
+// Never returns nullptr, may throw.
+void* SlabAllocate(std::size_t size);
+
+// Returns the memory allocated by SlabAllocate. May be called from any thread,
+// the block goes back to the cache of the thread that has allocated it.
+void SlabDeallocate(void* ptr) noexcept;
+
+// std::allocator-compatible wrapper over SlabAllocate and SlabDeallocate, e.g.
+// for std::allocate_shared
+template <typename T>
+class SlabAllocator final {
+ public:
+  using value_type = T;
+
+  SlabAllocator() noexcept = default;
+
+  template <typename U>
+  SlabAllocator(const SlabAllocator<U>&) noexcept {}
+
+  T* allocate(std::size_t n) {
+    if constexpr (alignof(T) > kSlabAlignment) {
+      return static_cast<T*>(
+          ::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+    } else {
+      return static_cast<T*>(SlabAllocate(n * sizeof(T)));
+    }
+  }
+
+  void deallocate(T* ptr, std::size_t) noexcept {
+    if constexpr (alignof(T) > kSlabAlignment) {
+      ::operator delete(ptr, std::align_val_t{alignof(T)});
+    } else {
+      SlabDeallocate(ptr);
+    }
+  }
+
+  template <typename U>
+  bool operator==(const SlabAllocator<U>&) const noexcept {
+    return true;
+  }
+
+  template <typename U>
+  bool operator!=(const SlabAllocator<U>&) const noexcept {
+    return false;
+  }
+};
+
+}  // namespace engine::impl
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <userver/engine/impl/task_context_holder.hpp>
+#include <userver/engine/task/task_processor_fwd.hpp>
+#include <userver/utils/fast_pimpl.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine::impl {
+
+class TaskContext;
+
+// Starts the passed not yet started tasks of `task_processor` all together:
+// with a single bulk enqueue and a single wakeup of as many workers as there
+// are tasks. Other tasks are scheduled as usual, even if they are started
+// while the batch is alive.
+class TaskBatch final {
+ public:
+  // Marks the tasks as queued, so that the tasks constructed from `contexts`
+  // afterwards do not schedule themselves. Schedule() must be called before
+  // any of them is waited for.
+  TaskBatch(TaskProcessor& task_processor,
+            const std::vector<TaskContextHolder>& contexts);
+
+  TaskBatch(const TaskBatch&) = delete;
+  TaskBatch& operator=(const TaskBatch&) = delete;
+  ~TaskBatch();
+
+  // Pushes the tasks into the task queue
+  void Schedule();
+
+ private:
+  struct Impl;
+  utils::FastPimpl<Impl, 32, 8> impl_;
+};
+
+// Starts the tasks of type `TaskType` for the contexts returned by
+// `make_context(index)` for `index` in `[0, count)` as a single TaskBatch
+template <typename TaskType, typename MakeContext>
+std::vector<TaskType> MakeTaskBatch(TaskProcessor& task_processor,
+                                    std::size_t count,
+                                    MakeContext&& make_context) {
+  std::vector<TaskContextHolder> contexts;
+  contexts.reserve(count);
+  for (std::size_t index = 0; index < count; ++index) {
+    contexts.push_back(make_context(index));
+  }
+
+  // Nothing may throw between the creation of the batch and Schedule(),
+  // otherwise the tasks would be waited for without ever being queued
+  std::vector<TaskType> tasks;
+  tasks.reserve(count);
+  TaskBatch batch{task_processor, contexts};
+  for (auto& context : contexts) tasks.emplace_back(std::move(context));
+  batch.Schedule();
+  return tasks;
+}
+
+}  // namespace engine::impl
+
+USERVER_NAMESPACE_END
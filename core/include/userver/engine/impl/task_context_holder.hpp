@@ -17,12 +17,14 @@ class TaskContextHolder final {
 
   static TaskContextHolder Adopt(TaskContext& context) noexcept;
 
-  TaskContextHolder(TaskContextHolder&&) noexcept = default;
+  TaskContextHolder(TaskContextHolder&&) noexcept;
   TaskContextHolder& operator=(TaskContextHolder&&) = delete;
   ~TaskContextHolder();
 
   boost::intrusive_ptr<TaskContext>&& Extract() && noexcept;
 
+  TaskContext& GetContext() const noexcept;
+
  private:
   boost::intrusive_ptr<TaskContext> context_;
 };
@@ -3,6 +3,8 @@
 /// @file userver/engine/io/tls_wrapper.hpp
 /// @brief TLS socket wrappers
 
+#include <cstddef>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -12,11 +14,82 @@
 #include <userver/engine/io/common.hpp>
 #include <userver/engine/io/socket.hpp>
 #include <userver/utils/fast_pimpl.hpp>
+#include <userver/utils/statistics/fwd.hpp>
+#include <userver/utils/statistics/relaxed_counter.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
 namespace engine::io {
 
+/// Handshakes performed with a TlsClientSessionCache or TlsTicketKeys
+struct TlsHandshakeStatistics final {
+  /// Handshakes that have negotiated a new session
+  utils::statistics::RelaxedCounter<std::size_t> full{0};
+
+  /// Handshakes that have resumed a previous session
+  utils::statistics::RelaxedCounter<std::size_t> resumed{0};
+};
+
+void DumpMetric(utils::statistics::Writer& writer,
+                const TlsHandshakeStatistics& stats);
+
+/// @brief Cache of the client TLS sessions shared between connections.
+///
+/// Lets TlsWrapper::StartTlsClient resume a session (using a session ticket
+/// or a TLS 1.3 PSK) with a peer it has already connected to, which skips the
+/// key exchange and the certificate verification of a full handshake.
+/// Sessions are keyed by the server name and the peer address.
+///
+/// Thread safe. Must outlive the TlsWrapper instances that use it.
+class TlsClientSessionCache final {
+ public:
+  explicit TlsClientSessionCache(std::size_t max_size = 1000);
+  ~TlsClientSessionCache();
+
+  TlsClientSessionCache(const TlsClientSessionCache&) = delete;
+  TlsClientSessionCache& operator=(const TlsClientSessionCache&) = delete;
+
+  /// Forgets all the sessions
+  void Clear();
+
+  const TlsHandshakeStatistics& GetStatistics() const;
+
+ private:
+  friend class TlsWrapper;
+
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+/// @brief Keys for the TLS session tickets issued by servers.
+///
+/// Lets TlsWrapper::StartTlsServer issue session tickets that are accepted by
+/// all the connections sharing the keys. The keys should be rotated
+/// periodically: the tickets of the previous key are still accepted and
+/// renewed until the next rotation.
+///
+/// Thread safe.
+class TlsTicketKeys final {
+ public:
+  /// Generates a random key
+  TlsTicketKeys();
+  ~TlsTicketKeys();
+
+  TlsTicketKeys(const TlsTicketKeys&) = delete;
+  TlsTicketKeys& operator=(const TlsTicketKeys&) = delete;
+
+  /// Generates a new key for the new tickets
+  void Rotate();
+
+  const TlsHandshakeStatistics& GetStatistics() const;
+
+ private:
+  friend class TlsWrapper;
+
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
 /// Class for TLS communications over a Socket.
 ///
 /// Not thread safe.
@@ -30,12 +103,27 @@ class [[nodiscard]] TlsWrapper final : public RwBase {
                                    const std::string& server_name,
                                    Deadline deadline);
 
+  /// Starts a TLS client on an opened socket, resumes the previous session
+  /// with the peer from the session_cache if possible
+  static TlsWrapper StartTlsClient(Socket&& socket,
+                                   const std::string& server_name,
+                                   Deadline deadline,
+                                   TlsClientSessionCache& session_cache);
+
   /// Starts a TLS server on an opened socket
   static TlsWrapper StartTlsServer(
       Socket&& socket, const crypto::Certificate& cert,
       const crypto::PrivateKey& key, Deadline deadline,
       const std::vector<crypto::Certificate>& cert_authorities = {});
 
+  /// Starts a TLS server on an opened socket, issues and accepts the session
+  /// tickets encrypted with the ticket_keys
+  static TlsWrapper StartTlsServer(
+      Socket&& socket, const crypto::Certificate& cert,
+      const crypto::PrivateKey& key, Deadline deadline,
+      const std::vector<crypto::Certificate>& cert_authorities,
+      TlsTicketKeys& ticket_keys);
+
   ~TlsWrapper() override;
 
   TlsWrapper(const TlsWrapper&) = delete;
@@ -47,6 +135,9 @@ class [[nodiscard]] TlsWrapper final : public RwBase {
   /// Whether the socket is valid.
   bool IsValid() const override;
 
+  /// Whether the handshake has resumed a previous session.
+  bool IsSessionReused() const;
+
   /// Suspends current task until the socket has data available.
   [[nodiscard]] bool WaitReadable(Deadline) override;
 
@@ -96,8 +187,19 @@ class [[nodiscard]] TlsWrapper final : public RwBase {
  private:
   explicit TlsWrapper(Socket&&);
 
+  static TlsWrapper DoStartTlsClient(Socket&& socket,
+                                     const std::string& server_name,
+                                     Deadline deadline,
+                                     TlsClientSessionCache* session_cache);
+
+  static TlsWrapper DoStartTlsServer(
+      Socket&& socket, const crypto::Certificate& cert,
+      const crypto::PrivateKey& key, Deadline deadline,
+      const std::vector<crypto::Certificate>& cert_authorities,
+      TlsTicketKeys* ticket_keys);
+
   class Impl;
-  constexpr static size_t kSize = 296;
+  constexpr static size_t kSize = 336;
   constexpr static size_t kAlignment = 8;
   utils::FastPimpl<Impl, kSize, kAlignment> impl_;
 };
@@ -20,6 +20,10 @@ struct TaskProcessorPoolsConfig final {
   std::string ev_thread_name = "ev";
   bool ev_default_loop_disabled = false;
   bool defer_events = true;
+  bool work_stealing_task_queue = false;
+  bool adaptive_spinning = false;
+  /// Use the io_uring libev backend for readiness polling of the ev loops
+  bool ev_io_uring = false;
 };
 
 /// @brief Runs a payload in a temporary coroutine engine instance.
@@ -48,6 +48,22 @@ class [[nodiscard]] TaskBase {
     kCritical,
   };
 
+  /// @brief Task priority class, tasks of a higher class are started first
+  /// by the TaskProcessor.
+  ///
+  /// Lower classes are not starved: they are periodically served ahead of the
+  /// higher ones, so background work still makes progress under load.
+  enum class Priority {
+    /// Latency-critical task, e.g. a request handler
+    kLatencyCritical,
+
+    /// Normal task
+    kNormal,
+
+    /// Background task, e.g. a periodic cache update
+    kBackground,
+  };
+
   /// Task state
   enum class State {
     kInvalid,    ///< Unusable
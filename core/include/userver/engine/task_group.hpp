@@ -0,0 +1,166 @@
+#pragma once
+
+/// @file userver/engine/task_group.hpp
+/// @brief @copybrief engine::TaskGroup
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <utility>
+
+#include <userver/engine/async.hpp>
+#include <userver/engine/deadline.hpp>
+#include <userver/engine/impl/detached_tasks_sync_block.hpp>
+#include <userver/engine/single_consumer_event.hpp>
+#include <userver/engine/task/task_processor_fwd.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine {
+
+/// @ingroup userver_concurrency
+///
+/// @brief A scope that owns a set of child tasks: starts them, cancels them
+/// all at once and waits for all of them with a single wait.
+///
+/// - The children are started with the deadline of the group, if any
+/// - If a child throws, the rest of the children are cancelled and Wait()
+///   rethrows the exception
+/// - If the task that has created the group is cancelled, the children are
+///   cancelled right away, whatever that task is doing
+/// - If the task that waits for the group is cancelled, the children are
+///   cancelled too
+/// - The children that are still running are cancelled and waited for on
+///   the group destruction
+///
+/// Prefer TaskGroup to hand-held containers of engine::TaskWithResult when the
+/// results are delivered through the captured state: cancellation does not
+/// visit the finished children, and joining does not wake the caller up on
+/// each child completion.
+///
+/// ## Usage synopsis
+/// @snippet engine/task_group_test.cpp  Sample
+class TaskGroup final {
+ public:
+  /// Creates a group that starts the children in the engine::TaskProcessor of
+  /// the caller.
+  TaskGroup();
+
+  /// Creates a group that starts the children in the specified
+  /// engine::TaskProcessor.
+  explicit TaskGroup(TaskProcessor& task_processor);
+
+  /// Creates a group whose children are cancelled on the `deadline`.
+  TaskGroup(TaskProcessor& task_processor, Deadline deadline);
+
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  /// Cancels and waits for the children that are still running.
+  ~TaskGroup();
+
+  /// @brief Starts a child task that runs `f(args...)`.
+  ///
+  /// The result of `f` is discarded. If the group is already cancelled, the
+  /// child is started cancelled and its body is not run.
+  template <typename Function, typename... Args>
+  void AsyncNoSpan(Function&& f, Args&&... args);
+
+  /// @brief Starts a child task that runs `f(args...)` even if the group or
+  /// the child is cancelled before the start.
+  /// @see Task::Importance::kCritical
+  template <typename Function, typename... Args>
+  void CriticalAsyncNoSpan(Function&& f, Args&&... args);
+
+  /// @brief Waits for all the children started so far.
+  ///
+  /// @throws WaitInterruptedException if the current task is cancelled. The
+  /// children are cancelled and waited for before the exception is thrown.
+  /// @throws the first exception thrown by a child, if any.
+  void Wait();
+
+  /// Requests cancellation of all the children, including the ones that will
+  /// be started later. Does not wait for the children.
+  void Cancel() noexcept;
+
+  /// Number of the children that have not finished yet.
+  std::size_t ActiveTasksApprox() const noexcept;
+
+ private:
+  // Accounts a child that has not finished yet, a part of the child payload
+  class ChildToken final {
+   public:
+    explicit ChildToken(TaskGroup& group) noexcept;
+
+    ChildToken(ChildToken&& other) noexcept;
+    ChildToken& operator=(ChildToken&&) = delete;
+    ~ChildToken();
+
+    template <typename Function, typename... Args>
+    void Run(Function& f, Args&&... args);
+
+   private:
+    // Returns false for the exception that unwinds a cancelled child, it must
+    // be rethrown
+    bool SetException(std::exception_ptr&& exception) noexcept;
+    void Finish() noexcept;
+
+    TaskGroup* group_;
+  };
+
+  template <typename Function, typename... Args>
+  void Start(Task::Importance importance, Function&& f, Args&&... args);
+
+  void Detach(Task&& task);
+  void WaitNonCancellable() noexcept;
+
+  TaskProcessor& task_processor_;
+  const Deadline deadline_;
+
+  std::atomic<std::size_t> active_tasks_{0};
+  SingleConsumerEvent all_tasks_finished_;
+
+  std::atomic<bool> has_exception_{false};
+  std::exception_ptr exception_;
+
+  impl::DetachedTasksSyncBlock sync_block_;
+};
+
+template <typename Function, typename... Args>
+void TaskGroup::AsyncNoSpan(Function&& f, Args&&... args) {
+  Start(Task::Importance::kNormal, std::forward<Function>(f),
+        std::forward<Args>(args)...);
+}
+
+template <typename Function, typename... Args>
+void TaskGroup::CriticalAsyncNoSpan(Function&& f, Args&&... args) {
+  Start(Task::Importance::kCritical, std::forward<Function>(f),
+        std::forward<Args>(args)...);
+}
+
+template <typename Function, typename... Args>
+void TaskGroup::Start(Task::Importance importance, Function&& f,
+                      Args&&... args) {
+  Detach(impl::MakeTaskWithResult<TaskWithResult>(
+      task_processor_, importance, Task::Priority::kNormal, deadline_,
+      [token = ChildToken{*this},
+       func = std::forward<Function>(f)](auto&&... call_args) mutable {
+        token.Run(func, std::forward<decltype(call_args)>(call_args)...);
+      },
+      std::forward<Args>(args)...));
+}
+
+template <typename Function, typename... Args>
+void TaskGroup::ChildToken::Run(Function& f, Args&&... args) {
+  try {
+    std::invoke(f, std::forward<Args>(args)...);
+  } catch (...) {
+    if (!SetException(std::current_exception())) throw;
+  }
+  Finish();
+}
+
+}  // namespace engine
+
+USERVER_NAMESPACE_END
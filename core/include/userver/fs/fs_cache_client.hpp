@@ -3,14 +3,20 @@
 /// @file userver/fs/fs_cache_client.hpp
 /// @brief @copybref fs::FsCacheClient
 
+#include <atomic>
+
 #include <userver/fs/read.hpp>
 #include <userver/rcu/rcu_map.hpp>
 #include <userver/utils/periodic_task.hpp>
+#include <userver/utils/statistics/fwd.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
 namespace fs {
 
+/// @brief Settings of fs::FsCacheClient
+using FsCacheSettings = ReadFilesSettings;
+
 /// @ingroup userver_clients
 ///
 /// @brief Class client for storing files in memory
@@ -24,6 +30,10 @@ class FsCacheClient final {
   FsCacheClient(std::string_view dir, std::chrono::milliseconds update_period,
                 engine::TaskProcessor& tp);
 
+  /// @overload
+  FsCacheClient(std::string_view dir, std::chrono::milliseconds update_period,
+                engine::TaskProcessor& tp, FsCacheSettings settings);
+
   /// @brief get file from memory
   /// @param path to file
   /// @return file info and content ; `nullptr` if no file with specified name
@@ -33,12 +43,26 @@ class FsCacheClient final {
   /// @brief Concurrency-safe cache update
   void UpdateCache();
 
+  /// @brief The task processor the filesystem operations are done in, e.g.
+  /// to read the mapped files
+  engine::TaskProcessor& GetTaskProcessor() const noexcept { return tp_; }
+
+  /// @brief Writes the memory usage statistics of the cache
+  friend void DumpMetric(utils::statistics::Writer& writer,
+                         const FsCacheClient& client);
+
  private:
   const std::string dir_;
   const std::chrono::milliseconds update_period_;
   engine::TaskProcessor& tp_;
+  const FsCacheSettings settings_;
   utils::PeriodicTask cache_updater_;
   rcu::RcuMap<std::string, const fs::FileInfoWithData> data_;
+
+  std::atomic<std::size_t> files_{0};
+  std::atomic<std::size_t> heap_bytes_{0};
+  std::atomic<std::size_t> mapped_bytes_{0};
+  std::atomic<std::size_t> encoded_variants_{0};
 };
 
 }  // namespace fs
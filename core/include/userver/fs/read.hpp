@@ -4,8 +4,12 @@
 /// @brief functions for asynchronous file read operations
 
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <userver/engine/task/task_processor_fwd.hpp>
 #include <userver/utils/flags.hpp>
@@ -15,11 +19,26 @@ USERVER_NAMESPACE_BEGIN
 /// @brief filesystem support
 namespace fs {
 
+namespace blocking {
+class MappedFile;
+}  // namespace blocking
+
 /// @brief Struct file with load data
 struct FileInfoWithData {
   std::string data;
   std::string extension;
   size_t size;
+
+  /// The mapping of a large file, `data` is empty for the mapped files
+  std::shared_ptr<const blocking::MappedFile> mapped_file;
+  /// Strong validator of the file, see RFC 9110 8.8.3
+  std::string etag;
+  /// Precompressed variants of the file by content coding, e.g. "gzip"
+  std::vector<std::pair<std::string, std::shared_ptr<const FileInfoWithData>>>
+      encoded_variants;
+
+  /// Returns the file contents, either read or mapped
+  std::string_view GetContent() const;
 };
 
 using FileInfoWithDataConstPtr = std::shared_ptr<const FileInfoWithData>;
@@ -32,6 +51,20 @@ enum class SettingsReadFile {
   kSkipHidden = 1 << 0,
 };
 
+/// @brief Settings of fs::ReadRecursiveFilesInfoWithData
+struct ReadFilesSettings {
+  /// Which files to skip
+  utils::Flags<SettingsReadFile> flags{SettingsReadFile::kSkipHidden};
+
+  /// The files of this size and larger are memory mapped instead of being
+  /// read into memory
+  std::optional<std::size_t> mmap_min_size;
+
+  /// Whether to attach the `.gz`, `.br` and `.zst` sibling files to the file
+  /// as its precompressed variants
+  bool precompressed_variants{false};
+};
+
 /// @brief Returns files from recursively traversed directory
 /// @param async_tp TaskProcessor for synchronous waiting
 /// @param path to directory to traverse recursively
@@ -43,6 +76,20 @@ FileInfoWithDataMap ReadRecursiveFilesInfoWithData(
     engine::TaskProcessor& async_tp, const std::string& path,
     utils::Flags<SettingsReadFile> flags = {SettingsReadFile::kSkipHidden});
 
+/// @brief Returns files from recursively traversed directory, the directory
+/// is traversed and the files are read in a single job on `async_tp`
+/// @param async_tp TaskProcessor for synchronous waiting
+/// @param path to directory to traverse recursively
+/// @param settings settings read files
+/// @param previous the result of the previous call for the same directory or
+/// an empty map, the mappings of the not modified files are reused
+/// @returns map with relative to `path` filepaths and file info
+/// @throws std::runtime_error if read fails for any reason (e.g. no such file,
+/// read error, etc.),
+FileInfoWithDataMap ReadRecursiveFilesInfoWithData(
+    engine::TaskProcessor& async_tp, const std::string& path,
+    const ReadFilesSettings& settings, const FileInfoWithDataMap& previous);
+
 /// @brief Reads file contents asynchronously
 /// @param async_tp TaskProcessor for synchronous waiting
 /// @param path file to open
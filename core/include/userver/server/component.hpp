@@ -69,10 +69,15 @@ namespace components {
 /// handler-defaults.set_tracing_headers | whether to set http tracing headers (X-YaTraceId, X-YaSpanId, X-RequestId) | true
 /// handler-defaults.deadline_propagation_enabled | when `false`, disables HTTP handler deadline propagation | true
 /// handler-defaults.deadline_expired_status_code | the HTTP status code to return if the request deadline expires | 504
+/// handler-defaults.arena_initial_size | size of the first block of the per-request arena that keeps the parsed arguments and the data allocated via server::request::RequestContext::GetMemoryResource(), 0 to disable the arena | 0
 /// connection.in_buffer_size | size of the buffer to preallocate for request receive: bigger values use more RAM and less CPU | 32 * 1024
-/// connection.requests_queue_size_threshold | drop requests from handlers that allow trottling if there's more pending requests than allowed by this value | 100
+/// connection.requests_queue_size_threshold | max count of the pipelined HTTP/1.1 requests of a connection that are processed concurrently, the next requests are not read until some responses are sent | 100
 /// connection.keepalive_timeout | timeout in seconds to drop connection if there's not data received from it | 600
-/// shards | how many concurrent tasks harvest data from a single socket; do not set if not sure what it is doing | -
+/// connection.idle_parking_timeout | an HTTP/1.1 keep-alive connection idle for this long frees its tasks and buffer until new data arrives, 0s to disable | 1s
+/// connection.http2_enabled | accept HTTP/2 connections with prior knowledge (h2c) besides the HTTP/1.1 ones | false
+/// connection.http2_max_concurrent_streams | max count of concurrently processed HTTP/2 streams of a connection | 100
+/// connection.http2_initial_window_size | HTTP/2 flow control window of a stream for the request bodies | 1024 * 1024
+/// shards | how many SO_REUSEPORT sockets to listen on, each with its own accept loop; the kernel distributes the new connections among them | count of the event threads
 ///
 /// @see @ref md_en_userver_http_server
 
@@ -43,6 +43,10 @@ namespace server::handlers {
 /// set_tracing_headers | whether to set http tracing headers (X-YaTraceId, X-YaSpanId, X-RequestId) | true
 /// deadline_propagation_enabled | when `false`, disables HTTP handler deadline propagation | true
 /// deadline_expired_status_code | the HTTP status code to return if the request deadline expires | 504
+/// response_compression.encodings | content codings to compress the responses with, in the order of preference: gzip, br, zstd (br and zstd require USERVER_FEATURE_BROTLI and USERVER_FEATURE_ZSTD) | [gzip]
+/// response_compression.level | compression level of the coding | <the coding default>
+/// response_compression.min_size | responses smaller than this are not compressed, does not apply to the streamed responses | 1024
+/// response_compression.task_processor | task processor to compress the responses on | <the handler task_processor>
 
 // clang-format on
 class HandlerBase : public components::LoggableComponentBase {
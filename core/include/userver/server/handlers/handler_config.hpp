@@ -26,6 +26,19 @@ enum class UrlTrailingSlashOption {
   kDefault = kBoth,
 };
 
+/// Compression of the handler responses, see the `response_compression`
+/// static option of the handlers.
+struct ResponseCompressionConfig {
+  /// Content codings in the order of preference: "gzip", "br" or "zstd"
+  std::vector<std::string> encodings{"gzip"};
+  /// Compression level of the coding, the coding default if not set
+  std::optional<int> level;
+  /// Smaller responses are sent as is, the body streams are always compressed
+  std::size_t min_size{1024};
+  /// Task processor to compress on, the handler one if not set
+  std::optional<std::string> task_processor;
+};
+
 struct HandlerConfig {
   std::variant<std::string, FallbackHandler> path;
   std::string task_processor;
@@ -44,6 +57,7 @@ struct HandlerConfig {
   bool set_tracing_headers{true};
   bool deadline_propagation_enabled{true};
   http::HttpStatus deadline_expired_status_code{504};
+  std::optional<ResponseCompressionConfig> response_compression;
 };
 
 HandlerConfig ParseHandlerConfigsWithDefaults(
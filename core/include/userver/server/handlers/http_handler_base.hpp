@@ -35,6 +35,7 @@ class HttpHandlerStatistics;
 class HttpRequestStatistics;
 class HttpHandlerMethodStatistics;
 class HttpHandlerStatisticsScope;
+class ResponseCompression;
 
 // clang-format off
 
@@ -193,6 +194,7 @@ class HttpHandlerBase : public HandlerBase {
 
   std::unique_ptr<HttpHandlerStatistics> handler_statistics_;
   std::unique_ptr<HttpRequestStatistics> request_statistics_;
+  std::unique_ptr<ResponseCompression> response_compression_;
   std::vector<auth::AuthCheckerBasePtr> auth_checkers_;
 
   std::optional<logging::Level> log_level_;
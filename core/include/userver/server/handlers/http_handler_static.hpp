@@ -19,6 +19,13 @@ namespace server::handlers {
 /// @brief Handler that returns HTTP 200 if file exist
 /// and returns file data with mapped content/type
 ///
+/// The files are sent with their `ETag` and the `If-None-Match` requests
+/// are answered with HTTP 304. A single byte range of the `Range` header is
+/// answered with HTTP 206, the `If-Range` condition is supported for the
+/// entity tags. The memory mapped files of components::FsCache are sent with
+/// sendfile without copying, the precompressed variants of the files are
+/// chosen by the `Accept-Encoding` header.
+///
 /// ## Dynamic config
 /// * @ref USERVER_FILES_CONTENT_TYPE_MAP
 ///
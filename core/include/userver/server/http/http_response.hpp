@@ -4,6 +4,7 @@
 /// @brief @copybrief server::http::HttpResponse
 
 #include <chrono>
+#include <memory>
 #include <string>
 #include <unordered_map>
 
@@ -20,6 +21,14 @@
 
 USERVER_NAMESPACE_BEGIN
 
+namespace engine {
+class TaskProcessor;
+}  // namespace engine
+
+namespace fs::blocking {
+class MappedFile;
+}  // namespace fs::blocking
+
 namespace server::http {
 
 namespace impl {
@@ -119,6 +128,7 @@ class HttpResponse final : public request::ResponseBase {
   /// @cond
   // TODO: server internals. remove from public interface
   void SendResponse(engine::io::Socket& socket) override;
+  bool SerializeResponse(net::ResponseWriter& writer) override;
   /// @endcond
 
   void SetStatusServiceUnavailable() override {
@@ -137,13 +147,50 @@ class HttpResponse final : public request::ResponseBase {
   // Can be called only once
   Queue::Producer GetBodyProducer();
 
+  /// @cond
+  // For HTTP/2 connections, which send the headers and the body in frames of
+  // their own. Returns false once the body stream is over.
+  bool PopBodyChunk(std::string& chunk);
+  /// @endcond
+
+  /// @brief Sends the `[offset, offset + size)` range of the file as the
+  /// response body without copying it, with sendfile on Linux.
+  ///
+  /// The file is opened and read in `fs_task_processor`, so that the reads of
+  /// a cold page cache do not block the request task processor.
+  ///
+  /// The file body is used only if the response data is empty, so the data
+  /// set by an error handler takes precedence.
+  void SetFileBody(std::shared_ptr<const fs::blocking::MappedFile> file,
+                   std::size_t offset, std::size_t size,
+                   engine::TaskProcessor& fs_task_processor);
+
+  /// @cond
+  struct FileBody {
+    std::shared_ptr<const fs::blocking::MappedFile> file;
+    std::size_t offset;
+    std::size_t size;
+    engine::TaskProcessor* fs_task_processor;
+  };
+
+  // The file body that is sent instead of the data, nullptr if there is
+  // none. For HTTP/2 connections.
+  const FileBody* GetFileBody() const;
+  /// @endcond
+
  private:
+  bool HasFileBody() const;
+  void SerializeHeaders(std::string& header);
+
+  void SerializeBodyNotStreamed(net::ResponseWriter& writer);
+
   // Returns total size of the response
-  std::size_t SetBodyStreamed(engine::io::Socket& socket, std::string& header);
+  std::size_t SendBodyStreamed(engine::io::Socket& socket,
+                               net::ResponseWriter& writer);
 
   // Returns total size of the response
-  std::size_t SetBodyNotStreamed(engine::io::Socket& socket,
-                                 std::string& header);
+  std::size_t SendFileBody(engine::io::Socket& socket,
+                           net::ResponseWriter& writer);
 
   const HttpRequestImpl& request_;
   HttpStatus status_ = HttpStatus::kOk;
@@ -153,6 +200,7 @@ class HttpResponse final : public request::ResponseBase {
   engine::SingleConsumerEvent headers_end_;
   std::optional<Queue::Consumer> body_stream_;
   std::optional<Queue::Producer> body_stream_producer_;
+  std::optional<FileBody> file_body_;
 };
 
 void SetThrottleReason(http::HttpResponse& http_response,
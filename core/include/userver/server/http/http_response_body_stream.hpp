@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <string>
 
 #include <userver/server/http/http_response.hpp>
@@ -9,13 +10,15 @@ USERVER_NAMESPACE_BEGIN
 
 namespace server::handlers {
 class HttpHandlerBase;
-}
+class ResponseBodyCompressor;
+}  // namespace server::handlers
 
 namespace server::http {
 
 class ResponseBodyStream final {
  public:
-  ResponseBodyStream(ResponseBodyStream&&) = default;
+  ResponseBodyStream(ResponseBodyStream&&) noexcept;
+  ~ResponseBodyStream();
 
   // Send a chunk of response data. It may NOT generate
   // exactly one HTTP chunk per call to PushBodyChunk().
@@ -41,6 +44,7 @@ class ResponseBodyStream final {
   bool headers_ended_{false};
   HttpResponse::Queue::Producer queue_producer_;
   server::http::HttpResponse& http_response_;
+  std::unique_ptr<server::handlers::ResponseBodyCompressor> compressor_;
 };
 
 }  // namespace server::http
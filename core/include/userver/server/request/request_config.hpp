@@ -19,6 +19,7 @@ struct HttpRequestConfig {
   bool set_tracing_headers = true;
   bool deadline_propagation_enabled = true;
   http::HttpStatus deadline_expired_status_code{504};
+  std::size_t arena_initial_size = 0;
 };
 
 HttpRequestConfig Parse(const yaml_config::YamlConfig& value,
@@ -3,8 +3,15 @@
 /// @file userver/server/request/request_context.hpp
 /// @brief @copybrief server::request::RequestContext
 
+#include <cstddef>
 #include <string>
 
+// The standard libraries that lack <memory_resource> get the RequestContext
+// without the memory resource accessors, its layout does not depend on them
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+
 #include <userver/compiler/select.hpp>
 #include <userver/utils/any_movable.hpp>
 #include <userver/utils/fast_pimpl.hpp>
@@ -20,6 +27,9 @@ namespace server::request {
 class RequestContext final {
  public:
   RequestContext();
+#if __has_include(<memory_resource>)
+  explicit RequestContext(std::pmr::memory_resource& memory_resource);
+#endif
   RequestContext(RequestContext&&) = delete;
   RequestContext(const RequestContext&) = delete;
 
@@ -98,14 +108,34 @@ class RequestContext final {
   /// @brief Erase data with specified name.
   void EraseData(const std::string& name);
 
+#if __has_include(<memory_resource>)
+  /// @brief Returns the memory resource for the data that is not needed
+  /// after the request is processed.
+  ///
+  /// If `handler-defaults.arena_initial_size` of the server is set, it is a
+  /// monotonic arena of the request: the allocations are cheap and the memory
+  /// is released all at once with the request. The allocated data must not
+  /// outlive the request. The resource is not thread-safe, use it from the
+  /// request handling task only.
+  ///
+  /// Is available if the standard library provides `<memory_resource>`.
+  std::pmr::memory_resource& GetMemoryResource() const;
+
+  /// @returns An allocator over GetMemoryResource() for std::pmr containers
+  template <typename T = std::byte>
+  std::pmr::polymorphic_allocator<T> GetAllocator() const {
+    return &GetMemoryResource();
+  }
+#endif
+
  private:
   class Impl;
 
   static constexpr std::size_t kPimplSize = compiler::SelectSize()  //
-                                                .ForLibCpp32(24)
-                                                .ForLibCpp64(48)
-                                                .ForLibStdCpp64(64)
-                                                .ForLibStdCpp32(32);
+                                                .ForLibCpp32(28)
+                                                .ForLibCpp64(56)
+                                                .ForLibStdCpp64(72)
+                                                .ForLibStdCpp32(36);
 
   utils::AnyMovable& SetUserAnyData(utils::AnyMovable&& data);
   utils::AnyMovable& GetUserAnyData();
@@ -14,6 +14,10 @@ namespace engine::io {
 class Socket;
 }  // namespace engine::io
 
+namespace server::net {
+class ResponseWriter;
+}  // namespace server::net
+
 namespace server::request {
 
 class ResponseDataAccounter final {
@@ -72,6 +76,14 @@ class ResponseBase {
 
   virtual void SendResponse(engine::io::Socket& socket) = 0;
 
+  // Serializes the response to send it together with the other pipelined
+  // responses of the connection. Returns false if the response may only be
+  // sent by SendResponse, e.g. with a streamed body.
+  virtual bool SerializeResponse(net::ResponseWriter& writer);
+
+  // For the responses sent by the connection itself
+  void SetSentByConnection(std::size_t bytes_sent);
+
   virtual void SetStatusServiceUnavailable() = 0;
   virtual void SetStatusOk() = 0;
   virtual void SetStatusNotFound() = 0;
@@ -204,6 +204,31 @@ template <typename Function, typename... Args>
       std::forward<Function>(f), std::forward<Args>(args)...);
 }
 
+/// @ingroup userver_concurrency
+///
+/// Starts an asynchronous task with the specified priority class, task
+/// execution may be cancelled before the function starts execution in case of
+/// TaskProcessor overload.
+///
+/// By default, arguments are copied or moved inside the resulting
+/// `TaskWithResult`, like `std::thread` does. To pass an argument by reference,
+/// wrap it in `std::ref / std::cref` or capture the arguments using a lambda.
+///
+/// @param tasks_processor Task processor to run on
+/// @param name Name of the task to show in logs
+/// @param priority Priority class of the task, see engine::Task::Priority
+/// @param f Function to execute asynchronously
+/// @param args Arguments to pass to the function
+/// @returns engine::TaskWithResult
+template <typename Function, typename... Args>
+[[nodiscard]] auto Async(engine::TaskProcessor& task_processor,
+                         std::string name, engine::Task::Priority priority,
+                         Function&& f, Args&&... args) {
+  return engine::AsyncNoSpan(
+      task_processor, priority, impl::SpanLazyPrvalue(std::move(name)),
+      std::forward<Function>(f), std::forward<Args>(args)...);
+}
+
 /// @ingroup userver_concurrency
 ///
 /// Starts an asynchronous task on current task processor, execution of
@@ -323,6 +348,29 @@ template <typename Function, typename... Args>
                       std::forward<Args>(args)...);
 }
 
+/// @ingroup userver_concurrency
+///
+/// Starts an asynchronous task with the specified priority class on current
+/// task processor, task execution may be cancelled before the function starts
+/// execution in case of engine::TaskProcessor overload.
+///
+/// By default, arguments are copied or moved inside the resulting
+/// `TaskWithResult`, like `std::thread` does. To pass an argument by reference,
+/// wrap it in `std::ref / std::cref` or capture the arguments using a lambda.
+///
+/// @param name Name of the task to show in logs
+/// @param priority Priority class of the task, see engine::Task::Priority
+/// @param f Function to execute asynchronously
+/// @param args Arguments to pass to the function
+/// @returns engine::TaskWithResult
+template <typename Function, typename... Args>
+[[nodiscard]] auto Async(std::string name, engine::Task::Priority priority,
+                         Function&& f, Args&&... args) {
+  return utils::Async(engine::current_task::GetTaskProcessor(), std::move(name),
+                      priority, std::forward<Function>(f),
+                      std::forward<Args>(args)...);
+}
+
 /// @ingroup userver_concurrency
 ///
 /// Starts an asynchronous task with deadline on current task processor, task
@@ -388,6 +436,56 @@ template <typename Function, typename... Args>
       std::forward<Function>(f), std::forward<Args>(args)...);
 }
 
+/// @ingroup userver_concurrency
+///
+/// Starts `count` asynchronous tasks `f(index)` for `index` in `[0, count)`,
+/// task execution may be cancelled before the function starts execution in
+/// case of engine::TaskProcessor overload.
+///
+/// The tasks are pushed into the task queue all at once, and exactly as many
+/// sleeping workers are woken up as needed to run them. Prefer it over calling
+/// utils::Async in a loop for large fan-outs, e.g. to subrequests.
+///
+/// `f` is copied into each of the tasks.
+///
+/// @param tasks_processor Task processor to run on
+/// @param name Name of the tasks to show in logs
+/// @param count Number of tasks to start
+/// @param f Function to execute asynchronously, takes the task index
+/// @returns std::vector of engine::TaskWithResult
+template <typename Function>
+[[nodiscard]] auto AsyncBatch(engine::TaskProcessor& task_processor,
+                              const std::string& name, std::size_t count,
+                              const Function& f) {
+  using TaskType = engine::impl::BatchTaskType<Function>;
+  return engine::impl::MakeTaskBatch<TaskType>(
+      task_processor, count, [&task_processor, &name, &f](std::size_t index) {
+        return engine::impl::MakeTask(
+            {task_processor, engine::Task::Importance::kNormal,
+             TaskType::kWaitMode, {}, engine::Task::Priority::kNormal},
+            impl::SpanLazyPrvalue(std::string{name}), f, index);
+      });
+}
+
+/// @ingroup userver_concurrency
+///
+/// Starts `count` asynchronous tasks `f(index)` for `index` in `[0, count)`
+/// on current task processor, task execution may be cancelled before the
+/// function starts execution in case of engine::TaskProcessor overload.
+///
+/// @see utils::AsyncBatch
+///
+/// @param name Name of the tasks to show in logs
+/// @param count Number of tasks to start
+/// @param f Function to execute asynchronously, takes the task index
+/// @returns std::vector of engine::TaskWithResult
+template <typename Function>
+[[nodiscard]] auto AsyncBatch(const std::string& name, std::size_t count,
+                              const Function& f) {
+  return utils::AsyncBatch(engine::current_task::GetTaskProcessor(), name,
+                           count, f);
+}
+
 }  // namespace utils
 
 USERVER_NAMESPACE_END
@@ -34,14 +34,20 @@ ResolverConfig ParseResolverConfig(
           config.network_custom_servers);
   config.cache_ways =
       component_config["cache-ways"].As<size_t>(config.cache_ways);
-  config.cache_size_per_way = component_config["cache_size_per_way"].As<size_t>(
+  config.cache_size_per_way = component_config["cache-size-per-way"].As<size_t>(
       config.cache_size_per_way);
   config.cache_max_reply_ttl =
-      component_config["cache_max_reply_ttl"].As<std::chrono::milliseconds>(
+      component_config["cache-max-reply-ttl"].As<std::chrono::milliseconds>(
           config.cache_max_reply_ttl);
   config.cache_failure_ttl =
-      component_config["cache_failure_ttl"].As<std::chrono::milliseconds>(
+      component_config["cache-failure-ttl"].As<std::chrono::milliseconds>(
           config.cache_failure_ttl);
+  config.cache_prefetch_ratio =
+      component_config["cache-prefetch-ratio"].As<double>(
+          config.cache_prefetch_ratio);
+  config.cache_max_stale =
+      component_config["cache-max-stale"].As<std::chrono::milliseconds>(
+          config.cache_max_stale);
   return config;
 }
 
@@ -122,6 +128,16 @@ properties:
         type: string
         description: TTL for network failures caching
         defaultDescription: 5s
+    cache-prefetch-ratio:
+        type: number
+        description: part of the reply TTL after which the record is updated in background
+        defaultDescription: 0.9
+        minimum: 0
+        maximum: 1
+    cache-max-stale:
+        type: string
+        description: how long an expired record may be returned while it is being updated
+        defaultDescription: 24h
 )");
 }
 
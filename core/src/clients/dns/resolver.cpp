@@ -171,6 +171,8 @@ class Resolver::Impl {
     AddrVector addrs;
     std::chrono::steady_clock::time_point expiration;
     bool is_failure{false};
+    // The record is updated in background after this time
+    std::chrono::steady_clock::time_point update_time{};
   };
 
   template <typename Mutex>
@@ -190,6 +192,8 @@ class Resolver::Impl {
   const std::chrono::milliseconds net_cache_update_margin_;
   const std::chrono::milliseconds net_cache_max_reply_ttl_;
   const std::chrono::milliseconds net_cache_failure_ttl_;
+  const double net_cache_prefetch_ratio_;
+  const std::chrono::milliseconds net_cache_max_stale_;
   cache::NWayLRU<std::string, NetCacheEntry> net_cache_;
   concurrent::MutexSet<std::string> net_cache_update_mutexes_;
   utils::impl::WaitTokenStorage wait_token_storage_;
@@ -204,6 +208,8 @@ Resolver::Impl::Impl(engine::TaskProcessor& fs_task_processor,
       net_cache_update_margin_{config.network_timeout},
       net_cache_max_reply_ttl_{config.cache_max_reply_ttl},
       net_cache_failure_ttl_{config.cache_failure_ttl},
+      net_cache_prefetch_ratio_{config.cache_prefetch_ratio},
+      net_cache_max_stale_{config.cache_max_stale},
       net_cache_{config.cache_ways, config.cache_size_per_way},
       net_cache_update_mutexes_(config.cache_ways) {}
 
@@ -236,7 +242,9 @@ Resolver::Impl::NetCacheResult Resolver::Impl::QueryNetCache(
 
   const auto now = utils::datetime::MockSteadyNow();
   const auto cached = net_cache_.Get(name);
-  if (!cached) return result;
+  if (!cached || cached->expiration + net_cache_max_stale_ < now) {
+    return result;
+  }
 
   if (cached->is_failure) {
     if (cached->expiration >= now) {
@@ -253,7 +261,7 @@ Resolver::Impl::NetCacheResult Resolver::Impl::QueryNetCache(
     ++source_counters_.cached_stale;
   }
 
-  if (cached->expiration - now >= net_cache_update_margin_) {
+  if (now < cached->update_time) {
     result.status = NetCacheResult::Status::kHitReply;
   } else {
     result.status = NetCacheResult::Status::kHitReplyWithUpdate;
@@ -364,9 +372,16 @@ void Resolver::Impl::FinishNetUpdate(
   if (addrs) *addrs = response.addrs;
   if (effective_ttl.count() > 0) {
     LOG_TRACE() << "Updating cache for '" << name << '\'';
-    net_cache_.Put(
-        name, NetCacheEntry{std::move(response.addrs),
-                            utils::datetime::MockSteadyNow() + effective_ttl});
+    // Prefetch the record before it expires so that the requests do not wait
+    // for the update
+    const auto now = utils::datetime::MockSteadyNow();
+    const auto expiration = now + effective_ttl;
+    const auto update_time = std::min(
+        now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                  effective_ttl * net_cache_prefetch_ratio_),
+        expiration - net_cache_update_margin_);
+    net_cache_.Put(name, NetCacheEntry{std::move(response.addrs), expiration,
+                                       false, update_time});
   } else {
     LOG_TRACE() << "Skipping cache update for '" << name << '\'';
   }
@@ -1,3 +1,4 @@
+#include <functional>
 #include <string_view>
 #include <vector>
 
@@ -58,7 +59,10 @@ constexpr auto kNetV6String{"2a02:6b8:a::a"};
 struct MockedResolver {
   using ServerMock = utest::DnsServerMock;
 
-  MockedResolver(size_t cache_max_ttl, size_t cache_size_per_way)
+  using ConfigModifier = std::function<void(clients::dns::ResolverConfig&)>;
+
+  MockedResolver(size_t cache_max_ttl, size_t cache_size_per_way,
+                 ConfigModifier modify_config = {})
       : hosts_file{[] {
           auto file = fs::blocking::TempFile::Create();
           fs::blocking::RewriteFileContents(file.GetPath(), kTestHosts);
@@ -88,6 +92,7 @@ struct MockedResolver {
               config.cache_ways = 1;
               config.cache_size_per_way = cache_size_per_way;
               config.network_custom_servers = {server_mock.GetServerAddress()};
+              if (modify_config) modify_config(config);
               return config;
             }()} {}
 
@@ -399,6 +404,77 @@ UTEST(Resolver, CacheStale) {
   EXPECT_EQ(counters.network_failure, 0);
 }
 
+UTEST(Resolver, CachePrefetch) {
+  const auto test_deadline =
+      engine::Deadline::FromDuration(utest::kMaxTestWaitTime);
+
+  MockedResolver resolver{1000, 1, [](clients::dns::ResolverConfig& config) {
+                            config.network_timeout = std::chrono::seconds{1};
+                            config.cache_prefetch_ratio = 0.9;
+                          }};
+
+  utils::datetime::MockNowSet({});
+
+  EXPECT_PRED_FORMAT2(CheckAddrs, resolver->Resolve("first", test_deadline),
+                      (Expected{kNetV6String, kNetV4String}));
+
+  utils::datetime::MockSleep(std::chrono::seconds{800});
+
+  EXPECT_PRED_FORMAT2(CheckAddrs, resolver->Resolve("first", test_deadline),
+                      (Expected{kNetV6String, kNetV4String}));
+
+  // the record is not expired yet, but is updated in background
+  utils::datetime::MockSleep(std::chrono::seconds{150});
+
+  EXPECT_PRED_FORMAT2(CheckAddrs, resolver->Resolve("first", test_deadline),
+                      (Expected{kNetV6String, kNetV4String}));
+
+  const auto& counters = resolver->GetLookupSourceCounters();
+  while (counters.network < 2) engine::SleepFor(std::chrono::milliseconds{1});
+
+  EXPECT_EQ(counters.file, 0);
+  EXPECT_EQ(counters.cached, 2);
+  EXPECT_EQ(counters.cached_stale, 0);
+  EXPECT_EQ(counters.cached_failure, 0);
+  EXPECT_EQ(counters.network, 2);
+  EXPECT_EQ(counters.network_failure, 0);
+}
+
+UTEST(Resolver, CacheMaxStale) {
+  const auto test_deadline =
+      engine::Deadline::FromDuration(utest::kMaxTestWaitTime);
+
+  MockedResolver resolver{1, 1, [](clients::dns::ResolverConfig& config) {
+                            config.cache_max_stale = std::chrono::seconds{10};
+                          }};
+
+  utils::datetime::MockNowSet({});
+
+  EXPECT_PRED_FORMAT2(CheckAddrs, resolver->Resolve("first", test_deadline),
+                      (Expected{kNetV6String, kNetV4String}));
+
+  utils::datetime::MockSleep(std::chrono::seconds{5});
+
+  EXPECT_PRED_FORMAT2(CheckAddrs, resolver->Resolve("first", test_deadline),
+                      (Expected{kNetV6String, kNetV4String}));
+
+  const auto& counters = resolver->GetLookupSourceCounters();
+  while (counters.network < 2) engine::SleepFor(std::chrono::milliseconds{1});
+
+  // the record is too stale to be returned
+  utils::datetime::MockSleep(std::chrono::seconds{20});
+
+  EXPECT_PRED_FORMAT2(CheckAddrs, resolver->Resolve("first", test_deadline),
+                      (Expected{kNetV6String, kNetV4String}));
+
+  EXPECT_EQ(counters.file, 0);
+  EXPECT_EQ(counters.cached, 0);
+  EXPECT_EQ(counters.cached_stale, 1);
+  EXPECT_EQ(counters.cached_failure, 0);
+  EXPECT_EQ(counters.network, 3);
+  EXPECT_EQ(counters.network_failure, 0);
+}
+
 UTEST(Resolver, CacheFailures) {
   const auto test_deadline =
       engine::Deadline::FromDuration(utest::kMaxTestWaitTime);
@@ -2,11 +2,14 @@
 
 #include <chrono>
 #include <cstdlib>
+#include <functional>
 #include <limits>
+#include <string_view>
 
 #include <moodycamel/concurrentqueue.h>
 
 #include <userver/components/headers_propagator_component.hpp>
+#include <userver/engine/wait_any.hpp>
 #include <userver/logging/log.hpp>
 #include <userver/tracing/manager.hpp>
 #include <userver/utils/async.hpp>
@@ -31,6 +34,11 @@ namespace {
 const std::string kIoThreadName = "curl";
 const auto kEasyReinitPeriod = std::chrono::minutes{1};
 
+// The hedging budget is kept in thousandths of a hedge, up to a burst of
+// kMaxHedgesBurst hedges
+constexpr std::int64_t kHedgeCost = 1000;
+constexpr std::int64_t kMaxHedgesBurst = 10;
+
 // cURL accepts options as long, but we use size_t to avoid writing checks.
 // Clamp too high values to LONG_MAX, it shouldn't matter for these magnitudes.
 long ClampToLong(size_t value) {
@@ -45,12 +53,27 @@ const tracing::TracingManagerBase* GetTracingManager(
   return &tracing::kDefaultTracingManager;
 }
 
+bool IsSuccessful(const Response& response) {
+  return static_cast<int>(response.status_code()) < 500;
+}
+
+// Returns the scheme and the authority of the URL, the connections are pooled
+// by them
+std::string_view GetDestination(std::string_view url) {
+  const auto scheme_end = url.find("://");
+  const auto authority_begin =
+      scheme_end == std::string_view::npos ? 0 : scheme_end + 3;
+  return url.substr(0, url.find_first_of("/?#", authority_begin));
+}
+
 }  // namespace
 
 Client::Client(impl::ClientSettings settings,
                engine::TaskProcessor& fs_task_processor,
                impl::PluginPipeline&& plugin_pipeline)
     : deadline_propagation_config_(settings.deadline_propagation),
+      destination_affinity_(settings.destination_affinity),
+      destination_affinity_spillover_(settings.destination_affinity_spillover),
       destination_statistics_(std::make_shared<DestinationStatistics>()),
       statistics_(settings.io_threads),
       fs_task_processor_(fs_task_processor),
@@ -59,6 +82,10 @@ Client::Client(impl::ClientSettings settings,
       tracing_manager_(GetTracingManager(settings)),
       headers_propagator_(settings.headers_propagator),
       plugin_pipeline_(std::move(plugin_pipeline)) {
+  // The budget starts full, so that hedging works from the first requests
+  // rather than after a warm-up of 1 / budget_ratio requests
+  hedging_budget_ = kMaxHedgesBurst * kHedgeCost;
+
   const auto io_threads = settings.io_threads;
   const auto& thread_name_prefix = settings.thread_name_prefix;
 
@@ -91,6 +118,14 @@ Client::Client(impl::ClientSettings settings,
       [this] { ReinitEasy(); });
 
   SetConfig({});
+
+  if (settings.http2_multiplexing) {
+    SetMultiplexingEnabled(true);
+    for (auto& multi : multis_) {
+      multi->SetMaxConcurrentStreams(
+          ClampToLong(settings.http2_max_concurrent_streams));
+    }
+  }
 }
 
 Client::~Client() {
@@ -124,6 +159,7 @@ Request Client::CreateRequest() {
       auto idx = FindMultiIndex(easy->GetMulti());
       auto wrapper =
           std::make_shared<impl::EasyWrapper>(std::move(easy), *this);
+      PrepareEasy(wrapper->Easy());
       return Request{std::move(wrapper), statistics_[idx].CreateRequestStats(),
                      destination_statistics_, resolver_, plugin_pipeline_};
     } else {
@@ -135,6 +171,7 @@ Request Client::CreateRequest() {
                          return std::make_shared<impl::EasyWrapper>(
                              easy_.Get()->GetBoundBlocking(*multi), *this);
                        }).Get();
+        PrepareEasy(wrapper->Easy());
         return Request{std::move(wrapper), statistics_[i].CreateRequestStats(),
                        destination_statistics_, resolver_, plugin_pipeline_};
       } catch (engine::WaitInterruptedException&) {
@@ -166,10 +203,98 @@ Request Client::CreateRequest() {
   }
   request.SetDeadlinePropagationConfig(deadline_propagation_config_);
 
+  if (multiplexing_enabled_) {
+    // HTTP/2 is negotiated via ALPN, HTTP/1.1 is used without TLS or h2
+    request.http_version(HttpVersion::k2Tls);
+  }
+
   return request;
 }
 
+std::shared_ptr<Response> Client::PerformHedged(
+    const HedgingSettings& settings,
+    const std::function<Request(std::size_t attempt)>& factory) {
+  auto request = factory(0);
+
+  // The delay is taken before the perform, as the perform and its retries
+  // update the destination statistics of the request
+  auto delay = settings.delay;
+  if (settings.delay_percentile) {
+    const auto percentile =
+        request.GetDestinationTimingsPercentile(*settings.delay_percentile);
+    if (percentile.count()) delay = percentile;
+  }
+
+  auto original = request.async_perform();
+  AddHedgingBudget(settings.budget_ratio);
+
+  if (engine::WaitAnyFor(delay, original) ||
+      engine::current_task::ShouldCancel() || !TryAcquireHedge()) {
+    return original.Get();
+  }
+
+  ++hedges_issued_;
+  auto hedge = factory(1).async_perform();
+
+  const auto first = engine::WaitAny(original, hedge);
+  if (!first) return original.Get();  // throws CancelException
+
+  const bool is_hedge_first = (*first == 1);
+  auto& winner = is_hedge_first ? hedge : original;
+  auto& other = is_hedge_first ? original : hedge;
+
+  std::shared_ptr<Response> response;
+  try {
+    response = winner.Get();
+  } catch (const std::exception& e) {
+    LOG_LIMITED_INFO() << "Hedged HTTP request failed: " << e;
+  }
+  if (response && IsSuccessful(*response)) {
+    if (is_hedge_first) ++hedges_won_;
+    // The other request may have completed while the winner was handled
+    const bool is_other_in_flight =
+        !engine::WaitAnyUntil(engine::Deadline::Passed(), other);
+    other.Cancel();
+    if (is_other_in_flight) ++hedges_cancelled_;
+    return response;
+  }
+
+  // The first result is returned only if the other one is not better
+  try {
+    auto other_response = other.Get();
+    if (!response || IsSuccessful(*other_response)) {
+      if (!is_hedge_first) ++hedges_won_;
+      return other_response;
+    }
+  } catch (const std::exception& e) {
+    if (!response) throw;
+    LOG_LIMITED_INFO() << "Hedged HTTP request failed: " << e;
+  }
+  if (is_hedge_first) ++hedges_won_;
+  return response;
+}
+
+void Client::AddHedgingBudget(double budget_ratio) noexcept {
+  const auto tokens = static_cast<std::int64_t>(budget_ratio * kHedgeCost);
+  auto budget = hedging_budget_.load();
+  while (budget < kMaxHedgesBurst * kHedgeCost &&
+         !hedging_budget_.compare_exchange_weak(
+             budget, std::min(budget + tokens, kMaxHedgesBurst * kHedgeCost))) {
+  }
+}
+
+bool Client::TryAcquireHedge() noexcept {
+  auto budget = hedging_budget_.load();
+  while (budget >= kHedgeCost) {
+    if (hedging_budget_.compare_exchange_weak(budget, budget - kHedgeCost)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void Client::SetMultiplexingEnabled(bool enabled) {
+  multiplexing_enabled_ = enabled;
   for (auto& multi : multis_) {
     multi->SetMultiplexingEnabled(enabled);
   }
@@ -209,6 +334,37 @@ InstanceStatistics Client::GetMultiStatistics(size_t n) const {
   return s;
 }
 
+void Client::PrepareEasy(curl::easy& easy) const {
+  // Wait for a connection to the destination to multiplex the request
+  // over it instead of opening a new one
+  if (multiplexing_enabled_) easy.set_pipewait(true);
+}
+
+std::shared_ptr<RequestStats> Client::BindToDestination(curl::easy& easy) {
+  if (!destination_affinity_ || multis_.size() < 2) return nullptr;
+
+  const auto destination = GetDestination(easy.get_original_url());
+  auto index = std::hash<std::string_view>{}(destination) % multis_.size();
+
+  // A hot destination must not overload a single IO thread
+  size_t least_loaded = 0;
+  for (size_t i = 1; i < statistics_.size(); ++i) {
+    if (statistics_[i].GetPendingRequests() <
+        statistics_[least_loaded].GetPendingRequests()) {
+      least_loaded = i;
+    }
+  }
+  if (statistics_[index].GetPendingRequests() >
+      statistics_[least_loaded].GetPendingRequests() +
+          destination_affinity_spillover_) {
+    index = least_loaded;
+  }
+
+  if (easy.GetMulti() == multis_[index].get()) return nullptr;
+  easy.SetMulti(*multis_[index]);
+  return statistics_[index].CreateRequestStats();
+}
+
 size_t Client::FindMultiIndex(const curl::multi* multi) const {
   for (size_t i = 0; i < multis_.size(); i++) {
     if (multis_[i].get() == multi) return i;
@@ -223,6 +379,9 @@ PoolStatistics Client::GetPoolStatistics() const {
   for (size_t i = 0; i < multis_.size(); i++) {
     stats.multi.push_back(GetMultiStatistics(i));
   };
+  stats.hedges_issued = hedges_issued_.load();
+  stats.hedges_won = hedges_won_.load();
+  stats.hedges_cancelled = hedges_cancelled_.load();
   return stats;
 }
 
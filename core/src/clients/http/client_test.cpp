@@ -7,6 +7,7 @@
 #include <boost/algorithm/string/trim.hpp>
 
 #include <clients/http/client_utils_test.hpp>
+#include <clients/http/statistics.hpp>
 #include <clients/http/testsuite.hpp>
 #include <engine/task/task_processor.hpp>
 #include <userver/clients/dns/resolver.hpp>
@@ -647,6 +648,109 @@ UTEST(HttpClient, StatsOnTimeout) {
   }
 }
 
+UTEST(HttpClient, DestinationAffinity) {
+  const utest::SimpleServer http_server{[](const HttpRequest&) {
+    return HttpResponse{"HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n",
+                        HttpResponse::kWriteAndContinue};
+  }};
+
+  clients::http::impl::ClientSettings settings;
+  settings.io_threads = 4;
+  clients::http::Client http_client{
+      std::move(settings), engine::current_task::GetTaskProcessor(),
+      std::vector<utils::NotNull<clients::http::Plugin*>>{}};
+
+  // The requests are created on random IO threads
+  std::vector<clients::http::Request> requests;
+  for (unsigned i = 0; i < kFewRepetitions; ++i) {
+    requests.push_back(http_client.CreateRequest()
+                           .get(http_server.GetBaseUrl())
+                           .retry(1)
+                           .http_version(clients::http::HttpVersion::k11)
+                           .timeout(kTimeout));
+  }
+
+  std::size_t open_socket_count = 0;
+  for (auto& request : requests) {
+    const auto response = request.perform();
+    EXPECT_EQ(response->status_code(), 200);
+    open_socket_count += response->GetStats().open_socket_count;
+  }
+  EXPECT_EQ(open_socket_count, 1);
+}
+
+UTEST(HttpClient, Http2MultiplexingFallback) {
+  const utest::SimpleServer http_server{EchoCallback{}};
+
+  clients::http::impl::ClientSettings settings;
+  settings.io_threads = 1;
+  settings.http2_multiplexing = true;
+  settings.http2_max_concurrent_streams = 10;
+  clients::http::Client http_client{
+      std::move(settings), engine::current_task::GetTaskProcessor(),
+      std::vector<utils::NotNull<clients::http::Plugin*>>{}};
+
+  // HTTP/2 is not negotiated without TLS, the request goes over HTTP/1.1
+  const auto response = http_client.CreateRequest()
+                            .post(http_server.GetBaseUrl(), kTestData)
+                            .retry(1)
+                            .timeout(kTimeout)
+                            .perform();
+  EXPECT_EQ(response->status_code(), 200);
+  EXPECT_EQ(response->body(), kTestData);
+}
+
+UTEST(HttpClient, Hedging) {
+  const utest::SimpleServer slow_server{&sleep_callback};
+  const utest::SimpleServer fast_server{EchoCallback{}};
+  auto http_client_ptr = utest::CreateHttpClient();
+
+  clients::http::HedgingSettings settings;
+  settings.delay = kSmallTimeout;
+  settings.budget_ratio = 1.0;
+
+  const auto response = http_client_ptr->PerformHedged(
+      settings, [&](std::size_t attempt) {
+        const auto& server = attempt == 0 ? slow_server : fast_server;
+        return http_client_ptr->CreateRequest()
+            .post(server.GetBaseUrl(), kTestData)
+            .retry(1)
+            .timeout(kTimeout);
+      });
+  EXPECT_EQ(response->body(), kTestData);
+
+  const auto stats = http_client_ptr->GetPoolStatistics();
+  EXPECT_EQ(stats.hedges_issued, 1);
+  EXPECT_EQ(stats.hedges_won, 1);
+  EXPECT_EQ(stats.hedges_cancelled, 1);
+}
+
+UTEST(HttpClient, HedgingBudget) {
+  const utest::SimpleServer http_server{[](const HttpRequest& request) {
+    return sleep_callback_base(request, kSmallTimeout * 2);
+  }};
+  auto http_client_ptr = utest::CreateHttpClient();
+
+  clients::http::HedgingSettings settings;
+  settings.delay = kSmallTimeout / 10;
+  settings.budget_ratio = 0.0;
+
+  // The initial budget allows a burst of hedges and is not refilled then
+  constexpr std::size_t kMaxHedgesBurst = 10;
+  for (std::size_t i = 0; i <= kMaxHedgesBurst; ++i) {
+    const auto response = http_client_ptr->PerformHedged(
+        settings, [&](std::size_t /*attempt*/) {
+          return http_client_ptr->CreateRequest()
+              .get(http_server.GetBaseUrl())
+              .retry(1)
+              .timeout(kTimeout);
+        });
+    EXPECT_EQ(response->status_code(), 200);
+  }
+  EXPECT_EQ(http_client_ptr->GetPoolStatistics().hedges_issued,
+            kMaxHedgesBurst);
+}
+
 UTEST(HttpClient, CancelPre) {
   auto task = utils::Async("test", [] {
     const utest::SimpleServer http_server{EchoCallback{}};
@@ -170,6 +170,24 @@ properties:
         type: boolean
         description: whether to defer events execution to a periodic timer; might affect timings a bit, might boost performance, use with care
         defaultDescription: false
+    destination-affinity:
+        type: boolean
+        description: whether to perform the requests to the same scheme and host in the same IO thread to reuse its connections
+        defaultDescription: true
+    destination-affinity-spillover:
+        type: integer
+        description: how many more pending requests than the least loaded IO thread the IO thread of a destination may have before the requests go to the least loaded one
+        defaultDescription: 16
+        minimum: 0
+    http2-multiplexing:
+        type: boolean
+        description: whether to perform the requests over HTTPS as HTTP/2 streams of the shared connections to the destination, HTTP/1.1 is used if the server does not support HTTP/2
+        defaultDescription: false
+    http2-max-concurrent-streams:
+        type: integer
+        description: max number of concurrent HTTP/2 streams over a single connection, a new connection is opened if all of them are busy
+        defaultDescription: 100
+        minimum: 1
     fs-task-processor:
         type: string
         description: task processor to run blocking HTTP related calls, like DNS resolving or hosts reading
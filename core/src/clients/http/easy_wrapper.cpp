@@ -17,6 +17,10 @@ EasyWrapper::~EasyWrapper() { client_.PushIdleEasy(std::move(easy_)); }
 
 curl::easy& EasyWrapper::Easy() { return *easy_; }
 
+std::shared_ptr<RequestStats> EasyWrapper::BindToDestination() {
+  return client_.BindToDestination(*easy_);
+}
+
 }  // namespace clients::http::impl
 
 USERVER_NAMESPACE_END
@@ -4,6 +4,8 @@
 
 #include <curl-ev/easy.hpp>
 
+#include <clients/http/statistics.hpp>
+
 USERVER_NAMESPACE_BEGIN
 
 namespace clients::http {
@@ -25,6 +27,10 @@ class EasyWrapper final {
 
   curl::easy& Easy();
 
+  // Moves the easy to the multi that serves the destination of its URL.
+  // Returns the statistics of the new multi if the multi was changed.
+  std::shared_ptr<RequestStats> BindToDestination();
+
  private:
   std::shared_ptr<curl::easy> easy_;
   Client& client_;
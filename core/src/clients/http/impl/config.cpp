@@ -46,6 +46,16 @@ ClientSettings Parse(const yaml_config::YamlConfig& value,
       value["thread-name-prefix"].As<std::string>(result.thread_name_prefix);
   result.io_threads = value["threads"].As<size_t>(result.io_threads);
   result.defer_events = value["defer-events"].As<bool>(result.defer_events);
+  result.destination_affinity =
+      value["destination-affinity"].As<bool>(result.destination_affinity);
+  result.destination_affinity_spillover =
+      value["destination-affinity-spillover"].As<size_t>(
+          result.destination_affinity_spillover);
+  result.http2_multiplexing =
+      value["http2-multiplexing"].As<bool>(result.http2_multiplexing);
+  result.http2_max_concurrent_streams =
+      value["http2-max-concurrent-streams"].As<size_t>(
+          result.http2_max_concurrent_streams);
   result.deadline_propagation = ParseDeadlinePropagationConfig(value);
   return result;
 }
@@ -633,6 +633,11 @@ void Request::SetHeadersPropagator(
   pimpl_->SetHeadersPropagator(headers_propagator);
 }
 
+std::chrono::milliseconds Request::GetDestinationTimingsPercentile(
+    double percent) const {
+  return pimpl_->GetDestinationTimingsPercentile(percent);
+}
+
 const std::string& Request::GetUrl() const& {
   return pimpl_->easy().get_original_url();
 }
@@ -314,6 +314,18 @@ void RequestState::SetDestinationMetricName(const std::string& destination) {
   dest_req_stats_ = dest_stats_->GetStatisticsForDestination(destination);
 }
 
+std::chrono::milliseconds RequestState::GetDestinationTimingsPercentile(
+    double percent) const {
+  // Is called before the perform, StartStats() takes the same statistics
+  // unless the auto destinations limit is reached
+  const auto stats = dest_req_stats_
+                         ? dest_req_stats_
+                         : dest_stats_->GetStatisticsForDestinationAuto(
+                               destination_metric_name_);
+  if (!stats) return {};
+  return stats->GetTimingsPercentile(percent);
+}
+
 void RequestState::SetTestsuiteConfig(
     const std::shared_ptr<const TestsuiteConfig>& config) {
   testsuite_config_ = config;
@@ -402,8 +414,13 @@ void RequestState::on_completed(std::shared_ptr<RequestState> holder,
 
   holder->AccountResponse(err);
   const auto sockets = easy.get_num_connects();
-  holder->WithRequestStats(
-      [sockets](RequestStats& stats) { stats.AccountOpenSockets(sockets); });
+  const bool is_http2 =
+      !err && easy.get_http_version() == curl::native::CURL_HTTP_VERSION_2_0;
+  holder->WithRequestStats([sockets, is_http2, &err](RequestStats& stats) {
+    stats.AccountOpenSockets(sockets);
+    if (!err) stats.AccountConnectionReuse(sockets == 0);
+    if (is_http2) stats.AccountHttp2Response();
+  });
 
   span.AddTag(tracing::kAttempts, holder->retry_.current);
   if (holder->effective_timeout_ != holder->original_timeout_) {
@@ -851,6 +868,7 @@ void RequestState::ResetDataForNewRequest() {
   // the original timeout is exceeded.
   SetEasyTimeout(original_timeout_);
 
+  if (auto stats = easy_->BindToDestination()) stats_ = std::move(stats);
   StartStats();
 }
 
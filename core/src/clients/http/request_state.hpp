@@ -109,6 +109,9 @@ class RequestState : public std::enable_shared_from_this<RequestState> {
 
   void SetDestinationMetricName(const std::string& destination);
 
+  std::chrono::milliseconds GetDestinationTimingsPercentile(
+      double percent) const;
+
   void SetTestsuiteConfig(const std::shared_ptr<const TestsuiteConfig>& config);
 
   void SetAllowedUrlsExtra(const std::vector<std::string>& urls);
@@ -61,6 +61,22 @@ void RequestStats::AccountOpenSockets(size_t sockets) noexcept {
   stats_.socket_open_ += sockets;
 }
 
+void RequestStats::AccountConnectionReuse(bool is_reused) noexcept {
+  if (is_reused) {
+    ++stats_.connections_reused_;
+  } else {
+    ++stats_.connections_new_;
+  }
+}
+
+void RequestStats::AccountHttp2Response() noexcept { ++stats_.http2_responses_; }
+
+std::chrono::milliseconds RequestStats::GetTimingsPercentile(
+    double percent) const {
+  return std::chrono::milliseconds{
+      stats_.timings_percentile_.GetStatsForPeriod().GetPercentile(percent)};
+}
+
 void RequestStats::AccountTimeoutUpdatedByDeadline() noexcept {
   ++stats_.timeout_updated_by_deadline_;
 }
@@ -147,6 +163,16 @@ void DumpMetric(utils::statistics::Writer& writer,
   writer["retries"] = stats.retries;
   writer["pending-requests"] = stats.easy_handles;
 
+  if (auto reuse = writer["connection-reuse"]) {
+    const auto requests = stats.connections_reused + stats.connections_new;
+    reuse["reused"] = stats.connections_reused;
+    reuse["new"] = stats.connections_new;
+    reuse["ratio"] = requests ? static_cast<double>(stats.connections_reused) /
+                                    static_cast<double>(requests)
+                              : 0.0;
+  }
+  writer["http2-responses"] = stats.http2_responses;
+
   writer["timeout-updated-by-deadline"] = stats.timeout_updated_by_deadline;
   writer["cancelled-by-deadline"] = stats.cancelled_by_deadline;
 
@@ -177,6 +203,10 @@ void DumpMetric(utils::statistics::Writer& writer,
   }
 
   writer = sum_stats;
+
+  writer["hedge-issued"] = stats.hedges_issued;
+  writer["hedge-won"] = stats.hedges_won;
+  writer["hedge-cancelled"] = stats.hedges_cancelled;
 }
 
 InstanceStatistics::InstanceStatistics(const Statistics& other)
@@ -184,6 +214,9 @@ InstanceStatistics::InstanceStatistics(const Statistics& other)
       last_time_to_start_us(other.last_time_to_start_us_.load()),
       timings_percentile(other.timings_percentile_.GetStatsForPeriod()),
       retries(other.retries_.load()),
+      connections_reused(other.connections_reused_.load()),
+      connections_new(other.connections_new_.load()),
+      http2_responses(other.http2_responses_.load()),
       timeout_updated_by_deadline(other.timeout_updated_by_deadline_.load()),
       cancelled_by_deadline(other.cancelled_by_deadline_.load()),
       reply_status(other.reply_status_) {
@@ -217,6 +250,9 @@ InstanceStatistics& InstanceStatistics::operator+=(
     error_count[i] += stat.error_count[i];
   }
   retries += stat.retries;
+  connections_reused += stat.connections_reused;
+  connections_new += stat.connections_new;
+  http2_responses += stat.http2_responses;
 
   timeout_updated_by_deadline += stat.timeout_updated_by_deadline;
   cancelled_by_deadline += stat.cancelled_by_deadline;
@@ -30,9 +30,18 @@ class RequestStats final {
 
   void AccountOpenSockets(size_t sockets) noexcept;
 
+  // Whether the response came over a connection from the pool
+  void AccountConnectionReuse(bool is_reused) noexcept;
+
+  // The response came over HTTP/2
+  void AccountHttp2Response() noexcept;
+
   void AccountTimeoutUpdatedByDeadline() noexcept;
   void AccountCancelledByDeadline() noexcept;
 
+  // Zero if there are no timings for the last minute
+  std::chrono::milliseconds GetTimingsPercentile(double percent) const;
+
  private:
   void StoreTiming() noexcept;
 
@@ -89,6 +98,11 @@ class Statistics {
 
   void AccountStatus(int);
 
+  // Requests bound to the multi of these statistics
+  std::uint64_t GetPendingRequests() const noexcept {
+    return easy_handles_.load();
+  }
+
  private:
   std::atomic<uint64_t> easy_handles_{0};
   std::atomic<uint64_t> last_time_to_start_us_{0};
@@ -99,6 +113,9 @@ class Statistics {
       {0, 0, 0, 0, 0, 0, 0}};
   std::atomic_llong retries_{0};
   std::atomic_llong socket_open_{0};
+  std::atomic<std::uint64_t> connections_reused_{0};
+  std::atomic<std::uint64_t> connections_new_{0};
+  std::atomic<std::uint64_t> http2_responses_{0};
 
   std::atomic<std::uint64_t> timeout_updated_by_deadline_{0};
   std::atomic<std::uint64_t> cancelled_by_deadline_{0};
@@ -127,6 +144,9 @@ struct InstanceStatistics {
   std::array<uint64_t, Statistics::kErrorGroupCount> error_count{
       {0, 0, 0, 0, 0, 0, 0}};
   uint64_t retries{0};
+  std::uint64_t connections_reused{0};
+  std::uint64_t connections_new{0};
+  std::uint64_t http2_responses{0};
 
   std::uint64_t timeout_updated_by_deadline{0};
   std::uint64_t cancelled_by_deadline{0};
@@ -137,6 +157,10 @@ struct InstanceStatistics {
 
 struct PoolStatistics {
   std::vector<InstanceStatistics> multi;
+
+  std::uint64_t hedges_issued{0};
+  std::uint64_t hedges_won{0};
+  std::uint64_t hedges_cancelled{0};
 };
 
 enum class FormatMode {
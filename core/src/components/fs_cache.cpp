@@ -1,12 +1,27 @@
 #include <userver/components/component_config.hpp>
 #include <userver/components/component_context.hpp>
 #include <userver/components/fs_cache.hpp>
+#include <userver/components/statistics_storage.hpp>
+#include <userver/utils/statistics/writer.hpp>
 #include <userver/yaml_config/merge_schemas.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
 namespace components {
 
+namespace {
+
+fs::FsCacheSettings ParseSettings(const components::ComponentConfig& config) {
+  fs::FsCacheSettings settings;
+  settings.mmap_min_size =
+      config["mmap-min-size"].As<std::optional<std::size_t>>();
+  settings.precompressed_variants =
+      config["precompressed-variants"].As<bool>(false);
+  return settings;
+}
+
+}  // namespace
+
 const FsCache::Client& FsCache::GetClient() const { return client_; }
 
 FsCache::FsCache(const components::ComponentConfig& config,
@@ -16,7 +31,18 @@ FsCache::FsCache(const components::ComponentConfig& config,
           config["dir"].As<std::string>("/var/www"),
           config["update-period"].As<std::chrono::milliseconds>(0),
           context.GetTaskProcessor(config["fs-task-processor"].As<std::string>(
-              "fs-task-processor"))) {}
+              "fs-task-processor")),
+          ParseSettings(config)) {
+  statistics_holder_ =
+      context.FindComponent<components::StatisticsStorage>()
+          .GetStorage()
+          .RegisterWriter(
+              "fs-cache",
+              [this](utils::statistics::Writer& writer) { writer = client_; },
+              {{"fs_cache_name", config.Name()}});
+}
+
+FsCache::~FsCache() { statistics_holder_.Unregister(); }
 
 yaml_config::Schema FsCache::GetStaticConfigSchema() {
   return yaml_config::MergeSchemas<components::LoggableComponentBase>(R"(
@@ -37,6 +63,19 @@ properties:
         type: string
         description: task processor to do filesystem operations
         defaultDescription: fs-task-processor
+    mmap-min-size:
+        type: integer
+        description: |
+            files of this size in bytes and larger are memory mapped and sent
+            with sendfile instead of being kept on heap
+        defaultDescription: <no mmap>
+        minimum: 0
+    precompressed-variants:
+        type: boolean
+        description: |
+            serve the .gz, .br and .zst sibling files as the precompressed
+            variants of a file
+        defaultDescription: false
 )");
 }
 
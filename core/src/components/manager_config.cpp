@@ -100,6 +100,25 @@ properties:
                 type: integer
                 description: size of a single coroutine, bytes
                 defaultDescription: 256 * 1024
+            small_stack_size:
+                type: integer
+                description: >
+                    stack size of the coroutines of task processors with
+                    `coro-stack-size-class: small`, bytes
+                defaultDescription: 64 * 1024
+            large_stack_size:
+                type: integer
+                description: >
+                    stack size of the coroutines of task processors with
+                    `coro-stack-size-class: large`, bytes
+                defaultDescription: 1024 * 1024
+            stack_reclaim_threshold:
+                type: integer
+                description: >
+                    if a coroutine has touched more stack than that, the rest
+                    of its stack is returned to the OS when the coroutine goes
+                    back to the pool; 0 disables
+                defaultDescription: 0
     event_thread_pool:
         type: object
         description: event thread pool options
@@ -122,6 +141,29 @@ properties:
                 description: >
                     Whether to defer timer events to a per-thread periodic timer
                     or notify ev-loop right away
+            poll_backend:
+                type: string
+                description: >
+                    libev backend the ev loops wait for IO readiness with,
+                    `io_uring` selects libev's EVBACKEND_IOURING and falls
+                    back to `default` if it is not supported. Only the
+                    readiness polling is affected, sockets still perform
+                    their IO with regular system calls
+                defaultDescription: default
+                enum:
+                  - default
+                  - io_uring
+            cpu_affinity:
+                type: string
+                description: >
+                    CPUs to pin the ev threads to, in the Linux cpulist format,
+                    e.g. `0-7,16-23`
+                defaultDescription: all CPUs
+            numa_node:
+                type: integer
+                description: >
+                    NUMA node to pin the ev threads to, the memory is
+                    preferably allocated from that node
     components:
         type: object
         description: 'dictionary of "component name": "options"'
@@ -161,8 +203,56 @@ properties:
                     type: integer
                     description: |
                         tunes the number of spin-wait iterations in case of
-                        an empty task queue before threads go to sleep
+                        an empty task queue before threads go to sleep.
+                        With `spinning-mode: adaptive` it is the upper bound
+                        of the spin-wait
                     defaultDescription: 10000
+                spinning-mode:
+                    type: string
+                    description: |
+                        `fixed` always spins `spinning-iterations` times.
+                        `adaptive` makes each worker learn from its recent
+                        idle periods and spin longer only when a task is
+                        likely to arrive soon.
+                    defaultDescription: fixed
+                    enum:
+                      - fixed
+                      - adaptive
+                task-processor-queue:
+                    type: string
+                    description: |
+                        Task queue mode for the task processor.
+                        `global-task-queue` is a single queue shared by all
+                        the worker threads.
+                        `work-stealing-task-queue` gives each worker its own
+                        run queue and lets idle workers steal tasks from the
+                        siblings, which scales better with many worker threads.
+                    defaultDescription: global-task-queue
+                    enum:
+                      - global-task-queue
+                      - work-stealing-task-queue
+                coro-stack-size-class:
+                    type: string
+                    description: |
+                        Stack size class of the task processor coroutines,
+                        see `small_stack_size`, `stack_size` and
+                        `large_stack_size` of the `coro_pool`.
+                    defaultDescription: normal
+                    enum:
+                      - small
+                      - normal
+                      - large
+                cpu-affinity:
+                    type: string
+                    description: |
+                        CPUs to pin the worker threads to, in the Linux cpulist
+                        format, e.g. `0-7,16-23`
+                    defaultDescription: all CPUs
+                numa-node:
+                    type: integer
+                    description: |
+                        NUMA node to pin the worker threads to, the memory is
+                        preferably allocated from that node
                 task-trace:
                     type: object
                     description: .
@@ -1,5 +1,10 @@
 #include <userver/components/manager_controller_component.hpp>
 
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+#include <utility>
+
 #include <components/manager_config.hpp>
 #include <components/manager_controller_component_config.hpp>
 #include <engine/task/task_processor.hpp>
@@ -16,6 +21,29 @@ USERVER_NAMESPACE_BEGIN
 
 namespace engine {
 
+namespace {
+
+constexpr std::pair<Task::Priority, std::string_view> kTaskPriorityLabels[] = {
+    {Task::Priority::kLatencyCritical, "latency-critical"},
+    {Task::Priority::kNormal, "normal"},
+    {Task::Priority::kBackground, "background"},
+};
+
+using WakeupKind = impl::TaskCounter::WakeupKind;
+
+constexpr std::pair<WakeupKind, std::string_view> kWakeupKindLabels[] = {
+    {WakeupKind::kSpin, "spin"},
+    {WakeupKind::kSleep, "sleep"},
+};
+
+// Upper bounds of impl::TaskCounter::kIdleTimeBucketBounds
+constexpr std::string_view kIdleTimeBucketLabels[] = {"10us", "100us", "1ms",
+                                                      "10ms", "+Inf"};
+static_assert(std::size(kIdleTimeBucketLabels) ==
+              impl::TaskCounter::kIdleTimeBucketsCount);
+
+}  // namespace
+
 void DumpMetric(utils::statistics::Writer& writer,
                 const engine::TaskProcessor& task_processor) {
   const auto& counter = task_processor.GetTaskCounter();
@@ -48,6 +76,35 @@ void DumpMetric(utils::statistics::Writer& writer,
     context_switch["no_overloaded"] = counter.GetTasksNoOverloadSensor().value;
   }
 
+  if (auto queue_wait = writer["queue-wait"]) {
+    for (const auto& [priority, label] : kTaskPriorityLabels) {
+      const utils::statistics::LabelView priority_label{"task_priority",
+                                                        label};
+      queue_wait["time-us"].ValueWithLabels(
+          counter.GetQueueWaitTimeUs(priority).value, priority_label);
+      queue_wait["samples"].ValueWithLabels(
+          counter.GetQueueWaitSamples(priority).value, priority_label);
+    }
+  }
+
+  if (auto worker_idle = writer["worker-idle"]) {
+    for (const auto& [kind, label] : kWakeupKindLabels) {
+      const utils::statistics::LabelView kind_label{"wakeup", label};
+      worker_idle["wakeups"].ValueWithLabels(
+          counter.GetIdleWakeups(kind).value, kind_label);
+
+      // Cumulative, as in Prometheus histograms
+      std::uint64_t idle_periods = 0;
+      for (std::size_t bucket = 0;
+           bucket < impl::TaskCounter::kIdleTimeBucketsCount; ++bucket) {
+        idle_periods += counter.GetIdleTimeBucket(kind, bucket).value;
+        worker_idle["time"].ValueWithLabels(
+            idle_periods,
+            {kind_label, {"le", kIdleTimeBucketLabels[bucket]}});
+      }
+    }
+  }
+
   writer["worker-threads"] = task_processor.GetWorkerCount();
 }
 
@@ -107,12 +164,27 @@ void ManagerControllerComponent::WriteStatistics(
 
   // coroutines
   if (auto coro_pool = writer["coro-pool"]) {
+    const auto stats =
+        components_manager_.GetTaskProcessorPools()->GetCoroPool().GetStats();
     if (auto coro_stats = coro_pool["coroutines"]) {
-      auto stats =
-          components_manager_.GetTaskProcessorPools()->GetCoroPool().GetStats();
       coro_stats["active"] = stats.active_coroutines;
       coro_stats["total"] = stats.total_coroutines;
     }
+    for (std::size_t i = 0; i < engine::coro::kStackSizeClassesCount; ++i) {
+      const auto& class_stats = stats.stack_size_classes[i];
+      const utils::statistics::LabelView label{
+          "stack_size_class",
+          engine::coro::ToString(static_cast<engine::coro::StackSizeClass>(i))};
+      auto stacks = coro_pool["stacks"];
+      stacks["stack-size"].ValueWithLabels(class_stats.stack_size, label);
+      stacks["active"].ValueWithLabels(class_stats.active_coroutines, label);
+      stacks["total"].ValueWithLabels(class_stats.total_coroutines, label);
+      stacks["max-touched-bytes"].ValueWithLabels(
+          class_stats.max_touched_stack_bytes, label);
+      stacks["released-bytes"].ValueWithLabels(
+          class_stats.released_stack_bytes, label);
+      stacks["reclaims"].ValueWithLabels(class_stats.stack_reclaims, label);
+    }
   }
 
   // misc
@@ -0,0 +1,93 @@
+#include <compression/brotli.hpp>
+
+#include <cstdint>
+
+#ifdef USERVER_FEATURE_BROTLI
+#include <brotli/encode.h>
+#endif
+
+USERVER_NAMESPACE_BEGIN
+
+namespace compression::brotli {
+
+#ifdef USERVER_FEATURE_BROTLI
+
+namespace {
+
+constexpr std::size_t kCompressBufferSize = 16 * 1024;
+// The library default of 11 is too slow for the on the fly compression
+constexpr int kDefaultQuality = 5;
+
+class BrotliCompressor final : public Compressor {
+ public:
+  explicit BrotliCompressor(int quality)
+      : state_(BrotliEncoderCreateInstance(nullptr, nullptr, nullptr)) {
+    if (!state_ || !BrotliEncoderSetParameter(
+                       state_.get(), BROTLI_PARAM_QUALITY,
+                       static_cast<std::uint32_t>(quality))) {
+      throw CompressionError("failed to initialize brotli compression");
+    }
+  }
+
+  void Compress(std::string_view input, bool flush,
+                std::string& output) override {
+    Process(input, flush ? BROTLI_OPERATION_FLUSH : BROTLI_OPERATION_PROCESS,
+            output);
+  }
+
+  void Finish(std::string& output) override {
+    Process({}, BROTLI_OPERATION_FINISH, output);
+  }
+
+ private:
+  struct StateDeleter {
+    void operator()(BrotliEncoderState* state) const noexcept {
+      BrotliEncoderDestroyInstance(state);
+    }
+  };
+
+  void Process(std::string_view input, BrotliEncoderOperation operation,
+               std::string& output) {
+    std::size_t available_in = input.size();
+    const auto* next_in = reinterpret_cast<const std::uint8_t*>(input.data());
+    do {
+      const auto old_size = output.size();
+      output.resize(old_size + kCompressBufferSize);
+      std::size_t available_out = kCompressBufferSize;
+      auto* next_out =
+          reinterpret_cast<std::uint8_t*>(output.data() + old_size);
+
+      const auto result = BrotliEncoderCompressStream(
+          state_.get(), operation, &available_in, &next_in, &available_out,
+          &next_out, nullptr);
+      output.resize(output.size() - available_out);
+      if (!result) throw CompressionError("failed to compress brotli data");
+    } while (available_in > 0 || BrotliEncoderHasMoreOutput(state_.get()) ||
+             (operation == BROTLI_OPERATION_FINISH &&
+              !BrotliEncoderIsFinished(state_.get())));
+  }
+
+  std::unique_ptr<BrotliEncoderState, StateDeleter> state_;
+};
+
+}  // namespace
+
+std::unique_ptr<Compressor> MakeCompressor(std::optional<int> level) {
+  const bool is_valid_level = level && *level >= BROTLI_MIN_QUALITY &&
+                              *level <= BROTLI_MAX_QUALITY;
+  return std::make_unique<BrotliCompressor>(is_valid_level ? *level
+                                                           : kDefaultQuality);
+}
+
+#else
+
+std::unique_ptr<Compressor> MakeCompressor(std::optional<int>) {
+  throw CompressionError(
+      "brotli is not available, build with USERVER_FEATURE_BROTLI");
+}
+
+#endif
+
+}  // namespace compression::brotli
+
+USERVER_NAMESPACE_END
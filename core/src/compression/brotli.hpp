@@ -0,0 +1,24 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+
+#include <compression/compressor.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace compression::brotli {
+
+#ifdef USERVER_FEATURE_BROTLI
+inline constexpr bool kIsAvailable = true;
+#else
+inline constexpr bool kIsAvailable = false;
+#endif
+
+/// Creates a compressor, the brotli qualities are 0..11
+/// @throws CompressionError if built without USERVER_FEATURE_BROTLI
+std::unique_ptr<Compressor> MakeCompressor(std::optional<int> level);
+
+}  // namespace compression::brotli
+
+USERVER_NAMESPACE_END
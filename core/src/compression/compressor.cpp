@@ -0,0 +1,72 @@
+#include <compression/compressor.hpp>
+
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include <compression/brotli.hpp>
+#include <compression/gzip.hpp>
+#include <compression/zstd.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace compression {
+
+std::string_view ToString(Encoding encoding) noexcept {
+  switch (encoding) {
+    case Encoding::kGzip:
+      return "gzip";
+    case Encoding::kBrotli:
+      return "br";
+    case Encoding::kZstd:
+      return "zstd";
+  }
+  return "unknown";
+}
+
+Encoding EncodingFromString(std::string_view encoding) {
+  for (const auto value :
+       {Encoding::kGzip, Encoding::kBrotli, Encoding::kZstd}) {
+    if (ToString(value) == encoding) return value;
+  }
+  throw std::runtime_error(
+      fmt::format("Unknown content-coding '{}'", encoding));
+}
+
+bool IsAvailable(Encoding encoding) noexcept {
+  switch (encoding) {
+    case Encoding::kGzip:
+      return true;
+    case Encoding::kBrotli:
+      return brotli::kIsAvailable;
+    case Encoding::kZstd:
+      return zstd::kIsAvailable;
+  }
+  return false;
+}
+
+std::unique_ptr<Compressor> MakeCompressor(Encoding encoding,
+                                           std::optional<int> level) {
+  switch (encoding) {
+    case Encoding::kGzip:
+      return gzip::MakeCompressor(level);
+    case Encoding::kBrotli:
+      return brotli::MakeCompressor(level);
+    case Encoding::kZstd:
+      return zstd::MakeCompressor(level);
+  }
+  throw CompressionError("Unknown encoding");
+}
+
+std::string Compress(Encoding encoding, std::string_view data,
+                     std::optional<int> level) {
+  std::string compressed;
+  const auto compressor = MakeCompressor(encoding, level);
+  compressor->Compress(data, false, compressed);
+  compressor->Finish(compressed);
+  return compressed;
+}
+
+}  // namespace compression
+
+USERVER_NAMESPACE_END
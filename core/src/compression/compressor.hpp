@@ -0,0 +1,59 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <compression/error.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace compression {
+
+/// Content codings of the HTTP bodies
+enum class Encoding {
+  kGzip,
+  kBrotli,
+  kZstd,
+};
+
+/// Returns the content-coding token, e.g. "br" for kBrotli
+std::string_view ToString(Encoding encoding) noexcept;
+
+/// @throws std::runtime_error for an unknown content-coding
+Encoding EncodingFromString(std::string_view encoding);
+
+/// Whether the encoding is built in, brotli and zstd are optional
+bool IsAvailable(Encoding encoding) noexcept;
+
+/// Streaming compressor of a single body
+class Compressor {
+ public:
+  virtual ~Compressor() = default;
+
+  /// Appends the compressed input to the output. With `flush` the output
+  /// is enough to decompress all the input passed so far.
+  /// @throws CompressionError
+  virtual void Compress(std::string_view input, bool flush,
+                        std::string& output) = 0;
+
+  /// Appends the end of the compressed stream to the output
+  /// @throws CompressionError
+  virtual void Finish(std::string& output) = 0;
+};
+
+/// Creates a compressor, the encoding default level is used if none is set
+/// or if the level is out of the encoding range.
+/// @throws CompressionError if the encoding is not available
+std::unique_ptr<Compressor> MakeCompressor(Encoding encoding,
+                                           std::optional<int> level);
+
+/// Compresses the whole data at once
+/// @throws CompressionError
+std::string Compress(Encoding encoding, std::string_view data,
+                     std::optional<int> level);
+
+}  // namespace compression
+
+USERVER_NAMESPACE_END
@@ -1,5 +1,9 @@
 #include <compression/gzip.hpp>
 
+#include <limits>
+
+#include <zlib.h>
+
 #include <boost/iostreams/filter/gzip.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
 
@@ -9,7 +13,59 @@ namespace compression::gzip {
 
 namespace {
 constexpr auto kDecompressBufferSize = 1024;
-}
+constexpr std::size_t kCompressBufferSize = 16 * 1024;
+constexpr int kDefaultLevel = 6;
+
+class GzipCompressor final : public Compressor {
+ public:
+  explicit GzipCompressor(int level) {
+    // 15 bits window, +16 for the gzip header and trailer
+    if (deflateInit2(&stream_, level, Z_DEFLATED, 15 + 16, 8,
+                     Z_DEFAULT_STRATEGY) != Z_OK) {
+      throw CompressionError("failed to initialize gzip compression");
+    }
+  }
+
+  ~GzipCompressor() override { deflateEnd(&stream_); }
+
+  void Compress(std::string_view input, bool flush,
+                std::string& output) override {
+    // avail_in is 32 bit wide
+    constexpr std::size_t kMaxInput = std::numeric_limits<uInt>::max();
+    do {
+      const auto part = input.substr(0, kMaxInput);
+      input.remove_prefix(part.size());
+      const bool is_last = input.empty();
+      Deflate(part, is_last && flush ? Z_SYNC_FLUSH : Z_NO_FLUSH, output);
+    } while (!input.empty());
+  }
+
+  void Finish(std::string& output) override { Deflate({}, Z_FINISH, output); }
+
+ private:
+  void Deflate(std::string_view input, int flush, std::string& output) {
+    // zlib does not modify the input
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    stream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream_.avail_in = static_cast<uInt>(input.size());
+    do {
+      const auto old_size = output.size();
+      output.resize(old_size + kCompressBufferSize);
+      stream_.next_out = reinterpret_cast<Bytef*>(output.data() + old_size);
+      stream_.avail_out = kCompressBufferSize;
+
+      const auto result = deflate(&stream_, flush);
+      output.resize(output.size() - stream_.avail_out);
+      if (result == Z_STREAM_ERROR) {
+        throw CompressionError("failed to compress gzip data");
+      }
+    } while (stream_.avail_out == 0);
+  }
+
+  z_stream stream_{};
+};
+
+}  // namespace
 
 std::string Decompress(std::string_view compressed, size_t max_size) {
   std::string decompressed;
@@ -38,6 +94,12 @@ std::string Decompress(std::string_view compressed, size_t max_size) {
   return decompressed;
 }
 
+std::unique_ptr<Compressor> MakeCompressor(std::optional<int> level) {
+  const bool is_valid_level = level && *level >= 1 && *level <= 9;
+  return std::make_unique<GzipCompressor>(is_valid_level ? *level
+                                                         : kDefaultLevel);
+}
+
 }  // namespace compression::gzip
 
 USERVER_NAMESPACE_END
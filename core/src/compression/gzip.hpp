@@ -1,7 +1,10 @@
 #pragma once
 
+#include <memory>
+#include <optional>
 #include <string_view>
 
+#include <compression/compressor.hpp>
 #include <compression/error.hpp>
 
 USERVER_NAMESPACE_BEGIN
@@ -12,6 +15,9 @@ namespace compression::gzip {
 /// @throws DecompressionError
 std::string Decompress(std::string_view compressed, size_t max_size);
 
+/// Creates a compressor, the zlib levels are 1..9
+std::unique_ptr<Compressor> MakeCompressor(std::optional<int> level);
+
 }  // namespace compression::gzip
 
 USERVER_NAMESPACE_END
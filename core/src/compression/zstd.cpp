@@ -0,0 +1,90 @@
+#include <compression/zstd.hpp>
+
+#ifdef USERVER_FEATURE_ZSTD
+#include <zstd.h>
+#endif
+
+USERVER_NAMESPACE_BEGIN
+
+namespace compression::zstd {
+
+#ifdef USERVER_FEATURE_ZSTD
+
+namespace {
+
+constexpr std::size_t kCompressBufferSize = 16 * 1024;
+constexpr int kDefaultLevel = 3;
+
+class ZstdCompressor final : public Compressor {
+ public:
+  explicit ZstdCompressor(int level) : context_(ZSTD_createCCtx()) {
+    if (!context_ ||
+        ZSTD_isError(ZSTD_CCtx_setParameter(
+            context_.get(), ZSTD_c_compressionLevel, level))) {
+      throw CompressionError("failed to initialize zstd compression");
+    }
+  }
+
+  void Compress(std::string_view input, bool flush,
+                std::string& output) override {
+    Process(input, flush ? ZSTD_e_flush : ZSTD_e_continue, output);
+  }
+
+  void Finish(std::string& output) override {
+    Process({}, ZSTD_e_end, output);
+  }
+
+ private:
+  struct ContextDeleter {
+    void operator()(ZSTD_CCtx* context) const noexcept {
+      ZSTD_freeCCtx(context);
+    }
+  };
+
+  void Process(std::string_view input, ZSTD_EndDirective mode,
+               std::string& output) {
+    ZSTD_inBuffer in{input.data(), input.size(), 0};
+    for (;;) {
+      const auto old_size = output.size();
+      output.resize(old_size + kCompressBufferSize);
+      ZSTD_outBuffer out{output.data() + old_size, kCompressBufferSize, 0};
+
+      const auto remaining =
+          ZSTD_compressStream2(context_.get(), &out, &in, mode);
+      output.resize(old_size + out.pos);
+      if (ZSTD_isError(remaining)) {
+        throw CompressionError(std::string{"failed to compress zstd data: "} +
+                               ZSTD_getErrorName(remaining));
+      }
+
+      // the flush and the end are done when nothing is left in the context
+      const bool is_done =
+          mode == ZSTD_e_continue ? in.pos == in.size : remaining == 0;
+      if (is_done) break;
+    }
+  }
+
+  std::unique_ptr<ZSTD_CCtx, ContextDeleter> context_;
+};
+
+}  // namespace
+
+std::unique_ptr<Compressor> MakeCompressor(std::optional<int> level) {
+  const bool is_valid_level =
+      level && *level >= 1 && *level <= ZSTD_maxCLevel();
+  return std::make_unique<ZstdCompressor>(is_valid_level ? *level
+                                                         : kDefaultLevel);
+}
+
+#else
+
+std::unique_ptr<Compressor> MakeCompressor(std::optional<int>) {
+  throw CompressionError(
+      "zstd is not available, build with USERVER_FEATURE_ZSTD");
+}
+
+#endif
+
+}  // namespace compression::zstd
+
+USERVER_NAMESPACE_END
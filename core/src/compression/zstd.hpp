@@ -0,0 +1,24 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+
+#include <compression/compressor.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace compression::zstd {
+
+#ifdef USERVER_FEATURE_ZSTD
+inline constexpr bool kIsAvailable = true;
+#else
+inline constexpr bool kIsAvailable = false;
+#endif
+
+/// Creates a compressor, the zstd levels are 1..22
+/// @throws CompressionError if built without USERVER_FEATURE_ZSTD
+std::unique_ptr<Compressor> MakeCompressor(std::optional<int> level);
+
+}  // namespace compression::zstd
+
+USERVER_NAMESPACE_END
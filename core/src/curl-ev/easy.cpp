@@ -146,6 +146,11 @@ easy* easy::from_native(native::CURL* native_easy) {
   return easy_handle;
 }
 
+void easy::SetMulti(multi& multi_handle) {
+  UASSERT_MSG(!multi_registered_, "easy is performing in another multi");
+  multi_ = &multi_handle;
+}
+
 engine::ev::ThreadControl& easy::GetThreadControl() {
   return multi_->GetThreadControl();
 }
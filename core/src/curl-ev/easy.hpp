@@ -170,6 +170,10 @@ class easy final : public std::enable_shared_from_this<easy> {
 
   const multi* GetMulti() const { return multi_; }
 
+  // Moves a not performing easy to another multi, the connections and the
+  // DNS cache of the new multi are used by the next perform.
+  void SetMulti(multi& multi_handle);
+
   inline native::CURL* native_handle() { return handle_; }
   engine::ev::ThreadControl& GetThreadControl();
 
@@ -462,6 +466,7 @@ class easy final : public std::enable_shared_from_this<easy> {
   };
   IMPLEMENT_CURL_OPTION_ENUM(set_http_version, native::CURLOPT_HTTP_VERSION,
                              http_version_t, long);
+  IMPLEMENT_CURL_OPTION_BOOLEAN(set_pipewait, native::CURLOPT_PIPEWAIT);
   IMPLEMENT_CURL_OPTION_BOOLEAN(set_ignore_content_length,
                                 native::CURLOPT_IGNORE_CONTENT_LENGTH);
   IMPLEMENT_CURL_OPTION_BOOLEAN(set_http_content_decoding,
@@ -56,6 +56,7 @@ class multi final {
 
   void SetMultiplexingEnabled(bool);
   void SetMaxHostConnections(long);
+  void SetMaxConcurrentStreams(long);
   void SetConnectionCacheSize(long);
 
  private:
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <algorithm>  // for std::max
+#include <array>
 #include <atomic>
 #include <cerrno>
+#include <optional>
 #include <utility>
 
 #include <moodycamel/concurrentqueue.h>
@@ -14,6 +16,7 @@
 
 #include "pool_config.hpp"
 #include "pool_stats.hpp"
+#include "stack_allocator.hpp"
 
 USERVER_NAMESPACE_BEGIN
 
@@ -30,67 +33,111 @@ class Pool final {
   Pool(PoolConfig config, Executor executor);
   ~Pool();
 
-  CoroutinePtr GetCoroutine();
+  CoroutinePtr GetCoroutine(
+      StackSizeClass stack_size_class = StackSizeClass::kNormal);
   void PutCoroutine(CoroutinePtr&& coroutine_ptr);
   PoolStats GetStats() const;
-  std::size_t GetStackSize() const;
+  std::size_t GetStackSize(
+      StackSizeClass stack_size_class = StackSizeClass::kNormal) const;
 
  private:
-  Coroutine CreateCoroutine(bool quiet = false);
-  void OnCoroutineDestruction() noexcept;
+  struct PooledCoroutine final {
+    Coroutine coroutine;
+    Stack stack;
+  };
+
+  // Coroutines with stacks of a single StackSizeClass
+  struct StackClassPool final {
+    StackClassPool(std::size_t stack_size, std::size_t queue_capacity);
+
+    const std::size_t stack_size;
+    moodycamel::ConcurrentQueue<PooledCoroutine> coroutines;
+    std::atomic<std::size_t> idle_coroutines_num{0};
+    std::atomic<std::size_t> total_coroutines_num{0};
+    std::atomic<std::size_t> max_touched_stack_bytes{0};
+    std::atomic<std::size_t> released_stack_bytes{0};
+    std::atomic<std::size_t> stack_reclaims{0};
+  };
+
+  PooledCoroutine CreateCoroutine(StackClassPool& class_pool,
+                                  bool quiet = false);
+  void OnCoroutineDestruction(StackSizeClass stack_size_class) noexcept;
+  void ReclaimStack(StackClassPool& class_pool, Stack& stack) noexcept;
+
+  StackClassPool& GetStackClassPool(StackSizeClass stack_size_class) noexcept;
 
   template <typename Token>
-  Token& GetToken();
+  Token& GetToken(StackSizeClass stack_size_class);
 
   const PoolConfig config_;
   const Executor executor_;
 
-  boost::coroutines2::protected_fixedsize_stack stack_allocator_;
-  moodycamel::ConcurrentQueue<Coroutine> coroutines_;
-  std::atomic<std::size_t> idle_coroutines_num_;
-  std::atomic<std::size_t> total_coroutines_num_;
+  std::array<StackClassPool, kStackSizeClassesCount> stack_class_pools_;
 };
 
 template <typename Task>
 class Pool<Task>::CoroutinePtr final {
  public:
-  CoroutinePtr(Coroutine&& coro, Pool<Task>& pool) noexcept
-      : coro_(std::move(coro)), pool_(&pool) {}
+  CoroutinePtr(PooledCoroutine&& coro, StackSizeClass stack_size_class,
+               Pool<Task>& pool) noexcept
+      : coro_(std::move(coro)),
+        stack_size_class_(stack_size_class),
+        pool_(&pool) {}
 
   CoroutinePtr(CoroutinePtr&&) noexcept = default;
   CoroutinePtr& operator=(CoroutinePtr&&) noexcept = default;
 
   ~CoroutinePtr() {
     UASSERT(pool_);
-    if (coro_) pool_->OnCoroutineDestruction();
+    if (coro_.coroutine) pool_->OnCoroutineDestruction(stack_size_class_);
   }
 
   Coroutine& Get() noexcept {
-    UASSERT(coro_);
-    return coro_;
+    UASSERT(coro_.coroutine);
+    return coro_.coroutine;
   }
 
   void ReturnToPool() && {
-    UASSERT(coro_);
+    UASSERT(coro_.coroutine);
     pool_->PutCoroutine(std::move(*this));
   }
 
  private:
-  Coroutine coro_;
+  friend class Pool<Task>;
+
+  PooledCoroutine coro_;
+  StackSizeClass stack_size_class_;
   Pool<Task>* pool_;
 };
 
+template <typename Task>
+Pool<Task>::StackClassPool::StackClassPool(std::size_t stack_size,
+                                           std::size_t queue_capacity)
+    : stack_size(stack_size), coroutines(queue_capacity) {}
+
 template <typename Task>
 Pool<Task>::Pool(PoolConfig config, Executor executor)
     : config_(std::move(config)),
       executor_(executor),
-      stack_allocator_(config.stack_size),
-      coroutines_(config_.max_size),
-      idle_coroutines_num_(config_.initial_size),
-      total_coroutines_num_(0) {
-  moodycamel::ProducerToken token(coroutines_);
+      // Only the normal stacks are preallocated, the other classes are
+      // populated on demand
+      stack_class_pools_{
+          StackClassPool{config_.small_stack_size,
+                         moodycamel::ConcurrentQueueDefaultTraits::BLOCK_SIZE},
+          StackClassPool{config_.stack_size, config_.max_size},
+          StackClassPool{config_.large_stack_size,
+                         moodycamel::ConcurrentQueueDefaultTraits::BLOCK_SIZE},
+      } {
+  static_assert(static_cast<std::size_t>(StackSizeClass::kSmall) == 0);
+  static_assert(static_cast<std::size_t>(StackSizeClass::kNormal) == 1);
+  static_assert(static_cast<std::size_t>(StackSizeClass::kLarge) == 2);
+
+  auto& class_pool = GetStackClassPool(StackSizeClass::kNormal);
+  class_pool.idle_coroutines_num = config_.initial_size;
+  moodycamel::ProducerToken token(class_pool.coroutines);
   for (std::size_t i = 0; i < config_.initial_size; ++i) {
-    bool ok = coroutines_.enqueue(token, CreateCoroutine(/*quiet =*/true));
+    bool ok = class_pool.coroutines.enqueue(
+        token, CreateCoroutine(class_pool, /*quiet =*/true));
     UINVARIANT(ok, "Failed to allocate the initial coro pool");
   }
 }
@@ -99,55 +146,82 @@ template <typename Task>
 Pool<Task>::~Pool() = default;
 
 template <typename Task>
-typename Pool<Task>::CoroutinePtr Pool<Task>::GetCoroutine() {
+typename Pool<Task>::CoroutinePtr Pool<Task>::GetCoroutine(
+    StackSizeClass stack_size_class) {
   struct CoroutineMover {
-    std::optional<Coroutine>& result;
+    std::optional<PooledCoroutine>& result;
 
-    CoroutineMover& operator=(Coroutine&& coro) {
+    CoroutineMover& operator=(PooledCoroutine&& coro) {
       result.emplace(std::move(coro));
       return *this;
     }
   };
 
-  std::optional<Coroutine> coroutine;
+  auto& class_pool = GetStackClassPool(stack_size_class);
+  std::optional<PooledCoroutine> coroutine;
   CoroutineMover mover{coroutine};
-  auto& token = GetToken<moodycamel::ConsumerToken>();
-  if (coroutines_.try_dequeue(token, mover)) {
-    --idle_coroutines_num_;
+  auto& token = GetToken<moodycamel::ConsumerToken>(stack_size_class);
+  if (class_pool.coroutines.try_dequeue(token, mover)) {
+    --class_pool.idle_coroutines_num;
   } else {
-    coroutine.emplace(CreateCoroutine());
+    coroutine.emplace(CreateCoroutine(class_pool));
   }
-  return CoroutinePtr(std::move(*coroutine), *this);
+  return CoroutinePtr(std::move(*coroutine), stack_size_class, *this);
 }
 
 template <typename Task>
 void Pool<Task>::PutCoroutine(CoroutinePtr&& coroutine_ptr) {
-  if (idle_coroutines_num_.load() >= config_.max_size) return;
-  auto& token = GetToken<moodycamel::ProducerToken>();
-  const bool ok = coroutines_.enqueue(token, std::move(coroutine_ptr.Get()));
-  if (ok) ++idle_coroutines_num_;
+  const auto stack_size_class = coroutine_ptr.stack_size_class_;
+  auto& class_pool = GetStackClassPool(stack_size_class);
+  if (class_pool.idle_coroutines_num.load() >= config_.max_size) return;
+
+  ReclaimStack(class_pool, coroutine_ptr.coro_.stack);
+
+  auto& token = GetToken<moodycamel::ProducerToken>(stack_size_class);
+  const bool ok =
+      class_pool.coroutines.enqueue(token, std::move(coroutine_ptr.coro_));
+  if (ok) ++class_pool.idle_coroutines_num;
 }
 
 template <typename Task>
 PoolStats Pool<Task>::GetStats() const {
   PoolStats stats;
-  stats.active_coroutines =
-      total_coroutines_num_.load() - coroutines_.size_approx();
-  stats.total_coroutines =
-      std::max(total_coroutines_num_.load(), stats.active_coroutines);
+  for (std::size_t i = 0; i < kStackSizeClassesCount; ++i) {
+    const auto& class_pool = stack_class_pools_[i];
+    auto& class_stats = stats.stack_size_classes[i];
+    class_stats.stack_size = class_pool.stack_size;
+    class_stats.active_coroutines = class_pool.total_coroutines_num.load() -
+                                    class_pool.coroutines.size_approx();
+    class_stats.total_coroutines =
+        std::max(class_pool.total_coroutines_num.load(),
+                 class_stats.active_coroutines);
+    class_stats.max_touched_stack_bytes =
+        class_pool.max_touched_stack_bytes.load();
+    class_stats.released_stack_bytes = class_pool.released_stack_bytes.load();
+    class_stats.stack_reclaims = class_pool.stack_reclaims.load();
+
+    stats.active_coroutines += class_stats.active_coroutines;
+    stats.total_coroutines += class_stats.total_coroutines;
+  }
   return stats;
 }
 
 template <typename Task>
-typename Pool<Task>::Coroutine Pool<Task>::CreateCoroutine(bool quiet) {
+typename Pool<Task>::PooledCoroutine Pool<Task>::CreateCoroutine(
+    StackClassPool& class_pool, bool quiet) {
   try {
-    Coroutine coroutine(stack_allocator_, executor_);
-    const auto new_total = ++total_coroutines_num_;
+    Stack stack;
+    Coroutine coroutine(
+        StackAllocator{class_pool.stack_size, config_.stack_reclaim_threshold,
+                       stack},
+        executor_);
+    const auto new_total = ++class_pool.total_coroutines_num;
     if (!quiet) {
       LOG_DEBUG() << "Created a coroutine #" << new_total << '/'
-                  << config_.max_size;
+                  << config_.max_size << " with stack size "
+                  << class_pool.stack_size;
     }
-    return coroutine;
+    return {std::move(coroutine), stack};
   } catch (const std::bad_alloc&) {
     if (errno == ENOMEM) {
       // It should be ok to allocate here (which LOG_ERROR might do),
@@ -157,7 +231,7 @@ typename Pool<Task>::Coroutine Pool<Task>::CreateCoroutine(bool quiet) {
       // boost/context/posix/protected_fixedsize_stack.hpp
       LOG_ERROR() << "Failed to allocate a coroutine (ENOMEM), current "
                      "coroutines count: "
-                  << total_coroutines_num_.load()
+                  << GetStats().total_coroutines
                   << "; are you hitting the vm.max_map_count limit?";
     }
 
@@ -166,20 +240,47 @@ typename Pool<Task>::Coroutine Pool<Task>::CreateCoroutine(bool quiet) {
 }
 
 template <typename Task>
-void Pool<Task>::OnCoroutineDestruction() noexcept {
-  --total_coroutines_num_;
+void Pool<Task>::OnCoroutineDestruction(
+    StackSizeClass stack_size_class) noexcept {
+  --GetStackClassPool(stack_size_class).total_coroutines_num;
+}
+
+template <typename Task>
+void Pool<Task>::ReclaimStack(StackClassPool& class_pool,
+                              Stack& stack) noexcept {
+  const auto result = stack.ReclaimIfDeep();
+  if (!result) return;
+
+  ++class_pool.stack_reclaims;
+  class_pool.released_stack_bytes += result->released_bytes;
+
+  auto max_touched = class_pool.max_touched_stack_bytes.load();
+  while (max_touched < result->touched_bytes &&
+         !class_pool.max_touched_stack_bytes.compare_exchange_weak(
+             max_touched, result->touched_bytes)) {
+  }
+}
+
+template <typename Task>
+std::size_t Pool<Task>::GetStackSize(StackSizeClass stack_size_class) const {
+  return config_.GetStackSize(stack_size_class);
 }
 
 template <typename Task>
-std::size_t Pool<Task>::GetStackSize() const {
-  return config_.stack_size;
+typename Pool<Task>::StackClassPool& Pool<Task>::GetStackClassPool(
+    StackSizeClass stack_size_class) noexcept {
+  const auto index = static_cast<std::size_t>(stack_size_class);
+  UASSERT(index < kStackSizeClassesCount);
+  return stack_class_pools_[index];
 }
 
 template <typename Task>
 template <typename Token>
-Token& Pool<Task>::GetToken() {
-  thread_local Token token(coroutines_);
-  return token;
+Token& Pool<Task>::GetToken(StackSizeClass stack_size_class) {
+  thread_local std::array<std::optional<Token>, kStackSizeClassesCount> tokens;
+  auto& token = tokens[static_cast<std::size_t>(stack_size_class)];
+  if (!token) token.emplace(GetStackClassPool(stack_size_class).coroutines);
+  return *token;
 }
 
 }  // namespace engine::coro
@@ -1,15 +1,58 @@
 #include "pool_config.hpp"
 
+#include <userver/utils/assert.hpp>
+#include <userver/utils/trivial_map.hpp>
+
 USERVER_NAMESPACE_BEGIN
 
 namespace engine::coro {
 
+namespace {
+
+constexpr utils::TrivialBiMap kStackSizeClassMap([](auto selector) {
+  return selector()
+      .Case(StackSizeClass::kSmall, "small")
+      .Case(StackSizeClass::kNormal, "normal")
+      .Case(StackSizeClass::kLarge, "large");
+});
+
+}  // namespace
+
+StackSizeClass Parse(const yaml_config::YamlConfig& value,
+                     formats::parse::To<StackSizeClass>) {
+  return utils::ParseFromValueString(value, kStackSizeClassMap);
+}
+
+std::string_view ToString(StackSizeClass stack_size_class) {
+  const auto result = kStackSizeClassMap.TryFind(stack_size_class);
+  UASSERT(result);
+  return result.value_or("unknown");
+}
+
+size_t PoolConfig::GetStackSize(StackSizeClass stack_size_class) const {
+  switch (stack_size_class) {
+    case StackSizeClass::kSmall:
+      return small_stack_size;
+    case StackSizeClass::kNormal:
+      return stack_size;
+    case StackSizeClass::kLarge:
+      return large_stack_size;
+  }
+  UINVARIANT(false, "Unexpected StackSizeClass");
+}
+
 PoolConfig Parse(const yaml_config::YamlConfig& value,
                  formats::parse::To<PoolConfig>) {
   PoolConfig config;
   config.initial_size = value["initial_size"].As<size_t>();
   config.max_size = value["max_size"].As<size_t>();
   config.stack_size = value["stack_size"].As<size_t>(config.stack_size);
+  config.small_stack_size =
+      value["small_stack_size"].As<size_t>(config.small_stack_size);
+  config.large_stack_size =
+      value["large_stack_size"].As<size_t>(config.large_stack_size);
+  config.stack_reclaim_threshold = value["stack_reclaim_threshold"].As<size_t>(
+      config.stack_reclaim_threshold);
   return config;
 }
 
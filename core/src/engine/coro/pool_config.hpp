@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
+#include <string_view>
 
 #include <userver/formats/yaml.hpp>
 #include <userver/yaml_config/yaml_config.hpp>
@@ -9,10 +11,31 @@ USERVER_NAMESPACE_BEGIN
 
 namespace engine::coro {
 
+/// Coroutine stacks of each class are allocated and pooled separately
+enum class StackSizeClass {
+  kSmall,
+  kNormal,
+  kLarge,
+};
+
+inline constexpr std::size_t kStackSizeClassesCount = 3;
+
+StackSizeClass Parse(const yaml_config::YamlConfig& value,
+                     formats::parse::To<StackSizeClass>);
+
+std::string_view ToString(StackSizeClass stack_size_class);
+
 struct PoolConfig {
   size_t initial_size = 1000;
   size_t max_size = 10000;
   size_t stack_size = 256 * 1024ULL;
+  size_t small_stack_size = 64 * 1024ULL;
+  size_t large_stack_size = 1024 * 1024ULL;
+  // If a coroutine has used more stack than that, the rest of its stack is
+  // returned to the OS when the coroutine goes back to the pool. 0 disables.
+  size_t stack_reclaim_threshold = 0;
+
+  size_t GetStackSize(StackSizeClass stack_size_class) const;
 };
 
 PoolConfig Parse(const yaml_config::YamlConfig& value,
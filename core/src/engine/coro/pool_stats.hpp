@@ -1,20 +1,50 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <utility>
 
+#include "pool_config.hpp"
+
 USERVER_NAMESPACE_BEGIN
 
 namespace engine::coro {
 
+struct StackSizeClassStats {
+  size_t stack_size = 0;
+  size_t active_coroutines = 0;
+  size_t total_coroutines = 0;
+  // The deepest stack usage observed when reclaiming the stacks
+  size_t max_touched_stack_bytes = 0;
+  size_t released_stack_bytes = 0;
+  size_t stack_reclaims = 0;
+};
+
 struct PoolStats {
   size_t active_coroutines = 0;
   size_t total_coroutines = 0;
+  std::array<StackSizeClassStats, kStackSizeClassesCount> stack_size_classes{};
 };
 
+inline StackSizeClassStats& operator+=(StackSizeClassStats& lhs,
+                                       const StackSizeClassStats& rhs) {
+  lhs.stack_size = std::max(lhs.stack_size, rhs.stack_size);
+  lhs.active_coroutines += rhs.active_coroutines;
+  lhs.total_coroutines += rhs.total_coroutines;
+  lhs.max_touched_stack_bytes =
+      std::max(lhs.max_touched_stack_bytes, rhs.max_touched_stack_bytes);
+  lhs.released_stack_bytes += rhs.released_stack_bytes;
+  lhs.stack_reclaims += rhs.stack_reclaims;
+  return lhs;
+}
+
 inline PoolStats& operator+=(PoolStats& lhs, const PoolStats& rhs) {
   lhs.active_coroutines += rhs.active_coroutines;
   lhs.total_coroutines += rhs.total_coroutines;
+  for (std::size_t i = 0; i < kStackSizeClassesCount; ++i) {
+    lhs.stack_size_classes[i] += rhs.stack_size_classes[i];
+  }
   return lhs;
 }
 
@@ -0,0 +1,143 @@
+#include <engine/coro/pool.hpp>
+
+#include <cstddef>
+#include <thread>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+struct StackTouchingTask final {
+  std::size_t stack_usage{0};
+};
+
+using Pool = engine::coro::Pool<StackTouchingTask>;
+using engine::coro::StackSizeClass;
+
+constexpr std::size_t kFrameSize = 1024;
+
+[[gnu::noinline]] void TouchStack(std::size_t bytes) {
+  volatile char buffer[kFrameSize];
+  buffer[0] = 1;
+  if (bytes > kFrameSize) TouchStack(bytes - kFrameSize);
+  // Prevents the tail call
+  buffer[kFrameSize - 1] = buffer[0];
+}
+
+void RunTasks(Pool::TaskPipe& task_pipe) {
+  for (auto* task : task_pipe) TouchStack(task->stack_usage);
+}
+
+engine::coro::PoolConfig MakeConfig() {
+  engine::coro::PoolConfig config;
+  config.initial_size = 1;
+  config.max_size = 10;
+  config.small_stack_size = 64 * 1024;
+  config.stack_size = 256 * 1024;
+  config.large_stack_size = 1024 * 1024;
+  return config;
+}
+
+void RunTask(Pool& pool, StackSizeClass stack_size_class,
+             std::size_t stack_usage) {
+  StackTouchingTask task{stack_usage};
+  auto coroutine = pool.GetCoroutine(stack_size_class);
+  coroutine.Get()(&task);
+  std::move(coroutine).ReturnToPool();
+}
+
+const engine::coro::StackSizeClassStats& GetClassStats(
+    const engine::coro::PoolStats& stats, StackSizeClass stack_size_class) {
+  return stats.stack_size_classes[static_cast<std::size_t>(stack_size_class)];
+}
+
+// Pool caches the queue tokens in thread_local variables, so each pool must
+// be used from its own threads
+template <typename Func>
+void RunInNewThread(Func func) {
+  std::thread(std::move(func)).join();
+}
+
+}  // namespace
+
+TEST(CoroPool, StackSizeClasses) {
+  RunInNewThread([] {
+    Pool pool(MakeConfig(), &RunTasks);
+    EXPECT_EQ(pool.GetStackSize(StackSizeClass::kSmall), 64 * 1024);
+    EXPECT_EQ(pool.GetStackSize(StackSizeClass::kNormal), 256 * 1024);
+    EXPECT_EQ(pool.GetStackSize(StackSizeClass::kLarge), 1024 * 1024);
+
+    auto stats = pool.GetStats();
+    EXPECT_EQ(stats.total_coroutines, 1);
+    EXPECT_EQ(GetClassStats(stats, StackSizeClass::kSmall).total_coroutines,
+              0);
+    EXPECT_EQ(GetClassStats(stats, StackSizeClass::kNormal).total_coroutines,
+              1);
+
+    {
+      auto small = pool.GetCoroutine(StackSizeClass::kSmall);
+      auto large = pool.GetCoroutine(StackSizeClass::kLarge);
+      stats = pool.GetStats();
+      EXPECT_EQ(stats.active_coroutines, 2);
+      EXPECT_EQ(stats.total_coroutines, 3);
+      EXPECT_EQ(GetClassStats(stats, StackSizeClass::kSmall).active_coroutines,
+                1);
+      EXPECT_EQ(GetClassStats(stats, StackSizeClass::kLarge).active_coroutines,
+                1);
+      EXPECT_EQ(GetClassStats(stats, StackSizeClass::kLarge).stack_size,
+                1024 * 1024);
+    }
+
+    // Deep recursion fits into the large stack only
+    RunTask(pool, StackSizeClass::kLarge, 512 * 1024);
+    stats = pool.GetStats();
+    EXPECT_EQ(stats.active_coroutines, 0);
+    EXPECT_EQ(GetClassStats(stats, StackSizeClass::kLarge).total_coroutines,
+              1);
+  });
+}
+
+TEST(CoroPool, ReclaimsDeepStacks) {
+  RunInNewThread([] {
+    auto config = MakeConfig();
+    config.stack_reclaim_threshold = 32 * 1024;
+    Pool pool(config, &RunTasks);
+
+    RunTask(pool, StackSizeClass::kNormal, 4 * 1024);
+    auto stats = GetClassStats(pool.GetStats(), StackSizeClass::kNormal);
+    EXPECT_EQ(stats.stack_reclaims, 0);
+
+    RunTask(pool, StackSizeClass::kNormal, 128 * 1024);
+    stats = GetClassStats(pool.GetStats(), StackSizeClass::kNormal);
+    EXPECT_EQ(stats.stack_reclaims, 1);
+    EXPECT_GE(stats.max_touched_stack_bytes, 128 * 1024);
+    EXPECT_LE(stats.max_touched_stack_bytes, 256 * 1024);
+    EXPECT_GE(stats.released_stack_bytes, 64 * 1024);
+
+    // The same coroutine is reused, the released part of the stack is usable
+    RunTask(pool, StackSizeClass::kNormal, 128 * 1024);
+    stats = GetClassStats(pool.GetStats(), StackSizeClass::kNormal);
+    EXPECT_EQ(stats.total_coroutines, 1);
+    EXPECT_EQ(stats.stack_reclaims, 2);
+
+    RunTask(pool, StackSizeClass::kNormal, 4 * 1024);
+    stats = GetClassStats(pool.GetStats(), StackSizeClass::kNormal);
+    EXPECT_EQ(stats.stack_reclaims, 2);
+  });
+}
+
+TEST(CoroPool, StackReclaimDisabled) {
+  RunInNewThread([] {
+    Pool pool(MakeConfig(), &RunTasks);
+
+    RunTask(pool, StackSizeClass::kNormal, 128 * 1024);
+    const auto stats = GetClassStats(pool.GetStats(), StackSizeClass::kNormal);
+    EXPECT_EQ(stats.stack_reclaims, 0);
+    EXPECT_EQ(stats.released_stack_bytes, 0);
+  });
+}
+
+USERVER_NAMESPACE_END
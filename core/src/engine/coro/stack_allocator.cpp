@@ -0,0 +1,127 @@
+#include <engine/coro/stack_allocator.hpp>
+
+#include <sys/mman.h>
+#include <sys/param.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include <userver/utils/assert.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine::coro {
+
+namespace {
+
+#if defined(__APPLE__) || defined(BSD)
+using MincoreVecItem = char;
+#else
+using MincoreVecItem = unsigned char;
+#endif
+
+constexpr std::uint64_t kMarkValue = 0x6b72'616d'6b63'6174;
+
+// Stack frames may skip some words of the mark page, so the mark is written
+// with a stride that is less than the size of a typical frame.
+constexpr std::size_t kMarkStride = 64;
+
+// The frames of a coroutine that is suspended between tasks must fit into the
+// kept part of the stack, together with the fiber record at the very top.
+constexpr std::size_t kMinKeepSize = 16 * 1024;
+
+// Pages per mincore() call
+constexpr std::size_t kResidencyChunkPages = 64;
+
+std::size_t GetPageSize() noexcept {
+  static const std::size_t kPageSize =
+      boost::context::stack_traits::page_size();
+  return kPageSize;
+}
+
+}  // namespace
+
+Stack::Stack(const boost::context::stack_context& context,
+             std::size_t keep_size) noexcept {
+  if (keep_size == 0) return;
+
+  const auto page_size = GetPageSize();
+  auto* const top = static_cast<std::byte*>(context.sp);
+  // protected_fixedsize_stack puts a guard page at the bottom
+  auto* const bottom = top - context.size + page_size;
+
+  keep_size = std::max(keep_size, kMinKeepSize);
+  keep_size = (keep_size + page_size - 1) / page_size * page_size;
+  if (keep_size >= static_cast<std::size_t>(top - bottom)) return;
+
+  bottom_ = bottom;
+  mark_ = top - keep_size;
+  top_ = top;
+  WriteMark();
+}
+
+std::optional<Stack::ReclaimResult> Stack::ReclaimIfDeep() noexcept {
+  if (!mark_) return std::nullopt;
+
+  const auto page_size = GetPageSize();
+  bool is_mark_intact = true;
+  for (std::size_t offset = 0; offset < page_size; offset += kMarkStride) {
+    std::uint64_t mark{};
+    std::memcpy(&mark, mark_ + offset, sizeof(mark));
+    is_mark_intact &= (mark == kMarkValue);
+  }
+  if (is_mark_intact) return std::nullopt;
+
+  ReclaimResult result;
+  result.touched_bytes = top_ - mark_;
+
+  std::array<MincoreVecItem, kResidencyChunkPages> residency{};
+  for (auto* chunk = bottom_; chunk < mark_;
+       chunk += kResidencyChunkPages * page_size) {
+    const auto chunk_size = std::min(static_cast<std::size_t>(mark_ - chunk),
+                                     kResidencyChunkPages * page_size);
+    if (::mincore(chunk, chunk_size, residency.data()) != 0) break;
+
+    for (std::size_t i = 0; i < chunk_size / page_size; ++i) {
+      if ((residency[i] & 1) == 0) continue;
+      if (result.released_bytes == 0) {
+        result.touched_bytes = top_ - (chunk + i * page_size);
+      }
+      result.released_bytes += page_size;
+    }
+  }
+
+  [[maybe_unused]] const auto madvise_result =
+      ::madvise(bottom_, mark_ - bottom_, MADV_DONTNEED);
+  UASSERT(madvise_result == 0);
+
+  WriteMark();
+  return result;
+}
+
+void Stack::WriteMark() noexcept {
+  const auto page_size = GetPageSize();
+  for (std::size_t offset = 0; offset < page_size; offset += kMarkStride) {
+    std::memcpy(mark_ + offset, &kMarkValue, sizeof(kMarkValue));
+  }
+}
+
+StackAllocator::StackAllocator(std::size_t stack_size, std::size_t keep_size,
+                               Stack& allocated) noexcept
+    : impl_(stack_size), keep_size_(keep_size), allocated_(&allocated) {}
+
+boost::context::stack_context StackAllocator::allocate() {
+  auto context = impl_.allocate();
+  *allocated_ = Stack{context, keep_size_};
+  return context;
+}
+
+void StackAllocator::deallocate(
+    boost::context::stack_context& context) noexcept {
+  impl_.deallocate(context);
+}
+
+}  // namespace engine::coro
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include <coroutines/coroutine.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine::coro {
+
+// The usable part of a coroutine stack, grows down from `top`
+class Stack final {
+ public:
+  struct ReclaimResult final {
+    // Bytes that were resident below the kept part of the stack
+    std::size_t released_bytes{0};
+    // How deep the stack was touched since the previous reclaim
+    std::size_t touched_bytes{0};
+  };
+
+  Stack() = default;
+
+  // With a non-zero `keep_size` marks the page `keep_size` bytes (rounded up
+  // to pages) below the top of the stack to detect the coroutines that went
+  // deeper than that.
+  Stack(const boost::context::stack_context& context,
+        std::size_t keep_size) noexcept;
+
+  // Must only be called while the coroutine is suspended at the top level.
+  // If the mark was overwritten, returns the pages below the marked page to
+  // the OS.
+  std::optional<ReclaimResult> ReclaimIfDeep() noexcept;
+
+ private:
+  void WriteMark() noexcept;
+
+  std::byte* bottom_{nullptr};
+  std::byte* mark_{nullptr};
+  std::byte* top_{nullptr};
+};
+
+// protected_fixedsize_stack that reports the allocated Stack
+class StackAllocator final {
+ public:
+  // `allocated` must outlive the coroutine construction only
+  StackAllocator(std::size_t stack_size, std::size_t keep_size,
+                 Stack& allocated) noexcept;
+
+  boost::context::stack_context allocate();
+
+  void deallocate(boost::context::stack_context& context) noexcept;
+
+ private:
+  boost::coroutines2::protected_fixedsize_stack impl_;
+  std::size_t keep_size_;
+  Stack* allocated_;
+};
+
+}  // namespace engine::coro
+
+USERVER_NAMESPACE_END
@@ -1,8 +1,14 @@
 #include <benchmark/benchmark.h>
 
+#include <atomic>
 #include <chrono>
+#include <vector>
 
+#include <userver/engine/async.hpp>
 #include <userver/engine/deadline.hpp>
+#include <userver/engine/run_standalone.hpp>
+#include <userver/engine/single_consumer_event.hpp>
+#include <userver/engine/task/task_with_result.hpp>
 
 #include <utils/gbench_auxilary.hpp>
 
@@ -47,6 +53,42 @@ void deadline_100s_interval_reached(benchmark::State& state) {
   deadline_is_reached(state, std::chrono::seconds{100});
 }
 
+// Each wait arms and disarms a deadline timer that never fires, like most of
+// the timeouts of network requests do.
+void deadline_bounded_wait_ping_pong(benchmark::State& state) {
+  constexpr std::size_t kWorkerThreads = 4;
+  constexpr std::chrono::seconds kTimeout{20};
+
+  engine::RunStandalone(kWorkerThreads, [&] {
+    const auto pairs_count = static_cast<std::size_t>(state.range(0));
+    std::atomic<bool> is_running{true};
+    std::vector<engine::SingleConsumerEvent> pings(pairs_count);
+    std::vector<engine::SingleConsumerEvent> pongs(pairs_count);
+
+    std::vector<engine::TaskWithResult<void>> tasks;
+    tasks.reserve(pairs_count);
+    for (std::size_t i = 0; i < pairs_count; ++i) {
+      tasks.push_back(engine::AsyncNoSpan([&, i] {
+        while (pings[i].WaitForEventFor(kTimeout) && is_running) {
+          pongs[i].Send();
+        }
+      }));
+    }
+
+    for (auto _ : state) {
+      for (auto& ping : pings) ping.Send();
+      for (auto& pong : pongs) {
+        if (!pong.WaitForEventFor(kTimeout)) state.SkipWithError("timeout");
+      }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+
+    is_running = false;
+    for (auto& ping : pings) ping.Send();
+    for (auto& task : tasks) task.Get();
+  });
+}
+
 }  // namespace
 
 BENCHMARK(deadline_1us_interval_construction);
@@ -56,4 +98,6 @@ BENCHMARK(deadline_1us_interval_reached);
 BENCHMARK(deadline_20ms_interval_reached);
 BENCHMARK(deadline_100s_interval_reached);
 
+BENCHMARK(deadline_bounded_wait_ping_pong)->RangeMultiplier(4)->Range(1, 256);
+
 USERVER_NAMESPACE_END
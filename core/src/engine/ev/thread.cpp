@@ -63,17 +63,24 @@ constexpr std::size_t kCpuStatsThrottle{16};
 }  // namespace
 
 Thread::Thread(const std::string& thread_name,
-               RegisterEventMode register_event_mode)
-    : Thread(thread_name, false, register_event_mode) {}
+               RegisterEventMode register_event_mode, PollBackend poll_backend,
+               engine::impl::ThreadPlacement placement)
+    : Thread(thread_name, false, register_event_mode, poll_backend,
+             std::move(placement)) {}
 
 Thread::Thread(const std::string& thread_name, UseDefaultEvLoop,
-               RegisterEventMode register_event_mode)
-    : Thread(thread_name, true, register_event_mode) {}
+               RegisterEventMode register_event_mode, PollBackend poll_backend,
+               engine::impl::ThreadPlacement placement)
+    : Thread(thread_name, true, register_event_mode, poll_backend,
+             std::move(placement)) {}
 
 Thread::Thread(const std::string& thread_name, bool use_ev_default_loop,
-               RegisterEventMode register_event_mode)
+               RegisterEventMode register_event_mode, PollBackend poll_backend,
+               engine::impl::ThreadPlacement placement)
     : use_ev_default_loop_(use_ev_default_loop),
       register_event_mode_(register_event_mode),
+      poll_backend_(poll_backend),
+      placement_(std::move(placement)),
       loop_(nullptr),
       lock_(loop_mutex_, std::defer_lock),
       name_{thread_name},
@@ -136,8 +143,7 @@ std::uint8_t Thread::GetCurrentLoadPercent() const {
 const std::string& Thread::GetName() const { return name_; }
 
 void Thread::Start() {
-  loop_ = use_ev_default_loop_ ? ev_default_loop(EVFLAG_AUTO)
-                               : ev_loop_new(EVFLAG_AUTO);
+  loop_ = CreateEvLoop();
   UASSERT(loop_);
   ev_set_userdata(loop_, this);
   ev_set_loop_release_cb(loop_, Release, Acquire);
@@ -183,10 +189,36 @@ void Thread::Start() {
   is_running_ = true;
   thread_ = std::thread([this] {
     utils::SetCurrentThreadName(name_);
+    placement_.Apply();
     RunEvLoop();
   });
 }
 
+struct ev_loop* Thread::CreateEvLoop() const {
+  const auto create_loop = [this](unsigned int flags) {
+    return use_ev_default_loop_ ? ev_default_loop(flags) : ev_loop_new(flags);
+  };
+
+  if (poll_backend_ == PollBackend::kIoUring) {
+#if EV_VERSION_MAJOR > 4 || (EV_VERSION_MAJOR == 4 && EV_VERSION_MINOR >= 31)
+    // libev does not pick io_uring with EVFLAG_AUTO, it has to be requested
+    // explicitly. Loop creation fails on kernels without io_uring support or
+    // with io_uring disabled via sysctl.
+    if (ev_supported_backends() & EVBACKEND_IOURING) {
+      auto* loop = create_loop(EVBACKEND_IOURING);
+      if (loop) {
+        LOG_INFO() << "Using io_uring ev backend for thread_name=" << name_;
+        return loop;
+      }
+    }
+#endif
+    LOG_WARNING() << "io_uring ev backend is not available for thread_name="
+                  << name_ << ", falling back to the default one";
+  }
+
+  return create_loop(EVFLAG_AUTO);
+}
+
 void Thread::StopEventLoop() {
   ev_async_send(loop_, &watch_break_);
   if (thread_.joinable()) thread_.join();
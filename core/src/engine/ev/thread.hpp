@@ -12,6 +12,8 @@
 
 #include <concurrent/impl/intrusive_mpsc_queue.hpp>
 #include <engine/ev/async_payload_base.hpp>
+#include <engine/ev/thread_pool_config.hpp>
+#include <engine/impl/thread_placement.hpp>
 #include <utils/statistics/thread_statistics.hpp>
 
 USERVER_NAMESPACE_BEGIN
@@ -34,8 +36,12 @@ class Thread final {
     kDeferred
   };
 
-  Thread(const std::string& thread_name, RegisterEventMode);
-  Thread(const std::string& thread_name, UseDefaultEvLoop, RegisterEventMode);
+  Thread(const std::string& thread_name, RegisterEventMode,
+         PollBackend poll_backend = PollBackend::kDefault,
+         engine::impl::ThreadPlacement placement = {});
+  Thread(const std::string& thread_name, UseDefaultEvLoop, RegisterEventMode,
+         PollBackend poll_backend = PollBackend::kDefault,
+         engine::impl::ThreadPlacement placement = {});
   ~Thread();
 
   struct ev_loop* GetEvLoop() const { return loop_; }
@@ -57,11 +63,13 @@ class Thread final {
 
  private:
   Thread(const std::string& thread_name, bool use_ev_default_loop,
-         RegisterEventMode register_event_mode);
+         RegisterEventMode register_event_mode, PollBackend poll_backend,
+         engine::impl::ThreadPlacement placement);
 
   void RegisterInEvLoop(AsyncPayloadBase& payload);
 
   void Start();
+  struct ev_loop* CreateEvLoop() const;
 
   void StopEventLoop();
   void RunEvLoop();
@@ -83,6 +91,8 @@ class Thread final {
 
   bool use_ev_default_loop_;
   RegisterEventMode register_event_mode_;
+  PollBackend poll_backend_;
+  engine::impl::ThreadPlacement placement_;
 
   struct ev_loop* loop_;
   std::thread thread_;
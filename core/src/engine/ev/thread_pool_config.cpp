@@ -1,9 +1,23 @@
 #include "thread_pool_config.hpp"
 
+#include <hostinfo/cpu_list.hpp>
+#include <userver/utils/trivial_map.hpp>
+
 USERVER_NAMESPACE_BEGIN
 
 namespace engine::ev {
 
+PollBackend Parse(const yaml_config::YamlConfig& value,
+                  formats::parse::To<PollBackend>) {
+  static constexpr utils::TrivialBiMap kMap([](auto selector) {
+    return selector()
+        .Case(PollBackend::kDefault, "default")
+        .Case(PollBackend::kIoUring, "io_uring");
+  });
+
+  return utils::ParseFromValueString(value, kMap);
+}
+
 ThreadPoolConfig Parse(const yaml_config::YamlConfig& value,
                        formats::parse::To<ThreadPoolConfig>) {
   ThreadPoolConfig config;
@@ -13,6 +27,11 @@ ThreadPoolConfig Parse(const yaml_config::YamlConfig& value,
           config.dedicated_timer_threads);
   config.thread_name = value["thread_name"].As<std::string>(config.thread_name);
   config.defer_events = value["defer_events"].As<bool>(config.defer_events);
+  config.poll_backend =
+      value["poll_backend"].As<PollBackend>(config.poll_backend);
+  config.cpu_affinity = hostinfo::impl::ParseCpuList(
+      value["cpu_affinity"].As<std::string>(std::string{}));
+  config.numa_node = value["numa_node"].As<std::optional<std::size_t>>();
   return config;
 }
 
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstddef>
+#include <optional>
 #include <string>
+#include <vector>
 
 #include <userver/formats/yaml.hpp>
 #include <userver/yaml_config/yaml_config.hpp>
@@ -9,12 +12,32 @@ USERVER_NAMESPACE_BEGIN
 
 namespace engine::ev {
 
+/// The libev backend used by ev loops to wait for I/O readiness.
+///
+/// Only the readiness polling is affected: Socket and Pipe still wait for
+/// readiness in FdPoller and perform the I/O with regular system calls, there
+/// is no completion-based io_uring path (multishot accept/recv, registered
+/// buffers).
+enum class PollBackend {
+  /// The best backend available on the platform, e.g. epoll on Linux
+  kDefault,
+  /// libev's EVBACKEND_IOURING, falls back to kDefault if the kernel or libev
+  /// lacks support
+  kIoUring,
+};
+
+PollBackend Parse(const yaml_config::YamlConfig& value,
+                  formats::parse::To<PollBackend>);
+
 struct ThreadPoolConfig {
   std::size_t threads = 2;
   std::size_t dedicated_timer_threads = 0;
   std::string thread_name = "event-worker";
   bool ev_default_loop_disabled = false;
   bool defer_events = false;
+  PollBackend poll_backend = PollBackend::kDefault;
+  std::vector<std::size_t> cpu_affinity;
+  std::optional<std::size_t> numa_node;
 };
 
 ThreadPoolConfig Parse(const yaml_config::YamlConfig& value,
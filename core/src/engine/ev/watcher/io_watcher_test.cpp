@@ -9,14 +9,13 @@
 
 USERVER_NAMESPACE_BEGIN
 
-#if defined(BSD) && !defined(__APPLE__)
-UTEST(IoWatcher, DISABLED_DevNull) {
-#else
-UTEST(IoWatcher, DevNull) {
-#endif
+namespace {
+
+void ReadDevNull(engine::ev::PollBackend poll_backend) {
   LOG_DEBUG() << "Opening /dev/null";
   engine::ev::Thread thread("test_thread",
-                            engine::ev::Thread::RegisterEventMode::kImmediate);
+                            engine::ev::Thread::RegisterEventMode::kImmediate,
+                            poll_backend);
   engine::ev::ThreadControl thread_control(thread);
 
   int fd = open("/dev/null", O_RDONLY | O_NONBLOCK | O_CLOEXEC);
@@ -51,4 +50,23 @@ UTEST(IoWatcher, DevNull) {
   EXPECT_EQ(counter, 0);
 }
 
+}  // namespace
+
+#if defined(BSD) && !defined(__APPLE__)
+UTEST(IoWatcher, DISABLED_DevNull) {
+#else
+UTEST(IoWatcher, DevNull) {
+#endif
+  ReadDevNull(engine::ev::PollBackend::kDefault);
+}
+
+// Falls back to the default backend if io_uring is not available
+#if defined(BSD) && !defined(__APPLE__)
+UTEST(IoWatcher, DISABLED_DevNullIoUring) {
+#else
+UTEST(IoWatcher, DevNullIoUring) {
+#endif
+  ReadDevNull(engine::ev::PollBackend::kIoUring);
+}
+
 USERVER_NAMESPACE_END
@@ -27,6 +27,33 @@ struct DetachedTasksSyncBlock::Token final {
   utils::impl::WaitTokenStorage::Token wait_token{};
 };
 
+namespace {
+
+class ParentCancellationListener final : public CancellationListener {
+ public:
+  ParentCancellationListener(TaskContext& parent,
+                             DetachedTasksSyncBlock& sync_block)
+      : parent_(&parent), sync_block_(sync_block) {
+    parent_->AddCancellationListener(*this);
+  }
+
+  ParentCancellationListener(const ParentCancellationListener&) = delete;
+  ParentCancellationListener& operator=(const ParentCancellationListener&) =
+      delete;
+
+  ~ParentCancellationListener() { parent_->RemoveCancellationListener(*this); }
+
+  void OnCancel(TaskCancellationReason reason) noexcept override {
+    sync_block_.CancelTasks(reason);
+  }
+
+ private:
+  const boost::intrusive_ptr<TaskContext> parent_;
+  DetachedTasksSyncBlock& sync_block_;
+};
+
+}  // namespace
+
 struct DetachedTasksSyncBlock::Impl final {
   std::optional<utils::impl::WaitTokenStorage> wait_tokens{};
   concurrent::impl::IntrusiveWalkablePool<
@@ -34,6 +61,8 @@ struct DetachedTasksSyncBlock::Impl final {
       cancel_tokens{};
   std::atomic<TaskCancellationReason> cancel_new_tasks{
       TaskCancellationReason::kNone};
+  // Is destroyed first, so that the parent does not cancel the tasks anymore
+  std::optional<ParentCancellationListener> parent_cancellation_listener{};
 };
 
 DetachedTasksSyncBlock::DetachedTasksSyncBlock(StopMode stop_mode) {
@@ -80,6 +109,15 @@ void DetachedTasksSyncBlock::Dispose(Token& token) noexcept {
 
 void DetachedTasksSyncBlock::RequestCancellation(
     TaskCancellationReason reason) noexcept {
+  CancelTasks(reason);
+
+  if (impl_->wait_tokens) {
+    impl_->wait_tokens->WaitForAllTokens();
+  }
+}
+
+void DetachedTasksSyncBlock::CancelTasks(
+    TaskCancellationReason reason) noexcept {
   impl_->cancel_new_tasks.store(reason);
 
   impl_->cancel_tokens.Walk([&](Token& token) {
@@ -91,10 +129,13 @@ void DetachedTasksSyncBlock::RequestCancellation(
       context->RequestCancel(reason);
     }
   });
+}
 
-  if (impl_->wait_tokens) {
-    impl_->wait_tokens->WaitForAllTokens();
-  }
+void DetachedTasksSyncBlock::CancelTasksWithCurrentTask() {
+  UASSERT(!impl_->parent_cancellation_listener);
+  auto* const parent = current_task::GetCurrentTaskContextUnchecked();
+  if (!parent) return;
+  impl_->parent_cancellation_listener.emplace(*parent, *this);
 }
 
 std::int64_t DetachedTasksSyncBlock::ActiveTasksApprox() const noexcept {
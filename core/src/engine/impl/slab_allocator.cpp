@@ -0,0 +1,354 @@
+#include <userver/engine/impl/slab_allocator.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+#include <compiler/tls.hpp>
+#include <concurrent/impl/interference_shield.hpp>
+#include <userver/compiler/impl/constexpr.hpp>
+#include <userver/utils/assert.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine::impl {
+
+namespace {
+
+// Cached blocks would hide use-after-free from the sanitizer
+#if defined(__SANITIZE_ADDRESS__)
+constexpr bool kCachingEnabled = false;
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+constexpr bool kCachingEnabled = false;
+#else
+constexpr bool kCachingEnabled = true;
+#endif
+#else
+constexpr bool kCachingEnabled = true;
+#endif
+
+// Size classes are multiples of kSmallStep up to kSmallMaxSize, then
+// multiples of kLargeStep up to kMaxSize. The sizes include the block header,
+// so the heap allocations of the cached blocks are exactly the class sizes.
+// Larger allocations are not cached.
+constexpr std::size_t kSmallStep = 64;
+constexpr std::size_t kSmallMaxSize = 1024;
+constexpr std::size_t kLargeStep = 512;
+constexpr std::size_t kMaxSize = 16 * 1024;
+
+constexpr std::size_t kSmallClassesCount = kSmallMaxSize / kSmallStep;
+constexpr std::size_t kClassesCount =
+    kSmallClassesCount + (kMaxSize - kSmallMaxSize) / kLargeStep;
+constexpr auto kNoSizeClass = std::numeric_limits<std::uint32_t>::max();
+
+// Limit the memory a thread keeps in the cached blocks: in total and in the
+// blocks of a single size class. The excess goes back to the heap.
+constexpr std::size_t kMaxCachedBytes = 1024 * 1024;
+constexpr std::size_t kMaxCachedBytesPerClass = 128 * 1024;
+constexpr std::size_t kMinCachedBlocksPerClass = 4;
+
+// Every that many allocations a thread takes the blocks freed by other
+// threads and returns to the heap the blocks it has not needed since the
+// previous time
+constexpr std::size_t kMaintenanceInterval = 1024;
+
+std::uint32_t GetSizeClass(std::size_t size) noexcept {
+  if (size <= kSmallMaxSize) {
+    return static_cast<std::uint32_t>(size == 0 ? 0 : (size - 1) / kSmallStep);
+  }
+  if (size <= kMaxSize) {
+    return static_cast<std::uint32_t>(kSmallClassesCount +
+                                      (size - kSmallMaxSize - 1) / kLargeStep);
+  }
+  return kNoSizeClass;
+}
+
+std::size_t GetClassSize(std::uint32_t size_class) noexcept {
+  UASSERT(size_class < kClassesCount);
+  if (size_class < kSmallClassesCount) return (size_class + 1) * kSmallStep;
+  return kSmallMaxSize + (size_class - kSmallClassesCount + 1) * kLargeStep;
+}
+
+std::size_t GetMaxCachedBlocks(std::uint32_t size_class) noexcept {
+  return std::max(kMinCachedBlocksPerClass,
+                  kMaxCachedBytesPerClass / GetClassSize(size_class));
+}
+
+class ThreadCache;
+
+// Precedes each allocated block. SlabDeallocate gets neither the size nor the
+// owner of the block: the fused task context deleter does not know the
+// payload size, and a block may be freed by any thread. Keeping them in the
+// block is cheaper than a lookup by address, and the 16 bytes are the minimum
+// that keeps the payload aligned to kSlabAlignment. The header is accounted in
+// the size class, so it does not add a separate heap chunk overhead.
+struct alignas(kSlabAlignment) BlockHeader final {
+  // nullptr for the blocks that are not cached
+  ThreadCache* owner{nullptr};
+  std::uint32_t size_class{kNoSizeClass};
+};
+
+static_assert(sizeof(BlockHeader) == kSlabAlignment);
+
+void* GetPayload(BlockHeader& block) noexcept { return &block + 1; }
+
+BlockHeader& GetBlock(void* payload) noexcept {
+  return *(static_cast<BlockHeader*>(payload) - 1);
+}
+
+// A free block stores the link to the next free block in place of its payload
+BlockHeader*& GetNextFree(BlockHeader& block) noexcept {
+  return *static_cast<BlockHeader**>(GetPayload(block));
+}
+
+BlockHeader& AllocateBlock(std::size_t total_size, ThreadCache* owner,
+                           std::uint32_t size_class) {
+  void* const storage =
+      ::operator new(total_size, std::align_val_t{kSlabAlignment});
+  return *new (storage) BlockHeader{owner, size_class};
+}
+
+void FreeBlock(BlockHeader& block) noexcept {
+  ::operator delete(&block, std::align_val_t{kSlabAlignment});
+}
+
+// Free blocks of a single thread. Only the owning thread allocates from the
+// cache, other threads put the blocks they free into a lock-free list, which
+// the owner drains once it runs out of the cached blocks of a size class, and
+// periodically.
+class ThreadCache final {
+ public:
+  ThreadCache() = default;
+
+  ThreadCache(const ThreadCache&) = delete;
+  ThreadCache& operator=(const ThreadCache&) = delete;
+
+  // Owner only
+  void* Allocate(std::uint32_t size_class) {
+    if (--allocations_until_maintenance_ == 0) Maintain();
+
+    auto& free_list = free_lists_[size_class];
+    if (!free_list.head &&
+        remote_frees_->load(std::memory_order_relaxed) != nullptr) {
+      DrainRemoteFrees();
+    }
+
+    if (auto* block = free_list.head) {
+      free_list.head = GetNextFree(*block);
+      --free_list.size;
+      free_list.low_watermark =
+          std::min(free_list.low_watermark, free_list.size);
+      cached_bytes_ -= GetClassSize(size_class);
+      return GetPayload(*block);
+    }
+    return GetPayload(
+        AllocateBlock(GetClassSize(size_class), this, size_class));
+  }
+
+  // Owner only
+  void DeallocateLocal(BlockHeader& block) noexcept {
+    UASSERT(block.owner == this);
+    const auto class_size = GetClassSize(block.size_class);
+    auto& free_list = free_lists_[block.size_class];
+    if (free_list.size >= GetMaxCachedBlocks(block.size_class) ||
+        cached_bytes_ + class_size > kMaxCachedBytes) {
+      FreeBlock(block);
+      return;
+    }
+    GetNextFree(block) = free_list.head;
+    free_list.head = &block;
+    ++free_list.size;
+    cached_bytes_ += class_size;
+  }
+
+  // Any thread
+  void DeallocateRemote(BlockHeader& block) noexcept {
+    UASSERT(block.owner == this);
+    auto& head = *remote_frees_;
+    auto* next = head.load(std::memory_order_relaxed);
+    do {
+      GetNextFree(block) = next;
+    } while (!head.compare_exchange_weak(next, &block,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed));
+  }
+
+  // Owner only. Frees all the cached blocks, called when the owning thread
+  // exits.
+  void ReleaseCachedBlocks() noexcept {
+    DrainRemoteFrees();
+    for (auto& free_list : free_lists_) {
+      while (auto* block = free_list.head) {
+        free_list.head = GetNextFree(*block);
+        FreeBlock(*block);
+      }
+      free_list.size = 0;
+      free_list.low_watermark = 0;
+    }
+    cached_bytes_ = 0;
+  }
+
+ private:
+  struct FreeList final {
+    BlockHeader* head{nullptr};
+    std::size_t size{0};
+    // The minimum size since the last Maintain()
+    std::size_t low_watermark{0};
+  };
+
+  void Maintain() noexcept {
+    allocations_until_maintenance_ = kMaintenanceInterval;
+    DrainRemoteFrees();
+
+    // The blocks below the low watermark were not needed for the whole
+    // interval. Half of them are freed, so that a thread whose load drops
+    // returns its memory gradually.
+    for (std::uint32_t size_class = 0; size_class < kClassesCount;
+         ++size_class) {
+      auto& free_list = free_lists_[size_class];
+      for (auto to_free = (free_list.low_watermark + 1) / 2; to_free > 0;
+           --to_free) {
+        auto* const block = free_list.head;
+        UASSERT(block);
+        free_list.head = GetNextFree(*block);
+        --free_list.size;
+        cached_bytes_ -= GetClassSize(size_class);
+        FreeBlock(*block);
+      }
+      free_list.low_watermark = free_list.size;
+    }
+  }
+
+  void DrainRemoteFrees() noexcept {
+    // The whole list is taken at once, so there is no ABA problem
+    auto* block = remote_frees_->exchange(nullptr, std::memory_order_acquire);
+    while (block) {
+      auto* const next = GetNextFree(*block);
+      DeallocateLocal(*block);
+      block = next;
+    }
+  }
+
+  std::array<FreeList, kClassesCount> free_lists_{};
+  std::size_t cached_bytes_{0};
+  std::size_t allocations_until_maintenance_{kMaintenanceInterval};
+  concurrent::impl::InterferenceShield<std::atomic<BlockHeader*>>
+      remote_frees_{nullptr};
+};
+
+// Caches of the exited threads. Other threads may still free the blocks of an
+// exited thread, so its cache is never destroyed, but adopted by a new
+// thread instead.
+class OrphanedCaches final {
+ public:
+  ThreadCache& AdoptOrCreate() {
+    {
+      const std::lock_guard lock{mutex_};
+      if (!caches_.empty()) {
+        auto* cache = caches_.back();
+        caches_.pop_back();
+        return *cache;
+      }
+    }
+    return *new ThreadCache();
+  }
+
+  void Orphan(ThreadCache& cache) noexcept {
+    cache.ReleaseCachedBlocks();
+    const std::lock_guard lock{mutex_};
+    try {
+      caches_.push_back(&cache);
+    } catch (const std::bad_alloc&) {
+      // The cache is leaked, the blocks freed by other threads still go into
+      // it, but are never reused
+    }
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<ThreadCache*> caches_;
+};
+
+OrphanedCaches& GetOrphanedCaches() {
+  // Never destroyed, the caches may be used by the threads that outlive
+  // the static objects
+  static auto* const orphaned_caches = new OrphanedCaches();
+  return *orphaned_caches;
+}
+
+thread_local USERVER_IMPL_CONSTINIT ThreadCache* current_cache = nullptr;
+thread_local USERVER_IMPL_CONSTINIT bool is_current_cache_released = false;
+
+// Coroutines migrate between threads, so the thread-local variables must not
+// be cached across the calls
+USERVER_PREVENT_TLS_CACHING ThreadCache* GetCurrentCacheIfExists() noexcept {
+  return current_cache;
+}
+
+USERVER_PREVENT_TLS_CACHING bool IsCurrentCacheReleased() noexcept {
+  return is_current_cache_released;
+}
+
+USERVER_PREVENT_TLS_CACHING void SetCurrentCache(ThreadCache* cache,
+                                                 bool is_released) noexcept {
+  current_cache = cache;
+  is_current_cache_released = is_released;
+}
+
+class CurrentCacheHolder final {
+ public:
+  CurrentCacheHolder() : cache_(GetOrphanedCaches().AdoptOrCreate()) {
+    SetCurrentCache(&cache_, false);
+  }
+
+  ~CurrentCacheHolder() {
+    // The blocks freed by this thread from now on go to the orphaned cache as
+    // if they were freed by another thread
+    SetCurrentCache(nullptr, true);
+    GetOrphanedCaches().Orphan(cache_);
+  }
+
+ private:
+  ThreadCache& cache_;
+};
+
+// Returns nullptr if the thread is exiting
+ThreadCache* GetCurrentCache() {
+  if (auto* cache = GetCurrentCacheIfExists()) return cache;
+  if (IsCurrentCacheReleased()) return nullptr;
+
+  thread_local CurrentCacheHolder holder;
+  return GetCurrentCacheIfExists();
+}
+
+}  // namespace
+
+void* SlabAllocate(std::size_t size) {
+  const auto total_size = sizeof(BlockHeader) + size;
+  const auto size_class = GetSizeClass(total_size);
+  if (kCachingEnabled && size_class != kNoSizeClass) {
+    if (auto* cache = GetCurrentCache()) return cache->Allocate(size_class);
+  }
+  return GetPayload(AllocateBlock(total_size, nullptr, kNoSizeClass));
+}
+
+void SlabDeallocate(void* ptr) noexcept {
+  UASSERT(ptr);
+  auto& block = GetBlock(ptr);
+  if (!block.owner) {
+    FreeBlock(block);
+  } else if (block.owner == GetCurrentCacheIfExists()) {
+    block.owner->DeallocateLocal(block);
+  } else {
+    block.owner->DeallocateRemote(block);
+  }
+}
+
+}  // namespace engine::impl
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,147 @@
+#include <userver/engine/impl/slab_allocator.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+// The blocks are not cached under the address sanitizer
+#if defined(__SANITIZE_ADDRESS__)
+constexpr bool kCachingEnabled = false;
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+constexpr bool kCachingEnabled = false;
+#else
+constexpr bool kCachingEnabled = true;
+#endif
+#else
+constexpr bool kCachingEnabled = true;
+#endif
+
+constexpr std::size_t kSmallSize = 250;
+constexpr std::size_t kUncachedSize = 1024 * 1024;
+
+// Each test uses its own thread to start with a clean thread cache
+template <typename Func>
+void RunInNewThread(Func func) {
+  std::thread(std::move(func)).join();
+}
+
+bool IsAligned(void* ptr) {
+  return reinterpret_cast<std::uintptr_t>(ptr) %
+             engine::impl::kSlabAlignment ==
+         0;
+}
+
+}  // namespace
+
+TEST(SlabAllocator, Alignment) {
+  RunInNewThread([] {
+    for (const auto size : {std::size_t{0}, std::size_t{1}, kSmallSize,
+                            std::size_t{5000}, kUncachedSize}) {
+      void* ptr = engine::impl::SlabAllocate(size);
+      EXPECT_TRUE(IsAligned(ptr)) << size;
+      engine::impl::SlabDeallocate(ptr);
+    }
+  });
+}
+
+TEST(SlabAllocator, ReusesLocalBlocks) {
+  if (!kCachingEnabled) GTEST_SKIP() << "Caching is disabled";
+
+  RunInNewThread([] {
+    void* ptr = engine::impl::SlabAllocate(kSmallSize);
+    engine::impl::SlabDeallocate(ptr);
+
+    // Blocks of the same size class are interchangeable
+    void* other = engine::impl::SlabAllocate(kSmallSize + 40);
+    EXPECT_EQ(other, ptr);
+    engine::impl::SlabDeallocate(other);
+  });
+}
+
+TEST(SlabAllocator, ReusesRemoteBlocks) {
+  if (!kCachingEnabled) GTEST_SKIP() << "Caching is disabled";
+
+  RunInNewThread([] {
+    void* ptr = engine::impl::SlabAllocate(kSmallSize);
+    RunInNewThread([ptr] { engine::impl::SlabDeallocate(ptr); });
+
+    // The block freed by the other thread returns to this thread
+    void* other = engine::impl::SlabAllocate(kSmallSize);
+    EXPECT_EQ(other, ptr);
+    engine::impl::SlabDeallocate(other);
+  });
+}
+
+TEST(SlabAllocator, DrainsRemoteBlocksPeriodically) {
+  if (!kCachingEnabled) GTEST_SKIP() << "Caching is disabled";
+
+  RunInNewThread([] {
+    void* remote = engine::impl::SlabAllocate(kSmallSize);
+    void* local = engine::impl::SlabAllocate(kSmallSize);
+    engine::impl::SlabDeallocate(local);
+    RunInNewThread([remote] { engine::impl::SlabDeallocate(remote); });
+
+    // More allocations of another size class than the maintenance interval
+    for (int i = 0; i < 1500; ++i) {
+      engine::impl::SlabDeallocate(engine::impl::SlabAllocate(kSmallSize * 4));
+    }
+
+    // The remote block was drained while the size class still had a local
+    // block, and is on top of it now
+    void* first = engine::impl::SlabAllocate(kSmallSize);
+    void* second = engine::impl::SlabAllocate(kSmallSize);
+    EXPECT_EQ(first, remote);
+    EXPECT_EQ(second, local);
+    engine::impl::SlabDeallocate(first);
+    engine::impl::SlabDeallocate(second);
+  });
+}
+
+TEST(SlabAllocator, FreesAfterThreadExit) {
+  void* ptr = nullptr;
+  RunInNewThread([&ptr] { ptr = engine::impl::SlabAllocate(kSmallSize); });
+
+  // The cache of the exited thread is still alive
+  RunInNewThread([ptr] { engine::impl::SlabDeallocate(ptr); });
+  RunInNewThread([] {
+    for (int i = 0; i < 100; ++i) {
+      engine::impl::SlabDeallocate(engine::impl::SlabAllocate(kSmallSize));
+    }
+  });
+}
+
+TEST(SlabAllocator, LargeAllocations) {
+  RunInNewThread([] {
+    auto* ptr = static_cast<char*>(engine::impl::SlabAllocate(kUncachedSize));
+    ptr[0] = 'a';
+    ptr[kUncachedSize - 1] = 'z';
+    RunInNewThread([ptr] { engine::impl::SlabDeallocate(ptr); });
+  });
+}
+
+TEST(SlabAllocator, AllocateShared) {
+  RunInNewThread([] {
+    const std::string value(100, 'x');
+    std::shared_ptr<std::string> shared;
+    RunInNewThread([&] {
+      shared = std::allocate_shared<std::string>(
+          engine::impl::SlabAllocator<std::string>{}, value);
+    });
+    EXPECT_EQ(*shared, value);
+
+    std::weak_ptr<std::string> weak = shared;
+    shared.reset();
+    EXPECT_TRUE(weak.expired());
+  });
+}
+
+USERVER_NAMESPACE_END
@@ -25,6 +25,9 @@ std::shared_ptr<TaskProcessorPools> MakeTaskProcessorPools(
   ev_config.thread_name = pools_config.ev_thread_name;
   ev_config.ev_default_loop_disabled = pools_config.ev_default_loop_disabled;
   ev_config.defer_events = pools_config.defer_events;
+  ev_config.poll_backend = pools_config.ev_io_uring
+                               ? ev::PollBackend::kIoUring
+                               : ev::PollBackend::kDefault;
 
   return std::make_shared<TaskProcessorPools>(std::move(coro_config),
                                               std::move(ev_config));
@@ -32,10 +35,13 @@ std::shared_ptr<TaskProcessorPools> MakeTaskProcessorPools(
 
 TaskProcessorHolder TaskProcessorHolder::Make(
     std::size_t threads_num, std::string thread_name,
-    std::shared_ptr<TaskProcessorPools> pools) {
+    std::shared_ptr<TaskProcessorPools> pools, TaskQueueType task_queue_type,
+    SpinningMode spinning_mode) {
   TaskProcessorConfig config;
   config.worker_threads = threads_num;
   config.thread_name = std::move(thread_name);
+  config.task_processor_queue = task_queue_type;
+  config.spinning_mode = spinning_mode;
 
   return TaskProcessorHolder(
       std::make_unique<TaskProcessor>(std::move(config), std::move(pools)));
@@ -14,6 +14,7 @@
 #include <memory>
 #include <string>
 
+#include <engine/task/task_processor_config.hpp>
 #include <userver/engine/run_standalone.hpp>
 #include <userver/engine/task/task_processor_fwd.hpp>
 #include <userver/utils/not_null.hpp>
@@ -29,9 +30,11 @@ std::shared_ptr<TaskProcessorPools> MakeTaskProcessorPools(
 
 class TaskProcessorHolder final {
  public:
-  static TaskProcessorHolder Make(std::size_t threads_num,
-                                  std::string thread_name,
-                                  std::shared_ptr<TaskProcessorPools> pools);
+  static TaskProcessorHolder Make(
+      std::size_t threads_num, std::string thread_name,
+      std::shared_ptr<TaskProcessorPools> pools,
+      TaskQueueType task_queue_type = TaskQueueType::kGlobalTaskQueue,
+      SpinningMode spinning_mode = SpinningMode::kFixed);
 
   explicit TaskProcessorHolder(std::unique_ptr<TaskProcessor>&&);
 
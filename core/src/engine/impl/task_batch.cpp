@@ -0,0 +1,42 @@
+#include <userver/engine/impl/task_batch.hpp>
+
+#include <boost/smart_ptr/intrusive_ptr.hpp>
+
+#include <engine/task/task_context.hpp>
+#include <engine/task/task_processor.hpp>
+#include <userver/utils/assert.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine::impl {
+
+struct TaskBatch::Impl final {
+  TaskProcessor& task_processor;
+  std::vector<boost::intrusive_ptr<TaskContext>> contexts;
+};
+
+TaskBatch::TaskBatch(TaskProcessor& task_processor,
+                     const std::vector<TaskContextHolder>& contexts)
+    : impl_(Impl{task_processor, {}}) {
+  // Allocates before any of the tasks is marked, so that an exception leaves
+  // them intact
+  impl_->contexts.reserve(contexts.size());
+  for (const auto& context : contexts) {
+    UASSERT(&context.GetContext().GetTaskProcessor() == &task_processor);
+    impl_->contexts.emplace_back(&context.GetContext());
+  }
+  for (const auto& context : impl_->contexts) context->MarkQueuedInBatch();
+}
+
+TaskBatch::~TaskBatch() {
+  UASSERT_MSG(impl_->contexts.empty(), "TaskBatch was not scheduled");
+}
+
+void TaskBatch::Schedule() {
+  impl_->task_processor.ScheduleBatch(impl_->contexts);
+  impl_->contexts.clear();
+}
+
+}  // namespace engine::impl
+
+USERVER_NAMESPACE_END
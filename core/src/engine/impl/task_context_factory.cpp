@@ -1,6 +1,7 @@
 #include <userver/engine/impl/task_context_factory.hpp>
 
 #include <engine/task/task_context.hpp>
+#include <userver/engine/impl/slab_allocator.hpp>
 #include <userver/utils/assert.hpp>
 
 USERVER_NAMESPACE_BEGIN
@@ -11,21 +12,22 @@ std::size_t GetTaskContextSize() noexcept { return sizeof(TaskContext); }
 
 static_assert(kTaskContextAlignment >= alignof(TaskContext));
 static_assert(sizeof(TaskContext) % kTaskContextAlignment == 0);
+static_assert(kSlabAlignment % kTaskContextAlignment == 0);
 
 TaskContext& PlacementNewTaskContext(std::byte* storage, TaskConfig config,
                                      utils::impl::WrappedCallBase& payload) {
-  return *new (storage) TaskContext{config.task_processor, config.importance,
-                                    config.wait_mode, config.deadline, payload};
+  return *new (storage)
+      TaskContext{config.task_processor, config.importance, config.priority,
+                  config.wait_mode, config.deadline, payload};
 }
 
 std::byte* AllocateFusedTaskContext(std::size_t total_size) {
-  return static_cast<std::byte*>(
-      ::operator new[](total_size, std::align_val_t{kTaskContextAlignment}));
+  return static_cast<std::byte*>(SlabAllocate(total_size));
 }
 
 void DeleteFusedTaskContext(std::byte* storage) noexcept {
   UASSERT(storage);
-  ::operator delete[](storage, std::align_val_t{kTaskContextAlignment});
+  SlabDeallocate(storage);
 }
 
 }  // namespace engine::impl
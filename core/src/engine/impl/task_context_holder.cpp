@@ -18,6 +18,8 @@ TaskContextHolder TaskContextHolder::Adopt(TaskContext& context) noexcept {
       boost::intrusive_ptr<TaskContext>{&context, /*add_ref=*/false});
 }
 
+TaskContextHolder::TaskContextHolder(TaskContextHolder&&) noexcept = default;
+
 TaskContextHolder::~TaskContextHolder() = default;
 
 boost::intrusive_ptr<TaskContext>&& TaskContextHolder::Extract() && noexcept {
@@ -25,6 +27,11 @@ boost::intrusive_ptr<TaskContext>&& TaskContextHolder::Extract() && noexcept {
   return std::move(context_);
 }
 
+TaskContext& TaskContextHolder::GetContext() const noexcept {
+  UASSERT(context_);
+  return *context_;
+}
+
 }  // namespace engine::impl
 
 USERVER_NAMESPACE_END
@@ -0,0 +1,78 @@
+#include <engine/impl/thread_placement.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include <hostinfo/cpu_list.hpp>
+#include <userver/hostinfo/cpu_limit.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/utils/threads.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine::impl {
+
+ThreadPlacement::ThreadPlacement(std::vector<std::size_t> cpu_affinity,
+                                 std::optional<std::size_t> numa_node)
+    : numa_node_(numa_node) {
+  if (cpu_affinity.empty() && !numa_node) return;
+
+  const auto& topology = hostinfo::GetCpuTopology();
+  std::vector<std::size_t> available_cpus;
+  if (numa_node) {
+    const auto* node = topology.FindNumaNode(*numa_node);
+    if (!node) {
+      throw std::runtime_error(fmt::format(
+          "NUMA node {} has no CPUs available to the process", *numa_node));
+    }
+    available_cpus = node->cpus;
+  } else {
+    available_cpus = topology.GetCpus();
+  }
+
+  if (cpu_affinity.empty()) {
+    cpus_ = std::move(available_cpus);
+    return;
+  }
+
+  std::sort(cpu_affinity.begin(), cpu_affinity.end());
+  std::set_intersection(cpu_affinity.begin(), cpu_affinity.end(),
+                        available_cpus.begin(), available_cpus.end(),
+                        std::back_inserter(cpus_));
+  if (cpus_.empty()) {
+    throw std::runtime_error(fmt::format(
+        "None of the CPUs '{}' are available to the process{}",
+        hostinfo::impl::ToCpuList(cpu_affinity),
+        numa_node ? fmt::format(" on NUMA node {}", *numa_node) : ""));
+  }
+}
+
+void ThreadPlacement::Apply() const noexcept {
+  // The syscalls may be forbidden, e.g. in containers or by seccomp. The
+  // thread is still usable, just without the requested placement.
+  if (!cpus_.empty()) {
+    try {
+      utils::SetCurrentThreadCpuAffinity(cpus_);
+    } catch (const std::exception& ex) {
+      LOG_ERROR() << "Failed to set CPU affinity '"
+                  << hostinfo::impl::ToCpuList(cpus_)
+                  << "', the thread runs without it: " << ex;
+    }
+  }
+  if (numa_node_) {
+    try {
+      utils::SetCurrentThreadPreferredNumaNode(*numa_node_);
+    } catch (const std::exception& ex) {
+      LOG_ERROR() << "Failed to prefer NUMA node " << *numa_node_
+                  << " for memory allocations, the thread runs without it: "
+                  << ex;
+    }
+  }
+}
+
+}  // namespace engine::impl
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine::impl {
+
+// CPUs and NUMA node for the threads of a TaskProcessor or an ev::ThreadPool
+class ThreadPlacement final {
+ public:
+  ThreadPlacement() = default;
+
+  // Restricts the threads to `cpu_affinity` and to the CPUs of `numa_node`
+  // if specified. With `numa_node` the memory is preferably allocated from
+  // that node, so that the coroutine stacks and the buffers touched by
+  // the threads are local to them.
+  //
+  // Throws if none of the requested CPUs are available to the process.
+  ThreadPlacement(std::vector<std::size_t> cpu_affinity,
+                  std::optional<std::size_t> numa_node);
+
+  // Applies the placement to the current thread. Failures are logged and
+  // leave the thread as is.
+  void Apply() const noexcept;
+
+ private:
+  std::vector<std::size_t> cpus_;
+  std::optional<std::size_t> numa_node_;
+};
+
+}  // namespace engine::impl
+
+USERVER_NAMESPACE_END
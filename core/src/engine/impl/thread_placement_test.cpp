@@ -0,0 +1,58 @@
+#include <engine/impl/thread_placement.hpp>
+
+#include <sched.h>
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <userver/hostinfo/cpu_limit.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+constexpr std::size_t kMissingCpu = 100500;
+
+}  // namespace
+
+TEST(ThreadPlacement, Topology) {
+  const auto& topology = hostinfo::GetCpuTopology();
+  ASSERT_FALSE(topology.numa_nodes.empty());
+  for (const auto& node : topology.numa_nodes) {
+    EXPECT_FALSE(node.cpus.empty());
+    EXPECT_EQ(topology.FindNumaNode(node.id), &node);
+  }
+  EXPECT_EQ(topology.FindNumaNode(kMissingCpu), nullptr);
+  EXPECT_FALSE(topology.GetCpus().empty());
+}
+
+TEST(ThreadPlacement, MissingCpus) {
+  EXPECT_THROW(engine::impl::ThreadPlacement({kMissingCpu}, std::nullopt),
+               std::runtime_error);
+  EXPECT_THROW(engine::impl::ThreadPlacement({}, kMissingCpu),
+               std::runtime_error);
+}
+
+#ifdef __linux__
+TEST(ThreadPlacement, CpuAffinity) {
+  const auto& topology = hostinfo::GetCpuTopology();
+  const auto& node = topology.numa_nodes.front();
+  const auto cpu = node.cpus.back();
+
+  // Unavailable CPUs are ignored
+  const engine::impl::ThreadPlacement placement{{cpu, kMissingCpu}, node.id};
+
+  std::thread([&placement, cpu] {
+    placement.Apply();
+
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    ASSERT_EQ(::sched_getaffinity(0, sizeof(cpu_set), &cpu_set), 0);
+    EXPECT_EQ(CPU_COUNT(&cpu_set), 1);
+    EXPECT_TRUE(CPU_ISSET(cpu, &cpu_set));
+  }).join();
+}
+#endif
+
+USERVER_NAMESPACE_END
@@ -23,10 +23,17 @@ namespace {
 
 constexpr auto kDeadlineMaxTime = std::chrono::seconds{60};
 
+engine::TaskProcessorPoolsConfig MakePoolsConfig(benchmark::State& state) {
+  engine::TaskProcessorPoolsConfig config;
+  config.ev_io_uring = state.range(0) != 0;
+  state.SetLabel(config.ev_io_uring ? "io_uring" : "default");
+  return config;
+}
+
 }  // namespace
 
 void socket_send_all(benchmark::State& state) {
-  engine::RunStandalone([&]() {
+  engine::RunStandalone(1, MakePoolsConfig(state), [&]() {
     const auto test_deadline = Deadline::FromDuration(kDeadlineMaxTime);
     internal::net::TcpListener listener;
     auto [server, client] = listener.MakeSocketPair(test_deadline);
@@ -49,7 +56,7 @@ void socket_send_all(benchmark::State& state) {
     task_reader.Get();
   });
 }
-BENCHMARK(socket_send_all);
+BENCHMARK(socket_send_all)->Arg(0)->Arg(1);
 
 void socket_send_all_v(benchmark::State& state) {
   engine::RunStandalone([&]() {
@@ -76,6 +83,32 @@ void socket_send_all_v(benchmark::State& state) {
 }
 BENCHMARK(socket_send_all_v);
 
+// Every RecvSome waits for the peer, so the ev backend is on the hot path
+void socket_ping_pong(benchmark::State& state) {
+  engine::RunStandalone(2, MakePoolsConfig(state), [&]() {
+    const auto test_deadline = Deadline::FromDuration(kDeadlineMaxTime);
+    internal::net::TcpListener listener;
+    auto [server, client] = listener.MakeSocketPair(test_deadline);
+    auto task_echo = engine::AsyncNoSpan(
+        [test_deadline](auto&& server) {
+          char c{};
+          while (server.RecvSome(&c, 1, test_deadline) > 0 &&
+                 server.SendAll(&c, 1, test_deadline) > 0) {
+          }
+        },
+        std::move(server));
+    for (auto _ : state) {
+      char c = 'a';
+      auto bytes = client.SendAll(&c, 1, test_deadline);
+      bytes += client.RecvSome(&c, 1, test_deadline);
+      benchmark::DoNotOptimize(bytes);
+    }
+    client.Close();
+    task_echo.Get();
+  });
+}
+BENCHMARK(socket_ping_pong)->Arg(0)->Arg(1);
+
 [[maybe_unused]] void socket_send_all_v_range(benchmark::State& state) {
   engine::RunStandalone(2, [&]() {
     const auto test_deadline = Deadline::FromDuration(kDeadlineMaxTime);
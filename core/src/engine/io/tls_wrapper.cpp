@@ -1,18 +1,35 @@
 #include <userver/engine/io/tls_wrapper.hpp>
 
+#include <array>
+#include <cstring>
 #include <exception>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
 
 #include <fmt/format.h>
 #include <openssl/bio.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
 #include <openssl/ssl.h>
+#if OPENSSL_VERSION_NUMBER >= 0x030000000L
+#include <openssl/core_names.h>
+#else
+#include <openssl/hmac.h>
+#endif
 
 #include <crypto/helpers.hpp>
 #include <crypto/openssl.hpp>
 #include <engine/io/fd_control.hpp>
+#include <userver/cache/lru_map.hpp>
 #include <userver/engine/io/exception.hpp>
+#include <userver/engine/mutex.hpp>
 #include <userver/logging/log.hpp>
+#include <userver/rcu/rcu.hpp>
 #include <userver/utils/assert.hpp>
+#include <userver/utils/statistics/writer.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
@@ -29,6 +46,13 @@ struct SslDeleter {
 };
 using Ssl = std::unique_ptr<SSL, SslDeleter>;
 
+struct SslSessionDeleter {
+  void operator()(SSL_SESSION* session) const noexcept {
+    SSL_SESSION_free(session);
+  }
+};
+using SslSession = std::unique_ptr<SSL_SESSION, SslSessionDeleter>;
+
 struct BioDeleter {
   void operator()(BIO* bio) const noexcept { BIO_free_all(bio); }
 };
@@ -230,8 +254,229 @@ enum InterruptAction {
   kFail,
 };
 
+// Sessions are only resumed by the servers with the same context. It is a
+// digest of the certificate, the verify mode and the CAs, so that the session
+// of a peer verified against other CAs, or not verified at all, is not
+// resumed by a server sharing the ticket keys.
+std::string MakeSessionIdContext(
+    SSL_CTX* ssl_ctx, const crypto::Certificate& cert,
+    const std::vector<crypto::Certificate>& cert_authorities) {
+  auto data = fmt::format("userver:{}", SSL_CTX_get_verify_mode(ssl_ctx));
+  const auto append_digest = [&data](const crypto::Certificate& certificate) {
+    std::array<unsigned char, EVP_MAX_MD_SIZE> digest{};
+    unsigned int digest_size = 0;
+    if (1 != X509_digest(certificate.GetNative(), EVP_sha256(), digest.data(),
+                         &digest_size)) {
+      throw TlsException(crypto::FormatSslError(
+          "Failed to set up server TLS wrapper: X509_digest"));
+    }
+    data.append(reinterpret_cast<const char*>(digest.data()), digest_size);
+  };
+  append_digest(cert);
+  for (const auto& ca : cert_authorities) append_digest(ca);
+
+  std::string context(EVP_MAX_MD_SIZE, '\0');
+  unsigned int context_size = 0;
+  if (1 != EVP_Digest(data.data(), data.size(),
+                      reinterpret_cast<unsigned char*>(context.data()),
+                      &context_size, EVP_sha256(), nullptr)) {
+    throw TlsException(crypto::FormatSslError(
+        "Failed to set up server TLS wrapper: EVP_Digest"));
+  }
+  UASSERT(context_size <= SSL_MAX_SID_CTX_LENGTH);
+  context.resize(context_size);
+  return context;
+}
+
+// Layout of the keys follows SSL_CTX_set_tlsext_ticket_keys
+struct TicketKey {
+  std::array<unsigned char, 16> name{};
+  std::array<unsigned char, 32> aes_key{};
+  std::array<unsigned char, 32> hmac_key{};
+};
+
+void RandomBytes(unsigned char* data, std::size_t size) {
+  if (1 != RAND_bytes(data, static_cast<int>(size))) {
+    throw TlsException(
+        crypto::FormatSslError("Failed to generate a ticket key: RAND_bytes"));
+  }
+}
+
+TicketKey GenerateTicketKey() {
+  TicketKey key;
+  RandomBytes(key.name.data(), key.name.size());
+  RandomBytes(key.aes_key.data(), key.aes_key.size());
+  RandomBytes(key.hmac_key.data(), key.hmac_key.size());
+  return key;
+}
+
+#if OPENSSL_VERSION_NUMBER >= 0x030000000L
+using TicketMacCtx = EVP_MAC_CTX;
+
+bool InitTicketMac(EVP_MAC_CTX* mac_ctx, const TicketKey& key) {
+  char digest[] = "sha256";
+  const std::array params{
+      OSSL_PARAM_construct_octet_string(
+          OSSL_MAC_PARAM_KEY,
+          // the key is copied by EVP_MAC_CTX_set_params
+          // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+          const_cast<unsigned char*>(key.hmac_key.data()),
+          key.hmac_key.size()),
+      OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, digest, 0),
+      OSSL_PARAM_construct_end(),
+  };
+  return 1 == EVP_MAC_CTX_set_params(mac_ctx, params.data());
+}
+#else
+using TicketMacCtx = HMAC_CTX;
+
+bool InitTicketMac(HMAC_CTX* mac_ctx, const TicketKey& key) {
+  return 1 == HMAC_Init_ex(mac_ctx, key.hmac_key.data(), key.hmac_key.size(),
+                           EVP_sha256(), nullptr);
+}
+#endif
+
+// TLS 1.3 clients use a ticket only once, so it should always be renewed
+bool HasSingleUseTickets(const SSL* ssl) {
+#ifdef TLS1_3_VERSION
+  return SSL_version(ssl) >= TLS1_3_VERSION;
+#else
+  return false;
+#endif
+}
+
+void AccountHandshake(TlsHandshakeStatistics& stats, SSL* ssl) {
+  if (SSL_session_reused(ssl)) {
+    ++stats.resumed;
+  } else {
+    ++stats.full;
+  }
+}
+
 }  // namespace
 
+void DumpMetric(utils::statistics::Writer& writer,
+                const TlsHandshakeStatistics& stats) {
+  writer["full"] = stats.full.Load();
+  writer["resumed"] = stats.resumed.Load();
+}
+
+class TlsClientSessionCache::Impl {
+ public:
+  explicit Impl(std::size_t max_size) : sessions_(max_size) {}
+
+  // Offers the session of the peer for resumption
+  void Apply(SSL* ssl, const std::string& peer) {
+    std::lock_guard lock{mutex_};
+    auto* session = sessions_.Get(peer);
+    if (!session) return;
+    if (1 != SSL_set_session(ssl, session->get())) {
+      sessions_.Erase(peer);
+    }
+  }
+
+  void Put(const std::string& peer, SslSession&& session) {
+    std::lock_guard lock{mutex_};
+    sessions_.Put(peer, std::move(session));
+  }
+
+  void Clear() {
+    std::lock_guard lock{mutex_};
+    sessions_.Clear();
+  }
+
+  TlsHandshakeStatistics stats;
+
+ private:
+  engine::Mutex mutex_;
+  cache::LruMap<std::string, SslSession> sessions_;
+};
+
+TlsClientSessionCache::TlsClientSessionCache(std::size_t max_size)
+    : impl_(std::make_unique<Impl>(max_size)) {}
+
+TlsClientSessionCache::~TlsClientSessionCache() = default;
+
+void TlsClientSessionCache::Clear() { impl_->Clear(); }
+
+const TlsHandshakeStatistics& TlsClientSessionCache::GetStatistics() const {
+  return impl_->stats;
+}
+
+class TlsTicketKeys::Impl {
+ public:
+  Impl() : keys_(Keys{GenerateTicketKey(), std::nullopt}) {}
+
+  void Rotate() {
+    auto new_key = GenerateTicketKey();
+    auto keys = keys_.StartWrite();
+    keys->previous = keys->current;
+    keys->current = new_key;
+    keys.Commit();
+  }
+
+  // See SSL_CTX_set_tlsext_ticket_key_cb
+  static int OnTicketKey(SSL* ssl, unsigned char* key_name, unsigned char* iv,
+                         EVP_CIPHER_CTX* cipher_ctx, TicketMacCtx* mac_ctx,
+                         int enc) noexcept {
+    auto* self =
+        static_cast<Impl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+    UASSERT(self);
+    const auto keys = self->keys_.Read();
+
+    if (enc) {
+      const auto& key = keys->current;
+      if (1 != RAND_bytes(iv, EVP_CIPHER_iv_length(EVP_aes_256_cbc()))) {
+        return -1;
+      }
+      std::memcpy(key_name, key.name.data(), key.name.size());
+      if (1 != EVP_EncryptInit_ex(cipher_ctx, EVP_aes_256_cbc(), nullptr,
+                                  key.aes_key.data(), iv) ||
+          !InitTicketMac(mac_ctx, key)) {
+        return -1;
+      }
+      return 1;
+    }
+
+    const auto matches = [key_name](const TicketKey& key) {
+      return 0 == std::memcmp(key_name, key.name.data(), key.name.size());
+    };
+    const bool is_current = matches(keys->current);
+    if (!is_current && !(keys->previous && matches(*keys->previous))) {
+      // unknown or expired key, falling back to a full handshake
+      return 0;
+    }
+    const auto& key = is_current ? keys->current : *keys->previous;
+    if (1 != EVP_DecryptInit_ex(cipher_ctx, EVP_aes_256_cbc(), nullptr,
+                                key.aes_key.data(), iv) ||
+        !InitTicketMac(mac_ctx, key)) {
+      return -1;
+    }
+    // tickets of the previous key are renewed with the current one
+    return is_current && !HasSingleUseTickets(ssl) ? 1 : 2;
+  }
+
+  TlsHandshakeStatistics stats;
+
+ private:
+  struct Keys {
+    TicketKey current;
+    std::optional<TicketKey> previous;
+  };
+
+  rcu::Variable<Keys> keys_;
+};
+
+TlsTicketKeys::TlsTicketKeys() : impl_(std::make_unique<Impl>()) {}
+
+TlsTicketKeys::~TlsTicketKeys() = default;
+
+void TlsTicketKeys::Rotate() { impl_->Rotate(); }
+
+const TlsHandshakeStatistics& TlsTicketKeys::GetStatistics() const {
+  return impl_->stats;
+}
+
 class TlsWrapper::Impl {
  public:
   explicit Impl(Socket&& socket) : bio_data(std::move(socket)) {}
@@ -239,9 +484,34 @@ class TlsWrapper::Impl {
   Impl(Impl&& other) noexcept
       : bio_data(std::move(other.bio_data)),
         ssl(std::move(other.ssl)),
-        is_in_shutdown(other.is_in_shutdown) {
+        is_in_shutdown(other.is_in_shutdown),
+        session_cache(other.session_cache),
+        session_peer(std::move(other.session_peer)) {
     UASSERT(SSL_get_rbio(ssl.get()) == SSL_get_wbio(ssl.get()));
     SyncBioData(SSL_get_rbio(ssl.get()), &other.bio_data);
+    if (ssl && session_cache) SSL_set_app_data(ssl.get(), this);
+  }
+
+  // Takes the ownership of the session, see SSL_CTX_sess_set_new_cb
+  static int OnNewSession(SSL* ssl, SSL_SESSION* session) noexcept {
+    SslSession owned_session{session};
+    auto* self = static_cast<Impl*>(SSL_get_app_data(ssl));
+    if (!self) return 1;
+
+    try {
+      self->StoreSession(std::move(owned_session));
+    } catch (const std::exception& ex) {
+      LOG_LIMITED_WARNING() << "Failed to cache TLS session: " << ex;
+    }
+    return 1;
+  }
+
+  void StoreSession(SslSession&& session) {
+    if (!session_cache || !session) return;
+#if OPENSSL_VERSION_NUMBER >= 0x010101000L
+    if (!SSL_SESSION_is_resumable(session.get())) return;
+#endif
+    session_cache->Put(session_peer, std::move(session));
   }
 
   void SetUp(SslCtx&& ssl_ctx) {
@@ -336,6 +606,8 @@ class TlsWrapper::Impl {
   SocketBioData bio_data;
   Ssl ssl;
   bool is_in_shutdown{false};
+  TlsClientSessionCache::Impl* session_cache{nullptr};
+  std::string session_peer;
 
  private:
   void SyncBioData(BIO* bio,
@@ -350,6 +622,21 @@ TlsWrapper::TlsWrapper(Socket&& socket) : impl_(std::move(socket)) {}
 TlsWrapper TlsWrapper::StartTlsClient(Socket&& socket,
                                       const std::string& server_name,
                                       Deadline deadline) {
+  return DoStartTlsClient(std::move(socket), server_name, deadline, nullptr);
+}
+
+TlsWrapper TlsWrapper::StartTlsClient(Socket&& socket,
+                                      const std::string& server_name,
+                                      Deadline deadline,
+                                      TlsClientSessionCache& session_cache) {
+  return DoStartTlsClient(std::move(socket), server_name, deadline,
+                          &session_cache);
+}
+
+TlsWrapper TlsWrapper::DoStartTlsClient(Socket&& socket,
+                                        const std::string& server_name,
+                                        Deadline deadline,
+                                        TlsClientSessionCache* session_cache) {
   auto ssl_ctx = MakeSslCtx();
 
   if (!server_name.empty()) {
@@ -366,8 +653,25 @@ TlsWrapper TlsWrapper::StartTlsClient(Socket&& socket,
     SSL_CTX_set_verify(ssl_ctx.get(), SSL_VERIFY_PEER, nullptr);
   }
 
+  if (session_cache) {
+    // TLS 1.3 sessions arrive after the handshake, so they are stored
+    // on arrival instead of being taken from a finished handshake
+    SSL_CTX_set_session_cache_mode(
+        ssl_ctx.get(),
+        SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(ssl_ctx.get(), &Impl::OnNewSession);
+  }
+
   TlsWrapper wrapper{std::move(socket)};
   wrapper.impl_->SetUp(std::move(ssl_ctx));
+  if (session_cache) {
+    auto& impl = *wrapper.impl_;
+    impl.session_cache = session_cache->impl_.get();
+    impl.session_peer =
+        fmt::format("{}@{}", server_name, impl.bio_data.socket.Getpeername());
+    SSL_set_app_data(impl.ssl.get(), &impl);
+    impl.session_cache->Apply(impl.ssl.get(), impl.session_peer);
+  }
   if (!server_name.empty()) {
     // cast in openssl1.0 macro expansion
     // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast)
@@ -390,6 +694,13 @@ TlsWrapper TlsWrapper::StartTlsClient(Socket&& socket,
         fmt::format("Failed to set up client TLS wrapper ({})",
                     SSL_get_error(wrapper.impl_->ssl.get(), ret))));
   }
+  if (session_cache) {
+    // the renewed ticket of a resumed TLS 1.2 session is not passed to
+    // the new session callback
+    wrapper.impl_->StoreSession(
+        SslSession{SSL_get1_session(wrapper.impl_->ssl.get())});
+    AccountHandshake(session_cache->impl_->stats, wrapper.impl_->ssl.get());
+  }
   return wrapper;
 }
 
@@ -397,6 +708,24 @@ TlsWrapper TlsWrapper::StartTlsServer(
     Socket&& socket, const crypto::Certificate& cert,
     const crypto::PrivateKey& key, Deadline deadline,
     const std::vector<crypto::Certificate>& cert_authorities) {
+  return DoStartTlsServer(std::move(socket), cert, key, deadline,
+                          cert_authorities, nullptr);
+}
+
+TlsWrapper TlsWrapper::StartTlsServer(
+    Socket&& socket, const crypto::Certificate& cert,
+    const crypto::PrivateKey& key, Deadline deadline,
+    const std::vector<crypto::Certificate>& cert_authorities,
+    TlsTicketKeys& ticket_keys) {
+  return DoStartTlsServer(std::move(socket), cert, key, deadline,
+                          cert_authorities, &ticket_keys);
+}
+
+TlsWrapper TlsWrapper::DoStartTlsServer(
+    Socket&& socket, const crypto::Certificate& cert,
+    const crypto::PrivateKey& key, Deadline deadline,
+    const std::vector<crypto::Certificate>& cert_authorities,
+    TlsTicketKeys* ticket_keys) {
   auto ssl_ctx = MakeSslCtx();
 
   if (!cert_authorities.empty()) {
@@ -419,6 +748,33 @@ TlsWrapper TlsWrapper::StartTlsServer(
         "Failed to set up server TLS wrapper: SSL_CTX_use_PrivateKey"));
   }
 
+  if (ticket_keys) {
+    SSL_CTX_set_app_data(ssl_ctx.get(), ticket_keys->impl_.get());
+    const auto context =
+        MakeSessionIdContext(ssl_ctx.get(), cert, cert_authorities);
+    if (1 != SSL_CTX_set_session_id_context(
+                 ssl_ctx.get(),
+                 reinterpret_cast<const unsigned char*>(context.data()),
+                 context.size())) {
+      throw TlsException(crypto::FormatSslError(
+          "Failed to set up server TLS wrapper: "
+          "SSL_CTX_set_session_id_context"));
+    }
+#if OPENSSL_VERSION_NUMBER >= 0x030000000L
+    const auto ticket_key_cb_ret = SSL_CTX_set_tlsext_ticket_key_evp_cb(
+        ssl_ctx.get(), &TlsTicketKeys::Impl::OnTicketKey);
+#else
+    const auto ticket_key_cb_ret = SSL_CTX_set_tlsext_ticket_key_cb(
+        ssl_ctx.get(), &TlsTicketKeys::Impl::OnTicketKey);
+#endif
+    if (1 != ticket_key_cb_ret) {
+      throw TlsException(crypto::FormatSslError(
+          "Failed to set up server TLS wrapper: ticket key callback"));
+    }
+    // the sessions are stored in the tickets, the context is not reused
+    SSL_CTX_set_session_cache_mode(ssl_ctx.get(), SSL_SESS_CACHE_OFF);
+  }
+
   TlsWrapper wrapper{std::move(socket)};
   wrapper.impl_->SetUp(std::move(ssl_ctx));
   wrapper.impl_->bio_data.current_deadline = deadline;
@@ -433,6 +789,9 @@ TlsWrapper TlsWrapper::StartTlsServer(
         fmt::format("Failed to set up server TLS wrapper ({})",
                     SSL_get_error(wrapper.impl_->ssl.get(), ret))));
   }
+  if (ticket_keys) {
+    AccountHandshake(ticket_keys->impl_->stats, wrapper.impl_->ssl.get());
+  }
 
   return wrapper;
 }
@@ -450,6 +809,10 @@ bool TlsWrapper::IsValid() const {
   return impl_->ssl && !impl_->is_in_shutdown;
 }
 
+bool TlsWrapper::IsSessionReused() const {
+  return impl_->ssl && SSL_session_reused(impl_->ssl.get());
+}
+
 bool TlsWrapper::WaitReadable(Deadline deadline) {
   impl_->CheckAlive();
   char buf = 0;
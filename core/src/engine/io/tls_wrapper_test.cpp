@@ -137,6 +137,37 @@ v2R63aFo/UfQSQ4dhC0o2Vy74DyLwnO3pH8wudfBJ8/LX/Uz/A==
 
 constexpr auto kShortTimeout = std::chrono::milliseconds{10};
 
+// Returns whether the connection has resumed a previous session
+bool Connect(TcpListener& tcp_listener,
+             io::TlsClientSessionCache& session_cache,
+             io::TlsTicketKeys& ticket_keys,
+             const std::vector<crypto::Certificate>& cert_authorities = {}) {
+  const auto test_deadline = Deadline::FromDuration(utest::kMaxTestWaitTime);
+  auto [server, client] = tcp_listener.MakeSocketPair(test_deadline);
+
+  auto server_task = engine::AsyncNoSpan(
+      [test_deadline, &ticket_keys, &cert_authorities](auto&& server) {
+        auto tls_server = io::TlsWrapper::StartTlsServer(
+            std::forward<decltype(server)>(server),
+            crypto::Certificate::LoadFromString(cert),
+            crypto::PrivateKey::LoadFromString(key), test_deadline,
+            cert_authorities, ticket_keys);
+        EXPECT_EQ(1, tls_server.SendAll("1", 1, test_deadline));
+        return tls_server.IsSessionReused();
+      },
+      std::move(server));
+
+  auto tls_client = io::TlsWrapper::StartTlsClient(
+      std::move(client), {}, test_deadline, session_cache);
+  // TLS 1.3 session tickets are received along with the data
+  char c = 0;
+  EXPECT_EQ(1, tls_client.RecvSome(&c, 1, test_deadline));
+  EXPECT_EQ('1', c);
+
+  EXPECT_EQ(server_task.Get(), tls_client.IsSessionReused());
+  return tls_client.IsSessionReused();
+}
+
 }  // namespace
 
 UTEST_MT(TlsWrapper, Smoke, 2) {
@@ -476,6 +507,67 @@ UTEST_MT(TlsWrapper, DoubleSmoke, 4) {
   other_client_task.Get();
 }
 
+UTEST_MT(TlsWrapper, SessionResumption, 2) {
+  TcpListener tcp_listener;
+  io::TlsClientSessionCache session_cache;
+  io::TlsTicketKeys ticket_keys;
+
+  EXPECT_FALSE(Connect(tcp_listener, session_cache, ticket_keys));
+  EXPECT_TRUE(Connect(tcp_listener, session_cache, ticket_keys));
+  EXPECT_TRUE(Connect(tcp_listener, session_cache, ticket_keys));
+
+  session_cache.Clear();
+  EXPECT_FALSE(Connect(tcp_listener, session_cache, ticket_keys));
+
+  // the tickets of other servers are not accepted
+  io::TlsTicketKeys other_ticket_keys;
+  EXPECT_FALSE(Connect(tcp_listener, session_cache, other_ticket_keys));
+
+  EXPECT_EQ(session_cache.GetStatistics().full, 3);
+  EXPECT_EQ(session_cache.GetStatistics().resumed, 2);
+  EXPECT_EQ(ticket_keys.GetStatistics().full, 2);
+  EXPECT_EQ(ticket_keys.GetStatistics().resumed, 2);
+  EXPECT_EQ(other_ticket_keys.GetStatistics().full, 1);
+  EXPECT_EQ(other_ticket_keys.GetStatistics().resumed, 0);
+}
+
+UTEST_MT(TlsWrapper, SessionResumptionOtherAuthorities, 2) {
+  TcpListener tcp_listener;
+  io::TlsClientSessionCache session_cache;
+  io::TlsTicketKeys ticket_keys;
+  const std::vector<crypto::Certificate> cert_authorities{
+      crypto::Certificate::LoadFromString(other_cert)};
+
+  EXPECT_FALSE(Connect(tcp_listener, session_cache, ticket_keys));
+  EXPECT_TRUE(Connect(tcp_listener, session_cache, ticket_keys));
+
+  // the sessions are not shared by the servers with different CAs
+  EXPECT_FALSE(
+      Connect(tcp_listener, session_cache, ticket_keys, cert_authorities));
+  EXPECT_TRUE(
+      Connect(tcp_listener, session_cache, ticket_keys, cert_authorities));
+  EXPECT_FALSE(Connect(tcp_listener, session_cache, ticket_keys));
+}
+
+UTEST_MT(TlsWrapper, TicketKeysRotation, 2) {
+  TcpListener tcp_listener;
+  io::TlsClientSessionCache session_cache;
+  io::TlsTicketKeys ticket_keys;
+
+  EXPECT_FALSE(Connect(tcp_listener, session_cache, ticket_keys));
+
+  // the ticket of the previous key is accepted and renewed
+  ticket_keys.Rotate();
+  EXPECT_TRUE(Connect(tcp_listener, session_cache, ticket_keys));
+  ticket_keys.Rotate();
+  EXPECT_TRUE(Connect(tcp_listener, session_cache, ticket_keys));
+
+  // the keys before the previous one are forgotten
+  ticket_keys.Rotate();
+  ticket_keys.Rotate();
+  EXPECT_FALSE(Connect(tcp_listener, session_cache, ticket_keys));
+}
+
 UTEST(TlsWrapper, InvalidSocket) {
   const auto test_deadline = Deadline::FromDuration(utest::kMaxTestWaitTime);
 
@@ -25,7 +25,11 @@ void RunStandalone(std::size_t worker_threads,
 
   auto task_processor_holder = engine::impl::TaskProcessorHolder::Make(
       worker_threads, "coro-runner",
-      engine::impl::MakeTaskProcessorPools(config));
+      engine::impl::MakeTaskProcessorPools(config),
+      config.work_stealing_task_queue ? TaskQueueType::kWorkStealingTaskQueue
+                                      : TaskQueueType::kGlobalTaskQueue,
+      config.adaptive_spinning ? SpinningMode::kAdaptive
+                               : SpinningMode::kFixed);
 
   engine::impl::RunOnTaskProcessorSync(*task_processor_holder,
                                        std::move(payload));
@@ -1,9 +1,12 @@
 #include <benchmark/benchmark.h>
 
+#include <vector>
+
 #include <engine/ev/thread_control.hpp>
 #include <userver/engine/async.hpp>
 #include <userver/engine/run_standalone.hpp>
 #include <userver/engine/sleep.hpp>
+#include <userver/engine/task/task_with_result.hpp>
 
 using namespace std::chrono_literals;
 
@@ -23,6 +26,29 @@ BENCHMARK(sleep_benchmark_us)
     ->Range(1, 1024 * 128)
     ->Unit(benchmark::kMicrosecond);
 
+void sleep_concurrent_benchmark(benchmark::State& state) {
+  constexpr std::size_t kWorkerThreads = 4;
+  engine::RunStandalone(kWorkerThreads, [&] {
+    const auto tasks_count = static_cast<std::size_t>(state.range(0));
+    std::vector<engine::TaskWithResult<void>> tasks;
+    tasks.reserve(tasks_count);
+
+    for (auto _ : state) {
+      for (std::size_t i = 0; i < tasks_count; ++i) {
+        tasks.push_back(engine::AsyncNoSpan(
+            [] { engine::InterruptibleSleepFor(100us); }));
+      }
+      for (auto& task : tasks) task.Get();
+      tasks.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  });
+}
+BENCHMARK(sleep_concurrent_benchmark)
+    ->RangeMultiplier(4)
+    ->Range(1, 1024)
+    ->Unit(benchmark::kMicrosecond);
+
 void run_in_ev_loop_benchmark(benchmark::State& state) {
   engine::RunStandalone([&] {
     auto& ev_thread = engine::current_task::GetEventThread();
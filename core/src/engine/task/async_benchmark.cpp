@@ -1,7 +1,9 @@
 #include <benchmark/benchmark.h>
 
 #include <array>
+#include <cstddef>
 #include <thread>
+#include <vector>
 
 #include <userver/engine/async.hpp>
 #include <userver/engine/impl/task_local_storage.hpp>
@@ -99,4 +101,37 @@ void async_comparisons_coro_spanned(benchmark::State& state) {
 }
 BENCHMARK(async_comparisons_coro_spanned)->RangeMultiplier(2)->Range(1, 32);
 
+// A handler fanning out to range(1) subrequests on range(0) worker threads,
+// starting the tasks one by one or as a single batch
+void async_fan_out(benchmark::State& state, bool batch, bool work_stealing) {
+  engine::TaskProcessorPoolsConfig config;
+  config.work_stealing_task_queue = work_stealing;
+  engine::RunStandalone(state.range(0), config, [&] {
+    const auto fan_out = static_cast<std::size_t>(state.range(1));
+    std::vector<engine::TaskWithResult<void>> tasks;
+    tasks.reserve(fan_out);
+
+    for (auto _ : state) {
+      if (batch) {
+        tasks = engine::AsyncBatchNoSpan(fan_out, [](std::size_t) {});
+      } else {
+        for (std::size_t i = 0; i < fan_out; ++i) {
+          tasks.push_back(engine::AsyncNoSpan([] {}));
+        }
+      }
+      for (auto& task : tasks) task.Wait();
+      tasks.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * fan_out);
+  });
+}
+BENCHMARK_CAPTURE(async_fan_out, one_by_one, false, false)
+    ->ArgsProduct({{2, 4, 8}, {8, 50, 200}});
+BENCHMARK_CAPTURE(async_fan_out, batch, true, false)
+    ->ArgsProduct({{2, 4, 8}, {8, 50, 200}});
+BENCHMARK_CAPTURE(async_fan_out, one_by_one_work_stealing, false, true)
+    ->ArgsProduct({{2, 4, 8}, {8, 50, 200}});
+BENCHMARK_CAPTURE(async_fan_out, batch_work_stealing, true, true)
+    ->ArgsProduct({{2, 4, 8}, {8, 50, 200}});
+
 USERVER_NAMESPACE_END
@@ -1,8 +1,10 @@
 #include <userver/utest/utest.hpp>
 
 #include <atomic>
+#include <cstddef>
 
 #include <userver/engine/async.hpp>
+#include <userver/engine/run_standalone.hpp>
 #include <userver/engine/sleep.hpp>
 #include <userver/engine/task/cancel.hpp>
 #include <userver/utils/lazy_prvalue.hpp>
@@ -285,4 +287,69 @@ UTEST(Async, FromNonWorkerThread) {
   task.Wait();
 }
 
+UTEST_MT(AsyncBatch, Results, 4) {
+  constexpr std::size_t kTasksCount = 200;
+  auto tasks = engine::AsyncBatchNoSpan(
+      kTasksCount, [](std::size_t index) { return index * 2; });
+
+  ASSERT_EQ(tasks.size(), kTasksCount);
+  for (std::size_t i = 0; i < kTasksCount; ++i) {
+    EXPECT_EQ(tasks[i].Get(), i * 2);
+  }
+}
+
+UTEST(AsyncBatch, Empty) {
+  auto tasks = engine::AsyncBatchNoSpan(0, [](std::size_t) {});
+  EXPECT_TRUE(tasks.empty());
+}
+
+UTEST_MT(AsyncBatch, NestedBatches, 4) {
+  auto tasks = engine::AsyncBatchNoSpan(10, [](std::size_t index) {
+    auto nested_tasks = engine::AsyncBatchNoSpan(
+        10, [index](std::size_t nested_index) { return index + nested_index; });
+    std::size_t sum = 0;
+    for (auto& task : nested_tasks) sum += task.Get();
+    return sum;
+  });
+
+  for (std::size_t i = 0; i < tasks.size(); ++i) {
+    EXPECT_EQ(tasks[i].Get(), i * 10 + 45);
+  }
+}
+
+namespace {
+
+// Starts and waits for an unrelated task whenever it is copied into a task of
+// the batch
+struct StartingTaskOnCopy final {
+  StartingTaskOnCopy() = default;
+  StartingTaskOnCopy(const StartingTaskOnCopy&) {
+    engine::AsyncNoSpan([] {}).Get();
+  }
+
+  void operator()(std::size_t) const {}
+};
+
+}  // namespace
+
+UTEST_MT(AsyncBatch, OtherTasksAreNotBatched, 2) {
+  auto tasks = engine::AsyncBatchNoSpan(10, StartingTaskOnCopy{});
+  for (auto& task : tasks) task.Get();
+}
+
+TEST(AsyncBatch, WorkStealingTaskQueue) {
+  engine::TaskProcessorPoolsConfig config;
+  config.work_stealing_task_queue = true;
+  engine::RunStandalone(4, config, [] {
+    // More than fits into a worker local queue
+    constexpr std::size_t kTasksCount = 1000;
+    std::atomic<std::size_t> counter{0};
+
+    auto tasks = engine::AsyncBatchNoSpan(
+        kTasksCount, [&counter](std::size_t) { ++counter; });
+    for (auto& task : tasks) task.Get();
+    EXPECT_EQ(counter.load(), kTasksCount);
+  });
+}
+
 USERVER_NAMESPACE_END
@@ -1,87 +1,72 @@
 #include <engine/task/context_timer.hpp>
 
-#include <chrono>
+#include <algorithm>
+#include <limits>
 
-#include <engine/ev/async_payload_base.hpp>
+#include <compiler/tls.hpp>
+#include <userver/compiler/impl/constexpr.hpp>
 #include <userver/logging/log.hpp>
 #include <userver/utils/assert.hpp>
 
-#include <engine/ev/data_pipe_to_ev.hpp>
 #include <engine/task/task_context.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
 namespace engine::impl {
 
-class ContextTimer::Impl final : public ev::MultiShotAsyncPayload<Impl> {
+namespace {
+
+using Clock = TimerWheel::Clock;
+
+constexpr auto kNoExpiration = std::numeric_limits<Clock::rep>::max();
+
+thread_local USERVER_IMPL_CONSTINIT WorkerTimerWheel* current_timer_wheel =
+    nullptr;
+
+USERVER_PREVENT_TLS_CACHING WorkerTimerWheel*
+GetCurrentWorkerTimerWheel() noexcept {
+  return current_timer_wheel;
+}
+
+}  // namespace
+
+class ContextTimer::Impl final : public TimerWheel::Entry {
  public:
-  Impl();
+  Impl() = default;
   ~Impl();
 
   bool WasStarted() const noexcept;
 
-  void Start(boost::intrusive_ptr<TaskContext>&& context,
-             ev::TimerThreadControl thread_control, Func&& on_timer_func,
+  void Start(boost::intrusive_ptr<TaskContext>&& context, Func&& on_timer_func,
              Deadline deadline);
 
   void Restart(Func&& on_timer_func, Deadline deadline);
 
-  void Finalize();
+  void Finalize() noexcept;
 
-  void DoPerformAndRelease();
+  // Called with the owning WorkerTimerWheel locked
+  static WorkerTimerWheel::ExpiredTimer TakeExpired(
+      TimerWheel::Entry& entry) noexcept;
 
  private:
-  void ArmTimerInEvThread();
-  void StopTimerInEvThread() noexcept;
-  void DoFinalize();
-
-  static void OnTimer(struct ev_loop*, ev_timer* w, int) noexcept;
-  void DoOnTimer();
-
-  class Finalizer final : public ev::SingleShotAsyncPayload<Finalizer> {
-   public:
-    explicit Finalizer(Impl& owner) : owner_(owner) {}
-    void DoPerformAndRelease() { owner_.DoFinalize(); }
-
-   private:
-    Impl& owner_;
-  };
-
-  struct Params {
-    Func on_timer_func{};
-    Deadline deadline{};
-  };
+  void Unlink() noexcept;
 
   boost::intrusive_ptr<TaskContext> context_;
-  std::optional<ev::TimerThreadControl> thread_control_;
-  Params params_;
-  ev_timer timer_{};
-  ev::DataPipeToEv<Params> params_pipe_to_ev_;
-  Finalizer finalizer_;
+  Func on_timer_func_;
+  // The wheel the timer was last put into, only changed by the task itself
+  WorkerTimerWheel* timer_wheel_{nullptr};
 };
 
-ContextTimer::Impl::Impl() : finalizer_(*this) {
-  timer_.data = this;
-  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast)
-  ev_init(&timer_, OnTimer);
-}
-
-ContextTimer::Impl::~Impl() {
-  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast)
-  UASSERT(!ev_is_active(&timer_));
-}
+ContextTimer::Impl::~Impl() { UASSERT(!IsLinked()); }
 
 bool ContextTimer::Impl::WasStarted() const noexcept {
-  return context_ && thread_control_;
+  return context_ != nullptr;
 }
 
 void ContextTimer::Impl::Start(boost::intrusive_ptr<TaskContext>&& context,
-                               ev::TimerThreadControl thread_control,
                                Func&& on_timer_func, Deadline deadline) {
   UASSERT(!context_);
-  UASSERT(!thread_control_);
   context_ = std::move(context);
-  thread_control_.emplace(thread_control);
 
   Restart(std::move(on_timer_func), deadline);
 }
@@ -90,80 +75,49 @@ void ContextTimer::Impl::Restart(Func&& on_timer_func, Deadline deadline) {
   UASSERT(WasStarted());
   UASSERT(on_timer_func);
 
-  params_pipe_to_ev_.Push({std::move(on_timer_func), deadline});
-  if (PrepareEnqueue()) {
-    thread_control_->RunPayloadInEvLoopDeferred(*this, deadline);
-  }
-}
+  auto* const timer_wheel = GetCurrentWorkerTimerWheel();
+  UINVARIANT(timer_wheel,
+             "ContextTimer must be started from a TaskProcessor worker");
 
-void ContextTimer::Impl::Finalize() {
-  if (!WasStarted()) return;
+  Unlink();
+  // Nobody else may access the unlinked timer
+  on_timer_func_ = std::move(on_timer_func);
 
-  // We cannot use *this as payload here, because with MultiShotAsyncPayload,
-  // two ev runs with the same data can happen. The first run would drop
-  // 'context_', potentially destroying *this. The second run would
-  // use-after-free.
-  thread_control_->RunPayloadInEvLoopDeferred(finalizer_, {});
-}
-
-void ContextTimer::Impl::DoPerformAndRelease() {
-  auto params = params_pipe_to_ev_.TryPop();
-  if (!params) {
-    return;
+  const auto now = Clock::now();
+  const auto expiration = now + deadline.TimeLeft();
+  {
+    const std::lock_guard lock{timer_wheel->mutex_};
+    timer_wheel->wheel_.Insert(*this, expiration, now);
+    timer_wheel->UpdateNextExpiration();
   }
-
-  params_ = std::move(*params);
-  ArmTimerInEvThread();
+  timer_wheel_ = timer_wheel;
 }
 
-void ContextTimer::Impl::ArmTimerInEvThread() {
-  using LibEvDuration = std::chrono::duration<double>;
-  const auto time_left =
-      std::chrono::duration_cast<LibEvDuration>(params_.deadline.TimeLeft())
-          .count();
-
-  LOG_TRACE() << "time_left=" << time_left;
-  if (time_left <= 0.0) {
-    // Optimization for small deadlines or high load
-    DoOnTimer();
-    return;
-  }
-
-  timer_.repeat = time_left;
-  thread_control_->Again(timer_);
-}
-
-void ContextTimer::Impl::StopTimerInEvThread() noexcept {
-  thread_control_->Stop(timer_);
-}
+void ContextTimer::Impl::Finalize() noexcept {
+  if (!WasStarted()) return;
 
-void ContextTimer::Impl::DoFinalize() {
-  StopTimerInEvThread();
+  Unlink();
 
-  // We should reset params pipe, because it may hold resources
-  // in timer func closures.
-  params_pipe_to_ev_.UnsafeReset();
+  // We should reset the timer func, because it may hold resources in closures
+  on_timer_func_ = {};
 
   context_.reset();
   // ContextTimer may be destroyed at this point
 }
 
-void ContextTimer::Impl::OnTimer(struct ev_loop*, ev_timer* w, int) noexcept {
-  auto* ev_timer = static_cast<Impl*>(w->data);
-  UASSERT(ev_timer != nullptr);
-  ev_timer->DoOnTimer();
+WorkerTimerWheel::ExpiredTimer ContextTimer::Impl::TakeExpired(
+    TimerWheel::Entry& entry) noexcept {
+  auto& self = static_cast<Impl&>(entry);
+  UASSERT(self.context_);
+  return {self.context_, std::move(self.on_timer_func_)};
 }
 
-void ContextTimer::Impl::DoOnTimer() {
-  try {
-    // do not keep the function object around for much longer
-    const auto on_timer_func = std::move(params_.on_timer_func);
-    UASSERT(on_timer_func);
-    on_timer_func(*context_);  // called in event loop
-  } catch (const std::exception& ex) {
-    LOG_ERROR() << "exception in on_timer_func: " << ex;
-  }
-  StopTimerInEvThread();
+void ContextTimer::Impl::Unlink() noexcept {
+  if (!timer_wheel_) return;
+
+  // The owning worker may be expiring the timer right now
+  const std::lock_guard lock{timer_wheel_->mutex_};
+  if (IsLinked()) timer_wheel_->wheel_.Remove(*this);
 }
 
 ContextTimer::ContextTimer() = default;
@@ -173,22 +127,90 @@ ContextTimer::~ContextTimer() = default;
 bool ContextTimer::WasStarted() const noexcept { return impl_->WasStarted(); }
 
 void ContextTimer::Start(boost::intrusive_ptr<TaskContext> context,
-                         ev::TimerThreadControl thread_control,
                          Func&& on_timer_func, Deadline deadline) {
-  impl_->Start(std::move(context), thread_control, std::move(on_timer_func),
-               deadline);
+  impl_->Start(std::move(context), std::move(on_timer_func), deadline);
 }
 
 void ContextTimer::Restart(Func&& on_timer_func, Deadline deadline) {
   impl_->Restart(std::move(on_timer_func), deadline);
 }
 
-void ContextTimer::Finalize() noexcept {
-  try {
-    impl_->Finalize();
-  } catch (const std::exception& e) {
-    LOG_ERROR() << "Exception while stopping the timer: " << e;
+void ContextTimer::Finalize() noexcept { impl_->Finalize(); }
+
+WorkerTimerWheel::WorkerTimerWheel() : next_expiration_(kNoExpiration) {}
+
+WorkerTimerWheel::~WorkerTimerWheel() = default;
+
+void WorkerTimerWheel::ProcessExpired(Clock::time_point now) {
+  UASSERT(GetCurrentWorkerTimerWheel() == this);
+
+  const auto next_expiration = GetNextExpiration();
+  if (!next_expiration || now < *next_expiration) return;
+
+  {
+    const std::lock_guard lock{mutex_};
+    TakeExpired(now, expired_);
   }
+  Fire(expired_);
+}
+
+void WorkerTimerWheel::StealExpired(Clock::time_point now) {
+  UASSERT(GetCurrentWorkerTimerWheel() != this);
+
+  const auto next_expiration = GetNextExpiration();
+  if (!next_expiration || now < *next_expiration + kStealDelay) return;
+
+  // The owner or another worker is already firing the timers
+  std::unique_lock lock{mutex_, std::try_to_lock};
+  if (!lock) return;
+
+  std::vector<ExpiredTimer> expired;
+  TakeExpired(now, expired);
+  lock.unlock();
+  Fire(expired);
+}
+
+std::optional<WorkerTimerWheel::Clock::time_point>
+WorkerTimerWheel::GetNextExpiration() const noexcept {
+  const auto next_expiration = next_expiration_.load(std::memory_order_relaxed);
+  if (next_expiration == kNoExpiration) return std::nullopt;
+  return Clock::time_point{Clock::duration{next_expiration}};
+}
+
+void WorkerTimerWheel::TakeExpired(Clock::time_point now,
+                                   std::vector<ExpiredTimer>& expired) {
+  TimerWheel::List expired_entries;
+  wheel_.Advance(now, expired_entries);
+  while (!expired_entries.empty()) {
+    auto& entry = expired_entries.front();
+    expired_entries.pop_front();
+    expired.push_back(ContextTimer::Impl::TakeExpired(entry));
+  }
+  UpdateNextExpiration();
+}
+
+void WorkerTimerWheel::Fire(std::vector<ExpiredTimer>& expired) {
+  for (auto& timer : expired) {
+    try {
+      timer.on_timer_func(*timer.context);
+    } catch (const std::exception& ex) {
+      LOG_ERROR() << "exception in on_timer_func: " << ex;
+    }
+  }
+  // May destroy the contexts
+  expired.clear();
+}
+
+void WorkerTimerWheel::UpdateNextExpiration() noexcept {
+  const auto next_expiration = wheel_.GetNextExpiration();
+  next_expiration_.store(next_expiration
+                             ? next_expiration->time_since_epoch().count()
+                             : kNoExpiration,
+                         std::memory_order_relaxed);
+}
+
+void SetCurrentWorkerTimerWheel(WorkerTimerWheel& timer_wheel) noexcept {
+  current_timer_wheel = &timer_wheel;
 }
 
 }  // namespace engine::impl
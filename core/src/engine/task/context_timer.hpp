@@ -1,10 +1,15 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <functional>
+#include <mutex>
+#include <optional>
+#include <vector>
 
 #include <boost/intrusive_ptr.hpp>
 
-#include <engine/ev/thread_control.hpp>
+#include <engine/task/timer_wheel.hpp>
 #include <userver/engine/deadline.hpp>
 #include <userver/utils/fast_pimpl.hpp>
 
@@ -13,12 +18,16 @@ USERVER_NAMESPACE_BEGIN
 namespace engine::impl {
 
 class TaskContext;
+class WorkerTimerWheel;
 
 // A timer bound to a specific TaskContext.
 // Not thread-safe, IOW you cannot call Start() and Stop() in parallel.
+//
+// Must be (re)started from a TaskProcessor worker thread, the timer is put into
+// the WorkerTimerWheel of that thread.
 class ContextTimer final {
  public:
-  // calls on_timer_func() in event loop
+  // calls on_timer_func() in a TaskProcessor worker thread, outside of any task
   using Func = std::function<void(TaskContext&)>;
 
   ContextTimer();
@@ -31,27 +40,88 @@ class ContextTimer final {
 
   bool WasStarted() const noexcept;
 
-  /// Asynchronously starts the timer.
+  /// Starts the timer.
   /// Prolongs lifetime of the context until Finalize().
-  void Start(boost::intrusive_ptr<TaskContext> context,
-             ev::TimerThreadControl thread_control, Func&& on_timer_func,
+  void Start(boost::intrusive_ptr<TaskContext> context, Func&& on_timer_func,
              Deadline deadline);
 
   /// Restarts a running timer with specified params. More efficient than
   /// calling Stop() + Start().
   void Restart(Func&& on_timer_func, Deadline deadline);
 
-  /// Asynchronously stops the timer and destroys all held resources.
+  /// Stops the timer and destroys all held resources.
   /// Invalidates the Timer and makes it unable to be restarted,
   /// releases the context.
   /// Does nothing for a WasStarted() == false timer.
   void Finalize() noexcept;
 
  private:
+  friend class WorkerTimerWheel;
+
   class Impl;
-  utils::FastPimpl<Impl, 336, 16> impl_;
+  utils::FastPimpl<Impl, 96, 16> impl_;
+};
+
+// Timers of the tasks that were last suspended on a specific TaskProcessor
+// worker thread.
+//
+// Only the owning worker inserts the timers and fires them between the task
+// steps, any thread may remove a timer. This keeps the timers away from the ev
+// threads, which are left for I/O.
+//
+// A worker that is stuck in a long task step does not fire its timers, so the
+// other workers of the TaskProcessor steal the timers that are overdue by more
+// than kStealDelay. The other wheels are scanned by at most one worker once per
+// kStealDelay, idle workers only wait for the timers of their own wheels.
+class WorkerTimerWheel final {
+ public:
+  using Clock = TimerWheel::Clock;
+
+  static constexpr std::chrono::microseconds kStealDelay{1000};
+
+  WorkerTimerWheel();
+
+  WorkerTimerWheel(const WorkerTimerWheel&) = delete;
+  WorkerTimerWheel& operator=(const WorkerTimerWheel&) = delete;
+  ~WorkerTimerWheel();
+
+  // Fires the timers expired by `now`. Must be called from the owning worker
+  // thread outside of any task.
+  void ProcessExpired(Clock::time_point now);
+
+  // Fires the timers that are overdue by more than kStealDelay at `now`. Must
+  // be called from another worker thread of the same TaskProcessor outside of
+  // any task.
+  void StealExpired(Clock::time_point now);
+
+  // Returns the time point of the next timer expiration, std::nullopt if there
+  // are no timers.
+  std::optional<Clock::time_point> GetNextExpiration() const noexcept;
+
+ private:
+  friend class ContextTimer::Impl;
+
+  struct ExpiredTimer final {
+    boost::intrusive_ptr<TaskContext> context;
+    ContextTimer::Func on_timer_func;
+  };
+
+  // Called with the mutex_ locked
+  void TakeExpired(Clock::time_point now, std::vector<ExpiredTimer>& expired);
+
+  static void Fire(std::vector<ExpiredTimer>& expired);
+
+  void UpdateNextExpiration() noexcept;
+
+  std::mutex mutex_;
+  TimerWheel wheel_;
+  std::atomic<TimerWheel::Clock::rep> next_expiration_;
+  std::vector<ExpiredTimer> expired_;
 };
 
+// Binds the WorkerTimerWheel to the current TaskProcessor worker thread
+void SetCurrentWorkerTimerWheel(WorkerTimerWheel& timer_wheel) noexcept;
+
 }  // namespace engine::impl
 
 USERVER_NAMESPACE_END
@@ -4,8 +4,8 @@
 
 #include <engine/impl/generic_wait_list.hpp>
 #include <engine/task/task_context.hpp>
+#include <engine/ev/thread_pool.hpp>
 #include <engine/task/task_processor.hpp>
-#include <engine/task/task_processor_pools.hpp>
 #include <userver/engine/async.hpp>
 #include <userver/engine/impl/task_context_holder.hpp>
 #include <userver/engine/task/cancel.hpp>
@@ -167,12 +167,7 @@ TaskProcessor& GetTaskProcessor() {
   return GetCurrentTaskContext().GetTaskProcessor();
 }
 
-std::size_t GetStackSize() {
-  return GetTaskProcessor()
-      .GetTaskProcessorPools()
-      ->GetCoroPool()
-      .GetStackSize();
-}
+std::size_t GetStackSize() { return GetTaskProcessor().GetCoroStackSize(); }
 
 ev::ThreadControl& GetEventThread() {
   return GetTaskProcessor().EventThreadPool().NextThread();
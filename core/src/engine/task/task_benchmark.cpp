@@ -1,6 +1,8 @@
 #include <benchmark/benchmark.h>
 
 #include <atomic>
+#include <chrono>
+#include <ctime>
 #include <thread>
 
 #include <engine/impl/standalone.hpp>
@@ -10,9 +12,20 @@
 #include <userver/engine/task/cancel.hpp>
 #include <userver/engine/task/single_threaded_task_processors_pool.hpp>
 #include <userver/engine/task/task_with_result.hpp>
+#include <userver/utils/statistics/percentile.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
+namespace {
+
+engine::TaskProcessorPoolsConfig MakeTaskQueueConfig(bool work_stealing) {
+  engine::TaskProcessorPoolsConfig config;
+  config.work_stealing_task_queue = work_stealing;
+  return config;
+}
+
+}  // namespace
+
 void engine_task_create(benchmark::State& state) {
   // We use 2 threads to ensure that detached tasks are deallocated,
   // otherwise this benchmark OOMs after some time.
@@ -38,8 +51,10 @@ void engine_task_yield_single_thread(benchmark::State& state) {
 }
 BENCHMARK(engine_task_yield_single_thread)->RangeMultiplier(2)->Range(1, 128);
 
-void engine_task_yield_multiple_threads(benchmark::State& state) {
-  engine::RunStandalone(state.range(0), [&] {
+void engine_task_yield_multiple_threads(benchmark::State& state,
+                                        bool work_stealing) {
+  const auto config = MakeTaskQueueConfig(work_stealing);
+  engine::RunStandalone(state.range(0), config, [&] {
     std::atomic<bool> keep_running{true};
     std::vector<engine::TaskWithResult<std::uint64_t>> tasks;
     tasks.reserve(state.range(0) - 1);
@@ -73,12 +88,114 @@ void engine_task_yield_multiple_threads(benchmark::State& state) {
         benchmark::Counter::kIsRate);
   });
 }
-BENCHMARK(engine_task_yield_multiple_threads)
+BENCHMARK_CAPTURE(engine_task_yield_multiple_threads, global_queue, false)
+    ->RangeMultiplier(2)
+    ->Range(1, 32)
+    ->Arg(6)
+    ->Arg(12);
+BENCHMARK_CAPTURE(engine_task_yield_multiple_threads, work_stealing, true)
     ->RangeMultiplier(2)
     ->Range(1, 32)
     ->Arg(6)
     ->Arg(12);
 
+// Measures the time between scheduling a task and the start of its execution,
+// with the spawning task being one of many competing for the workers.
+void engine_task_schedule_latency(benchmark::State& state, bool work_stealing) {
+  constexpr std::size_t kTasksPerIteration = 64;
+  // microseconds, precise up to 1ms, then 100 buckets of 1ms
+  using LatencyPercentile =
+      utils::statistics::Percentile<1000, std::uint64_t, 100, 1000>;
+
+  const auto config = MakeTaskQueueConfig(work_stealing);
+  engine::RunStandalone(state.range(0), config, [&] {
+    LatencyPercentile latencies;
+    std::vector<engine::TaskWithResult<void>> tasks;
+    tasks.reserve(kTasksPerIteration);
+
+    for (auto _ : state) {
+      for (std::size_t i = 0; i < kTasksPerIteration; ++i) {
+        tasks.push_back(engine::AsyncNoSpan(
+            [&latencies, scheduled_at = std::chrono::steady_clock::now()] {
+              latencies.Account(
+                  std::chrono::duration_cast<std::chrono::microseconds>(
+                      std::chrono::steady_clock::now() - scheduled_at)
+                      .count());
+            }));
+      }
+      for (auto& task : tasks) task.Get();
+      tasks.clear();
+    }
+
+    state.SetItemsProcessed(state.iterations() * kTasksPerIteration);
+    state.counters["p50-latency-us"] = latencies.GetPercentile(50);
+    state.counters["p99-latency-us"] = latencies.GetPercentile(99);
+  });
+}
+BENCHMARK_CAPTURE(engine_task_schedule_latency, global_queue, false)
+    ->RangeMultiplier(2)
+    ->Range(2, 32);
+BENCHMARK_CAPTURE(engine_task_schedule_latency, work_stealing, true)
+    ->RangeMultiplier(2)
+    ->Range(2, 32);
+
+// Measures the wakeup latency of idle workers and the CPU time they burn, for
+// the fixed and the adaptive spinning. range(0) is the number of tasks
+// scheduled at once, range(1) is the pause between the batches in
+// microseconds: a steady flow of single tasks or rare bursts.
+void engine_task_idle_wakeup(benchmark::State& state, bool adaptive_spinning) {
+  constexpr std::size_t kWorkerThreads = 4;
+  // microseconds, precise up to 1ms, then 100 buckets of 1ms
+  using LatencyPercentile =
+      utils::statistics::Percentile<1000, std::uint64_t, 100, 1000>;
+
+  const auto batch_size = static_cast<std::size_t>(state.range(0));
+  const std::chrono::microseconds pause{state.range(1)};
+
+  engine::TaskProcessorPoolsConfig config;
+  config.adaptive_spinning = adaptive_spinning;
+  engine::RunStandalone(kWorkerThreads, config, [&] {
+    LatencyPercentile latencies;
+    std::vector<engine::TaskWithResult<void>> tasks;
+    tasks.reserve(batch_size);
+
+    const auto cpu_time_start = std::clock();
+    for (auto _ : state) {
+      for (std::size_t i = 0; i < batch_size; ++i) {
+        tasks.push_back(engine::AsyncNoSpan(
+            [&latencies, scheduled_at = std::chrono::steady_clock::now()] {
+              latencies.Account(
+                  std::chrono::duration_cast<std::chrono::microseconds>(
+                      std::chrono::steady_clock::now() - scheduled_at)
+                      .count());
+            }));
+      }
+      for (auto& task : tasks) task.Get();
+      tasks.clear();
+
+      engine::SleepFor(pause);
+    }
+    const auto cpu_time = std::clock() - cpu_time_start;
+
+    state.SetItemsProcessed(state.iterations() * batch_size);
+    state.counters["p50-latency-us"] = latencies.GetPercentile(50);
+    state.counters["p99-latency-us"] = latencies.GetPercentile(99);
+    state.counters["cpu-ms-per-iteration"] =
+        static_cast<double>(cpu_time) * 1000 / CLOCKS_PER_SEC /
+        state.iterations();
+  });
+}
+BENCHMARK_CAPTURE(engine_task_idle_wakeup, fixed_spinning, false)
+    ->Args({1, 50})
+    ->Args({1, 1000})
+    ->Args({64, 2000})
+    ->Args({64, 20000});
+BENCHMARK_CAPTURE(engine_task_idle_wakeup, adaptive_spinning, true)
+    ->Args({1, 50})
+    ->Args({1, 1000})
+    ->Args({64, 2000})
+    ->Args({64, 20000});
+
 void engine_task_yield_multiple_task_processors(benchmark::State& state) {
   engine::RunStandalone([&] {
     auto tp_pool = engine::SingleThreadedTaskProcessorsPool::MakeForTests(
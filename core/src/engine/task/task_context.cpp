@@ -1,6 +1,7 @@
 #include "task_context.hpp"
 
 #include <exception>
+#include <thread>
 #include <utility>
 
 #include <fmt/format.h>
@@ -16,7 +17,6 @@
 #include <userver/utils/underlying_value.hpp>
 
 #include <compiler/tls.hpp>
-#include <engine/ev/thread_pool.hpp>
 #include <engine/impl/generic_wait_list.hpp>
 #include <engine/task/coro_unwinder.hpp>
 #include <engine/task/cxxabi_eh_globals.hpp>
@@ -98,15 +98,19 @@ constexpr SleepState MakeNextEpochSleepState(SleepState::Epoch current) {
 auto* const kFinishedDetachedToken =
     reinterpret_cast<DetachedTasksSyncBlock::Token*>(1);
 
+auto* const kBusyCancellationListeners =
+    reinterpret_cast<CancellationListener*>(1);
+
 }  // namespace
 
 TaskContext::TaskContext(TaskProcessor& task_processor,
-                         Task::Importance importance, Task::WaitMode wait_type,
-                         Deadline deadline,
+                         Task::Importance importance, Task::Priority priority,
+                         Task::WaitMode wait_type, Deadline deadline,
                          utils::impl::WrappedCallBase& payload)
     : task_processor_(task_processor),
       task_counter_token_(task_processor_.GetTaskCounter()),
       is_critical_(importance == Task::Importance::kCritical),
+      priority_(priority),
       payload_(&payload),
       finish_waiters_(wait_type),
       cancel_deadline_(deadline),
@@ -128,6 +132,7 @@ TaskContext::~TaskContext() noexcept {
           detached_token_ == kFinishedDetachedToken);
 
   UASSERT(payload_ == nullptr);
+  UASSERT(cancellation_listeners_.load() == nullptr);
 }
 
 utils::impl::WrappedCallBase& TaskContext::GetPayload() noexcept {
@@ -286,9 +291,68 @@ void TaskContext::RequestCancel(TaskCancellationReason reason) {
                 << logging::LogExtra::Stacktrace();
     const auto epoch = GetEpoch();
     Wakeup(WakeupSource::kCancelRequest, epoch);
+
+    // Pairs with the load of cancellation_reason_ in AddCancellationListener
+    if (cancellation_listeners_.load() != nullptr) {
+      NotifyCancellationListeners(reason);
+    }
+  }
+}
+
+void TaskContext::AddCancellationListener(CancellationListener& listener) {
+  UASSERT(!listener.next_listener_);
+  listener.next_listener_ = TakeCancellationListeners();
+  PutCancellationListeners(&listener);
+
+  // RequestCancel may notify the listener too if it runs concurrently, the
+  // listeners tolerate that
+  const auto reason = cancellation_reason_.load();
+  if (reason != TaskCancellationReason::kNone) listener.OnCancel(reason);
+}
+
+void TaskContext::RemoveCancellationListener(
+    CancellationListener& listener) noexcept {
+  auto* listeners = TakeCancellationListeners();
+  auto** link = &listeners;
+  while (*link != &listener) {
+    UASSERT_MSG(*link, "The listener is not registered");
+    link = &(*link)->next_listener_;
+  }
+  *link = listener.next_listener_;
+  listener.next_listener_ = nullptr;
+  PutCancellationListeners(listeners);
+}
+
+CancellationListener* TaskContext::TakeCancellationListeners() noexcept {
+  // Only held for a few pointer updates or for the single notification of
+  // the task, so a concurrent holder is waited for by spinning
+  while (true) {
+    auto* const listeners =
+        cancellation_listeners_.exchange(kBusyCancellationListeners);
+    if (listeners != kBusyCancellationListeners) return listeners;
+    std::this_thread::yield();
   }
 }
 
+void TaskContext::PutCancellationListeners(
+    CancellationListener* listeners) noexcept {
+  UASSERT(listeners != kBusyCancellationListeners);
+  cancellation_listeners_.store(listeners);
+}
+
+void TaskContext::NotifyCancellationListeners(
+    TaskCancellationReason reason) noexcept {
+  // The list stays taken while the listeners are notified, so that they are
+  // not removed and destroyed meanwhile. Only the list of this task is held,
+  // the children take their own lists in turn.
+  auto* const listeners = TakeCancellationListeners();
+  for (auto* listener = listeners; listener;
+       listener = listener->next_listener_) {
+    listener->OnCancel(reason);
+  }
+  PutCancellationListeners(listeners);
+}
+
 bool TaskContext::IsCancellable() const noexcept { return is_cancellable_; }
 
 bool TaskContext::SetCancellable(bool value) {
@@ -356,9 +420,8 @@ void TaskContext::ArmTimer(Deadline deadline, Func&& func) {
   if (deadline_timer_.WasStarted()) {
     deadline_timer_.Restart(std::forward<Func>(func), deadline);
   } else {
-    deadline_timer_.Start(boost::intrusive_ptr{this},
-                          task_processor_.EventThreadPool().NextTimerThread(),
-                          std::forward<Func>(func), deadline);
+    deadline_timer_.Start(boost::intrusive_ptr{this}, std::forward<Func>(func),
+                          deadline);
   }
 }
 
@@ -390,7 +453,8 @@ bool TaskContext::ShouldSchedule(SleepState::Flags prev_flags,
      */
     return prev_flags == SleepFlags::kSleeping;
   } else if (source == WakeupSource::kBootstrap) {
-    return true;
+    // Already done by MarkQueuedInBatch()
+    return !(prev_flags & SleepFlags::kWakeupByBootstrap);
   } else {
     if (prev_flags & SleepFlags::kNonCancellable) {
       /* If there was a cancellation request, but cancellation is blocked,
@@ -467,6 +531,18 @@ void TaskContext::Wakeup(WakeupSource source, NoEpoch) {
   }
 }
 
+void TaskContext::MarkQueuedInBatch() {
+  UASSERT(!coro_);
+  [[maybe_unused]] const auto prev_sleep_state =
+      sleep_state_.FetchOrFlags<std::memory_order_seq_cst>(
+          SleepFlags::kWakeupByBootstrap);
+  UASSERT(ShouldSchedule(prev_sleep_state.flags, WakeupSource::kBootstrap));
+
+  UASSERT(state_ != Task::State::kQueued);
+  SetState(Task::State::kQueued);
+  TraceStateTransition(Task::State::kQueued);
+}
+
 void TaskContext::WakeupCurrent() {
   UASSERT(IsCurrent());
   UASSERT(GetState() == Task::State::kRunning);
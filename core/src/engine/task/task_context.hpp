@@ -61,6 +61,21 @@ class WaitStrategy {
   const Deadline deadline_;
 };
 
+// Is notified when a task is cancelled, e.g. to cancel the children of
+// an engine::TaskGroup along with their parent
+class CancellationListener {
+ public:
+  virtual void OnCancel(TaskCancellationReason reason) noexcept = 0;
+
+ protected:
+  ~CancellationListener() = default;
+
+ private:
+  friend class TaskContext;
+
+  CancellationListener* next_listener_{nullptr};
+};
+
 class TaskContext final : public ContextAccessor {
  public:
   struct NoEpoch {};
@@ -78,8 +93,8 @@ class TaskContext final : public ContextAccessor {
     kBootstrap = static_cast<uint32_t>(SleepFlags::kWakeupByBootstrap),
   };
 
-  TaskContext(TaskProcessor&, Task::Importance, Task::WaitMode, Deadline,
-              utils::impl::WrappedCallBase& payload);
+  TaskContext(TaskProcessor&, Task::Importance, Task::Priority,
+              Task::WaitMode, Deadline, utils::impl::WrappedCallBase& payload);
 
   ~TaskContext() noexcept;
 
@@ -100,6 +115,8 @@ class TaskContext final : public ContextAccessor {
   // exceeding these limits causes task to become cancelled
   bool IsCritical() const;
 
+  Task::Priority GetPriority() const noexcept { return priority_; }
+
   // whether task is allowed to be awaited from multiple coroutines
   // simultaneously
   bool IsSharedWaitAllowed() const;
@@ -124,6 +141,11 @@ class TaskContext final : public ContextAccessor {
   // normally non-blocking, causes wakeup
   void RequestCancel(TaskCancellationReason);
 
+  // The listener is notified immediately if the task is already cancelled.
+  // It must be removed before it is destroyed.
+  void AddCancellationListener(CancellationListener& listener);
+  void RemoveCancellationListener(CancellationListener& listener) noexcept;
+
   TaskCancellationReason CancellationReason() const noexcept {
     return cancellation_reason_;
   }
@@ -155,6 +177,10 @@ class TaskContext final : public ContextAccessor {
   void Wakeup(WakeupSource, NoEpoch);
   void WakeupCurrent();
 
+  // Does the kBootstrap wakeup of a not yet started task without scheduling
+  // it, the task is then queued by TaskProcessor::ScheduleBatch
+  void MarkQueuedInBatch();
+
   static void CoroFunc(TaskPipe& task_pipe);
 
   // C++ ABI support, not to be used by anyone
@@ -212,12 +238,17 @@ class TaskContext final : public ContextAccessor {
 
   void ResetPayload() noexcept;
 
+  CancellationListener* TakeCancellationListeners() noexcept;
+  void PutCancellationListeners(CancellationListener* listeners) noexcept;
+  void NotifyCancellationListeners(TaskCancellationReason reason) noexcept;
+
   const uint64_t magic_{kMagic};
   TaskProcessor& task_processor_;
   TaskCounter::Token task_counter_token_;
   const bool is_critical_;
   bool is_cancellable_{true};
   bool within_sleep_{false};
+  const Task::Priority priority_;
   EhGlobals eh_globals_;
 
   utils::impl::WrappedCallBase* payload_;
@@ -228,6 +259,11 @@ class TaskContext final : public ContextAccessor {
       TaskCancellationReason::kNone};
   mutable FastPimplGenericWaitList finish_waiters_;
 
+  // Singly linked list of the listeners, kBusyCancellationListeners while
+  // it is modified or notified. A task without listeners is cancelled
+  // without taking it.
+  std::atomic<CancellationListener*> cancellation_listeners_{nullptr};
+
   ContextTimer deadline_timer_;
   engine::Deadline cancel_deadline_;
 
@@ -127,6 +127,29 @@ Rate TaskCounter::GetSpuriousWakeups() const noexcept {
   return GetApproximate(LocalCounterId::kSpuriousWakeups);
 }
 
+Rate TaskCounter::GetQueueWaitTimeUs(
+    TaskBase::Priority priority) const noexcept {
+  return GetApproximate(
+      ForPriority(LocalCounterId::kQueueWaitTimeLatencyCritical, priority));
+}
+
+Rate TaskCounter::GetQueueWaitSamples(
+    TaskBase::Priority priority) const noexcept {
+  return GetApproximate(
+      ForPriority(LocalCounterId::kQueueWaitSamplesLatencyCritical, priority));
+}
+
+Rate TaskCounter::GetIdleWakeups(WakeupKind kind) const noexcept {
+  return GetApproximate(static_cast<LocalCounterId>(
+      static_cast<std::size_t>(LocalCounterId::kIdleWakeupsSpin) +
+      static_cast<std::size_t>(kind)));
+}
+
+Rate TaskCounter::GetIdleTimeBucket(WakeupKind kind,
+                                    std::size_t bucket) const noexcept {
+  return GetApproximate(ForIdleTimeBucket(kind, bucket));
+}
+
 void TaskCounter::AccountTaskCancel() noexcept {
   Increment(LocalCounterId::kCancelled);
 }
@@ -159,6 +182,45 @@ void TaskCounter::AccountSpuriousWakeup() noexcept {
   Increment(LocalCounterId::kSpuriousWakeups);
 }
 
+void TaskCounter::AccountQueueWait(
+    TaskBase::Priority priority, std::chrono::microseconds wait_time) noexcept {
+  const auto wait_time_us =
+      std::max(wait_time, std::chrono::microseconds::zero()).count();
+  Add(ForPriority(LocalCounterId::kQueueWaitTimeLatencyCritical, priority),
+      Rate{static_cast<Rate::ValueType>(wait_time_us)});
+  Increment(
+      ForPriority(LocalCounterId::kQueueWaitSamplesLatencyCritical, priority));
+}
+
+void TaskCounter::AccountIdleWakeup(
+    WakeupKind kind, std::chrono::nanoseconds idle_time) noexcept {
+  std::size_t bucket = 0;
+  while (bucket < kIdleTimeBucketBounds.size() &&
+         idle_time > kIdleTimeBucketBounds[bucket]) {
+    ++bucket;
+  }
+  Increment(static_cast<LocalCounterId>(
+      static_cast<std::size_t>(LocalCounterId::kIdleWakeupsSpin) +
+      static_cast<std::size_t>(kind)));
+  Increment(ForIdleTimeBucket(kind, bucket));
+}
+
+TaskCounter::LocalCounterId TaskCounter::ForPriority(
+    LocalCounterId latency_critical_id, TaskBase::Priority priority) noexcept {
+  static_assert(static_cast<int>(TaskBase::Priority::kLatencyCritical) == 0);
+  return static_cast<LocalCounterId>(
+      static_cast<std::size_t>(latency_critical_id) +
+      static_cast<std::size_t>(priority));
+}
+
+TaskCounter::LocalCounterId TaskCounter::ForIdleTimeBucket(
+    WakeupKind kind, std::size_t bucket) noexcept {
+  UASSERT(bucket < kIdleTimeBucketsCount);
+  return static_cast<LocalCounterId>(
+      static_cast<std::size_t>(LocalCounterId::kIdleTimeBucketsBegin) +
+      static_cast<std::size_t>(kind) * kIdleTimeBucketsCount + bucket);
+}
+
 Rate TaskCounter::GetApproximate(LocalCounterId id) const noexcept {
   Rate total;
   for (const auto& local_counters_block : local_counters_) {
@@ -172,12 +234,14 @@ Rate TaskCounter::GetApproximate(GlobalCounterId id) const noexcept {
          GetApproximate(static_cast<LocalCounterId>(id));
 }
 
-void TaskCounter::Increment(LocalCounterId id) noexcept {
+void TaskCounter::Increment(LocalCounterId id) noexcept { Add(id, Rate{1}); }
+
+void TaskCounter::Add(LocalCounterId id, Rate value) noexcept {
   const auto local_data = GetLocalTaskCounterData();
   UASSERT(local_data.local_counter == this);
   auto& counter = (*local_counters_[local_data.task_processor_thread_index])
       [static_cast<std::size_t>(id)];
-  counter.Store(counter.Load() + Rate{1});
+  counter.Store(counter.Load() + value);
 }
 
 void TaskCounter::Increment(GlobalCounterId id) noexcept {
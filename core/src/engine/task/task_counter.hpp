@@ -7,6 +7,7 @@
 #include <cstdint>
 
 #include <concurrent/impl/interference_shield.hpp>
+#include <userver/engine/task/task_base.hpp>
 #include <userver/utils/fixed_array.hpp>
 #include <userver/utils/statistics/rate_counter.hpp>
 
@@ -21,6 +22,25 @@ class TaskCounter final {
   class Token;
   class CoroToken;
 
+  // How an idle worker got its next task
+  enum class WakeupKind : std::size_t {
+    kSpin,
+    kSleep,
+  };
+
+  static constexpr std::size_t kWakeupKindsCount = 2;
+
+  // Upper bounds of the worker idle time histogram buckets, the last bucket
+  // is unbounded
+  static constexpr std::array<std::chrono::microseconds, 4>
+      kIdleTimeBucketBounds{std::chrono::microseconds{10},
+                            std::chrono::microseconds{100},
+                            std::chrono::milliseconds{1},
+                            std::chrono::milliseconds{10}};
+
+  static constexpr std::size_t kIdleTimeBucketsCount =
+      kIdleTimeBucketBounds.size() + 1;
+
   explicit TaskCounter(std::size_t thread_count);
 
   ~TaskCounter();
@@ -55,6 +75,17 @@ class TaskCounter final {
 
   Rate GetSpuriousWakeups() const noexcept;
 
+  // Total queue wait time of the sampled tasks of the given priority class
+  Rate GetQueueWaitTimeUs(TaskBase::Priority priority) const noexcept;
+
+  Rate GetQueueWaitSamples(TaskBase::Priority priority) const noexcept;
+
+  Rate GetIdleWakeups(WakeupKind kind) const noexcept;
+
+  // Number of idle periods that ended with a wakeup of the given kind and
+  // fell into the given bucket of kIdleTimeBucketBounds
+  Rate GetIdleTimeBucket(WakeupKind kind, std::size_t bucket) const noexcept;
+
   void AccountTaskCancel() noexcept;
 
   void AccountTaskCancelOverload() noexcept;
@@ -71,6 +102,13 @@ class TaskCounter final {
 
   void AccountSpuriousWakeup() noexcept;
 
+  void AccountQueueWait(TaskBase::Priority priority,
+                        std::chrono::microseconds wait_time) noexcept;
+
+  // Called by a worker that has got a task after being idle for `idle_time`
+  void AccountIdleWakeup(WakeupKind kind,
+                         std::chrono::nanoseconds idle_time) noexcept;
+
  private:
   // Counters that may be mutated from outside the bound TaskProcessor.
   enum class GlobalCounterId : std::size_t {
@@ -96,7 +134,21 @@ class TaskCounter final {
     kOverloadSensor,
     kNoOverloadSensor,
 
-    kCountersSize,
+    kQueueWaitTimeLatencyCritical,
+    kQueueWaitTimeNormal,
+    kQueueWaitTimeBackground,
+    kQueueWaitSamplesLatencyCritical,
+    kQueueWaitSamplesNormal,
+    kQueueWaitSamplesBackground,
+
+    kIdleWakeupsSpin,
+    kIdleWakeupsSleep,
+    // kIdleTimeBucketsCount buckets for each of the WakeupKind
+    kIdleTimeBucketsBegin,
+    kIdleTimeBucketsEnd =
+        kIdleTimeBucketsBegin + kWakeupKindsCount * kIdleTimeBucketsCount,
+
+    kCountersSize = kIdleTimeBucketsEnd,
   };
 
   static constexpr auto kLocalCountersSize =
@@ -113,12 +165,21 @@ class TaskCounter final {
       std::array<concurrent::impl::InterferenceShield<Counter>,
                  kGlobalCountersSize>;
 
+  // Maps a per-priority counter group to the counter of the given priority
+  static LocalCounterId ForPriority(LocalCounterId latency_critical_id,
+                                    TaskBase::Priority priority) noexcept;
+
+  static LocalCounterId ForIdleTimeBucket(WakeupKind kind,
+                                          std::size_t bucket) noexcept;
+
   Rate GetApproximate(LocalCounterId) const noexcept;
 
   Rate GetApproximate(GlobalCounterId) const noexcept;
 
   void Increment(LocalCounterId) noexcept;
 
+  void Add(LocalCounterId, Rate) noexcept;
+
   void Increment(GlobalCounterId) noexcept;
 
   GlobalCounterPack global_counters_;
@@ -0,0 +1,71 @@
+#include <userver/utest/utest.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include <userver/engine/async.hpp>
+#include <userver/engine/sleep.hpp>
+#include <userver/engine/task/task_with_result.hpp>
+#include <userver/utils/async.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+using Priority = engine::Task::Priority;
+
+constexpr std::ptrdiff_t kTasksPerPriority = 10;
+
+}  // namespace
+
+UTEST(TaskPriority, HigherPriorityGoesFirst) {
+  std::vector<Priority> order;
+  std::vector<engine::TaskWithResult<void>> tasks;
+
+  // The tasks can not start until the current task blocks on a single worker
+  for (const auto priority : {Priority::kBackground, Priority::kNormal,
+                              Priority::kLatencyCritical}) {
+    for (std::ptrdiff_t i = 0; i < kTasksPerPriority; ++i) {
+      tasks.push_back(engine::AsyncNoSpan(
+          priority, [&order, priority] { order.push_back(priority); }));
+    }
+  }
+  for (auto& task : tasks) task.Get();
+
+  ASSERT_EQ(order.size(), static_cast<std::size_t>(kTasksPerPriority * 3));
+
+  // Aging lets at most a couple of lower priority tasks go ahead
+  const auto first_batch_end = order.begin() + kTasksPerPriority;
+  EXPECT_GE(std::count(order.begin(), first_batch_end,
+                       Priority::kLatencyCritical),
+            kTasksPerPriority - 2);
+  EXPECT_EQ(order.back(), Priority::kBackground);
+}
+
+UTEST(TaskPriority, BackgroundIsNotStarved) {
+  std::atomic<bool> background_done{false};
+
+  std::vector<engine::TaskWithResult<void>> busy_tasks;
+  for (std::size_t i = 0; i < 2; ++i) {
+    busy_tasks.push_back(
+        engine::AsyncNoSpan(Priority::kLatencyCritical, [&background_done] {
+          while (!background_done) engine::Yield();
+        }));
+  }
+
+  auto background_task = engine::AsyncNoSpan(
+      Priority::kBackground, [&background_done] { background_done = true; });
+
+  background_task.Get();
+  for (auto& task : busy_tasks) task.Get();
+  EXPECT_TRUE(background_done);
+}
+
+UTEST(TaskPriority, UtilsAsync) {
+  auto task =
+      utils::Async("background", Priority::kBackground, [] { return 42; });
+  EXPECT_EQ(task.Get(), 42);
+}
+
+USERVER_NAMESPACE_END
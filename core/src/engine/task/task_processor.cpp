@@ -1,6 +1,7 @@
 #include "task_processor.hpp"
 
 #include <sys/types.h>
+#include <algorithm>
 #include <csignal>
 
 #include <fmt/format.h>
@@ -25,7 +26,11 @@ namespace {
 void SetTaskQueueWaitTimepoint(impl::TaskContext* context) {
   static constexpr size_t kTaskTimestampInterval = 4;
   thread_local size_t task_count = 0;
-  if (task_count++ == kTaskTimestampInterval) {
+  // Tasks of non-default priority classes are usually rare, always sample them
+  // to keep their queue wait time statistics meaningful.
+  if (context->GetPriority() != Task::Priority::kNormal) {
+    context->SetQueueWaitTimepoint(std::chrono::steady_clock::now());
+  } else if (task_count++ == kTaskTimestampInterval) {
     task_count = 0;
     context->SetQueueWaitTimepoint(std::chrono::steady_clock::now());
   } else {
@@ -53,6 +58,19 @@ void EmitMagicNanosleep() {
   nanosleep(&ts, nullptr);
 }
 
+std::variant<TaskQueue, WorkStealingTaskQueue> MakeTaskQueue(
+    const TaskProcessorConfig& config, impl::TaskCounter& task_counter) {
+  switch (config.task_processor_queue) {
+    case TaskQueueType::kGlobalTaskQueue:
+      return std::variant<TaskQueue, WorkStealingTaskQueue>{
+          std::in_place_type<TaskQueue>, config, task_counter};
+    case TaskQueueType::kWorkStealingTaskQueue:
+      return std::variant<TaskQueue, WorkStealingTaskQueue>{
+          std::in_place_type<WorkStealingTaskQueue>, config, task_counter};
+  }
+  UINVARIANT(false, "Unexpected task processor queue type");
+}
+
 void TaskProcessorThreadStartedHook() {
   utils::impl::AssertStaticRegistrationFinished();
   (void)utils::DefaultRandom();
@@ -67,8 +85,10 @@ void TaskProcessorThreadStartedHook() {
 TaskProcessor::TaskProcessor(TaskProcessorConfig config,
                              std::shared_ptr<impl::TaskProcessorPools> pools)
     : task_counter_(config.worker_threads),
-      task_queue_(config),
+      task_queue_(MakeTaskQueue(config, task_counter_)),
+      timer_wheels_(config.worker_threads),
       config_(std::move(config)),
+      thread_placement_(config_.cpu_affinity, config_.numa_node),
       pools_(std::move(pools)) {
   utils::impl::FinishStaticRegistration();
   try {
@@ -82,7 +102,7 @@ TaskProcessor::TaskProcessor(TaskProcessorConfig config,
       workers_.emplace_back([this, i, &workers_left] {
         PrepareWorkerThread(i);
         workers_left.count_down();
-        ProcessTasks();
+        ProcessTasks(i);
       });
     }
     workers_left.wait();
@@ -100,7 +120,7 @@ void TaskProcessor::Cleanup() noexcept {
   // Some tasks may be bound but not scheduled yet
   task_counter_.WaitForExhaustion();
 
-  task_queue_.StopProcessing();
+  std::visit([](auto& queue) { queue.StopProcessing(); }, task_queue_);
 
   for (auto& w : workers_) {
     w.join();
@@ -116,6 +136,18 @@ void TaskProcessor::InitiateShutdown() {
 
 void TaskProcessor::Schedule(impl::TaskContext* context) {
   UASSERT(context);
+  PrepareToQueue(context);
+  std::visit([context](auto& queue) { queue.Push(context); }, task_queue_);
+}
+
+void TaskProcessor::ScheduleBatch(
+    std::vector<boost::intrusive_ptr<impl::TaskContext>>& contexts) {
+  for (const auto& context : contexts) PrepareToQueue(context.get());
+  std::visit([&contexts](auto& queue) { queue.PushBatch(contexts); },
+             task_queue_);
+}
+
+void TaskProcessor::PrepareToQueue(impl::TaskContext* context) {
   if (max_task_queue_wait_length_ && !context->IsCritical()) {
     const auto queue_size = GetTaskQueueSize();
     if (queue_size >= max_task_queue_wait_length_) {
@@ -130,8 +162,6 @@ void TaskProcessor::Schedule(impl::TaskContext* context) {
     context->RequestCancel(TaskCancellationReason::kShutdown);
 
   SetTaskQueueWaitTimepoint(context);
-
-  task_queue_.Push(context);
 }
 
 void TaskProcessor::Adopt(impl::TaskContext& context) {
@@ -143,7 +173,18 @@ ev::ThreadPool& TaskProcessor::EventThreadPool() {
 }
 
 impl::CountedCoroutinePtr TaskProcessor::GetCoroutine() {
-  return {pools_->GetCoroPool().GetCoroutine(), *this};
+  return {pools_->GetCoroPool().GetCoroutine(config_.coro_stack_size_class),
+          *this};
+}
+
+std::size_t TaskProcessor::GetCoroStackSize() const {
+  return pools_->GetCoroPool().GetStackSize(config_.coro_stack_size_class);
+}
+
+size_t TaskProcessor::GetTaskQueueSize() const {
+  return std::visit(
+      [](const auto& queue) { return queue.GetSizeApproximate(); },
+      task_queue_);
 }
 
 void TaskProcessor::SetSettings(const TaskProcessorSettings& settings) {
@@ -218,6 +259,8 @@ void RegisterThreadStartedHook(std::function<void()> func) {
 }
 
 void TaskProcessor::PrepareWorkerThread(std::size_t index) noexcept {
+  thread_placement_.Apply();
+
   switch (config_.os_scheduling) {
     case OsScheduling::kNormal:
       break;
@@ -232,13 +275,19 @@ void TaskProcessor::PrepareWorkerThread(std::size_t index) noexcept {
   utils::SetCurrentThreadName(fmt::format("{}_{}", config_.thread_name, index));
 
   impl::SetLocalTaskCounterData(task_counter_, index);
+  impl::SetCurrentWorkerTimerWheel(timer_wheels_[index]);
+
+  if (auto* queue = std::get_if<WorkStealingTaskQueue>(&task_queue_)) {
+    queue->PrepareWorker(index);
+  }
 
   TaskProcessorThreadStartedHook();
 }
 
-void TaskProcessor::ProcessTasks() noexcept {
+void TaskProcessor::ProcessTasks(std::size_t index) noexcept {
+  auto& timer_wheel = timer_wheels_[index];
   while (true) {
-    auto context = task_queue_.PopBlocking();
+    auto context = PopTask(timer_wheel);
     if (!context) break;
 
     GetTaskCounter().AccountTaskSwitchSlow();
@@ -258,18 +307,80 @@ void TaskProcessor::ProcessTasks() noexcept {
   }
 }
 
+boost::intrusive_ptr<impl::TaskContext> TaskProcessor::PopTask(
+    impl::WorkerTimerWheel& timer_wheel) {
+  while (true) {
+    try {
+      const auto now = impl::WorkerTimerWheel::Clock::now();
+      timer_wheel.ProcessExpired(now);
+      StealExpiredTimers(timer_wheel, now);
+    } catch (const std::exception& ex) {
+      LOG_ERROR() << "uncaught exception from timers: " << ex;
+    }
+
+    // Timers of the other wheels are only stolen between the tasks
+    const auto next_expiration = timer_wheel.GetNextExpiration();
+    if (!next_expiration) {
+      return std::visit([](auto& queue) { return queue.PopBlocking(); },
+                        task_queue_);
+    }
+
+    const auto timeout = std::max(
+        std::chrono::ceil<std::chrono::microseconds>(
+            *next_expiration - impl::WorkerTimerWheel::Clock::now()),
+        std::chrono::microseconds::zero());
+    auto context = std::visit(
+        [&timeout](auto& queue) { return queue.PopBlockingFor(timeout); },
+        task_queue_);
+    // Otherwise a timer has expired
+    if (context) return std::move(*context);
+  }
+}
+
+void TaskProcessor::StealExpiredTimers(
+    impl::WorkerTimerWheel& timer_wheel,
+    impl::WorkerTimerWheel::Clock::time_point now) {
+  // The owners of the other wheels may be stuck in long task steps. A single
+  // worker scans them at most once per kStealDelay to keep the task switches
+  // cheap.
+  auto& next_scan = *next_timers_steal_scan_;
+  auto next_scan_rep = next_scan.load(std::memory_order_relaxed);
+  if (now.time_since_epoch().count() < next_scan_rep) return;
+  const auto new_next_scan = now + impl::WorkerTimerWheel::kStealDelay;
+  if (!next_scan.compare_exchange_strong(
+          next_scan_rep, new_next_scan.time_since_epoch().count(),
+          std::memory_order_relaxed)) {
+    return;
+  }
+
+  for (auto& other_timer_wheel : timer_wheels_) {
+    if (&other_timer_wheel != &timer_wheel) {
+      other_timer_wheel.StealExpired(now);
+    }
+  }
+}
+
 void TaskProcessor::CheckWaitTime(impl::TaskContext& context) {
   const auto max_wait_time = max_task_queue_wait_time_.load();
   const auto sensor_wait_time = sensor_task_queue_wait_time_.load();
 
+  const auto wait_timepoint = context.GetQueueWaitTimepoint();
+  const bool has_wait_time =
+      wait_timepoint != std::chrono::steady_clock::time_point();
+  std::chrono::steady_clock::duration wait_time{};
+  if (has_wait_time) {
+    wait_time = std::chrono::steady_clock::now() - wait_timepoint;
+    GetTaskCounter().AccountQueueWait(
+        context.GetPriority(),
+        std::chrono::duration_cast<std::chrono::microseconds>(wait_time));
+  }
+
   if (max_wait_time.count() == 0 && sensor_wait_time.count() == 0) {
     SetTaskQueueWaitTimeOverloaded(false);
     return;
   }
 
-  const auto wait_timepoint = context.GetQueueWaitTimepoint();
-  if (wait_timepoint != std::chrono::steady_clock::time_point()) {
-    const auto wait_time = std::chrono::steady_clock::now() - wait_timepoint;
+  if (has_wait_time) {
     const auto wait_time_us =
         std::chrono::duration_cast<std::chrono::microseconds>(wait_time);
     LOG_TRACE() << "queue wait time = " << wait_time_us.count() << "us";
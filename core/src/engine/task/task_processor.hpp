@@ -5,16 +5,21 @@
 #include <functional>
 #include <memory>
 #include <thread>
+#include <variant>
 #include <vector>
 
 #include <boost/smart_ptr/intrusive_ptr.hpp>
 
 #include <concurrent/impl/interference_shield.hpp>
+#include <engine/impl/thread_placement.hpp>
+#include <engine/task/context_timer.hpp>
 #include <engine/task/task_counter.hpp>
 #include <engine/task/task_processor_config.hpp>
 #include <engine/task/task_queue.hpp>
+#include <engine/task/work_stealing_task_queue.hpp>
 #include <userver/engine/impl/detached_tasks_sync_block.hpp>
 #include <userver/logging/logger.hpp>
+#include <userver/utils/fixed_array.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
@@ -39,10 +44,17 @@ class TaskProcessor final {
 
   void Schedule(impl::TaskContext*);
 
+  // Pushes all the contexts into the task queue at once, see impl::TaskBatch.
+  // The contexts must already be marked as queued.
+  void ScheduleBatch(
+      std::vector<boost::intrusive_ptr<impl::TaskContext>>& contexts);
+
   void Adopt(impl::TaskContext& context);
 
   impl::CountedCoroutinePtr GetCoroutine();
 
+  std::size_t GetCoroStackSize() const;
+
   ev::ThreadPool& EventThreadPool();
 
   std::shared_ptr<impl::TaskProcessorPools> GetTaskProcessorPools() {
@@ -55,7 +67,7 @@ class TaskProcessor final {
 
   const impl::TaskCounter& GetTaskCounter() const { return task_counter_; }
 
-  size_t GetTaskQueueSize() const { return task_queue_.GetSizeApproximate(); }
+  size_t GetTaskQueueSize() const;
 
   size_t GetWorkerCount() const { return workers_.size(); }
 
@@ -78,12 +90,20 @@ class TaskProcessor final {
 
   void PrepareWorkerThread(std::size_t index) noexcept;
 
-  void ProcessTasks() noexcept;
+  void ProcessTasks(std::size_t index) noexcept;
+
+  boost::intrusive_ptr<impl::TaskContext> PopTask(
+      impl::WorkerTimerWheel& timer_wheel);
+
+  void StealExpiredTimers(impl::WorkerTimerWheel& timer_wheel,
+                          impl::WorkerTimerWheel::Clock::time_point now);
 
   void CheckWaitTime(impl::TaskContext& context);
 
   void SetTaskQueueWaitTimeOverloaded(bool new_value) noexcept;
 
+  void PrepareToQueue(impl::TaskContext* context);
+
   void HandleOverload(impl::TaskContext& context);
 
   impl::TaskCounter task_counter_;
@@ -91,9 +111,14 @@ class TaskProcessor final {
       detached_contexts_{impl::DetachedTasksSyncBlock::StopMode::kCancel};
   concurrent::impl::InterferenceShield<std::atomic<bool>>
       task_queue_wait_time_overloaded_{false};
-  TaskQueue task_queue_;
+  std::variant<TaskQueue, WorkStealingTaskQueue> task_queue_;
+  utils::FixedArray<impl::WorkerTimerWheel> timer_wheels_;
+  concurrent::impl::InterferenceShield<
+      std::atomic<impl::WorkerTimerWheel::Clock::rep>>
+      next_timers_steal_scan_{0};
 
   const TaskProcessorConfig config_;
+  const impl::ThreadPlacement thread_placement_;
   const std::shared_ptr<impl::TaskProcessorPools> pools_;
   std::vector<std::thread> workers_;
   logging::LoggerPtr task_trace_logger_{nullptr};
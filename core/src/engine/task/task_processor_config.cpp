@@ -2,6 +2,7 @@
 
 #include <cstdint>
 
+#include <hostinfo/cpu_list.hpp>
 #include <userver/formats/json/value.hpp>
 #include <userver/logging/log.hpp>
 #include <userver/utils/assert.hpp>
@@ -24,6 +25,29 @@ OsScheduling Parse(const yaml_config::YamlConfig& value,
   return utils::ParseFromValueString(value, kMap);
 }
 
+TaskQueueType Parse(const yaml_config::YamlConfig& value,
+                    formats::parse::To<TaskQueueType>) {
+  static constexpr utils::TrivialBiMap kMap([](auto selector) {
+    return selector()
+        .Case(TaskQueueType::kGlobalTaskQueue, "global-task-queue")
+        .Case(TaskQueueType::kWorkStealingTaskQueue,
+              "work-stealing-task-queue");
+  });
+
+  return utils::ParseFromValueString(value, kMap);
+}
+
+SpinningMode Parse(const yaml_config::YamlConfig& value,
+                   formats::parse::To<SpinningMode>) {
+  static constexpr utils::TrivialBiMap kMap([](auto selector) {
+    return selector()
+        .Case(SpinningMode::kFixed, "fixed")
+        .Case(SpinningMode::kAdaptive, "adaptive");
+  });
+
+  return utils::ParseFromValueString(value, kMap);
+}
+
 TaskProcessorConfig Parse(const yaml_config::YamlConfig& value,
                           formats::parse::To<TaskProcessorConfig>) {
   TaskProcessorConfig config;
@@ -35,6 +59,17 @@ TaskProcessorConfig Parse(const yaml_config::YamlConfig& value,
       value["os-scheduling"].As<OsScheduling>(config.os_scheduling);
   config.spinning_iterations =
       value["spinning-iterations"].As<int>(config.spinning_iterations);
+  config.spinning_mode =
+      value["spinning-mode"].As<SpinningMode>(config.spinning_mode);
+  config.task_processor_queue =
+      value["task-processor-queue"].As<TaskQueueType>(
+          config.task_processor_queue);
+  config.coro_stack_size_class =
+      value["coro-stack-size-class"].As<coro::StackSizeClass>(
+          config.coro_stack_size_class);
+  config.cpu_affinity = hostinfo::impl::ParseCpuList(
+      value["cpu-affinity"].As<std::string>(std::string{}));
+  config.numa_node = value["numa-node"].As<std::optional<std::size_t>>();
 
   const auto task_trace = value["task-trace"];
   if (!task_trace.IsMissing()) {
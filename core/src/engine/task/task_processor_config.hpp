@@ -3,8 +3,11 @@
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <optional>
 #include <string>
+#include <vector>
 
+#include <engine/coro/pool_config.hpp>
 #include <userver/formats/json_fwd.hpp>
 #include <userver/yaml_config/fwd.hpp>
 
@@ -21,6 +24,22 @@ enum class OsScheduling {
 OsScheduling Parse(const yaml_config::YamlConfig& value,
                    formats::parse::To<OsScheduling>);
 
+enum class TaskQueueType {
+  kGlobalTaskQueue,
+  kWorkStealingTaskQueue,
+};
+
+TaskQueueType Parse(const yaml_config::YamlConfig& value,
+                    formats::parse::To<TaskQueueType>);
+
+enum class SpinningMode {
+  kFixed,
+  kAdaptive,
+};
+
+SpinningMode Parse(const yaml_config::YamlConfig& value,
+                   formats::parse::To<SpinningMode>);
+
 struct TaskProcessorConfig {
   std::string name;
 
@@ -29,6 +48,11 @@ struct TaskProcessorConfig {
   std::string thread_name;
   OsScheduling os_scheduling{OsScheduling::kNormal};
   int spinning_iterations{10000};
+  SpinningMode spinning_mode{SpinningMode::kFixed};
+  TaskQueueType task_processor_queue{TaskQueueType::kGlobalTaskQueue};
+  coro::StackSizeClass coro_stack_size_class{coro::StackSizeClass::kNormal};
+  std::vector<std::size_t> cpu_affinity;
+  std::optional<std::size_t> numa_node;
 
   std::size_t task_trace_every{1000};
   std::size_t task_trace_max_csw{0};
@@ -1,17 +1,53 @@
 #include <engine/task/task_queue.hpp>
 
+#include <algorithm>
+
+#include <boost/iterator/filter_iterator.hpp>
+#include <boost/iterator/transform_iterator.hpp>
+
 #include <engine/task/task_context.hpp>
+#include <engine/task/worker_spinner.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
 namespace engine {
 
 namespace {
+
 constexpr std::size_t kSemaphoreInitialCount = 0;
+
+// Normal tasks go ahead of the latency-critical ones once in this many pops
+constexpr std::uint64_t kNormalAgingInterval = 8;
+
+// Background tasks go ahead of everything else once in this many pops
+constexpr std::uint64_t kBackgroundAgingInterval = 32;
+
+using Priority = TaskBase::Priority;
+
+constexpr std::array<Priority, 3> kDefaultOrder{
+    Priority::kLatencyCritical, Priority::kNormal, Priority::kBackground};
+
+constexpr std::array<Priority, 3> kNormalAgingOrder{
+    Priority::kNormal, Priority::kLatencyCritical, Priority::kBackground};
+
+constexpr std::array<Priority, 3> kBackgroundAgingOrder{
+    Priority::kBackground, Priority::kLatencyCritical, Priority::kNormal};
+
+const std::array<Priority, 3>& GetPopOrder(std::uint64_t pops_count) noexcept {
+  if (pops_count % kBackgroundAgingInterval == 0) return kBackgroundAgingOrder;
+  if (pops_count % kNormalAgingInterval == 0) return kNormalAgingOrder;
+  return kDefaultOrder;
 }
 
-TaskQueue::TaskQueue(const TaskProcessorConfig& config)
-    : queue_semaphore_(kSemaphoreInitialCount, config.spinning_iterations) {}
+}  // namespace
+
+TaskQueue::TaskQueue(const TaskProcessorConfig& config,
+                     impl::TaskCounter& task_counter)
+    : spinning_mode_(config.spinning_mode),
+      spinning_iterations_(config.spinning_iterations),
+      task_counter_(task_counter),
+      // Spinning is done by the WorkerSpinner
+      queue_semaphore_(kSemaphoreInitialCount, /*maxSpins=*/0) {}
 
 void TaskQueue::Push(boost::intrusive_ptr<impl::TaskContext>&& context) {
   UASSERT(context);
@@ -20,46 +56,131 @@ void TaskQueue::Push(boost::intrusive_ptr<impl::TaskContext>&& context) {
 }
 
 boost::intrusive_ptr<impl::TaskContext> TaskQueue::PopBlocking() {
-  // Current thread handles only a single TaskProcessor, so it's safe to store
-  // a token for the task processor in a thread-local variable.
-  thread_local moodycamel::ConsumerToken token(queue_);
+  WaitForTask(std::nullopt);
+  return PopAfterWait();
+}
 
-  boost::intrusive_ptr<impl::TaskContext> context{DoPopBlocking(token),
-                                                  /* add_ref= */ false};
+std::optional<boost::intrusive_ptr<impl::TaskContext>>
+TaskQueue::PopBlockingFor(std::chrono::microseconds timeout) {
+  if (!WaitForTask(timeout)) return std::nullopt;
+  return PopAfterWait();
+}
 
-  if (!context) {
-    // return "stop" token back
-    DoPush(nullptr);
+void TaskQueue::PushBatch(
+    std::vector<boost::intrusive_ptr<impl::TaskContext>>& contexts) {
+  if (contexts.empty()) return;
+
+  for (const auto priority : kDefaultOrder) {
+    const auto has_priority = [priority](const auto& context) {
+      UASSERT(context);
+      return context->GetPriority() == priority;
+    };
+    const auto count = static_cast<std::size_t>(
+        std::count_if(contexts.begin(), contexts.end(), has_priority));
+    if (count == 0) continue;
+
+    const auto first = boost::make_transform_iterator(
+        boost::make_filter_iterator(has_priority, contexts.begin(),
+                                    contexts.end()),
+        [](const auto& context) { return context.get(); });
+    GetQueue(priority).enqueue_bulk(first, count);
   }
 
-  return context;
+  for (auto& context : contexts) context.detach();
+  queue_semaphore_.signal(
+      static_cast<moodycamel::LightweightSemaphore::ssize_t>(contexts.size()));
 }
 
 void TaskQueue::StopProcessing() { DoPush(nullptr); }
 
 std::size_t TaskQueue::GetSizeApproximate() const noexcept {
-  return queue_.size_approx();
+  std::size_t size = 0;
+  for (const auto& queue : queues_) size += queue.size_approx();
+  return size;
 }
 
 void TaskQueue::DoPush(impl::TaskContext* context) {
+  // The "stop" token goes to the normal queue
+  const auto priority = context ? context->GetPriority() : Priority::kNormal;
+
   // This piece of code is copy-pasted from
   // moodycamel::BlockingConcurrentQueue::enqueue
-  queue_.enqueue(context);
+  GetQueue(priority).enqueue(context);
   queue_semaphore_.signal();
 }
 
-impl::TaskContext* TaskQueue::DoPopBlocking(moodycamel::ConsumerToken& token) {
+bool TaskQueue::WaitForTask(std::optional<std::chrono::microseconds> timeout) {
+  if (queue_semaphore_.tryWait()) return true;
+
+  // Current thread handles only a single TaskProcessor, so it's safe to store
+  // the spinner for the task processor in a thread-local variable.
+  thread_local impl::WorkerSpinner spinner(spinning_mode_,
+                                           spinning_iterations_);
+
+  const auto idle_start = impl::WorkerSpinner::Clock::now();
+  if (spinner.Spin(1, [this] { return queue_semaphore_.tryWait(); })) {
+    spinner.AccountWakeup(idle_start, impl::WorkerSpinner::WakeupKind::kSpin,
+                          task_counter_);
+    return true;
+  }
+
+  const bool acquired = timeout ? queue_semaphore_.wait(timeout->count())
+                                : queue_semaphore_.wait();
+  if (acquired) {
+    spinner.AccountWakeup(idle_start, impl::WorkerSpinner::WakeupKind::kSleep,
+                          task_counter_);
+  } else {
+    spinner.AccountTimeout(idle_start);
+  }
+  return acquired;
+}
+
+boost::intrusive_ptr<impl::TaskContext> TaskQueue::PopAfterWait() {
+  // Current thread handles only a single TaskProcessor, so it's safe to store
+  // tokens for the task processor in thread-local variables.
+  thread_local moodycamel::ConsumerToken latency_critical_token(
+      GetQueue(Priority::kLatencyCritical));
+  thread_local moodycamel::ConsumerToken normal_token(
+      GetQueue(Priority::kNormal));
+  thread_local moodycamel::ConsumerToken background_token(
+      GetQueue(Priority::kBackground));
+  thread_local std::uint64_t pops_count = 0;
+
+  ConsumerTokens tokens{&latency_critical_token, &normal_token,
+                        &background_token};
+  boost::intrusive_ptr<impl::TaskContext> context{DoPop(tokens, pops_count),
+                                                  /* add_ref= */ false};
+
+  if (!context) {
+    // return "stop" token back
+    DoPush(nullptr);
+  }
+
+  return context;
+}
+
+impl::TaskContext* TaskQueue::DoPop(ConsumerTokens& tokens,
+                                    std::uint64_t& pops_count) {
   impl::TaskContext* context{};
 
-  // This piece of code is copy-pasted from
-  // moodycamel::BlockingConcurrentQueue::wait_dequeue
-  queue_semaphore_.wait();
-  while (!queue_.try_dequeue(token, context)) {
+  // This piece of code is adapted from
+  // moodycamel::BlockingConcurrentQueue::wait_dequeue.
+  // The semaphore counts the items of all the queues together, so after a
+  // successful wait() one of the queues is guaranteed to contain an item for
+  // us.
+  const auto& order = GetPopOrder(++pops_count);
+  while (true) {
+    for (const auto priority : order) {
+      const auto index = static_cast<std::size_t>(priority);
+      if (queues_[index].try_dequeue(*tokens[index], context)) return context;
+    }
     // Can happen when another consumer steals our item in exchange for another
     // item in a Moodycamel sub-queue that we have already passed.
   }
+}
 
-  return context;
+TaskQueue::Queue& TaskQueue::GetQueue(Priority priority) noexcept {
+  return queues_[static_cast<std::size_t>(priority)];
 }
 
 }  // namespace engine
@@ -1,10 +1,18 @@
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
 #include <moodycamel/blockingconcurrentqueue.h>
 #include <moodycamel/lightweightsemaphore.h>
 #include <boost/smart_ptr/intrusive_ptr.hpp>
 
+#include <engine/task/task_counter.hpp>
 #include <engine/task/task_processor_config.hpp>
+#include <userver/engine/task/task_base.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
@@ -14,25 +22,57 @@ namespace impl {
 class TaskContext;
 }  // namespace impl
 
+/// Task queue shared by all the worker threads.
+///
+/// Keeps a separate FIFO for each TaskBase::Priority class. Higher classes are
+/// served first, but lower ones periodically go ahead of them, so that
+/// background tasks are not starved by a steady flow of latency-critical ones.
 class TaskQueue final {
  public:
-  explicit TaskQueue(const TaskProcessorConfig& config);
+  TaskQueue(const TaskProcessorConfig& config, impl::TaskCounter& task_counter);
 
   void Push(boost::intrusive_ptr<impl::TaskContext>&& context);
 
+  // Takes ownership of all the contexts, wakes up to `contexts.size()` workers
+  void PushBatch(
+      std::vector<boost::intrusive_ptr<impl::TaskContext>>& contexts);
+
   // Returns nullptr as a stop signal
   boost::intrusive_ptr<impl::TaskContext> PopBlocking();
 
+  // Same as PopBlocking(), but returns std::nullopt if no task arrives within
+  // the `timeout`
+  std::optional<boost::intrusive_ptr<impl::TaskContext>> PopBlockingFor(
+      std::chrono::microseconds timeout);
+
   void StopProcessing();
 
   std::size_t GetSizeApproximate() const noexcept;
 
  private:
+  static constexpr std::size_t kPrioritiesCount = 3;
+
+  using Queue = moodycamel::ConcurrentQueue<impl::TaskContext*>;
+  using ConsumerTokens =
+      std::array<moodycamel::ConsumerToken*, kPrioritiesCount>;
+
   void DoPush(impl::TaskContext* context);
 
-  impl::TaskContext* DoPopBlocking(moodycamel::ConsumerToken& token);
+  // Spin-waits and then sleeps until the semaphore is acquired. Returns false
+  // on timeout.
+  bool WaitForTask(std::optional<std::chrono::microseconds> timeout);
+
+  boost::intrusive_ptr<impl::TaskContext> PopAfterWait();
+
+  impl::TaskContext* DoPop(ConsumerTokens& tokens, std::uint64_t& pops_count);
+
+  Queue& GetQueue(TaskBase::Priority priority) noexcept;
+
+  const SpinningMode spinning_mode_;
+  const int spinning_iterations_;
+  impl::TaskCounter& task_counter_;
 
-  moodycamel::ConcurrentQueue<impl::TaskContext*> queue_;
+  std::array<Queue, kPrioritiesCount> queues_;
   moodycamel::LightweightSemaphore queue_semaphore_;
 };
 
@@ -3,6 +3,7 @@
 #include <array>
 #include <atomic>
 #include <chrono>
+#include <thread>
 
 #include <userver/engine/async.hpp>
 #include <userver/engine/condition_variable.hpp>
@@ -354,4 +355,20 @@ UTEST_MT(Task, ExceptionStorm, 8) {
   }
 }
 
+UTEST_MT(Task, TimerOfBlockedWorker, 2) {
+  // keep the current worker busy, so that the sleeper runs on the other one
+  auto sleeper = engine::AsyncNoSpan([] { engine::SleepFor(10ms); });
+  std::this_thread::sleep_for(5ms);
+
+  // the blocker is taken by the worker that has armed the sleeper timer
+  auto blocker =
+      engine::AsyncNoSpan([] { std::this_thread::sleep_for(500ms); });
+  std::this_thread::sleep_for(5ms);
+
+  // the timer is fired by the current worker
+  sleeper.WaitFor(250ms);
+  EXPECT_TRUE(sleeper.IsFinished());
+  blocker.Get();
+}
+
 USERVER_NAMESPACE_END
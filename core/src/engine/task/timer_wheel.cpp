@@ -0,0 +1,169 @@
+#include <engine/task/timer_wheel.hpp>
+
+#include <algorithm>
+
+#include <userver/utils/assert.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine::impl {
+
+namespace {
+
+int CountLeadingZeros(std::uint64_t value) noexcept {
+  UASSERT(value != 0);
+  return __builtin_clzll(value);
+}
+
+int CountTrailingZeros(std::uint64_t value) noexcept {
+  UASSERT(value != 0);
+  return __builtin_ctzll(value);
+}
+
+std::uint64_t RotateRight(std::uint64_t value, std::size_t shift) noexcept {
+  shift %= 64;
+  if (shift == 0) return value;
+  return (value >> shift) | (value << (64 - shift));
+}
+
+}  // namespace
+
+TimerWheel::TimerWheel(Clock::time_point start) noexcept : start_(start) {}
+
+TimerWheel::~TimerWheel() {
+  UASSERT_MSG(IsEmpty(), "TimerWheel is destroyed with active timers");
+}
+
+void TimerWheel::Insert(Entry& entry, Clock::time_point expiration,
+                        Clock::time_point now) noexcept {
+  UASSERT(!entry.IsLinked());
+
+  // Nothing was advanced while the wheel was empty, there is nothing to cascade
+  // either, so the slots may be based on the current time right away
+  const auto now_tick = ToTick(now);
+  if (IsEmpty()) elapsed_ = std::max(elapsed_, now_tick);
+
+  // Round up, so that the entry never expires too early
+  auto tick = ToTick(expiration);
+  if (ToTimePoint(tick) < expiration) ++tick;
+
+  // An entry for the current tick is expired by the next Advance()
+  entry.tick_ =
+      std::clamp(tick, elapsed_ + 1, std::max(elapsed_, now_tick) + kMaxTicks);
+  Place(entry);
+  ++size_;
+}
+
+void TimerWheel::Remove(Entry& entry) noexcept {
+  UASSERT(entry.IsLinked());
+  UASSERT(size_ != 0);
+
+  auto& level = levels_[entry.level_];
+  auto& list = level.slots[entry.slot_];
+  list.erase(List::s_iterator_to(entry));
+  if (list.empty()) level.occupied &= ~(std::uint64_t{1} << entry.slot_);
+  --size_;
+}
+
+void TimerWheel::Advance(Clock::time_point now, List& expired) noexcept {
+  const auto now_tick = ToTick(now);
+
+  while (const auto expiration = GetNextSlotExpiration()) {
+    if (expiration->tick > now_tick) break;
+
+    UASSERT(expiration->tick >= elapsed_);
+    elapsed_ = expiration->tick;
+
+    auto& level = levels_[expiration->level];
+    List slot_entries;
+    slot_entries.swap(level.slots[expiration->slot]);
+    level.occupied &= ~(std::uint64_t{1} << expiration->slot);
+
+    while (!slot_entries.empty()) {
+      auto& entry = slot_entries.front();
+      slot_entries.pop_front();
+      if (entry.tick_ <= elapsed_) {
+        expired.push_back(entry);
+        --size_;
+      } else {
+        // Cascade to a lower level
+        Place(entry);
+      }
+    }
+  }
+
+  elapsed_ = std::max(elapsed_, now_tick);
+}
+
+std::optional<TimerWheel::Clock::time_point> TimerWheel::GetNextExpiration()
+    const noexcept {
+  const auto expiration = GetNextSlotExpiration();
+  if (!expiration) return std::nullopt;
+  return ToTimePoint(expiration->tick);
+}
+
+std::uint64_t TimerWheel::ToTick(Clock::time_point time_point) const noexcept {
+  if (time_point <= start_) return 0;
+  return static_cast<std::uint64_t>((time_point - start_) / kTickDuration);
+}
+
+TimerWheel::Clock::time_point TimerWheel::ToTimePoint(
+    std::uint64_t tick) const noexcept {
+  return start_ + static_cast<std::int64_t>(tick) * kTickDuration;
+}
+
+std::optional<TimerWheel::Expiration> TimerWheel::GetNextSlotExpiration()
+    const noexcept {
+  // Entries of a lower level always expire before the ones of a higher level
+  for (std::size_t level_index = 0; level_index < kLevels; ++level_index) {
+    const auto& level = levels_[level_index];
+    if (level.occupied == 0) continue;
+
+    const auto slot_range = std::uint64_t{1} << (kLevelBits * level_index);
+    const auto level_range = slot_range << kLevelBits;
+    // The current slot of a level only holds the entries of the next
+    // revolution of the top level, so it is looked at last
+    const auto first_slot =
+        static_cast<std::size_t>((elapsed_ / slot_range + 1) % kSlotsPerLevel);
+    const auto slot = (static_cast<std::size_t>(CountTrailingZeros(
+                           RotateRight(level.occupied, first_slot))) +
+                       first_slot) %
+                      kSlotsPerLevel;
+
+    const auto level_start = elapsed_ & ~(level_range - 1);
+    auto tick = level_start + slot * slot_range;
+    if (tick <= elapsed_ && level_index != 0) {
+      // The slot holds entries of the next revolution of the top level
+      tick += level_range;
+    }
+    return Expiration{level_index, slot, std::max(tick, elapsed_)};
+  }
+  return std::nullopt;
+}
+
+void TimerWheel::Place(Entry& entry) noexcept {
+  UASSERT(entry.tick_ > elapsed_);
+
+  // An entry that is more than kMaxTicks away from a stale elapsed_ goes to the
+  // top level and is placed again when its slot is reached, Advance() only
+  // expires the entries that are actually due.
+
+  const auto masked = std::min((elapsed_ ^ entry.tick_) | (kSlotsPerLevel - 1),
+                               kMaxTicks - 1);
+  const auto significant_bit =
+      static_cast<std::size_t>(63 - CountLeadingZeros(masked));
+  const auto level_index = significant_bit / kLevelBits;
+  const auto slot = static_cast<std::size_t>(
+      (entry.tick_ >> (kLevelBits * level_index)) % kSlotsPerLevel);
+
+  entry.level_ = static_cast<std::uint8_t>(level_index);
+  entry.slot_ = static_cast<std::uint8_t>(slot);
+
+  auto& level = levels_[level_index];
+  level.slots[slot].push_back(entry);
+  level.occupied |= std::uint64_t{1} << slot;
+}
+
+}  // namespace engine::impl
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include <boost/intrusive/list.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine::impl {
+
+// Hierarchical timer wheel with a fixed tick.
+//
+// Each of the kLevels levels has kSlotsPerLevel slots, a slot of the level N
+// covers kSlotsPerLevel^N ticks. An entry is stored at the lowest level that
+// distinguishes its expiration tick from the current one and cascades to the
+// lower levels as the time goes by, so both Insert() and Remove() are O(1).
+//
+// Entries never expire earlier than requested and may expire at most one tick
+// later than requested. Expirations further than kMaxTicks from `now` are
+// capped.
+//
+// Not thread-safe.
+class TimerWheel final {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr std::chrono::microseconds kTickDuration{64};
+
+  class Entry {
+   public:
+    bool IsLinked() const noexcept { return hook_.is_linked(); }
+
+   private:
+    friend class TimerWheel;
+
+    boost::intrusive::list_member_hook<> hook_;
+    std::uint64_t tick_{0};
+    std::uint8_t level_{0};
+    std::uint8_t slot_{0};
+  };
+
+  using List = boost::intrusive::list<
+      Entry, boost::intrusive::constant_time_size<false>,
+      boost::intrusive::member_hook<Entry, boost::intrusive::list_member_hook<>,
+                                    &Entry::hook_>>;
+
+  explicit TimerWheel(Clock::time_point start = Clock::now()) noexcept;
+
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+  ~TimerWheel();
+
+  // The entry must not be linked into any TimerWheel.
+  void Insert(Entry& entry, Clock::time_point expiration,
+              Clock::time_point now) noexcept;
+
+  // The entry must be linked into this TimerWheel.
+  void Remove(Entry& entry) noexcept;
+
+  // Moves the entries that have expired by `now` to `expired`.
+  void Advance(Clock::time_point now, List& expired) noexcept;
+
+  // Returns the time point at which Advance() would expire an entry next
+  std::optional<Clock::time_point> GetNextExpiration() const noexcept;
+
+  bool IsEmpty() const noexcept { return size_ == 0; }
+
+  std::size_t GetSize() const noexcept { return size_; }
+
+ private:
+  static constexpr std::size_t kLevelBits = 6;
+  static constexpr std::size_t kSlotsPerLevel = 1 << kLevelBits;
+  static constexpr std::size_t kLevels = 6;
+  static constexpr std::uint64_t kMaxTicks =
+      (std::uint64_t{1} << (kLevelBits * kLevels)) - 1;
+
+  struct Level final {
+    std::uint64_t occupied{0};
+    std::array<List, kSlotsPerLevel> slots;
+  };
+
+  struct Expiration final {
+    std::size_t level;
+    std::size_t slot;
+    std::uint64_t tick;
+  };
+
+  std::uint64_t ToTick(Clock::time_point time_point) const noexcept;
+
+  Clock::time_point ToTimePoint(std::uint64_t tick) const noexcept;
+
+  std::optional<Expiration> GetNextSlotExpiration() const noexcept;
+
+  void Place(Entry& entry) noexcept;
+
+  const Clock::time_point start_;
+  std::uint64_t elapsed_{0};
+  std::size_t size_{0};
+  std::array<Level, kLevels> levels_;
+};
+
+}  // namespace engine::impl
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <engine/task/timer_wheel.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+using engine::impl::TimerWheel;
+using Clock = TimerWheel::Clock;
+
+using namespace std::chrono_literals;
+
+struct TestEntry final : TimerWheel::Entry {
+  Clock::time_point expiration;
+};
+
+const auto kStart = Clock::time_point{} + 1h;
+
+std::vector<TestEntry*> Advance(TimerWheel& wheel, Clock::time_point now) {
+  TimerWheel::List expired;
+  wheel.Advance(now, expired);
+
+  std::vector<TestEntry*> result;
+  while (!expired.empty()) {
+    result.push_back(&static_cast<TestEntry&>(expired.front()));
+    expired.pop_front();
+  }
+  return result;
+}
+
+}  // namespace
+
+TEST(TimerWheel, Empty) {
+  TimerWheel wheel{kStart};
+  EXPECT_TRUE(wheel.IsEmpty());
+  EXPECT_FALSE(wheel.GetNextExpiration());
+  EXPECT_TRUE(Advance(wheel, kStart + 1s).empty());
+}
+
+TEST(TimerWheel, ExpiresInOrder) {
+  TimerWheel wheel{kStart};
+  TestEntry near;
+  TestEntry far;
+  wheel.Insert(far, kStart + 10s, kStart);
+  wheel.Insert(near, kStart + 1ms, kStart);
+  EXPECT_EQ(wheel.GetSize(), 2);
+
+  EXPECT_TRUE(Advance(wheel, kStart + 999us).empty());
+  EXPECT_EQ(Advance(wheel, kStart + 1ms + TimerWheel::kTickDuration),
+            std::vector<TestEntry*>{&near});
+  EXPECT_FALSE(near.IsLinked());
+
+  const auto next_expiration = wheel.GetNextExpiration();
+  ASSERT_TRUE(next_expiration);
+  EXPECT_LE(*next_expiration, kStart + 10s);
+
+  EXPECT_TRUE(Advance(wheel, kStart + 9s).empty());
+  EXPECT_EQ(Advance(wheel, kStart + 11s), std::vector<TestEntry*>{&far});
+  EXPECT_TRUE(wheel.IsEmpty());
+}
+
+TEST(TimerWheel, Remove) {
+  TimerWheel wheel{kStart};
+  TestEntry entry;
+  wheel.Insert(entry, kStart + 5ms, kStart);
+  EXPECT_TRUE(entry.IsLinked());
+
+  wheel.Remove(entry);
+  EXPECT_FALSE(entry.IsLinked());
+  EXPECT_TRUE(wheel.IsEmpty());
+  EXPECT_TRUE(Advance(wheel, kStart + 1s).empty());
+}
+
+TEST(TimerWheel, ExpiredOnInsert) {
+  TimerWheel wheel{kStart};
+  EXPECT_TRUE(Advance(wheel, kStart + 1s).empty());
+
+  TestEntry entry;
+  wheel.Insert(entry, kStart, kStart + 1s);
+  EXPECT_EQ(Advance(wheel, kStart + 1s + TimerWheel::kTickDuration),
+            std::vector<TestEntry*>{&entry});
+}
+
+TEST(TimerWheel, InsertAfterIdle) {
+  TimerWheel wheel{kStart};
+  EXPECT_TRUE(Advance(wheel, kStart).empty());
+
+  const auto now = kStart + 24h;
+  TestEntry entry;
+  wheel.Insert(entry, now + 1ms, now);
+
+  const auto next_expiration = wheel.GetNextExpiration();
+  ASSERT_TRUE(next_expiration);
+  EXPECT_GE(*next_expiration, now + 1ms);
+  EXPECT_TRUE(Advance(wheel, now + 999us).empty());
+  EXPECT_EQ(Advance(wheel, now + 1ms + TimerWheel::kTickDuration),
+            std::vector<TestEntry*>{&entry});
+}
+
+TEST(TimerWheel, InsertFarAfterStaleAdvance) {
+  constexpr auto kDay = std::chrono::hours{24};
+
+  TimerWheel wheel{kStart};
+  TestEntry first;
+  wheel.Insert(first, kStart + 40 * kDay, kStart);
+
+  // Nothing has expired, so the wheel was not advanced for 30 days
+  const auto now = kStart + 30 * kDay;
+  TestEntry second;
+  wheel.Insert(second, now + 30 * kDay, now);
+
+  EXPECT_EQ(Advance(wheel, kStart + 40 * kDay + TimerWheel::kTickDuration),
+            std::vector<TestEntry*>{&first});
+  EXPECT_TRUE(Advance(wheel, now + 30 * kDay - 1ms).empty());
+  EXPECT_EQ(Advance(wheel, now + 30 * kDay + TimerWheel::kTickDuration),
+            std::vector<TestEntry*>{&second});
+  EXPECT_TRUE(wheel.IsEmpty());
+}
+
+TEST(TimerWheel, Randomized) {
+  constexpr std::size_t kEntries = 500;
+  constexpr std::size_t kSteps = 20000;
+
+  std::mt19937_64 rng{42};
+  TimerWheel wheel{kStart};
+  std::vector<TestEntry> entries(kEntries);
+  auto now = kStart;
+
+  for (std::size_t step = 0; step < kSteps; ++step) {
+    auto& entry = entries[rng() % entries.size()];
+    switch (rng() % 3) {
+      case 0: {
+        if (entry.IsLinked()) wheel.Remove(entry);
+        const auto max_delay = std::uint64_t{1} << (rng() % 53);
+        entry.expiration = now + std::chrono::nanoseconds(rng() % max_delay);
+        wheel.Insert(entry, entry.expiration, now);
+        break;
+      }
+      case 1:
+        if (entry.IsLinked()) wheel.Remove(entry);
+        break;
+      default: {
+        const auto next_expiration = wheel.GetNextExpiration();
+        if (next_expiration && rng() % 2) {
+          now = std::max(now, *next_expiration);
+        } else {
+          now += std::chrono::nanoseconds(rng() % (std::uint64_t{1} << 32));
+        }
+
+        for (const auto* expired : Advance(wheel, now)) {
+          ASSERT_LE(expired->expiration, now);
+        }
+        for (const auto& other : entries) {
+          if (other.IsLinked()) {
+            ASSERT_GT(other.expiration + TimerWheel::kTickDuration, now);
+          }
+        }
+      }
+    }
+  }
+
+  for (auto& entry : entries) {
+    if (entry.IsLinked()) wheel.Remove(entry);
+  }
+  EXPECT_TRUE(wheel.IsEmpty());
+}
+
+USERVER_NAMESPACE_END
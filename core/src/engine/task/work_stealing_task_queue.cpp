@@ -0,0 +1,398 @@
+#include <engine/task/work_stealing_task_queue.hpp>
+
+#include <algorithm>
+
+#include <compiler/tls.hpp>
+#include <engine/task/task_context.hpp>
+#include <userver/compiler/impl/constexpr.hpp>
+#include <userver/utils/assert.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine {
+
+namespace {
+
+constexpr std::size_t kSemaphoreInitialCount = 0;
+
+// The global queue is checked first once in this many pops, so that tasks
+// scheduled from outside of the workers are not starved by local wakeups.
+constexpr std::uint64_t kGlobalQueueCheckInterval = 61;
+
+// The background queue is checked first once in this many pops, so that
+// background tasks make progress even if the workers are never idle.
+constexpr std::uint64_t kBackgroundQueueCheckInterval = 127;
+
+// Limits the number of consecutive pops from the LIFO slot, so that two tasks
+// waking each other up do not starve the rest of the local run queue.
+constexpr std::size_t kMaxLifoStreak = 3;
+
+// Spinning workers re-check all the queues once in this many iterations.
+constexpr int kSpinCheckInterval = 64;
+
+struct CurrentWorkerData final {
+  const void* queue{nullptr};
+  void* worker{nullptr};
+};
+
+thread_local USERVER_IMPL_CONSTINIT CurrentWorkerData current_worker_data;
+
+USERVER_PREVENT_TLS_CACHING CurrentWorkerData GetCurrentWorkerData() noexcept {
+  return current_worker_data;
+}
+
+USERVER_PREVENT_TLS_CACHING void SetCurrentWorkerData(
+    CurrentWorkerData data) noexcept {
+  current_worker_data = data;
+}
+
+}  // namespace
+
+bool WorkStealingTaskQueue::LocalQueue::TryPush(
+    impl::TaskContext* context) noexcept {
+  const auto tail = tail_.load(std::memory_order_relaxed);
+  const auto head = head_.load(std::memory_order_acquire);
+  if (tail - head >= kCapacity) return false;
+
+  // The slot can not be read by a consumer that wins the head_ CAS: a reader
+  // of a stale head_ fails its CAS.
+  buffer_[tail % kCapacity].store(context, std::memory_order_relaxed);
+  tail_.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+impl::TaskContext* WorkStealingTaskQueue::LocalQueue::TryPop() noexcept {
+  auto head = head_.load(std::memory_order_acquire);
+  while (true) {
+    const auto tail = tail_.load(std::memory_order_acquire);
+    if (head == tail) return nullptr;
+
+    auto* context = buffer_[head % kCapacity].load(std::memory_order_relaxed);
+    if (head_.compare_exchange_weak(head, head + 1, std::memory_order_acq_rel,
+                                    std::memory_order_acquire)) {
+      return context;
+    }
+  }
+}
+
+std::size_t WorkStealingTaskQueue::LocalQueue::TryStealHalf(
+    StealBatch& batch) noexcept {
+  auto head = head_.load(std::memory_order_acquire);
+  while (true) {
+    const auto tail = tail_.load(std::memory_order_acquire);
+    const auto size = static_cast<std::size_t>(tail - head);
+    if (size == 0) return 0;
+
+    const auto to_steal = std::min(size - size / 2, kMaxStealBatch);
+    for (std::size_t i = 0; i < to_steal; ++i) {
+      batch[i] =
+          buffer_[(head + i) % kCapacity].load(std::memory_order_relaxed);
+    }
+    if (head_.compare_exchange_weak(head, head + to_steal,
+                                    std::memory_order_acq_rel,
+                                    std::memory_order_acquire)) {
+      return to_steal;
+    }
+  }
+}
+
+impl::TaskContext* WorkStealingTaskQueue::LocalQueue::ExchangeLifoSlot(
+    impl::TaskContext* context) noexcept {
+  return lifo_slot_.exchange(context, std::memory_order_acq_rel);
+}
+
+impl::TaskContext*
+WorkStealingTaskQueue::LocalQueue::TryPopLifoSlot() noexcept {
+  if (!lifo_slot_.load(std::memory_order_relaxed)) return nullptr;
+  return lifo_slot_.exchange(nullptr, std::memory_order_acq_rel);
+}
+
+std::size_t WorkStealingTaskQueue::LocalQueue::GetSizeApproximate()
+    const noexcept {
+  const auto head = head_.load(std::memory_order_relaxed);
+  const auto tail = tail_.load(std::memory_order_relaxed);
+  const std::size_t lifo_size =
+      lifo_slot_.load(std::memory_order_relaxed) ? 1 : 0;
+  return (tail > head ? static_cast<std::size_t>(tail - head) : 0) +
+         lifo_size;
+}
+
+WorkStealingTaskQueue::WorkStealingTaskQueue(const TaskProcessorConfig& config,
+                                             impl::TaskCounter& task_counter)
+    : task_counter_(task_counter),
+      workers_(config.worker_threads, global_queue_, background_queue_,
+               config),
+      sleep_semaphore_(kSemaphoreInitialCount, /*maxSpins=*/0) {
+  UINVARIANT(config.worker_threads > 0,
+             "WorkStealingTaskQueue requires at least one worker");
+}
+
+void WorkStealingTaskQueue::Push(
+    boost::intrusive_ptr<impl::TaskContext>&& context) {
+  UASSERT(context);
+  DoPush(context.get());
+  context.detach();
+}
+
+boost::intrusive_ptr<impl::TaskContext> WorkStealingTaskQueue::PopBlocking() {
+  auto* worker = GetCurrentWorker();
+  UINVARIANT(worker, "PopBlocking() must be called from a prepared worker");
+
+  return boost::intrusive_ptr<impl::TaskContext>{
+      *DoPopBlocking(*worker, std::nullopt), /* add_ref= */ false};
+}
+
+std::optional<boost::intrusive_ptr<impl::TaskContext>>
+WorkStealingTaskQueue::PopBlockingFor(std::chrono::microseconds timeout) {
+  auto* worker = GetCurrentWorker();
+  UINVARIANT(worker, "PopBlockingFor() must be called from a prepared worker");
+
+  const auto context =
+      DoPopBlocking(*worker, std::chrono::steady_clock::now() + timeout);
+  if (!context) return std::nullopt;
+  return boost::intrusive_ptr<impl::TaskContext>{*context,
+                                                 /* add_ref= */ false};
+}
+
+void WorkStealingTaskQueue::PushBatch(
+    std::vector<boost::intrusive_ptr<impl::TaskContext>>& contexts) {
+  if (contexts.empty()) return;
+
+  auto* worker = GetCurrentWorker();
+  for (auto& context_ptr : contexts) {
+    auto* context = context_ptr.detach();
+    UASSERT(context);
+    // The new tasks are not related to the running one, so they skip the LIFO
+    // slot. The ones that do not fit go to the global queue.
+    if (context->GetPriority() == Task::Priority::kBackground) {
+      background_queue_.enqueue(context);
+    } else if (!worker || !worker->local_queue.TryPush(context)) {
+      global_queue_.enqueue(context);
+    }
+  }
+  NotifySleepingWorkers(contexts.size());
+}
+
+void WorkStealingTaskQueue::StopProcessing() {
+  is_stopped_.store(true);
+  sleep_semaphore_.signal(
+      static_cast<moodycamel::LightweightSemaphore::ssize_t>(workers_.size()));
+}
+
+std::size_t WorkStealingTaskQueue::GetSizeApproximate() const noexcept {
+  std::size_t size =
+      global_queue_.size_approx() + background_queue_.size_approx();
+  for (const auto& worker : workers_) {
+    size += worker.local_queue.GetSizeApproximate();
+  }
+  return size;
+}
+
+void WorkStealingTaskQueue::PrepareWorker(std::size_t index) {
+  UASSERT(index < workers_.size());
+  SetCurrentWorkerData({this, &workers_[index]});
+}
+
+WorkStealingTaskQueue::Worker* WorkStealingTaskQueue::GetCurrentWorker()
+    const noexcept {
+  const auto data = GetCurrentWorkerData();
+  if (data.queue != this) return nullptr;
+  return static_cast<Worker*>(data.worker);
+}
+
+void WorkStealingTaskQueue::DoPush(impl::TaskContext* context) {
+  UASSERT(context);
+  auto* worker = GetCurrentWorker();
+  if (context->GetPriority() == Task::Priority::kBackground) {
+    background_queue_.enqueue(context);
+  } else if (worker) {
+    PushToLocalQueue(*worker, context);
+  } else {
+    global_queue_.enqueue(context);
+  }
+  NotifySleepingWorker();
+}
+
+void WorkStealingTaskQueue::PushToLocalQueue(Worker& worker,
+                                             impl::TaskContext* context) {
+  // A task woken up by a running task is likely to touch the same data, so
+  // it goes to the LIFO slot and runs next. Tasks rescheduled between the
+  // steps (e.g. after engine::Yield) go to the back of the run queue.
+  if (current_task::GetCurrentTaskContextUnchecked() != nullptr) {
+    context = worker.local_queue.ExchangeLifoSlot(context);
+    if (!context) return;
+  }
+
+  if (!worker.local_queue.TryPush(context)) {
+    global_queue_.enqueue(context);
+  }
+}
+
+void WorkStealingTaskQueue::NotifySleepingWorker() noexcept {
+  NotifySleepingWorkers(1);
+}
+
+void WorkStealingTaskQueue::NotifySleepingWorkers(
+    std::size_t tasks_count) noexcept {
+  // Pairs with the fence in DoPopBlocking: either the worker that is going to
+  // sleep sees the pushed tasks, or we see that worker.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  // Spinning workers are going to find the tasks without our help
+  const auto spinning = spinning_workers_->load(std::memory_order_relaxed);
+  if (spinning >= tasks_count) return;
+  const auto sleeping = sleeping_workers_->load(std::memory_order_relaxed);
+  const auto to_wake = std::min(tasks_count - spinning, sleeping);
+  if (to_wake == 0) return;
+  sleep_semaphore_.signal(
+      static_cast<moodycamel::LightweightSemaphore::ssize_t>(to_wake));
+}
+
+std::optional<impl::TaskContext*> WorkStealingTaskQueue::DoPopBlocking(
+    Worker& worker,
+    std::optional<std::chrono::steady_clock::time_point> wait_until) {
+  using WakeupKind = impl::WorkerSpinner::WakeupKind;
+
+  if (auto* context = TryPop(worker)) return context;
+
+  const auto idle_start = impl::WorkerSpinner::Clock::now();
+  auto wakeup_kind = WakeupKind::kSpin;
+  while (true) {
+    if (spinning_workers_->load(std::memory_order_relaxed) * 2 <
+        workers_.size()) {
+      spinning_workers_->fetch_add(1, std::memory_order_seq_cst);
+      impl::TaskContext* context = nullptr;
+      const bool found = worker.spinner.Spin(kSpinCheckInterval, [&] {
+        context = TryPop(worker);
+        return context != nullptr;
+      });
+      if (found) {
+        // The tasks pushed while we were spinning did not wake anybody up,
+        // let another worker continue the search.
+        if (spinning_workers_->fetch_sub(1, std::memory_order_seq_cst) == 1) {
+          NotifySleepingWorker();
+        }
+        worker.spinner.AccountWakeup(idle_start, wakeup_kind, task_counter_);
+        return context;
+      }
+      spinning_workers_->fetch_sub(1, std::memory_order_seq_cst);
+    }
+
+    sleeping_workers_->fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (auto* context = TryPop(worker)) {
+      sleeping_workers_->fetch_sub(1, std::memory_order_relaxed);
+      worker.spinner.AccountWakeup(idle_start, wakeup_kind, task_counter_);
+      return context;
+    }
+    if (is_stopped_.load()) {
+      sleeping_workers_->fetch_sub(1, std::memory_order_relaxed);
+      return nullptr;
+    }
+
+    if (!wait_until) {
+      sleep_semaphore_.wait();
+    } else {
+      const auto timeout = std::chrono::ceil<std::chrono::microseconds>(
+          *wait_until - std::chrono::steady_clock::now());
+      if (timeout.count() <= 0 || !sleep_semaphore_.wait(timeout.count())) {
+        sleeping_workers_->fetch_sub(1, std::memory_order_relaxed);
+        worker.spinner.AccountTimeout(idle_start);
+        return std::nullopt;
+      }
+    }
+    sleeping_workers_->fetch_sub(1, std::memory_order_relaxed);
+    wakeup_kind = WakeupKind::kSleep;
+
+    if (auto* context = TryPop(worker)) {
+      worker.spinner.AccountWakeup(idle_start, wakeup_kind, task_counter_);
+      return context;
+    }
+  }
+}
+
+impl::TaskContext* WorkStealingTaskQueue::TryPop(Worker& worker) {
+  ++worker.pops_count;
+  if (worker.pops_count % kBackgroundQueueCheckInterval == 0) {
+    if (auto* context = TryPopBackground(worker)) return context;
+  }
+  if (worker.pops_count % kGlobalQueueCheckInterval == 0) {
+    if (auto* context = TryPopGlobal(worker)) return context;
+  }
+
+  if (auto* context = TryPopLocal(worker)) return context;
+  if (auto* context = TryPopGlobal(worker)) return context;
+  if (auto* context = TrySteal(worker)) return context;
+  return TryPopBackground(worker);
+}
+
+impl::TaskContext* WorkStealingTaskQueue::TryPopLocal(Worker& worker) noexcept {
+  auto& local_queue = worker.local_queue;
+  if (worker.lifo_streak < kMaxLifoStreak) {
+    if (auto* context = local_queue.TryPopLifoSlot()) {
+      ++worker.lifo_streak;
+      return context;
+    }
+  }
+
+  worker.lifo_streak = 0;
+  if (auto* context = local_queue.TryPop()) return context;
+  return local_queue.TryPopLifoSlot();
+}
+
+impl::TaskContext* WorkStealingTaskQueue::TryPopGlobal(Worker& worker) {
+  impl::TaskContext* context{};
+  if (global_queue_.try_dequeue(worker.global_queue_token, context)) {
+    return context;
+  }
+  return nullptr;
+}
+
+impl::TaskContext* WorkStealingTaskQueue::TryPopBackground(Worker& worker) {
+  impl::TaskContext* context{};
+  if (background_queue_.try_dequeue(worker.background_queue_token, context)) {
+    return context;
+  }
+  return nullptr;
+}
+
+impl::TaskContext* WorkStealingTaskQueue::TrySteal(Worker& worker) {
+  const auto workers_count = workers_.size();
+  if (workers_count == 1) return nullptr;
+
+  const auto self_index = static_cast<std::size_t>(&worker - workers_.begin());
+  const auto start = self_index + 1 + worker.steal_round++ % workers_count;
+
+  LocalQueue::StealBatch batch;
+  for (std::size_t i = 0; i < workers_count; ++i) {
+    const auto victim_index = (start + i) % workers_count;
+    if (victim_index == self_index) continue;
+    auto& victim = workers_[victim_index].local_queue;
+
+    const auto stolen = victim.TryStealHalf(batch);
+    if (stolen != 0) {
+      for (std::size_t j = 1; j < stolen; ++j) {
+        if (!worker.local_queue.TryPush(batch[j])) {
+          global_queue_.enqueue(batch[j]);
+        }
+      }
+      return batch[0];
+    }
+  }
+
+  // LIFO slots are the last resort, their owners are about to run them
+  for (std::size_t i = 0; i < workers_count; ++i) {
+    const auto victim_index = (start + i) % workers_count;
+    if (victim_index == self_index) continue;
+    if (auto* context = workers_[victim_index].local_queue.TryPopLifoSlot()) {
+      return context;
+    }
+  }
+
+  return nullptr;
+}
+
+}  // namespace engine
+
+USERVER_NAMESPACE_END
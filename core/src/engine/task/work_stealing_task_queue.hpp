@@ -0,0 +1,158 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <moodycamel/concurrentqueue.h>
+#include <moodycamel/lightweightsemaphore.h>
+#include <boost/smart_ptr/intrusive_ptr.hpp>
+
+#include <concurrent/impl/interference_shield.hpp>
+#include <engine/task/task_counter.hpp>
+#include <engine/task/task_processor_config.hpp>
+#include <engine/task/worker_spinner.hpp>
+#include <userver/utils/fixed_array.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine {
+
+namespace impl {
+class TaskContext;
+}  // namespace impl
+
+/// Task queue with a bounded run queue per worker thread.
+///
+/// Tasks woken up from a worker thread are put into that worker's own run
+/// queue, tasks scheduled from any other thread go into a shared global queue.
+/// Workers that have nothing to do steal half of a sibling's run queue.
+///
+/// Background tasks (see TaskBase::Priority) always go into a separate shared
+/// queue that is served when there is nothing else to do and, to avoid
+/// starvation, periodically ahead of the other queues.
+class WorkStealingTaskQueue final {
+ public:
+  WorkStealingTaskQueue(const TaskProcessorConfig& config,
+                        impl::TaskCounter& task_counter);
+
+  void Push(boost::intrusive_ptr<impl::TaskContext>&& context);
+
+  // Takes ownership of all the contexts, wakes up to `contexts.size()` workers
+  void PushBatch(
+      std::vector<boost::intrusive_ptr<impl::TaskContext>>& contexts);
+
+  // Returns nullptr as a stop signal
+  boost::intrusive_ptr<impl::TaskContext> PopBlocking();
+
+  // Same as PopBlocking(), but returns std::nullopt if no task arrives within
+  // the `timeout`
+  std::optional<boost::intrusive_ptr<impl::TaskContext>> PopBlockingFor(
+      std::chrono::microseconds timeout);
+
+  void StopProcessing();
+
+  std::size_t GetSizeApproximate() const noexcept;
+
+  // Binds the calling thread to the worker run queue with the given index.
+  // Must be called from each worker thread before the first PopBlocking().
+  void PrepareWorker(std::size_t index);
+
+ private:
+  // Bounded single-producer multiple-consumer ring buffer. Only the owning
+  // worker pushes, any worker may pop.
+  class LocalQueue final {
+   public:
+    static constexpr std::size_t kCapacity = 256;
+    static constexpr std::size_t kMaxStealBatch = kCapacity / 2;
+
+    using StealBatch = std::array<impl::TaskContext*, kMaxStealBatch>;
+
+    // Owner only. Returns false if the queue is full.
+    bool TryPush(impl::TaskContext* context) noexcept;
+
+    impl::TaskContext* TryPop() noexcept;
+
+    // Moves up to a half of the queued tasks into `batch`, returns their count
+    std::size_t TryStealHalf(StealBatch& batch) noexcept;
+
+    // Owner only. Returns the task previously stored in the LIFO slot.
+    impl::TaskContext* ExchangeLifoSlot(impl::TaskContext* context) noexcept;
+
+    impl::TaskContext* TryPopLifoSlot() noexcept;
+
+    std::size_t GetSizeApproximate() const noexcept;
+
+   private:
+    alignas(concurrent::impl::kDestructiveInterferenceSize)
+        std::atomic<std::uint64_t> head_{0};
+    alignas(concurrent::impl::kDestructiveInterferenceSize)
+        std::atomic<std::uint64_t> tail_{0};
+    alignas(concurrent::impl::kDestructiveInterferenceSize)
+        std::atomic<impl::TaskContext*> lifo_slot_{nullptr};
+    std::array<std::atomic<impl::TaskContext*>, kCapacity> buffer_{};
+  };
+
+  struct Worker final {
+    Worker(moodycamel::ConcurrentQueue<impl::TaskContext*>& global_queue,
+           moodycamel::ConcurrentQueue<impl::TaskContext*>& background_queue,
+           const TaskProcessorConfig& config)
+        : global_queue_token(global_queue),
+          background_queue_token(background_queue),
+          spinner(config.spinning_mode, config.spinning_iterations) {}
+
+    LocalQueue local_queue;
+    moodycamel::ConsumerToken global_queue_token;
+    moodycamel::ConsumerToken background_queue_token;
+    impl::WorkerSpinner spinner;
+    std::uint64_t pops_count{0};
+    std::size_t lifo_streak{0};
+    std::size_t steal_round{0};
+  };
+
+  Worker* GetCurrentWorker() const noexcept;
+
+  void DoPush(impl::TaskContext* context);
+
+  void PushToLocalQueue(Worker& worker, impl::TaskContext* context);
+
+  void NotifySleepingWorker() noexcept;
+
+  void NotifySleepingWorkers(std::size_t tasks_count) noexcept;
+
+  // Returns std::nullopt on timeout, nullptr as a stop signal
+  std::optional<impl::TaskContext*> DoPopBlocking(
+      Worker& worker,
+      std::optional<std::chrono::steady_clock::time_point> wait_until);
+
+  impl::TaskContext* TryPop(Worker& worker);
+
+  impl::TaskContext* TryPopLocal(Worker& worker) noexcept;
+
+  impl::TaskContext* TryPopGlobal(Worker& worker);
+
+  impl::TaskContext* TrySteal(Worker& worker);
+
+  impl::TaskContext* TryPopBackground(Worker& worker);
+
+  impl::TaskCounter& task_counter_;
+
+  moodycamel::ConcurrentQueue<impl::TaskContext*> global_queue_;
+  moodycamel::ConcurrentQueue<impl::TaskContext*> background_queue_;
+  utils::FixedArray<Worker> workers_;
+
+  concurrent::impl::InterferenceShield<std::atomic<std::size_t>>
+      spinning_workers_{0};
+  concurrent::impl::InterferenceShield<std::atomic<std::size_t>>
+      sleeping_workers_{0};
+  moodycamel::LightweightSemaphore sleep_semaphore_;
+  std::atomic<bool> is_stopped_{false};
+};
+
+}  // namespace engine
+
+USERVER_NAMESPACE_END
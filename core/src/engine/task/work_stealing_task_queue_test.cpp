@@ -0,0 +1,120 @@
+#include <userver/utest/utest.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#include <userver/engine/async.hpp>
+#include <userver/engine/run_standalone.hpp>
+#include <userver/engine/single_consumer_event.hpp>
+#include <userver/engine/sleep.hpp>
+#include <userver/engine/task/task_with_result.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr std::size_t kWorkerThreads = 4;
+
+engine::TaskProcessorPoolsConfig MakeWorkStealingConfig() {
+  engine::TaskProcessorPoolsConfig config;
+  config.work_stealing_task_queue = true;
+  return config;
+}
+
+}  // namespace
+
+TEST(WorkStealingTaskQueue, ManyTasks) {
+  engine::RunStandalone(kWorkerThreads, MakeWorkStealingConfig(), [] {
+    constexpr std::size_t kTasksCount = 10000;
+    std::atomic<std::size_t> counter{0};
+
+    std::vector<engine::TaskWithResult<void>> tasks;
+    tasks.reserve(kTasksCount);
+    for (std::size_t i = 0; i < kTasksCount; ++i) {
+      tasks.push_back(engine::AsyncNoSpan([&counter] { ++counter; }));
+    }
+    for (auto& task : tasks) task.Get();
+
+    EXPECT_EQ(counter.load(), kTasksCount);
+  });
+}
+
+TEST(WorkStealingTaskQueue, Yield) {
+  engine::RunStandalone(kWorkerThreads, MakeWorkStealingConfig(), [] {
+    constexpr std::size_t kTasksCount = 100;
+    constexpr std::size_t kYieldsCount = 100;
+
+    std::vector<engine::TaskWithResult<std::size_t>> tasks;
+    tasks.reserve(kTasksCount);
+    for (std::size_t i = 0; i < kTasksCount; ++i) {
+      tasks.push_back(engine::AsyncNoSpan([] {
+        std::size_t yields = 0;
+        for (; yields < kYieldsCount; ++yields) engine::Yield();
+        return yields;
+      }));
+    }
+    for (auto& task : tasks) EXPECT_EQ(task.Get(), kYieldsCount);
+  });
+}
+
+TEST(WorkStealingTaskQueue, PingPong) {
+  engine::RunStandalone(kWorkerThreads, MakeWorkStealingConfig(), [] {
+    constexpr std::size_t kRoundTrips = 1000;
+    engine::SingleConsumerEvent ping;
+    engine::SingleConsumerEvent pong;
+
+    auto task = engine::AsyncNoSpan([&] {
+      for (std::size_t i = 0; i < kRoundTrips; ++i) {
+        ASSERT_TRUE(ping.WaitForEvent());
+        pong.Send();
+      }
+    });
+
+    for (std::size_t i = 0; i < kRoundTrips; ++i) {
+      ping.Send();
+      ASSERT_TRUE(pong.WaitForEvent());
+    }
+    task.Get();
+  });
+}
+
+TEST(WorkStealingTaskQueue, WakeupsFromEvThreads) {
+  engine::RunStandalone(kWorkerThreads, MakeWorkStealingConfig(), [] {
+    constexpr std::size_t kTasksCount = 100;
+
+    std::vector<engine::TaskWithResult<void>> tasks;
+    tasks.reserve(kTasksCount);
+    for (std::size_t i = 0; i < kTasksCount; ++i) {
+      tasks.push_back(engine::AsyncNoSpan([] { engine::SleepFor(1ms); }));
+    }
+    for (auto& task : tasks) task.Get();
+  });
+}
+
+TEST(WorkStealingTaskQueue, SingleWorker) {
+  engine::RunStandalone(1, MakeWorkStealingConfig(), [] {
+    auto task = engine::AsyncNoSpan([] { return 42; });
+    EXPECT_EQ(task.Get(), 42);
+  });
+}
+
+TEST(WorkStealingTaskQueue, BackgroundIsNotStarved) {
+  engine::RunStandalone(1, MakeWorkStealingConfig(), [] {
+    std::atomic<bool> background_done{false};
+
+    auto busy_task = engine::AsyncNoSpan([&background_done] {
+      while (!background_done) engine::Yield();
+    });
+    auto background_task =
+        engine::AsyncNoSpan(engine::Task::Priority::kBackground,
+                            [&background_done] { background_done = true; });
+
+    background_task.Get();
+    busy_task.Get();
+  });
+}
+
+USERVER_NAMESPACE_END
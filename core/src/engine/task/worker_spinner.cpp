@@ -0,0 +1,116 @@
+#include <engine/task/worker_spinner.hpp>
+
+#include <algorithm>
+#include <limits>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine::impl {
+
+namespace {
+
+// Even a worker that expects a long idle period spins a little, to catch the
+// task that is being pushed right now
+constexpr int kMinSpinIterations = 64;
+
+// Shorter spins are dominated by the clock reads and are not used to measure
+// the cost of a spin iteration
+constexpr int kMinMeasuredSpinIterations = 1024;
+
+// Weight of a new sample in the moving averages
+constexpr double kSampleWeight = 1.0 / 8;
+
+// The worker spins for this many expected idle periods
+constexpr double kSpinToIdleRatio = 2.0;
+
+// Idle periods longer than this many longest spins are all equally long for
+// the policy. Limits the effect of a single long sleep, so that a worker
+// resumes spinning after a few short idle periods.
+constexpr double kMaxIdleToSpinRatio = 2.0;
+
+double UpdateAverage(double average, double sample) noexcept {
+  if (average == 0) return sample;
+  return average + (sample - average) * kSampleWeight;
+}
+
+}  // namespace
+
+WorkerSpinner::WorkerSpinner(SpinningMode mode,
+                             int max_spin_iterations) noexcept
+    : mode_(mode),
+      max_spin_iterations_(std::max(max_spin_iterations, 0)),
+      spin_iterations_(max_spin_iterations_) {
+  if (mode_ == SpinningMode::kAdaptive && max_spin_iterations_ > 0 &&
+      max_spin_iterations_ < kMinMeasuredSpinIterations) {
+    // None of the spins is long enough to be measured
+    Calibrate();
+  }
+}
+
+void WorkerSpinner::AccountWakeup(Clock::time_point idle_start,
+                                  WakeupKind kind,
+                                  TaskCounter& counter) noexcept {
+  const auto idle_time = Clock::now() - idle_start;
+  counter.AccountIdleWakeup(kind, idle_time);
+  AccountIdleTime(idle_time);
+}
+
+void WorkerSpinner::AccountTimeout(Clock::time_point idle_start) noexcept {
+  // The next task is going to arrive even later, still a valid sample
+  AccountIdleTime(Clock::now() - idle_start);
+}
+
+void WorkerSpinner::AccountIdleTime(
+    std::chrono::nanoseconds idle_time) noexcept {
+  if (mode_ != SpinningMode::kAdaptive) return;
+  // Spin for the whole budget until the cost of an iteration is known
+  if (spin_iteration_ns_ == 0) return;
+
+  const double max_spin_ns = max_spin_iterations_ * spin_iteration_ns_;
+  const double idle_ns = std::min(static_cast<double>(idle_time.count()),
+                                  max_spin_ns * kMaxIdleToSpinRatio);
+  idle_time_ns_ = UpdateAverage(idle_time_ns_, idle_ns);
+
+  const int min_spin_iterations =
+      std::min(kMinSpinIterations, max_spin_iterations_);
+  if (idle_time_ns_ > max_spin_ns) {
+    // The task is not likely to arrive while we are spinning
+    spin_iterations_ = min_spin_iterations;
+    return;
+  }
+
+  const double wanted_iterations =
+      idle_time_ns_ * kSpinToIdleRatio / spin_iteration_ns_;
+  spin_iterations_ = std::clamp(
+      static_cast<int>(std::min(wanted_iterations,
+                                static_cast<double>(max_spin_iterations_))),
+      min_spin_iterations, max_spin_iterations_);
+}
+
+void WorkerSpinner::Calibrate() noexcept {
+  // Same as the spin loop, except for the rare `try_acquire` calls
+  const auto start = Clock::now();
+  for (int i = 0; i < kMinMeasuredSpinIterations; ++i) {
+    std::atomic_signal_fence(std::memory_order_acquire);
+  }
+  const auto spin_time = Clock::now() - start;
+  // Never zero, zero means "not measured yet"
+  spin_iteration_ns_ = std::max(
+      static_cast<double>(spin_time.count()) / kMinMeasuredSpinIterations,
+      std::numeric_limits<double>::min());
+}
+
+void WorkerSpinner::AccountExhaustedSpin(Clock::time_point spin_start,
+                                         int iterations) noexcept {
+  if (mode_ != SpinningMode::kAdaptive) return;
+  if (iterations < kMinMeasuredSpinIterations) return;
+
+  const auto spin_time = Clock::now() - spin_start;
+  spin_iteration_ns_ =
+      UpdateAverage(spin_iteration_ns_,
+                    static_cast<double>(spin_time.count()) / iterations);
+}
+
+}  // namespace engine::impl
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include <engine/task/task_counter.hpp>
+#include <engine/task/task_processor_config.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine::impl {
+
+// Decides for how long an idle TaskProcessor worker spin-waits for a task
+// before going to sleep, and accounts the idle periods of the worker.
+//
+// In SpinningMode::kAdaptive the spin budget follows a moving average of the
+// recent idle periods of the worker: if the next task is expected to arrive
+// within the longest allowed spin, the worker spins for about twice the
+// expected idle time, otherwise it spins just a little and goes to sleep. So
+// a busy worker avoids the costly futex wakeups, and a mostly idle one does
+// not burn the CPU.
+//
+// One instance per worker thread, not thread-safe.
+class WorkerSpinner final {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using WakeupKind = TaskCounter::WakeupKind;
+
+  WorkerSpinner(SpinningMode mode, int max_spin_iterations) noexcept;
+
+  // Number of iterations the next Spin() is going to do at most
+  int GetSpinIterations() const noexcept { return spin_iterations_; }
+
+  // Calls `try_acquire` once in `check_interval` iterations until it succeeds
+  // or the spin budget is exhausted. Returns true if `try_acquire` succeeded.
+  template <typename TryAcquire>
+  bool Spin(int check_interval, TryAcquire&& try_acquire);
+
+  // Called when the idle period that has started at `idle_start` ends with a
+  // task. Must be called from the worker thread bound to `counter`.
+  void AccountWakeup(Clock::time_point idle_start, WakeupKind kind,
+                     TaskCounter& counter) noexcept;
+
+  // Called when the idle period that has started at `idle_start` ends without
+  // a task, e.g. on a timeout.
+  void AccountTimeout(Clock::time_point idle_start) noexcept;
+
+ private:
+  void AccountIdleTime(std::chrono::nanoseconds idle_time) noexcept;
+
+  void AccountExhaustedSpin(Clock::time_point spin_start,
+                            int iterations) noexcept;
+
+  // Measures the cost of a spin iteration up front, for the spins that are
+  // too short to be measured
+  void Calibrate() noexcept;
+
+  const SpinningMode mode_;
+  const int max_spin_iterations_;
+  int spin_iterations_;
+
+  // Moving averages, zero until the first measurement
+  double idle_time_ns_{0};
+  double spin_iteration_ns_{0};
+};
+
+template <typename TryAcquire>
+bool WorkerSpinner::Spin(int check_interval, TryAcquire&& try_acquire) {
+  const auto iterations = spin_iterations_;
+  const auto spin_start = Clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    if (i % check_interval != 0) {
+      // Prevent the compiler from collapsing the loop
+      std::atomic_signal_fence(std::memory_order_acquire);
+      continue;
+    }
+    if (try_acquire()) return true;
+  }
+  AccountExhaustedSpin(spin_start, iterations);
+  return false;
+}
+
+}  // namespace engine::impl
+
+USERVER_NAMESPACE_END
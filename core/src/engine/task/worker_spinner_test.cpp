@@ -0,0 +1,127 @@
+#include <userver/utest/utest.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#include <engine/task/worker_spinner.hpp>
+#include <userver/engine/async.hpp>
+#include <userver/engine/run_standalone.hpp>
+#include <userver/engine/single_consumer_event.hpp>
+#include <userver/engine/sleep.hpp>
+#include <userver/engine/task/task_with_result.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr int kMaxSpinIterations = 100000;
+constexpr std::size_t kWorkerThreads = 4;
+
+using Clock = engine::impl::WorkerSpinner::Clock;
+
+// Spins for the whole budget, returns the time it took
+Clock::duration SpinToExhaustion(engine::impl::WorkerSpinner& spinner) {
+  const auto start = Clock::now();
+  EXPECT_FALSE(spinner.Spin(1, [] { return false; }));
+  return Clock::now() - start;
+}
+
+engine::TaskProcessorPoolsConfig MakeAdaptiveSpinningConfig(
+    bool work_stealing) {
+  engine::TaskProcessorPoolsConfig config;
+  config.adaptive_spinning = true;
+  config.work_stealing_task_queue = work_stealing;
+  return config;
+}
+
+void PingPong(const engine::TaskProcessorPoolsConfig& config) {
+  engine::RunStandalone(kWorkerThreads, config, [] {
+    constexpr std::size_t kRoundTrips = 1000;
+    engine::SingleConsumerEvent ping;
+    engine::SingleConsumerEvent pong;
+
+    auto task = engine::AsyncNoSpan([&] {
+      for (std::size_t i = 0; i < kRoundTrips; ++i) {
+        ASSERT_TRUE(ping.WaitForEvent());
+        pong.Send();
+      }
+    });
+
+    for (std::size_t i = 0; i < kRoundTrips; ++i) {
+      // Let the workers fall asleep once in a while
+      if (i % 100 == 0) engine::SleepFor(2ms);
+      ping.Send();
+      ASSERT_TRUE(pong.WaitForEvent());
+    }
+    task.Get();
+  });
+}
+
+}  // namespace
+
+TEST(WorkerSpinner, FixedSpinsTheWholeBudget) {
+  engine::impl::WorkerSpinner spinner{engine::SpinningMode::kFixed,
+                                      kMaxSpinIterations};
+  EXPECT_EQ(spinner.GetSpinIterations(), kMaxSpinIterations);
+
+  for (int i = 0; i < 10; ++i) {
+    SpinToExhaustion(spinner);
+    spinner.AccountTimeout(Clock::now() - 1s);
+  }
+  EXPECT_EQ(spinner.GetSpinIterations(), kMaxSpinIterations);
+}
+
+TEST(WorkerSpinner, StopsItOnLongIdlePeriods) {
+  engine::impl::WorkerSpinner spinner{engine::SpinningMode::kAdaptive,
+                                      kMaxSpinIterations};
+  EXPECT_EQ(spinner.GetSpinIterations(), kMaxSpinIterations);
+
+  SpinToExhaustion(spinner);
+  for (int i = 0; i < 10; ++i) spinner.AccountTimeout(Clock::now() - 1s);
+  EXPECT_LT(spinner.GetSpinIterations(), kMaxSpinIterations / 100);
+}
+
+TEST(WorkerSpinner, FollowsShortIdlePeriods) {
+  engine::impl::WorkerSpinner spinner{engine::SpinningMode::kAdaptive,
+                                      kMaxSpinIterations};
+  const auto max_spin_time = SpinToExhaustion(spinner);
+
+  // A single long sleep does not stop the spinning for long
+  spinner.AccountTimeout(Clock::now() - 1s);
+  for (int i = 0; i < 50; ++i) {
+    spinner.AccountTimeout(Clock::now() - max_spin_time / 4);
+  }
+  EXPECT_GT(spinner.GetSpinIterations(), kMaxSpinIterations / 10);
+  EXPECT_LT(spinner.GetSpinIterations(), kMaxSpinIterations);
+}
+
+TEST(WorkerSpinner, CalibratesShortBudgets) {
+  constexpr int kShortSpinIterations = 512;
+  engine::impl::WorkerSpinner spinner{engine::SpinningMode::kAdaptive,
+                                      kShortSpinIterations};
+
+  // No spin is long enough to measure the iteration cost
+  for (int i = 0; i < 10; ++i) spinner.AccountTimeout(Clock::now() - 1s);
+  EXPECT_LT(spinner.GetSpinIterations(), kShortSpinIterations);
+}
+
+TEST(WorkerSpinner, SpinStopsOnSuccess) {
+  engine::impl::WorkerSpinner spinner{engine::SpinningMode::kAdaptive,
+                                      kMaxSpinIterations};
+  int attempts = 0;
+  EXPECT_TRUE(spinner.Spin(4, [&attempts] { return ++attempts == 3; }));
+  EXPECT_EQ(attempts, 3);
+}
+
+TEST(WorkerSpinner, GlobalTaskQueue) {
+  PingPong(MakeAdaptiveSpinningConfig(/*work_stealing=*/false));
+}
+
+TEST(WorkerSpinner, WorkStealingTaskQueue) {
+  PingPong(MakeAdaptiveSpinningConfig(/*work_stealing=*/true));
+}
+
+USERVER_NAMESPACE_END
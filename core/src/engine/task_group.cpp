@@ -0,0 +1,104 @@
+#include <userver/engine/task_group.hpp>
+
+#include <engine/task/coro_unwinder.hpp>
+#include <userver/engine/exception.hpp>
+#include <userver/engine/task/cancel.hpp>
+#include <userver/engine/task/task.hpp>
+#include <userver/utils/assert.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace engine {
+
+TaskGroup::TaskGroup() : TaskGroup(current_task::GetTaskProcessor()) {}
+
+TaskGroup::TaskGroup(TaskProcessor& task_processor)
+    : TaskGroup(task_processor, Deadline{}) {}
+
+TaskGroup::TaskGroup(TaskProcessor& task_processor, Deadline deadline)
+    : task_processor_(task_processor),
+      deadline_(deadline),
+      sync_block_(impl::DetachedTasksSyncBlock::StopMode::kCancelAndWait) {
+  sync_block_.CancelTasksWithCurrentTask();
+}
+
+TaskGroup::~TaskGroup() {
+  // Also waits for the children to release the group completely, after they
+  // have been accounted as finished
+  sync_block_.RequestCancellation(TaskCancellationReason::kAbandoned);
+  UASSERT(active_tasks_.load() == 0);
+}
+
+void TaskGroup::Wait() {
+  while (active_tasks_.load(std::memory_order_acquire) != 0) {
+    if (!all_tasks_finished_.WaitForEvent()) {
+      const auto reason = current_task::CancellationReason();
+      sync_block_.CancelTasks(reason);
+      WaitNonCancellable();
+      throw WaitInterruptedException(reason);
+    }
+  }
+
+  if (has_exception_.load(std::memory_order_acquire)) {
+    std::rethrow_exception(exception_);
+  }
+}
+
+void TaskGroup::Cancel() noexcept {
+  sync_block_.CancelTasks(TaskCancellationReason::kUserRequest);
+}
+
+std::size_t TaskGroup::ActiveTasksApprox() const noexcept {
+  return active_tasks_.load(std::memory_order_relaxed);
+}
+
+void TaskGroup::Detach(Task&& task) { sync_block_.Add(std::move(task)); }
+
+void TaskGroup::WaitNonCancellable() noexcept {
+  const TaskCancellationBlocker cancel_blocker;
+  while (active_tasks_.load(std::memory_order_acquire) != 0) {
+    [[maybe_unused]] const bool is_finished =
+        all_tasks_finished_.WaitForEvent();
+    UASSERT(is_finished);
+  }
+}
+
+TaskGroup::ChildToken::ChildToken(TaskGroup& group) noexcept : group_(&group) {
+  group_->active_tasks_.fetch_add(1, std::memory_order_relaxed);
+}
+
+TaskGroup::ChildToken::ChildToken(ChildToken&& other) noexcept
+    : group_(std::exchange(other.group_, nullptr)) {}
+
+TaskGroup::ChildToken::~ChildToken() { Finish(); }
+
+bool TaskGroup::ChildToken::SetException(
+    std::exception_ptr&& exception) noexcept {
+  UASSERT(group_);
+  try {
+    std::rethrow_exception(exception);
+  } catch (const impl::CoroUnwinder&) {
+    return false;
+  } catch (...) {
+  }
+
+  if (!group_->has_exception_.exchange(true, std::memory_order_relaxed)) {
+    // Is read by Wait only after all the children have finished
+    group_->exception_ = std::move(exception);
+  }
+  group_->sync_block_.CancelTasks(TaskCancellationReason::kUserRequest);
+  return true;
+}
+
+void TaskGroup::ChildToken::Finish() noexcept {
+  auto* const group = std::exchange(group_, nullptr);
+  if (!group) return;
+
+  if (group->active_tasks_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    group->all_tasks_finished_.Send();
+  }
+}
+
+}  // namespace engine
+
+USERVER_NAMESPACE_END
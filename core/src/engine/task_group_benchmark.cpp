@@ -0,0 +1,110 @@
+#include <userver/engine/task_group.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <userver/concurrent/background_task_storage.hpp>
+#include <userver/engine/async.hpp>
+#include <userver/engine/run_standalone.hpp>
+#include <userver/engine/single_consumer_event.hpp>
+#include <userver/engine/task/task_with_result.hpp>
+#include <userver/engine/wait_all_checked.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+constexpr std::size_t kWorkerThreads = 4;
+
+// Sleeps until cancelled
+void WaitForCancel() {
+  engine::SingleConsumerEvent event;
+  [[maybe_unused]] const bool is_sent = event.WaitForEvent();
+}
+
+}  // namespace
+
+// Fan-out of short tasks and a join
+
+void task_group_fan_out_wait_all_checked(benchmark::State& state) {
+  engine::RunStandalone(kWorkerThreads, [&] {
+    std::vector<engine::TaskWithResult<void>> tasks;
+    tasks.reserve(state.range(0));
+
+    for (auto _ : state) {
+      for (std::int64_t i = 0; i < state.range(0); ++i) {
+        tasks.push_back(engine::AsyncNoSpan([] {}));
+      }
+      engine::WaitAllChecked(tasks);
+      tasks.clear();
+    }
+  });
+}
+BENCHMARK(task_group_fan_out_wait_all_checked)
+    ->RangeMultiplier(4)
+    ->Range(4, 256);
+
+void task_group_fan_out(benchmark::State& state) {
+  engine::RunStandalone(kWorkerThreads, [&] {
+    for (auto _ : state) {
+      engine::TaskGroup group;
+      for (std::int64_t i = 0; i < state.range(0); ++i) {
+        group.AsyncNoSpan([] {});
+      }
+      group.Wait();
+    }
+  });
+}
+BENCHMARK(task_group_fan_out)->RangeMultiplier(4)->Range(4, 256);
+
+// Fan-out of sleeping tasks and their cancellation
+
+void task_group_cancel_task_vector(benchmark::State& state) {
+  engine::RunStandalone(kWorkerThreads, [&] {
+    std::vector<engine::TaskWithResult<void>> tasks;
+    tasks.reserve(state.range(0));
+
+    for (auto _ : state) {
+      for (std::int64_t i = 0; i < state.range(0); ++i) {
+        tasks.push_back(engine::AsyncNoSpan(&WaitForCancel));
+      }
+      for (auto& task : tasks) task.RequestCancel();
+      for (auto& task : tasks) task.Wait();
+      tasks.clear();
+    }
+  });
+}
+BENCHMARK(task_group_cancel_task_vector)->RangeMultiplier(4)->Range(4, 256);
+
+void task_group_cancel_background_task_storage(benchmark::State& state) {
+  engine::RunStandalone(kWorkerThreads, [&] {
+    for (auto _ : state) {
+      concurrent::BackgroundTaskStorage bts;
+      for (std::int64_t i = 0; i < state.range(0); ++i) {
+        bts.AsyncDetach("task", &WaitForCancel);
+      }
+      bts.CancelAndWait();
+    }
+  });
+}
+BENCHMARK(task_group_cancel_background_task_storage)
+    ->RangeMultiplier(4)
+    ->Range(4, 256);
+
+void task_group_cancel(benchmark::State& state) {
+  engine::RunStandalone(kWorkerThreads, [&] {
+    for (auto _ : state) {
+      engine::TaskGroup group;
+      for (std::int64_t i = 0; i < state.range(0); ++i) {
+        group.AsyncNoSpan(&WaitForCancel);
+      }
+      group.Cancel();
+      group.Wait();
+    }
+  });
+}
+BENCHMARK(task_group_cancel)->RangeMultiplier(4)->Range(4, 256);
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,187 @@
+#include <userver/utest/utest.hpp>
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <userver/engine/async.hpp>
+#include <userver/engine/exception.hpp>
+#include <userver/engine/single_consumer_event.hpp>
+#include <userver/engine/sleep.hpp>
+#include <userver/engine/task/cancel.hpp>
+#include <userver/engine/task_group.hpp>
+
+using namespace std::chrono_literals;
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+constexpr std::size_t kTasksCount = 100;
+
+class TestError : public std::runtime_error {
+ public:
+  TestError() : std::runtime_error("test") {}
+};
+
+// Waits until cancelled, returns whether it was
+bool WaitForCancel() {
+  engine::SingleConsumerEvent event;
+  return !event.WaitForEventFor(utest::kMaxTestWaitTime);
+}
+
+}  // namespace
+
+UTEST_MT(TaskGroup, Sample, 4) {
+  /// [Sample]
+  std::vector<int> results(kTasksCount);
+
+  engine::TaskGroup group;
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    group.AsyncNoSpan([&results, i] { results[i] = static_cast<int>(i); });
+  }
+  // Rethrows the first exception of the children, if any
+  group.Wait();
+  /// [Sample]
+
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    EXPECT_EQ(results[i], static_cast<int>(i));
+  }
+  EXPECT_EQ(group.ActiveTasksApprox(), 0);
+}
+
+UTEST(TaskGroup, Arguments) {
+  int result = 0;
+  engine::TaskGroup group;
+  group.AsyncNoSpan([&result](int x, int y) { result = x + y; }, 1, 2);
+  group.Wait();
+  EXPECT_EQ(result, 3);
+}
+
+UTEST(TaskGroup, WaitWithoutTasks) {
+  engine::TaskGroup group;
+  UEXPECT_NO_THROW(group.Wait());
+}
+
+UTEST_MT(TaskGroup, ExceptionCancelsSiblings, 4) {
+  engine::TaskGroup group;
+  for (std::size_t i = 0; i < kTasksCount; ++i) {
+    group.AsyncNoSpan([] { EXPECT_TRUE(WaitForCancel()); });
+  }
+  group.AsyncNoSpan([] { throw TestError{}; });
+
+  UEXPECT_THROW(group.Wait(), TestError);
+  EXPECT_EQ(group.ActiveTasksApprox(), 0);
+}
+
+UTEST(TaskGroup, NonStdException) {
+  engine::TaskGroup group;
+  // NOLINTNEXTLINE(hicpp-exception-baseclass)
+  group.AsyncNoSpan([] { throw 42; });
+
+  int thrown = 0;
+  try {
+    group.Wait();
+  } catch (int value) {
+    thrown = value;
+  }
+  EXPECT_EQ(thrown, 42);
+}
+
+UTEST_MT(TaskGroup, Cancel, 2) {
+  engine::TaskGroup group;
+  for (std::size_t i = 0; i < kTasksCount; ++i) {
+    group.AsyncNoSpan([] { EXPECT_TRUE(WaitForCancel()); });
+  }
+  engine::Yield();
+  group.Cancel();
+  group.Wait();
+
+  // The children started after the cancellation do not run
+  bool is_started = false;
+  group.AsyncNoSpan([&is_started] { is_started = true; });
+  group.Wait();
+  EXPECT_FALSE(is_started);
+}
+
+UTEST_MT(TaskGroup, ParentCancellation, 2) {
+  std::atomic<std::size_t> cancelled{0};
+  engine::SingleConsumerEvent started;
+
+  auto parent = engine::AsyncNoSpan([&] {
+    engine::TaskGroup group;
+    for (std::size_t i = 0; i < kTasksCount; ++i) {
+      group.AsyncNoSpan([&] {
+        started.Send();
+        if (WaitForCancel()) ++cancelled;
+      });
+    }
+    UEXPECT_THROW(group.Wait(), engine::WaitInterruptedException);
+    EXPECT_EQ(group.ActiveTasksApprox(), 0);
+  });
+
+  ASSERT_TRUE(started.WaitForEventFor(utest::kMaxTestWaitTime));
+  parent.SyncCancel();
+  EXPECT_GE(cancelled.load(), 1);
+}
+
+UTEST_MT(TaskGroup, ParentCancellationWithoutWait, 2) {
+  engine::SingleConsumerEvent started;
+  engine::SingleConsumerEvent child_cancelled;
+
+  auto parent = engine::AsyncNoSpan([&] {
+    engine::TaskGroup group;
+    group.AsyncNoSpan([&] {
+      started.Send();
+      if (WaitForCancel()) child_cancelled.Send();
+    });
+
+    // The parent is busy with something else than the group
+    const engine::TaskCancellationBlocker cancel_blocker;
+    EXPECT_TRUE(child_cancelled.WaitForEventFor(utest::kMaxTestWaitTime));
+  });
+
+  ASSERT_TRUE(started.WaitForEventFor(utest::kMaxTestWaitTime));
+  parent.RequestCancel();
+  parent.Get();
+}
+
+UTEST(TaskGroup, CriticalAfterCancel) {
+  bool is_started = false;
+
+  engine::TaskGroup group;
+  group.Cancel();
+  group.CriticalAsyncNoSpan([&is_started] {
+    is_started = true;
+    EXPECT_TRUE(engine::current_task::ShouldCancel());
+  });
+  group.Wait();
+  EXPECT_TRUE(is_started);
+}
+
+UTEST(TaskGroup, Deadline) {
+  bool cancelled = false;
+  {
+    engine::TaskGroup group{engine::current_task::GetTaskProcessor(),
+                            engine::Deadline::FromDuration(10ms)};
+    group.AsyncNoSpan([&cancelled] { cancelled = WaitForCancel(); });
+    group.Wait();
+  }
+  EXPECT_TRUE(cancelled);
+}
+
+UTEST(TaskGroup, CancelAndWaitInDtor) {
+  std::atomic<bool> cancelled{false};
+  auto shared = std::make_shared<int>(1);
+  {
+    engine::TaskGroup group;
+    group.AsyncNoSpan([shared, &cancelled] { cancelled = WaitForCancel(); });
+    engine::SleepFor(10ms);
+    EXPECT_EQ(shared.use_count(), 2);
+  }
+  EXPECT_TRUE(cancelled);
+  EXPECT_EQ(shared.use_count(), 1);
+}
+
+USERVER_NAMESPACE_END
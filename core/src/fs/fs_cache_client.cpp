@@ -1,8 +1,11 @@
 #include <userver/fs/fs_cache_client.hpp>
 
+#include <utility>
+
 #include <userver/engine/task/task_processor_fwd.hpp>
 #include <userver/rcu/rcu_map.hpp>
 #include <userver/utils/periodic_task.hpp>
+#include <userver/utils/statistics/writer.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
@@ -11,7 +14,16 @@ namespace fs {
 FsCacheClient::FsCacheClient(std::string_view dir,
                              std::chrono::milliseconds update_period,
                              engine::TaskProcessor& tp)
-    : dir_(dir), update_period_(update_period), tp_(tp) {
+    : FsCacheClient(dir, update_period, tp, FsCacheSettings{}) {}
+
+FsCacheClient::FsCacheClient(std::string_view dir,
+                             std::chrono::milliseconds update_period,
+                             engine::TaskProcessor& tp,
+                             FsCacheSettings settings)
+    : dir_(dir),
+      update_period_(update_period),
+      tp_(tp),
+      settings_(std::move(settings)) {
   UpdateCache();
 
   if (update_period_ == std::chrono::milliseconds(0)) {
@@ -24,8 +36,22 @@ FsCacheClient::FsCacheClient(std::string_view dir,
 }
 
 void FsCacheClient::UpdateCache() {
-  auto map = fs::ReadRecursiveFilesInfoWithData(
-      tp_, dir_, {fs::SettingsReadFile::kSkipHidden});
+  auto map = fs::ReadRecursiveFilesInfoWithData(tp_, dir_, settings_,
+                                                data_.GetSnapshot());
+
+  std::size_t heap_bytes = 0;
+  std::size_t mapped_bytes = 0;
+  std::size_t encoded_variants = 0;
+  for (const auto& [path, info] : map) {
+    heap_bytes += info->data.size();
+    if (info->mapped_file) mapped_bytes += info->size;
+    encoded_variants += info->encoded_variants.size();
+  }
+  files_ = map.size();
+  heap_bytes_ = heap_bytes;
+  mapped_bytes_ = mapped_bytes;
+  encoded_variants_ = encoded_variants;
+
   data_.Assign(std::move(map));
 }
 
@@ -38,6 +64,14 @@ FileInfoWithDataConstPtr FsCacheClient::TryGetFile(
   return nullptr;
 }
 
+void DumpMetric(utils::statistics::Writer& writer,
+                const FsCacheClient& client) {
+  writer["files"] = client.files_.load();
+  writer["heap-bytes"] = client.heap_bytes_.load();
+  writer["mapped-bytes"] = client.mapped_bytes_.load();
+  writer["encoded-variants"] = client.encoded_variants_.load();
+}
+
 }  // namespace fs
 
 USERVER_NAMESPACE_END
@@ -1,7 +1,17 @@
 #include <userver/fs/read.hpp>
 
+#include <sys/stat.h>
+
+#include <functional>
+#include <utility>
+
+#include <boost/filesystem/operations.hpp>
+#include <fmt/format.h>
+
 #include <userver/engine/async.hpp>
+#include <userver/fs/blocking/mapped_file.hpp>
 #include <userver/fs/blocking/read.hpp>
+#include <utils/check_syscall.hpp>
 
 USERVER_NAMESPACE_BEGIN
 
@@ -9,6 +19,16 @@ namespace fs {
 
 namespace {
 
+// The sibling files with these suffixes are the precompressed variants
+constexpr std::pair<std::string_view, std::string_view> kEncodedSuffixes[] = {
+    {".gz", "gzip"},
+    {".br", "br"},
+    {".zst", "zstd"},
+};
+
+using MutableFilesMap =
+    std::unordered_map<std::string, std::shared_ptr<FileInfoWithData>>;
+
 bool IsHiddenFile(const boost::filesystem::path& path) {
   auto name = path.filename().native();
   UASSERT(!name.empty());
@@ -21,8 +41,101 @@ std::string GetRelative(std::string_view path, std::string_view dir) {
   return std::string{rel};
 }
 
+struct ::stat GetStats(const boost::filesystem::path& path) {
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
+  struct ::stat stats;
+  utils::CheckSyscall(::stat(path.c_str(), &stats), "calling ::stat for '{}'",
+                      path.string());
+  return stats;
+}
+
+// Like the validator of nginx, but with the inode and the modification time in
+// nanoseconds, so that a rewrite within the same second changes it too. Does
+// not require hashing the contents.
+std::string MakeETag(const struct ::stat& stats) {
+#ifdef __APPLE__
+  const auto& modified = stats.st_mtimespec;
+#else
+  const auto& modified = stats.st_mtim;
+#endif
+  return fmt::format("\"{:x}-{:x}.{:x}-{:x}\"",
+                     static_cast<std::uint64_t>(stats.st_ino),
+                     static_cast<std::uint64_t>(modified.tv_sec),
+                     static_cast<std::uint64_t>(modified.tv_nsec),
+                     static_cast<std::uint64_t>(stats.st_size));
+}
+
+// Returns the mapping of the previous read if the file is not modified since
+std::shared_ptr<const blocking::MappedFile> FindMapping(
+    const FileInfoWithDataMap& previous, const std::string& relative_path) {
+  const auto it = previous.find(relative_path);
+  if (it == previous.end() || !it->second->mapped_file) return nullptr;
+  if (it->second->mapped_file->IsModified()) return nullptr;
+  return it->second->mapped_file;
+}
+
+std::shared_ptr<FileInfoWithData> ReadFile(
+    const boost::filesystem::path& path, const ReadFilesSettings& settings,
+    std::shared_ptr<const blocking::MappedFile> previous_mapping) {
+  auto info = std::make_shared<FileInfoWithData>();
+  const auto stats = GetStats(path);
+  info->size = static_cast<std::size_t>(stats.st_size);
+  info->extension = path.extension().string();
+  info->etag = MakeETag(stats);
+
+  if (settings.mmap_min_size && info->size >= *settings.mmap_min_size) {
+    info->mapped_file =
+        previous_mapping ? std::move(previous_mapping)
+                         : std::make_shared<const blocking::MappedFile>(
+                               blocking::MappedFile::Open(path.string()));
+    info->size = info->mapped_file->GetData().size();
+  } else {
+    info->data = blocking::ReadFileContents(path.string());
+  }
+  return info;
+}
+
+void AttachEncodedVariants(MutableFilesMap& files) {
+  for (auto& [path, info] : files) {
+    for (const auto& [suffix, coding] : kEncodedSuffixes) {
+      const auto it = files.find(path + std::string{suffix});
+      if (it == files.end()) continue;
+      info->encoded_variants.emplace_back(std::string{coding}, it->second);
+    }
+  }
+}
+
+// Blocking, runs on the async task processor
+FileInfoWithDataMap ReadFiles(const std::string& path,
+                              const ReadFilesSettings& settings,
+                              const FileInfoWithDataMap& previous) {
+  MutableFilesMap files;
+  for (const auto& f : boost::filesystem::recursive_directory_iterator(path)) {
+    // only files
+    if (f.status().type() != boost::filesystem::regular_file) continue;
+    if ((settings.flags & SettingsReadFile::kSkipHidden) &&
+        IsHiddenFile(f.path()))
+      continue;
+    auto relative_path = GetRelative(f.path().string(), path);
+    auto mapping = settings.mmap_min_size
+                       ? FindMapping(previous, relative_path)
+                       : nullptr;
+    files.emplace(std::move(relative_path),
+                  ReadFile(f.path(), settings, std::move(mapping)));
+  }
+  if (settings.precompressed_variants) AttachEncodedVariants(files);
+
+  return {std::make_move_iterator(files.begin()),
+          std::make_move_iterator(files.end())};
+}
+
 }  // namespace
 
+std::string_view FileInfoWithData::GetContent() const {
+  if (mapped_file) return mapped_file->GetData();
+  return data;
+}
+
 std::string ReadFileContents(engine::TaskProcessor& async_tp,
                              const std::string& path) {
   return engine::AsyncNoSpan(async_tp, &fs::blocking::ReadFileContents, path)
@@ -32,20 +145,17 @@ std::string ReadFileContents(engine::TaskProcessor& async_tp,
 FileInfoWithDataMap ReadRecursiveFilesInfoWithData(
     engine::TaskProcessor& async_tp, const std::string& path,
     utils::Flags<SettingsReadFile> flags) {
-  FileInfoWithDataMap data{};
-  for (const auto& f : boost::filesystem::recursive_directory_iterator(path)) {
-    // only files
-    if (f.status().type() != boost::filesystem::regular_file) continue;
-    if ((flags & SettingsReadFile::kSkipHidden) && IsHiddenFile(f.path()))
-      continue;
-    FileInfoWithData info{};
-    info.size = boost::filesystem::file_size(f.path());
-    info.extension = f.path().extension().string();
-    info.data = ReadFileContents(async_tp, f.path().string());
-    data[GetRelative(f.path().string(), path)] =
-        std::make_shared<const FileInfoWithData>(std::move(info));
-  }
-  return data;
+  ReadFilesSettings settings;
+  settings.flags = flags;
+  return ReadRecursiveFilesInfoWithData(async_tp, path, settings, {});
+}
+
+FileInfoWithDataMap ReadRecursiveFilesInfoWithData(
+    engine::TaskProcessor& async_tp, const std::string& path,
+    const ReadFilesSettings& settings, const FileInfoWithDataMap& previous) {
+  return engine::AsyncNoSpan(async_tp, &ReadFiles, std::cref(path),
+                             std::cref(settings), std::cref(previous))
+      .Get();
 }
 
 bool FileExists(engine::TaskProcessor& async_tp, const std::string& path) {
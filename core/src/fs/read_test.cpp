@@ -0,0 +1,42 @@
+#include <userver/utest/utest.hpp>
+
+#include <userver/engine/task/task.hpp>
+#include <userver/fs/blocking/mapped_file.hpp>
+#include <userver/fs/blocking/temp_directory.hpp>
+#include <userver/fs/blocking/write.hpp>
+#include <userver/fs/read.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+UTEST(AsyncFs, ReadRecursiveFilesInfoWithDataReusesMappings) {
+  const auto dir = fs::blocking::TempDirectory::Create();
+  fs::blocking::RewriteFileContents(dir.GetPath() + "/same", "same");
+  fs::blocking::RewriteFileContents(dir.GetPath() + "/changed", "old");
+  fs::blocking::RewriteFileContents(dir.GetPath() + "/changed.gz", "gz");
+
+  auto& async_tp = engine::current_task::GetTaskProcessor();
+  fs::ReadFilesSettings settings;
+  settings.mmap_min_size = 0;
+  settings.precompressed_variants = true;
+
+  const auto first =
+      fs::ReadRecursiveFilesInfoWithData(async_tp, dir.GetPath(), settings, {});
+  ASSERT_EQ(first.size(), 3);
+  EXPECT_EQ(first.at("/changed")->encoded_variants.size(), 1);
+
+  fs::blocking::RewriteFileContents(dir.GetPath() + "/changed.tmp", "new");
+  fs::blocking::Rename(dir.GetPath() + "/changed.tmp",
+                       dir.GetPath() + "/changed");
+  const auto second = fs::ReadRecursiveFilesInfoWithData(
+      async_tp, dir.GetPath(), settings, first);
+  ASSERT_EQ(second.size(), 3);
+
+  EXPECT_EQ(second.at("/same")->mapped_file, first.at("/same")->mapped_file);
+  EXPECT_NE(second.at("/changed")->mapped_file,
+            first.at("/changed")->mapped_file);
+  EXPECT_EQ(second.at("/changed")->GetContent(), "new");
+  EXPECT_EQ(first.at("/changed")->GetContent(), "old");
+  EXPECT_EQ(second.at("/changed")->encoded_variants.size(), 1);
+}
+
+USERVER_NAMESPACE_END
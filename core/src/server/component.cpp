@@ -130,6 +130,11 @@ properties:
                         defaultDescription: 504
                         minimum: 400
                         maximum: 599
+                    arena_initial_size:
+                        type: integer
+                        description: size of the first block of the per-request arena, 0 to disable the arena
+                        defaultDescription: 0
+                        minimum: 0
             connection:
                 type: object
                 description: connection options
@@ -141,15 +146,36 @@ properties:
                         defaultDescription: 32 * 1024
                     requests_queue_size_threshold:
                         type: integer
-                        description: drop requests from handlers that allow trottling if there's more pending requests than allowed by this value
+                        description: max count of the pipelined HTTP/1.1 requests of a connection that are processed concurrently, the next requests are not read until some responses are sent
                         defaultDescription: 100
                     keepalive_timeout:
                         type: integer
                         description: timeout in seconds to drop connection if there's not data received from it
                         defaultDescription: 600
+                    idle_parking_timeout:
+                        type: string
+                        description: an HTTP/1.1 keep-alive connection idle for this long frees its tasks and buffer until new data arrives, 0s to disable
+                        defaultDescription: 1s
+                    http2_enabled:
+                        type: boolean
+                        description: accept HTTP/2 connections with prior knowledge (h2c) besides the HTTP/1.1 ones
+                        defaultDescription: false
+                    http2_max_concurrent_streams:
+                        type: integer
+                        description: max count of concurrently processed HTTP/2 streams of a connection
+                        defaultDescription: 100
+                        minimum: 1
+                    http2_initial_window_size:
+                        type: integer
+                        description: HTTP/2 flow control window of a stream for the request bodies
+                        defaultDescription: 1024 * 1024
+                        minimum: 65535
+                        maximum: 2147483647
             shards:
                 type: integer
-                description: how many concurrent tasks harvest data from a single socket; do not set if not sure what it is doing
+                description: how many SO_REUSEPORT sockets to listen on, each with its own accept loop; the kernel distributes the new connections among them
+                defaultDescription: count of the event threads
+                minimum: 1
     listener-monitor:
         type: object
         description: describes the special monitoring socket, used for getting statistics and processing utility requests that should succeed even is the main socket is under heavy pressure
@@ -138,6 +138,37 @@ properties:
         defaultDescription: 504
         minimum: 400
         maximum: 599
+    response_compression:
+        type: object
+        description: |
+            compression of the responses with the content coding negotiated
+            by the Accept-Encoding request header; the responses are not
+            compressed if the option is missing
+        additionalProperties: false
+        properties:
+            encodings:
+                type: array
+                description: content codings in the order of preference
+                defaultDescription: '[gzip]'
+                items:
+                    type: string
+                    description: content coding
+                    enum:
+                      - gzip
+                      - br
+                      - zstd
+            level:
+                type: integer
+                description: compression level of the coding
+                defaultDescription: <the coding default>
+            min_size:
+                type: integer
+                description: responses smaller than this are not compressed, does not apply to the streamed responses
+                defaultDescription: 1024
+            task_processor:
+                type: string
+                description: task processor to compress the responses on
+                defaultDescription: <the handler task_processor>
 )");
 }
 
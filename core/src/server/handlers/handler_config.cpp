@@ -31,6 +31,22 @@ FallbackHandler Parse(const yaml_config::YamlConfig& yaml,
   return FallbackHandlerFromString(value);
 }
 
+ResponseCompressionConfig Parse(const yaml_config::YamlConfig& yaml,
+                                formats::parse::To<ResponseCompressionConfig>) {
+  ResponseCompressionConfig config;
+  config.encodings =
+      yaml["encodings"].As<std::vector<std::string>>(config.encodings);
+  config.level = yaml["level"].As<std::optional<int>>();
+  config.min_size = yaml["min_size"].As<std::size_t>(config.min_size);
+  config.task_processor =
+      yaml["task_processor"].As<std::optional<std::string>>();
+  if (config.encodings.empty()) {
+    throw std::runtime_error(
+        fmt::format("Empty encodings list at {}", yaml.GetPath()));
+  }
+  return config;
+}
+
 HandlerConfig ParseHandlerConfigsWithDefaults(
     const yaml_config::YamlConfig& value,
     const server::ServerConfig& server_config, bool is_monitor) {
@@ -107,6 +123,10 @@ HandlerConfig ParseHandlerConfigsWithDefaults(
       value["deadline_expired_status_code"].As<http::HttpStatus>(
           handler_defaults.deadline_expired_status_code);
 
+  config.response_compression =
+      value["response_compression"]
+          .As<std::optional<ResponseCompressionConfig>>();
+
   return config;
 }
 
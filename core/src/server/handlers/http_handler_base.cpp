@@ -6,6 +6,7 @@
 #include <compression/gzip.hpp>
 #include <server/handlers/http_handler_base_statistics.hpp>
 #include <server/handlers/http_server_settings.hpp>
+#include <server/handlers/response_compression.hpp>
 #include <server/http/http_request_impl.hpp>
 #include <server/server_config.hpp>
 #include <userver/baggage/baggage.hpp>
@@ -504,6 +505,21 @@ logging::LogExtra LogRequestExtra(bool need_log_request_headers,
   return log_extra;
 }
 
+std::unique_ptr<ResponseCompression> MakeResponseCompression(
+    const HandlerConfig& config,
+    const components::ComponentContext& context) {
+  if (!config.response_compression) return nullptr;
+
+  const auto& compression_config = *config.response_compression;
+  engine::TaskProcessor* task_processor = nullptr;
+  if (compression_config.task_processor) {
+    task_processor =
+        &context.GetTaskProcessor(*compression_config.task_processor);
+  }
+  return std::make_unique<ResponseCompression>(compression_config,
+                                               task_processor);
+}
+
 }  // namespace
 
 HttpHandlerBase::HttpHandlerBase(const components::ComponentConfig& config,
@@ -519,6 +535,7 @@ HttpHandlerBase::HttpHandlerBase(const components::ComponentConfig& config,
               .GetTracingManager()),
       handler_statistics_(std::make_unique<HttpHandlerStatistics>()),
       request_statistics_(std::make_unique<HttpRequestStatistics>()),
+      response_compression_(MakeResponseCompression(GetConfig(), context)),
       auth_checkers_(auth::CreateAuthCheckers(
           context, GetConfig(),
           context.FindComponent<components::AuthCheckerSettings>().Get())),
@@ -574,6 +591,9 @@ HttpHandlerBase::HttpHandlerBase(const components::ComponentConfig& config,
         if constexpr (kIncludeServerHttpMetrics) {
           FormatStatistics(result["request"], *request_statistics_);
         }
+        if (response_compression_) {
+          result["response-compression"] = *response_compression_;
+        }
       },
       std::move(labels));
 
@@ -595,6 +615,11 @@ void HttpHandlerBase::HandleRequestStream(
   auto& http_response = http_request.GetHttpResponse();
   server::http::ResponseBodyStream response_body_stream{
       response.GetBodyProducer(), http_response};
+  if (response_compression_) {
+    AddVaryAcceptEncoding(http_response);
+    response_body_stream.compressor_ =
+        response_compression_->MakeBodyCompressor(http_request);
+  }
 
   // Just in case HandleStreamRequest() throws an exception.
   // Though it can be changed in HandleStreamRequest().
@@ -724,6 +749,15 @@ void HttpHandlerBase::HandleRequest(request::RequestBase& request,
     LOG_ERROR() << "unable to handle request: " << ex;
   }
 
+  if (response_compression_ && !response.IsBodyStreamed()) {
+    try {
+      response_compression_->CompressResponse(http_request, response);
+    } catch (const std::exception& ex) {
+      LOG_WARNING() << "unable to compress the response, sending it as is: "
+                    << ex;
+    }
+  }
+
   SetResponseAcceptEncoding(response);
   SetResponseServerHostname(response);
   response.SetHeadersEnd();
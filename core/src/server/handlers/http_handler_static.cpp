@@ -1,9 +1,15 @@
 #include <userver/server/handlers/http_handler_static.hpp>
 
+#include <fmt/format.h>
+
+#include <server/handlers/response_compression.hpp>
+#include <server/handlers/static_file_request.hpp>
 #include <userver/components/component_config.hpp>
 #include <userver/components/component_context.hpp>
 #include <userver/dynamic_config/storage/component.hpp>
 #include <userver/dynamic_config/value.hpp>
+#include <userver/fs/blocking/mapped_file.hpp>
+#include <userver/http/common_headers.hpp>
 #include <userver/yaml_config/merge_schemas.hpp>
 
 USERVER_NAMESPACE_BEGIN
@@ -18,6 +24,42 @@ auto ParseContentTypeMap(const dynamic_config::DocsMap& docs_map) {
 }
 constexpr dynamic_config::Key<ParseContentTypeMap> kContentTypeMap{};
 
+// Chooses the precompressed variant of the file accepted by the client, if any
+const fs::FileInfoWithData& ChooseRepresentation(
+    const http::HttpRequest& request, const fs::FileInfoWithData& file,
+    http::HttpResponse& response) {
+  if (file.encoded_variants.empty()) return file;
+  AddVaryAcceptEncoding(response);
+  // The ranges are served of the identity representation only
+  if (request.HasHeader(USERVER_NAMESPACE::http::headers::kRange)) return file;
+
+  std::vector<std::string_view> codings;
+  codings.reserve(file.encoded_variants.size());
+  for (const auto& [coding, variant] : file.encoded_variants) {
+    codings.push_back(coding);
+  }
+  const auto index = NegotiateEncoding(
+      request.GetHeader(USERVER_NAMESPACE::http::headers::kAcceptEncoding),
+      codings);
+  if (!index) return file;
+
+  const auto& [coding, variant] = file.encoded_variants[*index];
+  response.SetContentEncoding(coding);
+  return *variant;
+}
+
+// The mapped files are sent with sendfile, the others are copied
+std::string ServeContent(const fs::FileInfoWithData& file, ByteRange range,
+                         http::HttpResponse& response,
+                         engine::TaskProcessor& fs_task_processor) {
+  if (file.mapped_file) {
+    response.SetFileBody(file.mapped_file, range.offset, range.size,
+                         fs_task_processor);
+    return {};
+  }
+  return file.data.substr(range.offset, range.size);
+}
+
 }  // namespace
 
 HttpHandlerStatic::HttpHandlerStatic(
@@ -35,14 +77,57 @@ std::string HttpHandlerStatic::HandleRequestThrow(
     const http::HttpRequest& request, request::RequestContext&) const {
   LOG_DEBUG() << "Handler: " << request.GetRequestPath();
   const auto file = storage_.TryGetFile(request.GetRequestPath());
-  if (file) {
-    const auto config = config_.GetSnapshot();
-    request.GetHttpResponse().SetContentType(
-        config[kContentTypeMap][file->extension]);
-    return file->data;
+  if (!file) {
+    request.GetResponse().SetStatusNotFound();
+    return "File not found";
   }
-  request.GetResponse().SetStatusNotFound();
-  return "File not found";
+
+  auto& response = request.GetHttpResponse();
+  const auto config = config_.GetSnapshot();
+  response.SetContentType(config[kContentTypeMap][file->extension]);
+
+  const auto& representation = ChooseRepresentation(request, *file, response);
+  const auto content_size = representation.GetContent().size();
+  if (!representation.etag.empty()) {
+    response.SetHeader(USERVER_NAMESPACE::http::headers::kETag,
+                       representation.etag);
+  }
+  if (MatchesETag(
+          request.GetHeader(USERVER_NAMESPACE::http::headers::kIfNoneMatch),
+          representation.etag)) {
+    response.SetStatus(http::HttpStatus::kNotModified);
+    return {};
+  }
+  if (&representation == file.get()) {
+    response.SetHeader(USERVER_NAMESPACE::http::headers::kAcceptRanges,
+                       std::string{"bytes"});
+  }
+
+  const auto& range_header =
+      request.GetHeader(USERVER_NAMESPACE::http::headers::kRange);
+  if (!range_header.empty() &&
+      IsRangeApplicable(
+          request.GetHeader(USERVER_NAMESPACE::http::headers::kIfRange),
+          representation.etag)) {
+    if (const auto range = ParseByteRange(range_header, content_size)) {
+      if (range->size == 0) {
+        response.SetStatus(http::HttpStatus::kRangeNotSatisfiable);
+        response.SetHeader(USERVER_NAMESPACE::http::headers::kContentRange,
+                           fmt::format("bytes */{}", content_size));
+        return {};
+      }
+      response.SetStatus(http::HttpStatus::kPartialContent);
+      response.SetHeader(
+          USERVER_NAMESPACE::http::headers::kContentRange,
+          fmt::format("bytes {}-{}/{}", range->offset,
+                      range->offset + range->size - 1, content_size));
+      return ServeContent(representation, *range, response,
+                          storage_.GetTaskProcessor());
+    }
+  }
+
+  return ServeContent(representation, ByteRange{0, content_size}, response,
+                      storage_.GetTaskProcessor());
 }
 
 yaml_config::Schema HttpHandlerStatic::GetStaticConfigSchema() {
@@ -0,0 +1,305 @@
+#include <server/handlers/response_compression.hpp>
+
+#include <time.h>
+
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include <userver/engine/async.hpp>
+#include <userver/http/common_headers.hpp>
+#include <userver/utils/assert.hpp>
+#include <userver/utils/str_icase.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::handlers {
+
+namespace {
+
+constexpr int kMaxQuality = 1000;
+
+std::string_view TrimView(std::string_view value) {
+  const auto begin = value.find_first_not_of(" \t");
+  if (begin == std::string_view::npos) return {};
+  const auto end = value.find_last_not_of(" \t");
+  return value.substr(begin, end - begin + 1);
+}
+
+// Pops the next element of a comma or semicolon separated list
+std::string_view PopElement(std::string_view& list, char separator) {
+  const auto pos = list.find(separator);
+  const auto element = list.substr(0, pos);
+  list.remove_prefix(pos == std::string_view::npos ? list.size() : pos + 1);
+  return TrimView(element);
+}
+
+// Returns the qvalue in thousandths, RFC 9110 12.4.2
+std::optional<int> ParseQValue(std::string_view value) {
+  if (value.empty() || value.size() > 5) return std::nullopt;
+  if (value[0] != '0' && value[0] != '1') return std::nullopt;
+
+  int result = (value[0] - '0') * kMaxQuality;
+  if (value.size() == 1) return result;
+  if (value[1] != '.') return std::nullopt;
+
+  int scale = kMaxQuality / 10;
+  for (const char c : value.substr(2)) {
+    if (c < '0' || c > '9') return std::nullopt;
+    result += (c - '0') * scale;
+    scale /= 10;
+  }
+  if (result > kMaxQuality) return std::nullopt;
+  return result;
+}
+
+// Returns the quality of a coding from its parameters. The codings with
+// malformed qvalues are treated as not acceptable.
+int ParseQuality(std::string_view params) {
+  while (!params.empty()) {
+    const auto param = PopElement(params, ';');
+    if (param.size() < 2 || (param[0] != 'q' && param[0] != 'Q') ||
+        param[1] != '=') {
+      continue;
+    }
+    return ParseQValue(TrimView(param.substr(2))).value_or(0);
+  }
+  return kMaxQuality;
+}
+
+bool MatchesEncoding(std::string_view coding, std::string_view name) {
+  const utils::StrIcaseEqual equal;
+  // RFC 9110 8.4.1.3: x-gzip is equivalent to gzip
+  return equal(coding, name) || (name == "gzip" && equal(coding, "x-gzip"));
+}
+
+std::chrono::microseconds GetThreadCpuTime() noexcept {
+  struct timespec ts {};
+  ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::seconds{ts.tv_sec} + std::chrono::nanoseconds{ts.tv_nsec});
+}
+
+bool IsBodyAllowed(http::HttpStatus status) {
+  return status != http::HttpStatus::kNoContent &&
+         status != http::HttpStatus::kNotModified;
+}
+
+// The content coding applies to the whole representation, not to its part
+bool IsPartialContent(http::HttpStatus status) {
+  return status == http::HttpStatus::kPartialContent;
+}
+
+}  // namespace
+
+ResponseCompression::ResponseCompression(
+    const ResponseCompressionConfig& config,
+    engine::TaskProcessor* task_processor)
+    : level_(config.level),
+      min_size_(config.min_size),
+      task_processor_(task_processor) {
+  for (const auto& name : config.encodings) {
+    const auto encoding = compression::EncodingFromString(name);
+    if (!compression::IsAvailable(encoding)) {
+      throw std::runtime_error(fmt::format(
+          "response compression with '{}' is not built in, enable the "
+          "corresponding USERVER_FEATURE_* CMake option",
+          name));
+    }
+    encodings_.push_back(encoding);
+    encoding_names_.push_back(compression::ToString(encoding));
+  }
+  UASSERT(!encodings_.empty());
+}
+
+template <typename Func>
+void ResponseCompression::Run(compression::Encoding encoding,
+                              std::size_t size, Func&& func) const {
+  auto measured = [this, encoding, &func] {
+    const auto start = GetThreadCpuTime();
+    func();
+    const auto elapsed = GetThreadCpuTime() - start;
+    GetStatistics(encoding).cpu_time_us +=
+        utils::statistics::Rate{static_cast<std::uint64_t>(elapsed.count())};
+  };
+
+  if (!task_processor_ || size < kMinOffloadSize) {
+    measured();
+    return;
+  }
+  engine::AsyncNoSpan(*task_processor_, std::move(measured)).Get();
+}
+
+ResponseCompressionStatistics& ResponseCompression::GetStatistics(
+    compression::Encoding encoding) const {
+  return statistics_[static_cast<std::size_t>(encoding)];
+}
+
+std::optional<compression::Encoding> ResponseCompression::Negotiate(
+    std::string_view accept_encoding) const {
+  const auto index = NegotiateEncoding(accept_encoding, encoding_names_);
+  if (!index) return std::nullopt;
+  return encodings_[*index];
+}
+
+void ResponseCompression::CompressResponse(const http::HttpRequest& request,
+                                           http::HttpResponse& response) const {
+  UASSERT(!response.IsBodyStreamed());
+
+  const auto& data = response.GetData();
+  // An empty data may stand for a file body
+  if (data.empty() || data.size() < min_size_ ||
+      !IsBodyAllowed(response.GetStatus()) ||
+      IsPartialContent(response.GetStatus())) {
+    return;
+  }
+  // The handler has encoded the data on its own
+  if (response.HasHeader(USERVER_NAMESPACE::http::headers::kContentEncoding)) {
+    return;
+  }
+
+  AddVaryAcceptEncoding(response);
+  const auto encoding = Negotiate(
+      request.GetHeader(USERVER_NAMESPACE::http::headers::kAcceptEncoding));
+  if (!encoding) return;
+
+  std::string compressed;
+  Run(*encoding, data.size(), [&] {
+    compressed = compression::Compress(*encoding, data, level_);
+  });
+
+  auto& stats = GetStatistics(*encoding);
+  stats.original_bytes += utils::statistics::Rate{data.size()};
+  stats.compressed_bytes += utils::statistics::Rate{compressed.size()};
+  ++stats.responses;
+
+  response.SetHeader(USERVER_NAMESPACE::http::headers::kContentEncoding,
+                     std::string{compression::ToString(*encoding)});
+  WeakenETag(response);
+  response.SetData(std::move(compressed));
+}
+
+std::unique_ptr<ResponseBodyCompressor> ResponseCompression::MakeBodyCompressor(
+    const http::HttpRequest& request) const {
+  const auto encoding = Negotiate(
+      request.GetHeader(USERVER_NAMESPACE::http::headers::kAcceptEncoding));
+  if (!encoding) return nullptr;
+  return std::make_unique<ResponseBodyCompressor>(*this, *encoding);
+}
+
+void DumpMetric(utils::statistics::Writer& writer,
+                const ResponseCompression& compression) {
+  for (const auto encoding : compression.encodings_) {
+    const auto& stats = compression.GetStatistics(encoding);
+    const auto original_bytes = stats.original_bytes.Load();
+    const auto compressed_bytes = stats.compressed_bytes.Load();
+    const utils::statistics::LabelView label{"encoding",
+                                             compression::ToString(encoding)};
+
+    writer["responses"].ValueWithLabels(stats.responses.Load(), label);
+    writer["original-bytes"].ValueWithLabels(original_bytes, label);
+    writer["compressed-bytes"].ValueWithLabels(compressed_bytes, label);
+    writer["cpu-time-us"].ValueWithLabels(stats.cpu_time_us.Load(), label);
+    writer["ratio"].ValueWithLabels(
+        compressed_bytes.value
+            ? static_cast<double>(original_bytes.value) /
+                  static_cast<double>(compressed_bytes.value)
+            : 0.0,
+        label);
+  }
+}
+
+ResponseBodyCompressor::ResponseBodyCompressor(
+    const ResponseCompression& owner, compression::Encoding encoding)
+    : owner_(owner),
+      encoding_(encoding),
+      compressor_(compression::MakeCompressor(encoding, owner.level_)) {}
+
+std::string ResponseBodyCompressor::Compress(std::string_view chunk) {
+  std::string compressed;
+  owner_.Run(encoding_, chunk.size(), [&] {
+    compressor_->Compress(chunk, /*flush=*/true, compressed);
+  });
+
+  auto& stats = owner_.GetStatistics(encoding_);
+  stats.original_bytes += utils::statistics::Rate{chunk.size()};
+  stats.compressed_bytes += utils::statistics::Rate{compressed.size()};
+  return compressed;
+}
+
+std::string ResponseBodyCompressor::Finish() {
+  std::string compressed;
+  // Only the buffered remainder is left, it is not worth offloading
+  owner_.Run(encoding_, 0, [&] { compressor_->Finish(compressed); });
+
+  auto& stats = owner_.GetStatistics(encoding_);
+  stats.compressed_bytes += utils::statistics::Rate{compressed.size()};
+  ++stats.responses;
+  return compressed;
+}
+
+std::optional<std::size_t> NegotiateEncoding(
+    std::string_view accept_encoding,
+    const std::vector<std::string_view>& codings) {
+  std::vector<std::optional<int>> qualities(codings.size());
+  std::optional<int> any_quality;
+
+  while (!accept_encoding.empty()) {
+    auto params = PopElement(accept_encoding, ',');
+    const auto coding = PopElement(params, ';');
+    if (coding.empty()) continue;
+
+    const auto quality = ParseQuality(params);
+    if (coding == "*") {
+      any_quality = quality;
+      continue;
+    }
+    for (std::size_t i = 0; i < codings.size(); ++i) {
+      if (MatchesEncoding(coding, codings[i])) qualities[i] = quality;
+    }
+  }
+
+  std::optional<std::size_t> result;
+  int best_quality = 0;
+  for (std::size_t i = 0; i < codings.size(); ++i) {
+    const auto quality = qualities[i].value_or(any_quality.value_or(0));
+    if (quality > best_quality) {
+      best_quality = quality;
+      result = i;
+    }
+  }
+  return result;
+}
+
+void AddVaryAcceptEncoding(http::HttpResponse& response) {
+  const auto& vary =
+      response.GetHeader(USERVER_NAMESPACE::http::headers::kVary);
+  if (vary.empty()) {
+    response.SetHeader(USERVER_NAMESPACE::http::headers::kVary,
+                       std::string{"Accept-Encoding"});
+    return;
+  }
+
+  auto values = std::string_view{vary};
+  while (!values.empty()) {
+    const auto value = PopElement(values, ',');
+    if (value == "*" || utils::StrIcaseEqual{}(value, "Accept-Encoding")) {
+      return;
+    }
+  }
+  response.SetHeader(USERVER_NAMESPACE::http::headers::kVary,
+                     vary + ", Accept-Encoding");
+}
+
+void WeakenETag(http::HttpResponse& response) {
+  const auto& etag =
+      response.GetHeader(USERVER_NAMESPACE::http::headers::kETag);
+  if (etag.empty() || etag.rfind("W/", 0) == 0) return;
+  response.SetHeader(USERVER_NAMESPACE::http::headers::kETag, "W/" + etag);
+}
+
+}  // namespace server::handlers
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <compression/compressor.hpp>
+
+#include <userver/engine/task/task_processor_fwd.hpp>
+#include <userver/server/handlers/handler_config.hpp>
+#include <userver/server/http/http_request.hpp>
+#include <userver/server/http/http_response.hpp>
+#include <userver/utils/statistics/rate_counter.hpp>
+#include <userver/utils/statistics/writer.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::handlers {
+
+class ResponseBodyCompressor;
+
+inline constexpr std::size_t kMinOffloadSize = 16 * 1024;
+
+inline constexpr std::size_t kEncodingsCount =
+    static_cast<std::size_t>(compression::Encoding::kZstd) + 1;
+
+struct ResponseCompressionStatistics final {
+  utils::statistics::RateCounter responses{};
+  utils::statistics::RateCounter original_bytes{};
+  utils::statistics::RateCounter compressed_bytes{};
+  utils::statistics::RateCounter cpu_time_us{};
+};
+
+// Compresses the responses of a handler with the content coding negotiated
+// by the Accept-Encoding request header. The compression runs either in the
+// request task or, if configured, on a separate task processor to keep the
+// CPU-heavy work off the request task processor. The data smaller than
+// kMinOffloadSize is compressed in place, as switching the tasks costs more.
+class ResponseCompression final {
+ public:
+  // @throws std::runtime_error for unknown or not built in encodings
+  ResponseCompression(const ResponseCompressionConfig& config,
+                      engine::TaskProcessor* task_processor);
+
+  // Returns the most preferred by the client of the configured encodings,
+  // ties are resolved by the configuration order
+  std::optional<compression::Encoding> Negotiate(
+      std::string_view accept_encoding) const;
+
+  // Replaces the response data with the compressed one if the client accepts
+  // one of the encodings and the data is large enough
+  // @throws compression::CompressionError
+  void CompressResponse(const http::HttpRequest& request,
+                        http::HttpResponse& response) const;
+
+  // Returns nullptr if the client accepts none of the encodings
+  std::unique_ptr<ResponseBodyCompressor> MakeBodyCompressor(
+      const http::HttpRequest& request) const;
+
+  friend void DumpMetric(utils::statistics::Writer& writer,
+                         const ResponseCompression& compression);
+
+ private:
+  friend class ResponseBodyCompressor;
+
+  template <typename Func>
+  void Run(compression::Encoding encoding, std::size_t size,
+           Func&& func) const;
+
+  ResponseCompressionStatistics& GetStatistics(
+      compression::Encoding encoding) const;
+
+  std::vector<compression::Encoding> encodings_;
+  std::vector<std::string_view> encoding_names_;
+  std::optional<int> level_;
+  std::size_t min_size_;
+  engine::TaskProcessor* task_processor_;
+
+  mutable std::array<ResponseCompressionStatistics, kEncodingsCount>
+      statistics_;
+};
+
+// Compresses the chunks of a streamed response body, each chunk is flushed
+// to be decodable by the client as soon as it is received
+class ResponseBodyCompressor final {
+ public:
+  ResponseBodyCompressor(const ResponseCompression& owner,
+                         compression::Encoding encoding);
+
+  compression::Encoding GetEncoding() const { return encoding_; }
+
+  // @throws compression::CompressionError
+  std::string Compress(std::string_view chunk);
+
+  // @throws compression::CompressionError
+  std::string Finish();
+
+ private:
+  const ResponseCompression& owner_;
+  const compression::Encoding encoding_;
+  std::unique_ptr<compression::Compressor> compressor_;
+};
+
+// Returns the index of the most preferred by the client of the content
+// codings, ties are resolved by the order of the codings
+std::optional<std::size_t> NegotiateEncoding(
+    std::string_view accept_encoding,
+    const std::vector<std::string_view>& codings);
+
+// Adds the Accept-Encoding to the Vary header of the response, the responses
+// that depend on the request header must not be cached regardless of it
+void AddVaryAcceptEncoding(http::HttpResponse& response);
+
+// Makes the ETag of the response weak: the compressed representation is not
+// byte-for-byte identical to the uncompressed one, RFC 9110 8.8.1
+void WeakenETag(http::HttpResponse& response);
+
+}  // namespace server::handlers
+
+USERVER_NAMESPACE_END
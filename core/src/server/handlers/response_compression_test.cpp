@@ -0,0 +1,63 @@
+#include <server/handlers/response_compression.hpp>
+
+#include <gtest/gtest.h>
+
+#include <compression/gzip.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+using compression::Encoding;
+
+server::handlers::ResponseCompression MakeGzipCompression() {
+  server::handlers::ResponseCompressionConfig config;
+  config.encodings = {"gzip"};
+  return server::handlers::ResponseCompression{config, nullptr};
+}
+
+}  // namespace
+
+TEST(ResponseCompression, Negotiate) {
+  const auto compression = MakeGzipCompression();
+
+  EXPECT_EQ(compression.Negotiate("gzip"), Encoding::kGzip);
+  EXPECT_EQ(compression.Negotiate("deflate, GZIP;q=0.5"), Encoding::kGzip);
+  EXPECT_EQ(compression.Negotiate("x-gzip"), Encoding::kGzip);
+  EXPECT_EQ(compression.Negotiate("*"), Encoding::kGzip);
+  EXPECT_EQ(compression.Negotiate("identity, *;q=0.1"), Encoding::kGzip);
+
+  EXPECT_EQ(compression.Negotiate(""), std::nullopt);
+  EXPECT_EQ(compression.Negotiate("identity"), std::nullopt);
+  EXPECT_EQ(compression.Negotiate("gzip;q=0"), std::nullopt);
+  EXPECT_EQ(compression.Negotiate("gzip;q=0.000"), std::nullopt);
+  EXPECT_EQ(compression.Negotiate("*, gzip;q=0"), std::nullopt);
+  EXPECT_EQ(compression.Negotiate("gzip;q=1.5"), std::nullopt);
+  EXPECT_EQ(compression.Negotiate("gzip;q=abc"), std::nullopt);
+}
+
+TEST(ResponseCompression, UnknownEncoding) {
+  server::handlers::ResponseCompressionConfig config;
+  config.encodings = {"compress"};
+  EXPECT_ANY_THROW(server::handlers::ResponseCompression(config, nullptr));
+}
+
+TEST(ResponseCompression, BodyChunks) {
+  const auto compression = MakeGzipCompression();
+  server::handlers::ResponseBodyCompressor compressor{compression,
+                                                      Encoding::kGzip};
+
+  std::string body;
+  std::string compressed;
+  for (const auto* chunk : {"first chunk, ", "second chunk, ", "last chunk"}) {
+    body += chunk;
+    const auto compressed_chunk = compressor.Compress(chunk);
+    // every chunk is flushed to be sent to the client right away
+    EXPECT_FALSE(compressed_chunk.empty());
+    compressed += compressed_chunk;
+  }
+  compressed += compressor.Finish();
+  EXPECT_EQ(compression::gzip::Decompress(compressed, body.size()), body);
+}
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,103 @@
+#include <server/handlers/static_file_request.hpp>
+
+#include <algorithm>
+#include <charconv>
+
+#include <userver/utils/str_icase.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::handlers {
+
+namespace {
+
+constexpr std::string_view kWeakPrefix = "W/";
+constexpr std::string_view kBytesUnit = "bytes=";
+
+std::string_view TrimView(std::string_view value) {
+  const auto begin = value.find_first_not_of(" \t");
+  if (begin == std::string_view::npos) return {};
+  const auto end = value.find_last_not_of(" \t");
+  return value.substr(begin, end - begin + 1);
+}
+
+std::string_view StripWeakPrefix(std::string_view etag) {
+  if (etag.substr(0, kWeakPrefix.size()) == kWeakPrefix) {
+    etag.remove_prefix(kWeakPrefix.size());
+  }
+  return etag;
+}
+
+std::optional<std::size_t> ParsePosition(std::string_view value) {
+  std::size_t result = 0;
+  const auto* end = value.data() + value.size();
+  const auto [ptr, ec] = std::from_chars(value.data(), end, result);
+  if (ec != std::errc{} || ptr != end) return std::nullopt;
+  return result;
+}
+
+}  // namespace
+
+bool MatchesETag(std::string_view if_none_match, std::string_view etag) {
+  if (etag.empty()) return false;
+  if (TrimView(if_none_match) == "*") return true;
+
+  etag = StripWeakPrefix(etag);
+  while (!if_none_match.empty()) {
+    const auto pos = if_none_match.find(',');
+    const auto element = TrimView(if_none_match.substr(0, pos));
+    if_none_match.remove_prefix(
+        pos == std::string_view::npos ? if_none_match.size() : pos + 1);
+    if (StripWeakPrefix(element) == etag) return true;
+  }
+  return false;
+}
+
+bool IsRangeApplicable(std::string_view if_range, std::string_view etag) {
+  if_range = TrimView(if_range);
+  if (if_range.empty()) return true;
+  // The dates and the weak entity tags never match
+  return !etag.empty() && if_range == etag &&
+         if_range.substr(0, kWeakPrefix.size()) != kWeakPrefix;
+}
+
+std::optional<ByteRange> ParseByteRange(std::string_view range,
+                                        std::size_t content_size) {
+  range = TrimView(range);
+  if (!utils::StrIcaseEqual{}(range.substr(0, kBytesUnit.size()), kBytesUnit)) {
+    return std::nullopt;
+  }
+  range.remove_prefix(kBytesUnit.size());
+  // Multipart responses are not worth it for the static files
+  if (range.find(',') != std::string_view::npos) return std::nullopt;
+
+  const auto dash = range.find('-');
+  if (dash == std::string_view::npos) return std::nullopt;
+  const auto first = TrimView(range.substr(0, dash));
+  const auto last = TrimView(range.substr(dash + 1));
+
+  if (first.empty()) {
+    const auto suffix_length = ParsePosition(last);
+    if (!suffix_length) return std::nullopt;
+    const auto size = std::min(*suffix_length, content_size);
+    if (size == 0) return ByteRange{};
+    return ByteRange{content_size - size, size};
+  }
+
+  const auto first_pos = ParsePosition(first);
+  if (!first_pos) return std::nullopt;
+  std::optional<std::size_t> last_pos;
+  if (!last.empty()) {
+    last_pos = ParsePosition(last);
+    if (!last_pos || *last_pos < *first_pos) return std::nullopt;
+  }
+
+  if (*first_pos >= content_size) return ByteRange{};
+  const auto end = std::min(last_pos.value_or(content_size - 1) + 1,
+                            content_size);
+  return ByteRange{*first_pos, end - *first_pos};
+}
+
+}  // namespace server::handlers
+
+USERVER_NAMESPACE_END
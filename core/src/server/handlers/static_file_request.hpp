@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::handlers {
+
+struct ByteRange final {
+  std::size_t offset{0};
+  std::size_t size{0};
+};
+
+// Returns true if the If-None-Match list contains the entity tag, the
+// comparison is weak, RFC 9110 13.1.2
+bool MatchesETag(std::string_view if_none_match, std::string_view etag);
+
+// Returns true if the Range header is to be applied for the If-Range
+// condition, only the strong entity tags are supported, RFC 9110 13.1.5
+bool IsRangeApplicable(std::string_view if_range, std::string_view etag);
+
+// Parses a single range of the Range header, RFC 9110 14.2. Returns
+// std::nullopt if the header is to be ignored and the whole content is to be
+// sent: the header is malformed, not in bytes or has several ranges. Returns
+// an empty range if the range is not satisfiable.
+std::optional<ByteRange> ParseByteRange(std::string_view range,
+                                        std::size_t content_size);
+
+}  // namespace server::handlers
+
+USERVER_NAMESPACE_END
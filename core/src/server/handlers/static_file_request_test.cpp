@@ -0,0 +1,65 @@
+#include <server/handlers/static_file_request.hpp>
+
+#include <gtest/gtest.h>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+using server::handlers::ParseByteRange;
+
+void ExpectRange(std::string_view header, std::size_t offset,
+                 std::size_t size) {
+  const auto range = ParseByteRange(header, 100);
+  ASSERT_TRUE(range) << header;
+  EXPECT_EQ(range->offset, offset) << header;
+  EXPECT_EQ(range->size, size) << header;
+}
+
+}  // namespace
+
+TEST(StaticFileRequest, MatchesETag) {
+  using server::handlers::MatchesETag;
+
+  EXPECT_TRUE(MatchesETag("\"a-1\"", "\"a-1\""));
+  EXPECT_TRUE(MatchesETag("\"b-2\", W/\"a-1\"", "\"a-1\""));
+  EXPECT_TRUE(MatchesETag(" * ", "\"a-1\""));
+
+  EXPECT_FALSE(MatchesETag("\"a-2\"", "\"a-1\""));
+  EXPECT_FALSE(MatchesETag("", "\"a-1\""));
+  EXPECT_FALSE(MatchesETag("*", ""));
+}
+
+TEST(StaticFileRequest, IsRangeApplicable) {
+  using server::handlers::IsRangeApplicable;
+
+  EXPECT_TRUE(IsRangeApplicable("", "\"a-1\""));
+  EXPECT_TRUE(IsRangeApplicable("\"a-1\"", "\"a-1\""));
+
+  EXPECT_FALSE(IsRangeApplicable("\"a-2\"", "\"a-1\""));
+  EXPECT_FALSE(IsRangeApplicable("W/\"a-1\"", "\"a-1\""));
+  EXPECT_FALSE(IsRangeApplicable("Wed, 21 Oct 2015 07:28:00 GMT", "\"a-1\""));
+}
+
+TEST(StaticFileRequest, ParseByteRange) {
+  ExpectRange("bytes=0-9", 0, 10);
+  ExpectRange("bytes=90-", 90, 10);
+  ExpectRange("bytes=90-1000", 90, 10);
+  ExpectRange("bytes=-10", 90, 10);
+  ExpectRange("bytes=-1000", 0, 100);
+  ExpectRange("Bytes= 5 - 5 ", 5, 1);
+
+  // not satisfiable
+  ExpectRange("bytes=100-", 0, 0);
+  ExpectRange("bytes=-0", 0, 0);
+  EXPECT_EQ(ParseByteRange("bytes=-10", 0)->size, 0);
+
+  // ignored
+  EXPECT_FALSE(ParseByteRange("bytes=0-1,5-6", 100));
+  EXPECT_FALSE(ParseByteRange("bytes=9-1", 100));
+  EXPECT_FALSE(ParseByteRange("bytes=a-b", 100));
+  EXPECT_FALSE(ParseByteRange("bytes=", 100));
+  EXPECT_FALSE(ParseByteRange("items=0-9", 100));
+}
+
+USERVER_NAMESPACE_END
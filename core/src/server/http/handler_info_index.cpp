@@ -25,6 +25,8 @@ class HandlerInfoIndex::HandlerInfoIndexImpl final {
   void AddHandler(const handlers::HttpHandlerBase& handler,
                   engine::TaskProcessor& task_processor);
 
+  void Build();
+
   const HandlerList& GetHandlers() const;
 
   MatchRequestResult MatchRequest(HttpMethod method,
@@ -54,6 +56,10 @@ void HandlerInfoIndex::HandlerInfoIndexImpl::AddHandler(
   handler_list_.emplace_back(&handler);
 }
 
+void HandlerInfoIndex::HandlerInfoIndexImpl::Build() {
+  wildcard_path_index_.Build();
+}
+
 const HandlerInfoIndex::HandlerList&
 HandlerInfoIndex::HandlerInfoIndexImpl::GetHandlers() const {
   return handler_list_;
@@ -108,6 +114,8 @@ void HandlerInfoIndex::AddHandler(const handlers::HttpHandlerBase& handler,
              handler.GetConfig().path);
 }
 
+void HandlerInfoIndex::Build() { impl_->Build(); }
+
 const HandlerInfoIndex::HandlerList& HandlerInfoIndex::GetHandlers() const {
   return impl_->GetHandlers();
 }
@@ -6,6 +6,8 @@
 #include <vector>
 
 #include <userver/engine/task/task_processor_fwd.hpp>
+
+#include <server/http/radix_path_tree.hpp>
 #include <userver/server/handlers/fallback_handlers.hpp>
 #include <userver/server/handlers/http_handler_base.hpp>
 #include <userver/server/http/http_method.hpp>
@@ -34,7 +36,7 @@ struct MatchRequestResult {
   const HandlerInfo* handler_info = nullptr;
   size_t matched_path_length = 0;
   Status status = Status::kHandlerNotFound;
-  std::vector<std::pair<std::string, std::string>> args_from_path;
+  impl::PathArgs args_from_path;
 };
 
 class HandlerInfoIndex final {
@@ -45,6 +47,10 @@ class HandlerInfoIndex final {
   void AddHandler(const handlers::HttpHandlerBase& handler,
                   engine::TaskProcessor& task_processor);
 
+  // Compacts the index for matching, must be called after the last
+  // AddHandler() and before MatchRequest()
+  void Build();
+
   using HandlerList =
       std::vector<utils::NotNull<const handlers::HttpHandlerBase*>>;
   const HandlerList& GetHandlers() const;
@@ -0,0 +1,779 @@
+#include <server/http/http2_session.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <nghttp2/nghttp2.h>
+
+#include <userver/engine/async.hpp>
+#include <userver/engine/exception.hpp>
+#include <userver/engine/single_consumer_event.hpp>
+#include <userver/engine/task/cancel.hpp>
+#include <userver/fs/blocking/mapped_file.hpp>
+#include <userver/http/common_headers.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/utils/assert.hpp>
+#include <userver/utils/scope_guard.hpp>
+
+#include <server/http/http_cached_date.hpp>
+#include <server/http/http_request_impl.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::http {
+
+namespace {
+
+namespace headers = USERVER_NAMESPACE::http::headers;
+
+constexpr std::string_view kConnectionPreface{NGHTTP2_CLIENT_MAGIC,
+                                              NGHTTP2_CLIENT_MAGIC_LEN};
+
+constexpr std::string_view kDefaultContentType = "text/html; charset=utf-8";
+
+// Frames are coalesced into a single send up to this size
+constexpr std::size_t kMaxOutBufferSize = 64 * 1024;
+
+// A streamed response body is not popped from the handler while this much of
+// it waits for the peer flow control window
+constexpr std::size_t kMaxBufferedBodySize = 256 * 1024;
+
+// A file body is read in the fs task processor by chunks of this size
+constexpr std::size_t kFileChunkSize = 64 * 1024;
+
+using HeaderList = std::vector<std::pair<std::string, std::string>>;
+
+class StreamClosedError final : public std::runtime_error {
+ public:
+  StreamClosedError() : std::runtime_error("HTTP/2 stream is closed") {}
+};
+
+void ThrowIfError(int rv, std::string_view what) {
+  if (rv != 0) {
+    throw std::runtime_error(
+        fmt::format("{} failed: {}", what, nghttp2_strerror(rv)));
+  }
+}
+
+bool IsRequestHeaders(const nghttp2_frame& frame) {
+  return frame.hd.type == NGHTTP2_HEADERS &&
+         frame.headers.cat == NGHTTP2_HCAT_REQUEST;
+}
+
+std::string_view AsStringView(const std::uint8_t* data, std::size_t size) {
+  return {reinterpret_cast<const char*>(data), size};
+}
+
+bool IsBodyForbiddenForStatus(HttpStatus status) {
+  return status == HttpStatus::kNoContent ||
+         status == HttpStatus::kNotModified ||
+         (static_cast<int>(status) >= 100 && static_cast<int>(status) < 200);
+}
+
+std::string ToLowerAscii(std::string_view name) {
+  std::string result{name};
+  for (auto& c : result) {
+    if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+  }
+  return result;
+}
+
+// These are prohibited in HTTP/2 (RFC 7540, 8.1.2.2), the content length is
+// set by the session itself
+bool IsSkippedResponseHeader(std::string_view lowercase_name) {
+  return lowercase_name == "connection" || lowercase_name == "keep-alive" ||
+         lowercase_name == "proxy-connection" ||
+         lowercase_name == "transfer-encoding" ||
+         lowercase_name == "upgrade" || lowercase_name == "content-length";
+}
+
+void AppendHeader(HttpRequestConstructor& constructor, std::string_view name,
+                  std::string_view value) {
+  constructor.AppendHeaderField(name.data(), name.size());
+  constructor.AppendHeaderValue(value.data(), value.size());
+}
+
+HttpMethod ParseMethod(std::string_view method) {
+  try {
+    return HttpMethodFromString(method);
+  } catch (const std::exception&) {
+    return HttpMethod::kUnknown;
+  }
+}
+
+HeaderList MakeResponseHeaders(const HttpResponse& response,
+                               std::optional<std::size_t> content_length) {
+  HeaderList result;
+  result.emplace_back(":status",
+                      std::to_string(static_cast<int>(response.GetStatus())));
+  if (!response.HasHeader(headers::kDate)) {
+    // impl::GetCachedDate() must not cross thread boundaries
+    result.emplace_back("date", std::string{impl::GetCachedDate()});
+  }
+  if (!response.HasHeader(headers::kContentType)) {
+    result.emplace_back("content-type", std::string{kDefaultContentType});
+  }
+  for (const auto& name : response.GetHeaderNames()) {
+    auto lowercase_name = ToLowerAscii(name);
+    if (IsSkippedResponseHeader(lowercase_name)) continue;
+    result.emplace_back(std::move(lowercase_name), response.GetHeader(name));
+  }
+  for (const auto& name : response.GetCookieNames()) {
+    std::string value;
+    response.GetCookie(name).AppendToString(value);
+    result.emplace_back("set-cookie", std::move(value));
+  }
+  if (content_length) {
+    result.emplace_back("content-length", std::to_string(*content_length));
+  }
+  return result;
+}
+
+// Uncompressed size, HPACK output size is not reported by nghttp2
+std::size_t GetHeadersSize(const HeaderList& headers) {
+  std::size_t size = 0;
+  for (const auto& [name, value] : headers) size += name.size() + value.size();
+  return size;
+}
+
+std::vector<nghttp2_nv> MakeNameValues(HeaderList& headers) {
+  std::vector<nghttp2_nv> result;
+  result.reserve(headers.size());
+  for (auto& [name, value] : headers) {
+    result.push_back({reinterpret_cast<std::uint8_t*>(name.data()),
+                      reinterpret_cast<std::uint8_t*>(value.data()),
+                      name.size(), value.size(), NGHTTP2_NV_FLAG_NONE});
+  }
+  return result;
+}
+
+}  // namespace
+
+struct Http2Session::Stream final {
+  Stream(std::int32_t stream_id, const HttpRequestConstructor::Config& config,
+         const HandlerInfoIndex& handler_info_index,
+         request::ResponseDataAccounter& data_accounter)
+      : id(stream_id) {
+    constructor.emplace(config, handler_info_index, data_accounter);
+  }
+
+  void Close(std::uint32_t close_error_code) noexcept {
+    is_closed = true;
+    error_code = close_error_code;
+    if (error_code != NGHTTP2_NO_ERROR && handler_task.IsValid()) {
+      handler_task.RequestCancel();
+    }
+    body_drained.Send();
+    closed.Send();
+  }
+
+  const std::int32_t id;
+
+  // Is reset once the request is complete
+  std::optional<HttpRequestConstructor> constructor;
+  bool is_url_parsed{false};
+  bool is_request_broken{false};
+
+  std::shared_ptr<request::RequestBase> request;
+  engine::TaskWithResult<void> handler_task;
+
+  // The response body, is read by nghttp2 on sending DATA frames. Either the
+  // response data, or body_buffer for the streamed and the file bodies, which
+  // are appended to it outside of the session lock.
+  std::string_view body;
+  bool is_body_buffered{false};
+  std::string body_buffer;
+  std::size_t body_offset{0};
+  bool is_body_complete{false};
+  std::size_t bytes_sent{0};
+  engine::SingleConsumerEvent body_drained;
+
+  bool is_closed{false};
+  std::uint32_t error_code{NGHTTP2_NO_ERROR};
+  engine::SingleConsumerEvent closed{
+      engine::SingleConsumerEvent::NoAutoReset{}};
+};
+
+// The callbacks are called under the session lock. Exceptions must not cross
+// the C code, the stream-level errors are reported in the responses.
+struct Http2Session::Callbacks final {
+  static Http2Session& Self(void* user_data) {
+    UASSERT(user_data);
+    return *static_cast<Http2Session*>(user_data);
+  }
+
+  static int OnBeginHeaders(nghttp2_session*, const nghttp2_frame* frame,
+                            void* user_data) {
+    if (!IsRequestHeaders(*frame)) return 0;
+
+    auto& self = Self(user_data);
+    try {
+      self.streams_.emplace(
+          frame->hd.stream_id,
+          std::make_shared<Stream>(
+              frame->hd.stream_id, self.request_constructor_config_,
+              self.request_handler_.GetHandlerInfoIndex(),
+              self.data_accounter_));
+    } catch (const std::exception& ex) {
+      LOG_ERROR() << "Failed to open an HTTP/2 stream: " << ex;
+      return NGHTTP2_ERR_CALLBACK_FAILURE;
+    }
+    ++self.stats_.parser_stats.parsing_request_count;
+    return 0;
+  }
+
+  static int OnHeader(nghttp2_session*, const nghttp2_frame* frame,
+                      const std::uint8_t* name, size_t name_size,
+                      const std::uint8_t* value, size_t value_size,
+                      std::uint8_t /*flags*/, void* user_data) {
+    // Trailers are ignored
+    if (!IsRequestHeaders(*frame)) return 0;
+
+    auto& self = Self(user_data);
+    auto* stream = self.FindStream(frame->hd.stream_id);
+    if (!stream || stream->is_request_broken) return 0;
+
+    const auto name_view = AsStringView(name, name_size);
+    const auto value_view = AsStringView(value, value_size);
+    LOG_TRACE() << "header: '" << name_view << "': '" << value_view << '\'';
+
+    auto& constructor = *stream->constructor;
+    try {
+      if (name_view == ":method") {
+        constructor.SetMethod(ParseMethod(value_view));
+      } else if (name_view == ":path") {
+        constructor.AppendUrl(value_view.data(), value_view.size());
+      } else if (name_view == ":authority") {
+        AppendHeader(constructor, headers::kHost, value_view);
+      } else if (!name_view.empty() && name_view[0] != ':') {
+        // The pseudo-headers go first, the handler limits apply to the rest
+        self.ParseUrl(*stream);
+        if (!stream->is_request_broken) {
+          AppendHeader(constructor, name_view, value_view);
+        }
+      }
+      // :scheme is implied by the listener
+    } catch (const std::exception& ex) {
+      LOG_WARNING() << "can't append header: " << ex;
+      stream->is_request_broken = true;
+    }
+    return 0;
+  }
+
+  static int OnFrameRecv(nghttp2_session*, const nghttp2_frame* frame,
+                         void* user_data) {
+    auto& self = Self(user_data);
+    const auto stream_id = frame->hd.stream_id;
+
+    if (IsRequestHeaders(*frame)) {
+      if (auto* stream = self.FindStream(stream_id)) {
+        self.FinishHeaders(*stream);
+      }
+    } else if (frame->hd.type != NGHTTP2_HEADERS &&
+               frame->hd.type != NGHTTP2_DATA) {
+      return 0;
+    }
+
+    if (frame->hd.flags & NGHTTP2_FLAG_END_STREAM) {
+      const auto it = self.streams_.find(stream_id);
+      if (it != self.streams_.end() && it->second->constructor) {
+        self.FinishRequest(it->second);
+      }
+    }
+    return 0;
+  }
+
+  static int OnDataChunkRecv(nghttp2_session*, std::uint8_t /*flags*/,
+                             std::int32_t stream_id, const std::uint8_t* data,
+                             size_t size, void* user_data) {
+    auto* stream = Self(user_data).FindStream(stream_id);
+    if (!stream || stream->is_request_broken) return 0;
+
+    try {
+      stream->constructor->AppendBody(reinterpret_cast<const char*>(data),
+                                      size);
+    } catch (const std::exception& ex) {
+      LOG_WARNING() << "can't append body: " << ex;
+      stream->is_request_broken = true;
+    }
+    return 0;
+  }
+
+  static int OnStreamClose(nghttp2_session*, std::int32_t stream_id,
+                           std::uint32_t error_code, void* user_data) {
+    auto& self = Self(user_data);
+    const auto it = self.streams_.find(stream_id);
+    if (it == self.streams_.end()) return 0;
+
+    const auto stream = std::move(it->second);
+    self.streams_.erase(it);
+    if (stream->constructor) {
+      stream->constructor.reset();
+      --self.stats_.parser_stats.parsing_request_count;
+    }
+    stream->Close(error_code);
+    return 0;
+  }
+
+  static ssize_t OnDataSourceRead(nghttp2_session*, std::int32_t /*stream_id*/,
+                                  std::uint8_t* buf, size_t length,
+                                  std::uint32_t* data_flags,
+                                  nghttp2_data_source* source,
+                                  void* /*user_data*/) {
+    auto& stream = *static_cast<Stream*>(source->ptr);
+    const std::string_view body =
+        stream.is_body_buffered ? stream.body_buffer : stream.body;
+
+    const auto size = std::min(length, body.size() - stream.body_offset);
+    if (size == 0 && !stream.is_body_complete) {
+      stream.body_drained.Send();
+      return NGHTTP2_ERR_DEFERRED;
+    }
+
+    std::memcpy(buf, body.data() + stream.body_offset, size);
+    stream.body_offset += size;
+    stream.bytes_sent += size;
+
+    if (stream.body_offset == body.size()) {
+      if (stream.is_body_complete) {
+        *data_flags |= NGHTTP2_DATA_FLAG_EOF;
+      } else {
+        stream.body_drained.Send();
+      }
+    }
+    return static_cast<ssize_t>(size);
+  }
+};
+
+void Http2Session::SessionDeleter::operator()(
+    nghttp2_session* session) const noexcept {
+  nghttp2_session_del(session);
+}
+
+Http2Session::Http2Session(
+    const net::ConnectionConfig& config,
+    const request::HttpRequestConfig& handler_defaults_config,
+    engine::io::Socket& socket, const RequestHandlerBase& request_handler,
+    net::Stats& stats, request::ResponseDataAccounter& data_accounter,
+    const std::string& remote_address)
+    : request_constructor_config_{handler_defaults_config},
+      socket_(socket),
+      request_handler_(request_handler),
+      stats_(stats),
+      data_accounter_(data_accounter),
+      remote_address_(remote_address) {
+  nghttp2_session_callbacks* callbacks = nullptr;
+  ThrowIfError(nghttp2_session_callbacks_new(&callbacks),
+               "nghttp2_session_callbacks_new");
+  const utils::ScopeGuard callbacks_guard(
+      [callbacks] { nghttp2_session_callbacks_del(callbacks); });
+
+  nghttp2_session_callbacks_set_on_begin_headers_callback(
+      callbacks, &Callbacks::OnBeginHeaders);
+  nghttp2_session_callbacks_set_on_header_callback(callbacks,
+                                                   &Callbacks::OnHeader);
+  nghttp2_session_callbacks_set_on_frame_recv_callback(
+      callbacks, &Callbacks::OnFrameRecv);
+  nghttp2_session_callbacks_set_on_data_chunk_recv_callback(
+      callbacks, &Callbacks::OnDataChunkRecv);
+  nghttp2_session_callbacks_set_on_stream_close_callback(
+      callbacks, &Callbacks::OnStreamClose);
+
+  nghttp2_session* session = nullptr;
+  ThrowIfError(nghttp2_session_server_new(&session, callbacks, this),
+               "nghttp2_session_server_new");
+  session_.reset(session);
+
+  const std::array<nghttp2_settings_entry, 2> settings{{
+      {NGHTTP2_SETTINGS_MAX_CONCURRENT_STREAMS,
+       config.http2_max_concurrent_streams},
+      {NGHTTP2_SETTINGS_INITIAL_WINDOW_SIZE, config.http2_initial_window_size},
+  }};
+  ThrowIfError(nghttp2_submit_settings(session_.get(), NGHTTP2_FLAG_NONE,
+                                       settings.data(), settings.size()),
+               "nghttp2_submit_settings");
+  // The connection window is not covered by the settings
+  ThrowIfError(nghttp2_session_set_local_window_size(
+                   session_.get(), NGHTTP2_FLAG_NONE, 0,
+                   static_cast<std::int32_t>(config.http2_initial_window_size)),
+               "nghttp2_session_set_local_window_size");
+}
+
+Http2Session::~Http2Session() { CloseStreams(); }
+
+bool Http2Session::Parse(const char* data, size_t size) {
+  std::unique_lock lock{mutex_};
+
+  const auto rv = nghttp2_session_mem_recv(
+      session_.get(), reinterpret_cast<const std::uint8_t*>(data), size);
+  if (rv < 0) {
+    LOG_WARNING() << "HTTP/2 session failure: "
+                  << nghttp2_strerror(static_cast<int>(rv));
+    // Sends the GOAWAY frame, if any
+    Flush(lock);
+    return false;
+  }
+
+  Flush(lock);
+  return !is_send_failed_ && (nghttp2_session_want_read(session_.get()) ||
+                              nghttp2_session_want_write(session_.get()));
+}
+
+Http2Session::PrefaceMatch Http2Session::MatchConnectionPreface(
+    std::string_view data) noexcept {
+  if (kConnectionPreface.substr(0, data.size()) !=
+      data.substr(0, kConnectionPreface.size())) {
+    return PrefaceMatch::kMismatch;
+  }
+  return data.size() < kConnectionPreface.size() ? PrefaceMatch::kIncomplete
+                                                 : PrefaceMatch::kMatch;
+}
+
+Http2Session::Stream* Http2Session::FindStream(std::int32_t stream_id) {
+  const auto it = streams_.find(stream_id);
+  if (it == streams_.end() || !it->second->constructor) return nullptr;
+  return it->second.get();
+}
+
+void Http2Session::ParseUrl(Stream& stream) {
+  if (stream.is_url_parsed) return;
+  stream.is_url_parsed = true;
+
+  auto& constructor = *stream.constructor;
+  constructor.SetHttpMajor(2);
+  constructor.SetHttpMinor(0);
+  try {
+    constructor.ParseUrl();
+  } catch (const std::exception& ex) {
+    LOG_WARNING() << "can't parse url: " << ex;
+    stream.is_request_broken = true;
+  }
+}
+
+void Http2Session::FinishHeaders(Stream& stream) {
+  ParseUrl(stream);
+  if (stream.is_request_broken) return;
+
+  try {
+    stream.constructor->AppendHeaderField("", 0);
+  } catch (const std::exception& ex) {
+    LOG_WARNING() << "can't append header value: " << ex;
+    stream.is_request_broken = true;
+  }
+}
+
+void Http2Session::FinishRequest(const std::shared_ptr<Stream>& stream) {
+  // A broken request gets its error response from the constructor
+  auto request = stream->constructor->Finalize();
+  stream->constructor.reset();
+  --stats_.parser_stats.parsing_request_count;
+
+  if (!request) {
+    LOG_ERROR() << "request is null after Finalize()";
+    nghttp2_submit_rst_stream(session_.get(), NGHTTP2_FLAG_NONE, stream->id,
+                              NGHTTP2_INTERNAL_ERROR);
+    return;
+  }
+
+  ++stats_.active_request_count;
+  stream->handler_task = request_handler_.StartRequestTask(request);
+  stream->request = std::move(request);
+  responders_.CriticalAsyncNoSpan([this, stream] { ProcessStream(stream); });
+}
+
+void Http2Session::ProcessStream(
+    const std::shared_ptr<Stream>& stream) noexcept {
+  auto& request = *stream->request;
+  WaitForHandler(*stream);
+
+  // now we must complete processing
+  const engine::TaskCancellationBlocker block_cancel;
+
+  auto& response = request.GetResponse();
+  request.SetStartSendResponseTime();
+  try {
+    SendResponse(stream);
+  } catch (const StreamClosedError& ex) {
+    LOG_DEBUG() << "Failed to send the response: " << ex;
+    response.SetSendFailed(std::chrono::steady_clock::now());
+  } catch (const std::exception& ex) {
+    LOG_WARNING() << "Error while sending data: " << ex;
+    response.SetSendFailed(std::chrono::steady_clock::now());
+  }
+  // Waits for the producer of the streamed body, if any
+  auto handler_task = TakeHandlerTask(*stream);
+  handler_task = {};
+  request.SetFinishSendResponseTime();
+  --stats_.active_request_count;
+  ++stats_.requests_processed_count;
+
+  request.WriteAccessLogs(request_handler_.LoggerAccess(),
+                          request_handler_.LoggerAccessTskv(), remote_address_);
+}
+
+void Http2Session::WaitForHandler(Stream& stream) noexcept {
+  auto& request = *stream.request;
+  try {
+    auto& response = request.GetResponse();
+    if (response.IsBodyStreamed()) {
+      response.WaitForHeadersEnd();
+    } else {
+      // The handler task stays in the stream to be cancelled on RST_STREAM
+      stream.handler_task.Wait();
+      TakeHandlerTask(stream).Get();
+    }
+  } catch (const engine::TaskCancelledException& e) {
+    LOG_LIMITED_ERROR() << "Handler task was cancelled with reason: "
+                        << ToString(e.Reason());
+    auto& response = request.GetResponse();
+    if (!response.IsReady()) {
+      response.SetReady();
+      response.SetStatusServiceUnavailable();
+    }
+  } catch (const engine::WaitInterruptedException&) {
+    // The session is being destroyed, the stream is closed already
+    LOG_DEBUG() << "Request processing interrupted";
+    TakeHandlerTask(stream).SyncCancel();
+  } catch (const std::exception& e) {
+    LOG_WARNING() << "Request failed with unhandled exception: " << e;
+    request.MarkAsInternalServerError();
+  }
+}
+
+void Http2Session::SendResponse(const std::shared_ptr<Stream>& stream) {
+  auto& request = static_cast<HttpRequestImpl&>(*stream->request);
+  auto& response = request.GetHttpResponse();
+  UASSERT(!response.IsSent());
+
+  // Both the data and the file body stay alive until the stream is closed
+  const auto* file_body = response.GetFileBody();
+  const std::string_view data =
+      file_body ? file_body->file->GetData().substr(file_body->offset,
+                                                    file_body->size)
+                : std::string_view{response.GetData()};
+  const bool is_body_forbidden = IsBodyForbiddenForStatus(response.GetStatus());
+  const bool is_head_request = request.GetOrigMethod() == HttpMethod::kHead;
+  const bool is_streamed = response.IsBodyStreamed() && data.empty();
+  const bool has_body = !is_body_forbidden && !is_head_request &&
+                        (is_streamed || !data.empty());
+  // The file is read outside of the session lock, as it may block on the disk
+  const bool is_body_buffered = is_streamed || file_body;
+
+  std::optional<std::size_t> content_length;
+  if (!is_streamed && !is_body_forbidden) content_length = data.size();
+  auto headers = MakeResponseHeaders(response, content_length);
+  auto name_values = MakeNameValues(headers);
+
+  {
+    std::unique_lock lock{mutex_};
+    if (stream->is_closed || is_send_failed_) throw StreamClosedError{};
+
+    nghttp2_data_provider data_provider{};
+    if (has_body) {
+      if (!is_body_buffered) stream->body = data;
+      stream->is_body_buffered = is_body_buffered;
+      stream->is_body_complete = !is_body_buffered;
+      data_provider.source.ptr = stream.get();
+      data_provider.read_callback = &Callbacks::OnDataSourceRead;
+    }
+    ThrowIfError(nghttp2_submit_response(session_.get(), stream->id,
+                                         name_values.data(), name_values.size(),
+                                         has_body ? &data_provider : nullptr),
+                 "nghttp2_submit_response");
+    stream->bytes_sent += GetHeadersSize(headers);
+    Flush(lock);
+  }
+
+  if (is_streamed) {
+    SendBodyStream(*stream, response, has_body);
+  } else if (has_body && file_body) {
+    SendFileBody(*stream, *file_body);
+  }
+
+  // The stream is closed once all of its frames are sent or on a reset
+  [[maybe_unused]] const bool is_closed = stream->closed.WaitForEvent();
+  UASSERT(is_closed);
+  if (stream->error_code != NGHTTP2_NO_ERROR) throw StreamClosedError{};
+
+  response.SetSentByConnection(stream->bytes_sent);
+}
+
+void Http2Session::SendBodyStream(Stream& stream, HttpResponse& response,
+                                  bool has_body) {
+  std::string chunk;
+  while (response.PopBodyChunk(chunk)) {
+    // The body of a HEAD response is dropped
+    if (chunk.empty() || !has_body) continue;
+    AppendBody(stream, chunk);
+  }
+  if (has_body) CompleteBody(stream);
+}
+
+void Http2Session::SendFileBody(Stream& stream,
+                                const HttpResponse::FileBody& file_body) {
+  auto& fs_task_processor = *file_body.fs_task_processor;
+  try {
+    // The file is read with a descriptor, as the access to the mapping of a
+    // truncated file raises SIGBUS. The mapping of a replaced file stays
+    // intact.
+    auto fd = engine::AsyncNoSpan(fs_task_processor, [&file_body] {
+                auto fd = file_body.file->Reopen();
+                if (fd) fd->Seek(file_body.offset);
+                return fd;
+              }).Get();
+
+    std::string chunk;
+    for (std::size_t offset = 0; offset < file_body.size;
+         offset += chunk.size()) {
+      chunk.resize(std::min(kFileChunkSize, file_body.size - offset));
+      engine::AsyncNoSpan(fs_task_processor, [&] {
+        if (!fd) {
+          const auto data = file_body.file->GetData();
+          std::memcpy(chunk.data(), data.data() + file_body.offset + offset,
+                      chunk.size());
+          return;
+        }
+        for (std::size_t read_bytes = 0; read_bytes < chunk.size();) {
+          const auto result =
+              fd->Read(chunk.data() + read_bytes, chunk.size() - read_bytes);
+          if (result == 0) {
+            throw std::runtime_error("The file was truncated while being sent");
+          }
+          read_bytes += result;
+        }
+      }).Get();
+      AppendBody(stream, chunk);
+    }
+  } catch (const StreamClosedError&) {
+    throw;
+  } catch (const std::exception&) {
+    // The content length is sent already, the peer must not take a part of
+    // the body for the whole one
+    std::unique_lock lock{mutex_};
+    if (!stream.is_closed) {
+      nghttp2_submit_rst_stream(session_.get(), NGHTTP2_FLAG_NONE, stream.id,
+                                NGHTTP2_INTERNAL_ERROR);
+      Flush(lock);
+    }
+    throw;
+  }
+  CompleteBody(stream);
+}
+
+void Http2Session::AppendBody(Stream& stream, std::string_view chunk) {
+  std::unique_lock lock{mutex_};
+  if (stream.is_closed) throw StreamClosedError{};
+
+  stream.body_buffer.erase(0, stream.body_offset);
+  stream.body_offset = 0;
+  stream.body_buffer.append(chunk);
+  nghttp2_session_resume_data(session_.get(), stream.id);
+  Flush(lock);
+
+  // The peer flow control window is exhausted
+  while (!stream.is_closed && stream.body_buffer.size() - stream.body_offset >
+                                  kMaxBufferedBodySize) {
+    lock.unlock();
+    [[maybe_unused]] const bool is_drained = stream.body_drained.WaitForEvent();
+    lock.lock();
+  }
+}
+
+void Http2Session::CompleteBody(Stream& stream) {
+  std::unique_lock lock{mutex_};
+  if (stream.is_closed) throw StreamClosedError{};
+  stream.is_body_complete = true;
+  nghttp2_session_resume_data(session_.get(), stream.id);
+  Flush(lock);
+}
+
+engine::TaskWithResult<void> Http2Session::TakeHandlerTask(Stream& stream) {
+  const std::lock_guard lock{mutex_};
+  return std::move(stream.handler_task);
+}
+
+void Http2Session::Flush(std::unique_lock<engine::Mutex>& lock) {
+  UASSERT(lock.owns_lock());
+  if (is_send_failed_) return;
+
+  try {
+    SerializeFrames();
+  } catch (const std::exception&) {
+    FailSend();
+    throw;
+  }
+
+  // The task that is already sending also sends the frames serialized here
+  if (is_sending_) return;
+  is_sending_ = true;
+
+  std::string buffer;
+  while (!out_buffer_.empty() && !is_send_failed_) {
+    buffer.swap(out_buffer_);
+    lock.unlock();
+    try {
+      const auto sent = socket_.SendAll(buffer.data(), buffer.size(), {});
+      if (sent != buffer.size()) {
+        throw std::runtime_error("Peer closed the HTTP/2 connection");
+      }
+    } catch (const std::exception&) {
+      lock.lock();
+      is_sending_ = false;
+      FailSend();
+      throw;
+    }
+    buffer.clear();
+    lock.lock();
+
+    try {
+      SerializeFrames();
+    } catch (const std::exception&) {
+      is_sending_ = false;
+      FailSend();
+      throw;
+    }
+  }
+  is_sending_ = false;
+}
+
+void Http2Session::SerializeFrames() {
+  while (out_buffer_.size() < kMaxOutBufferSize) {
+    const std::uint8_t* data = nullptr;
+    const auto size = nghttp2_session_mem_send(session_.get(), &data);
+    if (size < 0) {
+      ThrowIfError(static_cast<int>(size), "nghttp2_session_mem_send");
+    }
+    if (size == 0) break;
+
+    out_buffer_.append(reinterpret_cast<const char*>(data), size);
+  }
+}
+
+void Http2Session::CloseStreams() noexcept {
+  const std::lock_guard lock{mutex_};
+  FailSend();
+}
+
+void Http2Session::FailSend() noexcept {
+  // Nothing is sent by nghttp2 from now on, so the data sources of the closed
+  // streams are never read again
+  is_send_failed_ = true;
+  for (auto& [id, stream] : streams_) {
+    if (stream->constructor) {
+      stream->constructor.reset();
+      --stats_.parser_stats.parsing_request_count;
+    }
+    stream->Close(NGHTTP2_CANCEL);
+  }
+  streams_.clear();
+}
+
+}  // namespace server::http
+
+USERVER_NAMESPACE_END
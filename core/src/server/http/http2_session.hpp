@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <server/http/http_request_constructor.hpp>
+#include <server/http/request_handler_base.hpp>
+#include <server/net/connection_config.hpp>
+#include <server/net/stats.hpp>
+#include <server/request/request_parser.hpp>
+
+#include <userver/engine/io/socket.hpp>
+#include <userver/engine/mutex.hpp>
+#include <userver/engine/task/task_with_result.hpp>
+#include <userver/engine/task_group.hpp>
+#include <userver/server/request/request_config.hpp>
+
+struct nghttp2_session;
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::http {
+
+// Server side of an HTTP/2 connection (h2c with prior knowledge).
+//
+// Is fed with the bytes received from the peer like the HTTP/1.1 parser.
+// Each request stream gets a handler task and a responder task of its own, so
+// the responses are sent as soon as they are ready, in any order. The frames
+// are serialized under the session lock and written to the socket outside of
+// it, by one task at a time.
+class Http2Session final : public request::RequestParser {
+ public:
+  Http2Session(const net::ConnectionConfig& config,
+               const request::HttpRequestConfig& handler_defaults_config,
+               engine::io::Socket& socket,
+               const RequestHandlerBase& request_handler, net::Stats& stats,
+               request::ResponseDataAccounter& data_accounter,
+               const std::string& remote_address);
+
+  // Cancels and waits for the streams that are still being processed
+  ~Http2Session() override;
+
+  // Returns false if the connection should be closed
+  bool Parse(const char* data, size_t size) override;
+
+  enum class PrefaceMatch {
+    kMatch,
+    kMismatch,
+    // `data` is a proper prefix of the preface, more bytes are needed
+    kIncomplete,
+  };
+
+  // Matches the first bytes received from the peer against the HTTP/2
+  // connection preface
+  static PrefaceMatch MatchConnectionPreface(std::string_view data) noexcept;
+
+ private:
+  struct Stream;
+  // nghttp2 callbacks
+  struct Callbacks;
+  struct SessionDeleter {
+    void operator()(nghttp2_session* session) const noexcept;
+  };
+
+  Stream* FindStream(std::int32_t stream_id);
+  void ParseUrl(Stream& stream);
+  void FinishHeaders(Stream& stream);
+  void FinishRequest(const std::shared_ptr<Stream>& stream);
+
+  void ProcessStream(const std::shared_ptr<Stream>& stream) noexcept;
+  void WaitForHandler(Stream& stream) noexcept;
+  void SendResponse(const std::shared_ptr<Stream>& stream);
+  void SendBodyStream(Stream& stream, HttpResponse& response, bool has_body);
+  void SendFileBody(Stream& stream, const HttpResponse::FileBody& file_body);
+  // Appends a part of the buffered body and waits for it to be sent, if too
+  // much of the body is buffered
+  void AppendBody(Stream& stream, std::string_view chunk);
+  void CompleteBody(Stream& stream);
+  engine::TaskWithResult<void> TakeHandlerTask(Stream& stream);
+
+  // Sends the pending frames. Is called under the lock, which is released
+  // while writing to the socket.
+  void Flush(std::unique_lock<engine::Mutex>& lock);
+  // Moves the pending frames from nghttp2 into out_buffer_, up to its limit
+  void SerializeFrames();
+  void CloseStreams() noexcept;
+  // Is called under the lock once sending fails. Closes all the streams with
+  // an error, which wakes up their responders.
+  void FailSend() noexcept;
+
+  const HttpRequestConstructor::Config request_constructor_config_;
+  engine::io::Socket& socket_;
+  const RequestHandlerBase& request_handler_;
+  net::Stats& stats_;
+  request::ResponseDataAccounter& data_accounter_;
+  const std::string& remote_address_;
+
+  // Guards the session state below
+  engine::Mutex mutex_;
+  std::unique_ptr<nghttp2_session, SessionDeleter> session_;
+  std::unordered_map<std::int32_t, std::shared_ptr<Stream>> streams_;
+  std::string out_buffer_;
+  // Whether a task is writing to the socket
+  bool is_sending_{false};
+  bool is_send_failed_{false};
+
+  // Is destroyed first, the responders use the session
+  engine::TaskGroup responders_;
+};
+
+}  // namespace server::http
+
+USERVER_NAMESPACE_END
@@ -46,7 +46,8 @@ HttpRequestConstructor::HttpRequestConstructor(
     request::ResponseDataAccounter& data_accounter)
     : config_(config),
       handler_info_index_(handler_info_index),
-      request_(std::make_shared<HttpRequestImpl>(data_accounter)) {}
+      request_(std::make_shared<HttpRequestImpl>(data_accounter,
+                                                 config.arena_initial_size)) {}
 
 void HttpRequestConstructor::SetMethod(HttpMethod method) {
   request_->orig_method_ = method;
@@ -96,7 +97,7 @@ void HttpRequestConstructor::ParseUrl() {
   const auto* handler_info = match_result.handler_info;
 
   request_->SetMatchedPathLength(match_result.matched_path_length);
-  request_->SetPathArgs(std::move(match_result.args_from_path));
+  request_->SetPathArgs(match_result.args_from_path);
 
   if (!handler_info && request_->GetMethod() == HttpMethod::kOptions &&
       match_result.status == MatchRequestResult::Status::kMethodNotAllowed) {
@@ -238,8 +239,12 @@ void HttpRequestConstructor::ParseArgs(const http_parser_url& url) {
 }
 
 void HttpRequestConstructor::ParseArgs(const char* data, size_t size) {
-  return USERVER_NAMESPACE::http::parser::ParseArgs(
-      std::string_view(data, size), request_->request_args_);
+  USERVER_NAMESPACE::http::parser::ParseAndConsumeArgs(
+      std::string_view(data, size),
+      [&args = request_->request_args_](std::string&& key,
+                                        std::string&& value) {
+        args[std::move(key)].push_back(std::move(value));
+      });
 }
 
 void HttpRequestConstructor::AddHeader() {
@@ -1,6 +1,11 @@
 #include <benchmark/benchmark.h>
 
+#include <memory_resource>
+#include <string>
+
 #include <server/http/http_request_constructor.hpp>
+#include <server/http/http_request_parser.hpp>
+#include <userver/engine/run_standalone.hpp>
 #include <utils/gbench_auxilary.hpp>
 
 USERVER_NAMESPACE_BEGIN
@@ -16,9 +21,115 @@ void http_request_constructor_url_decode(benchmark::State& state) {
   for (auto _ : state)
     benchmark::DoNotOptimize(USERVER_NAMESPACE::http::parser::UrlDecode(input));
 }
+
+const std::string kRequest =
+    "POST /v1/some/handler?arg1=value1&arg2=value2 HTTP/1.1\r\n"
+    "Host: localhost:8080\r\n"
+    "User-Agent: benchmark/1.0\r\n"
+    "Accept: */*\r\n"
+    "Accept-Encoding: gzip, deflate\r\n"
+    "Content-Type: application/json\r\n"
+    "X-Request-Id: 0123456789abcdef0123456789abcdef\r\n"
+    "Content-Length: 27\r\n"
+    "\r\n"
+    "{\"key\": \"value\", \"num\": 42}";
+
+// Parses the request received by the pieces of the range size
+void http_request_parser_parse(benchmark::State& state) {
+  engine::RunStandalone([&] {
+    const server::http::HandlerInfoIndex handler_info_index;
+    server::net::ParserStats stats;
+    server::request::ResponseDataAccounter data_accounter;
+    server::http::HttpRequestParser parser(
+        handler_info_index, {},
+        [](std::shared_ptr<server::request::RequestBase>&& request) {
+          benchmark::DoNotOptimize(request);
+        },
+        stats, data_accounter);
+
+    const auto step = static_cast<std::size_t>(state.range(0));
+    for (auto _ : state) {
+      for (std::size_t pos = 0; pos < kRequest.size(); pos += step) {
+        parser.Parse(kRequest.data() + pos,
+                     std::min(step, kRequest.size() - pos));
+      }
+    }
+  });
+}
+
+const std::string kRequestWithArgs =
+    "GET /v1/some/handler?a=1&b=2&c=3&d=4&e=5&f=6&g=7&h=8 HTTP/1.1\r\n"
+    "Host: localhost:8080\r\n"
+    "User-Agent: benchmark/1.0\r\n"
+    "Accept: */*\r\n"
+    "\r\n";
+
+// Counts the allocations of the std::pmr containers that do not use the
+// request arena
+class CountingResource final : public std::pmr::memory_resource {
+ public:
+  std::size_t GetAllocations() const { return allocations_; }
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    ++allocations_;
+    return upstream_->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* p, std::size_t bytes,
+                     std::size_t alignment) override {
+    upstream_->deallocate(p, bytes, alignment);
+  }
+
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+  std::pmr::memory_resource* upstream_{std::pmr::new_delete_resource()};
+  std::size_t allocations_{0};
+};
+
+// Parses a request with many arguments with the arena of the range size, 0
+// disables the arena. The allocations counter shows how many allocations per
+// request the arena saves.
+void http_request_parser_arena(benchmark::State& state) {
+  engine::RunStandalone([&] {
+    CountingResource counting_resource;
+    auto* const default_resource =
+        std::pmr::set_default_resource(&counting_resource);
+
+    {
+      const server::http::HandlerInfoIndex handler_info_index;
+      server::request::HttpRequestConfig config;
+      config.arena_initial_size = state.range(0);
+      server::net::ParserStats stats;
+      server::request::ResponseDataAccounter data_accounter;
+      server::http::HttpRequestParser parser(
+          handler_info_index, config,
+          [](std::shared_ptr<server::request::RequestBase>&& request) {
+            benchmark::DoNotOptimize(request);
+          },
+          stats, data_accounter);
+
+      for (auto _ : state) {
+        parser.Parse(kRequestWithArgs.data(), kRequestWithArgs.size());
+      }
+    }
+
+    state.counters["allocations"] = benchmark::Counter(
+        static_cast<double>(counting_resource.GetAllocations()),
+        benchmark::Counter::kAvgIterations);
+    std::pmr::set_default_resource(default_resource);
+  });
+}
 }  // namespace
 BENCHMARK(http_request_constructor_url_decode)
     ->RangeMultiplier(2)
     ->Range(1, 1024);
 
+BENCHMARK(http_request_parser_parse)->RangeMultiplier(8)->Range(1, 512);
+
+BENCHMARK(http_request_parser_arena)->Arg(0)->Arg(1024);
+
 USERVER_NAMESPACE_END
@@ -185,7 +185,8 @@ engine::TaskWithResult<void> HttpRequestHandler::StartRequestTask(
 
     request->SetTaskStartTime();
 
-    request::RequestContext context;
+    request::RequestContext context{
+        static_cast<HttpRequestImpl&>(*request).GetMemoryResource()};
     handler->HandleRequest(*request, context);
 
     const auto now = std::chrono::steady_clock::now();
@@ -203,6 +204,9 @@ engine::TaskWithResult<void> HttpRequestHandler::StartRequestTask(
 void HttpRequestHandler::DisableAddHandler() {
   const auto was_enabled = !add_handler_disabled_.exchange(true);
   UASSERT(was_enabled);
+
+  std::lock_guard<engine::Mutex> lock(handler_infos_mutex_);
+  handler_info_index_.Build();
 }
 
 void HttpRequestHandler::AddHandler(const handlers::HttpHandlerBase& handler,
@@ -1,6 +1,13 @@
 #include <benchmark/benchmark.h>
 
+#include <string>
+
+#include <http_parser.h>
+
 #include <server/http/http_request_constructor.hpp>
+#include <server/http/http_request_parser.hpp>
+#include <server/http/http_request_scanner.hpp>
+#include <userver/engine/run_standalone.hpp>
 #include <userver/http/predefined_header.hpp>
 
 #include <utils/gbench_auxilary.hpp>
@@ -51,6 +58,72 @@ void http_request_headers_get(benchmark::State& state) {
   }
 }
 
+std::string MakeRequest(std::size_t headers_count) {
+  std::string request = "GET /some/path?arg=value HTTP/1.1\r\n";
+  for (std::size_t i = 0; i < headers_count; ++i) {
+    request += std::string{kHeadersArray[i]};
+    request += ": some-header-value-of-a-typical-length-" + std::to_string(i);
+    request += "\r\n";
+  }
+  request += "\r\n";
+  return request;
+}
+
+// The whole request parsing with the headers put into the request
+void http_request_parser_headers(benchmark::State& state) {
+  engine::RunStandalone([&] {
+    const server::http::HandlerInfoIndex handler_info_index;
+    server::net::ParserStats stats;
+    server::request::ResponseDataAccounter data_accounter;
+    server::http::HttpRequestParser parser(
+        handler_info_index, {},
+        [](std::shared_ptr<server::request::RequestBase>&& request) {
+          benchmark::DoNotOptimize(request);
+        },
+        stats, data_accounter);
+
+    const auto request = MakeRequest(state.range(0));
+    for (auto _ : state) {
+      parser.Parse(request.data(), request.size());
+    }
+    state.SetBytesProcessed(state.iterations() * request.size());
+  });
+}
+
+// http_parser with the no-op callbacks, the tokenizing only
+void http_request_headers_tokenize_http_parser(benchmark::State& state) {
+  http_parser_settings settings{};
+  settings.on_header_field = [](http_parser*, const char*, size_t) {
+    return 0;
+  };
+  settings.on_header_value = [](http_parser*, const char*, size_t) {
+    return 0;
+  };
+
+  const auto request = MakeRequest(state.range(0));
+  for (auto _ : state) {
+    http_parser parser{};
+    http_parser_init(&parser, HTTP_REQUEST);
+    benchmark::DoNotOptimize(http_parser_execute(&parser, &settings,
+                                                 request.data(),
+                                                 request.size()));
+  }
+  state.SetBytesProcessed(state.iterations() * request.size());
+}
+
+// The line scanning of HttpRequestParser, the tokenizing only
+void http_request_headers_tokenize_scanner(benchmark::State& state) {
+  const auto request = MakeRequest(state.range(0));
+  for (auto _ : state) {
+    const char* pos = request.data();
+    const char* const end = pos + request.size();
+    while ((pos = server::http::impl::FindControlChar(pos, end)) != end) {
+      benchmark::DoNotOptimize(pos++);
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * request.size());
+}
+
 }  // namespace
 BENCHMARK(http_request_headers_insert)
     ->RangeMultiplier(2)
@@ -58,4 +131,14 @@ BENCHMARK(http_request_headers_insert)
 
 BENCHMARK(http_request_headers_get);
 
+BENCHMARK(http_request_parser_headers)
+    ->RangeMultiplier(2)
+    ->Range(1, kHeadersCount);
+BENCHMARK(http_request_headers_tokenize_http_parser)
+    ->RangeMultiplier(2)
+    ->Range(1, kHeadersCount);
+BENCHMARK(http_request_headers_tokenize_scanner)
+    ->RangeMultiplier(2)
+    ->Range(1, kHeadersCount);
+
 USERVER_NAMESPACE_END
@@ -73,17 +73,31 @@ namespace server::http {
 // Use hash_function() magic to pass out the same RNG seed among all
 // unordered_maps because we don't need different seeds and want to avoid its
 // overhead.
-HttpRequestImpl::HttpRequestImpl(request::ResponseDataAccounter& data_accounter)
-    : form_data_args_(kZeroAllocationBucketCount,
-                      request_args_.hash_function()),
+HttpRequestImpl::HttpRequestImpl(request::ResponseDataAccounter& data_accounter,
+                                 std::size_t arena_initial_size)
+    : arena_(arena_initial_size
+                 // The first block is allocated on the first use
+                 ? std::make_optional<std::pmr::monotonic_buffer_resource>(
+                       arena_initial_size)
+                 : std::nullopt),
+      request_args_(&GetMemoryResource()),
+      form_data_args_(kZeroAllocationBucketCount,
+                      request_args_.hash_function(), &GetMemoryResource()),
+      path_args_(&GetMemoryResource()),
       path_args_by_name_index_(kZeroAllocationBucketCount,
-                               request_args_.hash_function()),
+                               request_args_.hash_function(),
+                               &GetMemoryResource()),
       headers_(kBucketCount),
       cookies_(kZeroAllocationBucketCount, request_args_.hash_function()),
       response_(*this, data_accounter) {}
 
 HttpRequestImpl::~HttpRequestImpl() = default;
 
+std::pmr::memory_resource& HttpRequestImpl::GetMemoryResource() {
+  if (arena_) return *arena_;
+  return *std::pmr::get_default_resource();
+}
+
 std::chrono::duration<double> HttpRequestImpl::GetRequestTime() const {
   return GetResponse().SentTime() - StartTime();
 }
@@ -250,7 +264,10 @@ void HttpRequestImpl::SetRequestBody(std::string body) {
 }
 
 void HttpRequestImpl::ParseArgsFromBody() {
-  USERVER_NAMESPACE::http::parser::ParseArgs(request_body_, request_args_);
+  USERVER_NAMESPACE::http::parser::ParseAndConsumeArgs(
+      request_body_, [this](std::string&& key, std::string&& value) {
+        request_args_[std::move(key)].push_back(std::move(value));
+      });
 }
 
 bool HttpRequestImpl::IsBodyCompressed() const {
@@ -259,16 +276,15 @@ bool HttpRequestImpl::IsBodyCompressed() const {
   return !encoding.empty() && encoding != "identity";
 }
 
-void HttpRequestImpl::SetPathArgs(
-    std::vector<std::pair<std::string, std::string>> args) {
+void HttpRequestImpl::SetPathArgs(const impl::PathArgs& args) {
   path_args_.clear();
   path_args_.reserve(args.size());
 
   path_args_by_name_index_.clear();
-  for (auto& [name, value] : args) {
-    path_args_.push_back(std::move(value));
+  for (const auto& [name, value] : args) {
+    path_args_.emplace_back(value);
     if (!name.empty()) {
-      path_args_by_name_index_[std::move(name)] = path_args_.size() - 1;
+      path_args_by_name_index_[std::string{name}] = path_args_.size() - 1;
     }
   }
 }
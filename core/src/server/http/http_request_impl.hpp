@@ -2,12 +2,17 @@
 
 #include <chrono>
 #include <memory>
+#include <memory_resource>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include <userver/engine/task/task_processor_fwd.hpp>
 
+#include <server/http/multipart_form_data_parser.hpp>
+#include <server/http/radix_path_tree.hpp>
+
 #include <userver/server/http/http_method.hpp>
 #include <userver/server/http/http_request.hpp>
 #include <userver/server/http/http_response.hpp>
@@ -27,9 +32,17 @@ namespace http {
 
 class HttpRequestImpl final : public request::RequestBase {
  public:
-  HttpRequestImpl(request::ResponseDataAccounter& data_accounter);
+  explicit HttpRequestImpl(request::ResponseDataAccounter& data_accounter,
+                           std::size_t arena_initial_size = 0);
   ~HttpRequestImpl() override;
 
+  // Memory resource for the data that lives no longer than the request: a
+  // monotonic arena released with the request if it is enabled, the default
+  // resource otherwise. Not thread-safe.
+  std::pmr::memory_resource& GetMemoryResource();
+
+  bool HasArena() const { return arena_.has_value(); }
+
   const HttpMethod& GetMethod() const { return method_; }
   const HttpMethod& GetOrigMethod() const { return orig_method_; }
   const std::string& GetMethodStr() const { return ToString(method_); }
@@ -110,7 +123,7 @@ class HttpRequestImpl final : public request::RequestBase {
                           utils::datetime::WallCoarseClock::time_point tp,
                           const std::string& remote_address) const;
 
-  void SetPathArgs(std::vector<std::pair<std::string, std::string>> args);
+  void SetPathArgs(const impl::PathArgs& args);
 
   void SetMatchedPathLength(size_t length) override;
 
@@ -138,12 +151,15 @@ class HttpRequestImpl final : public request::RequestBase {
   std::string request_path_;
   std::string request_body_;
   std::string path_suffix_;
-  std::unordered_map<std::string, std::vector<std::string>, utils::StrCaseHash>
+  // Is declared before the containers that allocate from it
+  std::optional<std::pmr::monotonic_buffer_resource> arena_;
+  // The nodes of the containers are allocated from GetMemoryResource()
+  std::pmr::unordered_map<std::string, std::vector<std::string>,
+                          utils::StrCaseHash>
       request_args_;
-  std::unordered_map<std::string, std::vector<FormDataArg>, utils::StrCaseHash>
-      form_data_args_;
-  std::vector<std::string> path_args_;
-  std::unordered_map<std::string, size_t, utils::StrCaseHash>
+  FormDataArgs form_data_args_;
+  std::pmr::vector<std::string> path_args_;
+  std::pmr::unordered_map<std::string, size_t, utils::StrCaseHash>
       path_args_by_name_index_;
   HttpRequest::HeadersMap headers_;
   HttpRequest::CookiesMap cookies_;
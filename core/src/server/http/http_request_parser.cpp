@@ -1,9 +1,16 @@
 #include "http_request_parser.hpp"
 
+#include <algorithm>
+#include <array>
+#include <charconv>
+
+#include <userver/http/common_headers.hpp>
 #include <userver/logging/log.hpp>
-#include <userver/server/http/http_method.hpp>
 #include <userver/server/request/request_base.hpp>
 #include <userver/utils/assert.hpp>
+#include <userver/utils/str_icase.hpp>
+
+#include "http_request_scanner.hpp"
 
 USERVER_NAMESPACE_BEGIN
 
@@ -11,42 +18,89 @@ namespace server::http {
 
 namespace {
 
-HttpMethod ConvertHttpMethod(http_method method) {
-  switch (method) {
-    case HTTP_DELETE:
-      return HttpMethod::kDelete;
-    case HTTP_GET:
-      return HttpMethod::kGet;
-    case HTTP_HEAD:
-      return HttpMethod::kHead;
-    case HTTP_POST:
-      return HttpMethod::kPost;
-    case HTTP_PUT:
-      return HttpMethod::kPut;
-    case HTTP_CONNECT:
-      return HttpMethod::kConnect;
-    case HTTP_PATCH:
-      return HttpMethod::kPatch;
-    case HTTP_OPTIONS:
-      return HttpMethod::kOptions;
-    default:
-      return HttpMethod::kUnknown;
+// The method, the spaces and the version around the url
+constexpr std::size_t kMaxRequestLineOverhead = 64;
+
+constexpr std::string_view kHttpVersionPrefix = "HTTP/";
+constexpr std::string_view kUpgrade = "Upgrade";
+
+HttpMethod ParseMethod(std::string_view method) {
+  if (method == "GET") return HttpMethod::kGet;
+  if (method == "POST") return HttpMethod::kPost;
+  if (method == "PUT") return HttpMethod::kPut;
+  if (method == "DELETE") return HttpMethod::kDelete;
+  if (method == "HEAD") return HttpMethod::kHead;
+  if (method == "PATCH") return HttpMethod::kPatch;
+  if (method == "OPTIONS") return HttpMethod::kOptions;
+  if (method == "CONNECT") return HttpMethod::kConnect;
+  return HttpMethod::kUnknown;
+}
+
+constexpr auto kTokenChars = [] {
+  std::array<bool, 256> table{};
+  for (char c = 'a'; c <= 'z'; ++c) table[static_cast<unsigned char>(c)] = true;
+  for (char c = 'A'; c <= 'Z'; ++c) table[static_cast<unsigned char>(c)] = true;
+  for (char c = '0'; c <= '9'; ++c) table[static_cast<unsigned char>(c)] = true;
+  for (const char c : std::string_view{"!#$%&'*+-.^_`|~"}) {
+    table[static_cast<unsigned char>(c)] = true;
   }
+  return table;
+}();
+
+// 'token' of RFC 7230, the methods and the header names are tokens
+bool IsToken(std::string_view str) {
+  return !str.empty() && std::all_of(str.begin(), str.end(), [](char c) {
+    return kTokenChars[static_cast<unsigned char>(c)];
+  });
 }
 
-}  // namespace
+bool IsDigit(char c) { return c >= '0' && c <= '9'; }
 
-const http_parser_settings HttpRequestParser::parser_settings = []() {
-  http_parser_settings settings{};
-  settings.on_message_begin = HttpRequestParser::OnMessageBegin;
-  settings.on_url = HttpRequestParser::OnUrl;
-  settings.on_header_field = HttpRequestParser::OnHeaderField;
-  settings.on_header_value = HttpRequestParser::OnHeaderValue;
-  settings.on_headers_complete = HttpRequestParser::OnHeadersComplete;
-  settings.on_body = HttpRequestParser::OnBody;
-  settings.on_message_complete = HttpRequestParser::OnMessageComplete;
-  return settings;
-}();
+bool IsIcaseEqual(std::string_view lhs, std::string_view rhs) {
+  return utils::StrIcaseEqual{}(lhs, rhs);
+}
+
+std::string_view TrimWhitespace(std::string_view str) {
+  const auto begin = str.find_first_not_of(" \t");
+  if (begin == std::string_view::npos) return {};
+  return str.substr(begin, str.find_last_not_of(" \t") - begin + 1);
+}
+
+// Calls func for each element of a comma separated header value
+template <typename Func>
+void ForEachListElement(std::string_view value, Func func) {
+  while (!value.empty()) {
+    const auto pos = value.find(',');
+    func(TrimWhitespace(value.substr(0, pos)));
+    if (pos == std::string_view::npos) break;
+    value.remove_prefix(pos + 1);
+  }
+}
+
+std::optional<std::size_t> ParseSize(std::string_view str, int base) {
+  std::size_t result = 0;
+  const auto* end = str.data() + str.size();
+  const auto [ptr, ec] = std::from_chars(str.data(), end, result, base);
+  if (str.empty() || ec != std::errc{} || ptr != end) return std::nullopt;
+  return result;
+}
+
+bool ParseHttpVersion(std::string_view version, unsigned short& major,
+                      unsigned short& minor) {
+  if (version.size() != kHttpVersionPrefix.size() + 3 ||
+      version.substr(0, kHttpVersionPrefix.size()) != kHttpVersionPrefix) {
+    return false;
+  }
+  version.remove_prefix(kHttpVersionPrefix.size());
+  if (!IsDigit(version[0]) || version[1] != '.' || !IsDigit(version[2])) {
+    return false;
+  }
+  major = version[0] - '0';
+  minor = version[2] - '0';
+  return true;
+}
+
+}  // namespace
 
 HttpRequestParser::HttpRequestParser(
     const HandlerInfoIndex& handler_info_index,
@@ -57,184 +111,381 @@ HttpRequestParser::HttpRequestParser(
       request_constructor_config_{request_config},
       on_new_request_cb_(std::move(on_new_request_cb)),
       stats_(stats),
-      data_accounter_(data_accounter) {
-  http_parser_init(&parser_, HTTP_REQUEST);
-  parser_.data = this;
-}
+      data_accounter_(data_accounter) {}
 
 bool HttpRequestParser::Parse(const char* data, size_t size) {
-  size_t parsed = http_parser_execute(&parser_, &parser_settings, data, size);
-  if (parsed != size) {
-    LOG_WARNING() << "parsed=" << parsed << " size=" << size
-                  << " error_description="
-                  << http_errno_description(HTTP_PARSER_ERRNO(&parser_));
-    FinalizeRequest();
-    return false;
-  }
-  if (parser_.upgrade) {
-    LOG_WARNING() << "upgrade detected";
-    FinalizeRequest();
-    return false;
+  std::string_view input{data, size};
+  while (!input.empty()) {
+    bool is_ok = false;
+    switch (state_) {
+      case State::kRequestLine:
+        is_ok = ParseRequestLine(input);
+        break;
+      case State::kHeaders:
+        is_ok = ParseHeaders(input);
+        break;
+      case State::kBody:
+        is_ok = ParseBody(input);
+        break;
+      case State::kChunkSize:
+        is_ok = ParseChunkSize(input);
+        break;
+      case State::kChunkData:
+        is_ok = ParseChunkData(input);
+        break;
+      case State::kChunkDataEnd:
+        is_ok = ParseChunkDataEnd(input);
+        break;
+      case State::kTrailers:
+        is_ok = ParseTrailers(input);
+        break;
+    }
+
+    if (!is_ok) {
+      LOG_WARNING() << "can't parse request, unparsed size=" << input.size()
+                    << " size=" << size;
+      state_ = State::kRequestLine;
+      line_buffer_.clear();
+      is_line_buffer_consumed_ = false;
+      FinalizeRequest();
+      return false;
+    }
   }
   return true;
 }
 
-int HttpRequestParser::OnMessageBegin(http_parser* p) {
-  auto* http_request_parser = static_cast<HttpRequestParser*>(p->data);
-  UASSERT(http_request_parser != nullptr);
-  return http_request_parser->OnMessageBeginImpl(p);
+bool HttpRequestParser::ParseRequestLine(std::string_view& input) {
+  if (!request_constructor_) {
+    // the empty lines before a request are ignored
+    const auto begin = input.find_first_not_of("\r\n");
+    if (begin == std::string_view::npos) {
+      input = {};
+      return true;
+    }
+    input.remove_prefix(begin);
+
+    LOG_TRACE() << "message begin";
+    CreateRequestConstructor();
+  }
+
+  std::string_view line;
+  const auto status = NextLine(input, line);
+  if (status != LineStatus::kComplete) return status == LineStatus::kPartial;
+  return ProcessRequestLine(line);
 }
 
-int HttpRequestParser::OnHeadersComplete(http_parser* p) {
-  auto* http_request_parser = static_cast<HttpRequestParser*>(p->data);
-  UASSERT(http_request_parser != nullptr);
-  return http_request_parser->OnHeadersCompleteImpl(p);
+bool HttpRequestParser::ParseHeaders(std::string_view& input) {
+  std::string_view line;
+  while (!input.empty()) {
+    const auto status = NextLine(input, line);
+    if (status != LineStatus::kComplete) return status == LineStatus::kPartial;
+    if (line.empty()) return OnHeadersComplete();
+    if (!ProcessHeader(line)) return false;
+  }
+  return true;
 }
 
-int HttpRequestParser::OnMessageComplete(http_parser* p) {
-  auto* http_request_parser = static_cast<HttpRequestParser*>(p->data);
-  UASSERT(http_request_parser != nullptr);
-  return http_request_parser->OnMessageCompleteImpl(p);
+bool HttpRequestParser::ParseBody(std::string_view& input) {
+  const auto size = std::min(body_left_, input.size());
+  if (!AppendBody(input.substr(0, size))) return false;
+  input.remove_prefix(size);
+  body_left_ -= size;
+
+  if (body_left_ == 0) return OnMessageComplete();
+  return true;
+}
+
+bool HttpRequestParser::ParseChunkSize(std::string_view& input) {
+  std::string_view line;
+  const auto status = NextLine(input, line);
+  if (status != LineStatus::kComplete) return status == LineStatus::kPartial;
+
+  // the chunk extensions are ignored
+  const auto chunk_size =
+      ParseSize(TrimWhitespace(line.substr(0, line.find(';'))), 16);
+  if (!chunk_size) {
+    LOG_WARNING() << "invalid chunk size: '" << line << '\'';
+    return false;
+  }
+
+  if (*chunk_size == 0) {
+    state_ = State::kTrailers;
+  } else {
+    body_left_ = *chunk_size;
+    state_ = State::kChunkData;
+  }
+  return true;
 }
 
-int HttpRequestParser::OnUrl(http_parser* p, const char* data, size_t size) {
-  auto* http_request_parser = static_cast<HttpRequestParser*>(p->data);
-  UASSERT(http_request_parser != nullptr);
-  return http_request_parser->OnUrlImpl(p, data, size);
+bool HttpRequestParser::ParseChunkData(std::string_view& input) {
+  const auto size = std::min(body_left_, input.size());
+  if (!AppendBody(input.substr(0, size))) return false;
+  input.remove_prefix(size);
+  body_left_ -= size;
+
+  if (body_left_ == 0) state_ = State::kChunkDataEnd;
+  return true;
 }
 
-int HttpRequestParser::OnHeaderField(http_parser* p, const char* data,
-                                     size_t size) {
-  auto* http_request_parser = static_cast<HttpRequestParser*>(p->data);
-  UASSERT(http_request_parser != nullptr);
-  return http_request_parser->OnHeaderFieldImpl(p, data, size);
+bool HttpRequestParser::ParseChunkDataEnd(std::string_view& input) {
+  std::string_view line;
+  const auto status = NextLine(input, line);
+  if (status != LineStatus::kComplete) return status == LineStatus::kPartial;
+
+  if (!line.empty()) {
+    LOG_WARNING() << "no line break after the chunk data";
+    return false;
+  }
+  state_ = State::kChunkSize;
+  return true;
 }
 
-int HttpRequestParser::OnHeaderValue(http_parser* p, const char* data,
-                                     size_t size) {
-  auto* http_request_parser = static_cast<HttpRequestParser*>(p->data);
-  UASSERT(http_request_parser != nullptr);
-  return http_request_parser->OnHeaderValueImpl(p, data, size);
+bool HttpRequestParser::ParseTrailers(std::string_view& input) {
+  std::string_view line;
+  while (!input.empty()) {
+    const auto status = NextLine(input, line);
+    if (status != LineStatus::kComplete) return status == LineStatus::kPartial;
+    // the trailer fields are not passed to the handlers
+    if (line.empty()) return OnMessageComplete();
+  }
+  return true;
 }
 
-int HttpRequestParser::OnBody(http_parser* p, const char* data, size_t size) {
-  auto* http_request_parser = static_cast<HttpRequestParser*>(p->data);
-  UASSERT(http_request_parser != nullptr);
-  return http_request_parser->OnBodyImpl(p, data, size);
+HttpRequestParser::LineStatus HttpRequestParser::NextLine(
+    std::string_view& input, std::string_view& line) {
+  if (is_line_buffer_consumed_) {
+    line_buffer_.clear();
+    is_line_buffer_consumed_ = false;
+  }
+
+  const char* const begin = input.data();
+  const char* const end = begin + input.size();
+  const char* pos = begin;
+  while ((pos = impl::FindControlChar(pos, end)) != end && *pos != '\n') {
+    // CR is allowed only before LF, it may be the last received char though
+    const bool is_allowed =
+        *pos == '\t' || (*pos == '\r' && (pos + 1 == end || pos[1] == '\n'));
+    if (!is_allowed) {
+      LOG_WARNING() << "invalid char in the request, code="
+                    << static_cast<int>(static_cast<unsigned char>(*pos));
+      return LineStatus::kInvalid;
+    }
+    ++pos;
+  }
+
+  if (pos == end) {
+    line_buffer_.append(begin, end - begin);
+    input = {};
+    if (line_buffer_.size() > MaxLineSize()) {
+      OnLineTooLong();
+      return LineStatus::kInvalid;
+    }
+    return LineStatus::kPartial;
+  }
+
+  line = std::string_view(begin, pos - begin);
+  input.remove_prefix(pos - begin + 1);
+  if (!line_buffer_.empty()) {
+    line_buffer_.append(line);
+    line = line_buffer_;
+    is_line_buffer_consumed_ = true;
+  }
+  if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+  // a CR received last in the previous read must be followed by LF
+  if (is_line_buffer_consumed_ && line.find('\r') != std::string_view::npos) {
+    LOG_WARNING() << "invalid line break in the request";
+    return LineStatus::kInvalid;
+  }
+  return LineStatus::kComplete;
 }
 
-int HttpRequestParser::OnMessageBeginImpl(http_parser*) {
-  LOG_TRACE() << "message begin";
-  CreateRequestConstructor();
-  return 0;
+std::size_t HttpRequestParser::MaxLineSize() const {
+  if (state_ == State::kRequestLine) {
+    return request_constructor_config_.max_url_size + kMaxRequestLineOverhead;
+  }
+  return request_constructor_config_.max_request_size;
 }
 
-int HttpRequestParser::OnUrlImpl(http_parser* p, const char* data,
-                                 size_t size) {
+void HttpRequestParser::OnLineTooLong() {
   UASSERT(request_constructor_);
-  LOG_TRACE() << "url: '" << std::string_view(data, size) << '\'';
-  request_constructor_->SetMethod(
-      ConvertHttpMethod(static_cast<http_method>(p->method)));
+  // the constructor sets the matching status and throws
   try {
-    request_constructor_->AppendUrl(data, size);
+    if (state_ == State::kRequestLine) {
+      request_constructor_->AppendUrl(line_buffer_.data(), line_buffer_.size());
+    } else if (state_ == State::kHeaders) {
+      request_constructor_->AppendHeaderField(line_buffer_.data(),
+                                              line_buffer_.size());
+    }
   } catch (const std::exception& ex) {
-    LOG_WARNING() << "can't append url: " << ex;
-    return -1;
+    LOG_WARNING() << "line is too long: " << ex;
+    return;
   }
-  return 0;
+  LOG_WARNING() << "line is too long, size=" << line_buffer_.size();
 }
 
-int HttpRequestParser::OnHeaderFieldImpl(http_parser* p, const char* data,
-                                         size_t size) {
+bool HttpRequestParser::ProcessRequestLine(std::string_view line) {
   UASSERT(request_constructor_);
-  LOG_TRACE() << "header field: '" << std::string_view(data, size) << "'";
-  if (!CheckUrlComplete(p)) return -1;
+  LOG_TRACE() << "request line: '" << line << '\'';
+
+  const auto method_end = line.find(' ');
+  const auto target_end = line.rfind(' ');
+  if (method_end == std::string_view::npos || method_end == target_end) {
+    LOG_WARNING() << "invalid request line: '" << line << '\'';
+    return false;
+  }
+
+  const auto method = line.substr(0, method_end);
+  message_.method = ParseMethod(method);
+  request_constructor_->SetMethod(message_.method);
+  if (!IsToken(method)) {
+    LOG_WARNING() << "invalid method: '" << method << '\'';
+    return false;
+  }
+
+  const auto version = line.substr(target_end + 1);
+  if (!ParseHttpVersion(version, message_.http_major, message_.http_minor)) {
+    LOG_WARNING() << "invalid http version: '" << version << '\'';
+    return false;
+  }
+  request_constructor_->SetHttpMajor(message_.http_major);
+  request_constructor_->SetHttpMinor(message_.http_minor);
+
+  const auto url = line.substr(method_end + 1, target_end - method_end - 1);
   try {
-    request_constructor_->AppendHeaderField(data, size);
+    request_constructor_->AppendUrl(url.data(), url.size());
   } catch (const std::exception& ex) {
-    LOG_WARNING() << "can't append header field: " << ex;
-    return -1;
+    LOG_WARNING() << "can't append url: " << ex;
+    return false;
   }
-  return 0;
+  try {
+    request_constructor_->ParseUrl();
+  } catch (const std::exception& ex) {
+    LOG_WARNING() << "can't parse url: " << ex;
+    return false;
+  }
+
+  state_ = State::kHeaders;
+  return true;
 }
 
-int HttpRequestParser::OnHeaderValueImpl(http_parser* p, const char* data,
-                                         size_t size) {
+bool HttpRequestParser::ProcessHeader(std::string_view line) {
   UASSERT(request_constructor_);
-  if (!CheckUrlComplete(p)) return -1;
-  LOG_TRACE() << "header value: '" << std::string_view(data, size) << '\'';
+
+  // the whitespace before the colon and the obsolete line folding are
+  // rejected here as well, as RFC 7230 requires
+  const auto colon = line.find(':');
+  const auto name = line.substr(0, colon);
+  if (colon == std::string_view::npos || !IsToken(name)) {
+    LOG_WARNING() << "invalid header line: '" << line << '\'';
+    return false;
+  }
+  const auto value = TrimWhitespace(line.substr(colon + 1));
+  LOG_TRACE() << "header: '" << name << "': '" << value << '\'';
+
   try {
-    request_constructor_->AppendHeaderValue(data, size);
+    request_constructor_->AppendHeaderField(name.data(), name.size());
+    request_constructor_->AppendHeaderValue(value.data(), value.size());
   } catch (const std::exception& ex) {
-    LOG_WARNING() << "can't append header value: " << ex;
-    return -1;
+    LOG_WARNING() << "can't append header: " << ex;
+    return false;
+  }
+
+  if (IsIcaseEqual(name, USERVER_NAMESPACE::http::headers::kContentLength)) {
+    const auto content_length = ParseSize(value, 10);
+    if (!content_length || (message_.content_length &&
+                            *message_.content_length != *content_length)) {
+      LOG_WARNING() << "invalid content length: '" << value << '\'';
+      return false;
+    }
+    message_.content_length = content_length;
+  } else if (IsIcaseEqual(
+                 name, USERVER_NAMESPACE::http::headers::kTransferEncoding)) {
+    // only the last coding matters for the message framing
+    message_.has_transfer_encoding = true;
+    ForEachListElement(value, [this](std::string_view coding) {
+      message_.is_chunked = IsIcaseEqual(coding, "chunked");
+    });
+  } else if (IsIcaseEqual(name,
+                          USERVER_NAMESPACE::http::headers::kConnection)) {
+    ForEachListElement(value, [this](std::string_view option) {
+      if (IsIcaseEqual(option, "close")) {
+        message_.connection_close = true;
+      } else if (IsIcaseEqual(option, "keep-alive")) {
+        message_.connection_keep_alive = true;
+      } else if (IsIcaseEqual(option, "upgrade")) {
+        message_.connection_upgrade = true;
+      }
+    });
+  } else if (IsIcaseEqual(name, kUpgrade)) {
+    message_.has_upgrade = true;
   }
-  return 0;
+  return true;
 }
 
-int HttpRequestParser::OnHeadersCompleteImpl(http_parser* p) {
+bool HttpRequestParser::OnHeadersComplete() {
   UASSERT(request_constructor_);
-  if (!CheckUrlComplete(p)) return -1;
   try {
     request_constructor_->AppendHeaderField("", 0);
   } catch (const std::exception& ex) {
     LOG_WARNING() << "can't append header value: " << ex;
-    return -1;
+    return false;
   }
   LOG_TRACE() << "headers complete";
-  return 0;
-}
 
-int HttpRequestParser::OnBodyImpl(http_parser* p, const char* data,
-                                  size_t size) {
-  UASSERT(request_constructor_);
-  if (!CheckUrlComplete(p)) return -1;
-  LOG_TRACE() << "body: '" << std::string_view(data, size) << "'";
-  try {
-    request_constructor_->AppendBody(data, size);
-  } catch (const std::exception& ex) {
-    LOG_WARNING() << "can't append body: " << ex;
-    return -1;
+  if (message_.has_transfer_encoding) {
+    // a request with both of them is ambiguous, see RFC 7230 3.3.3
+    if (!message_.is_chunked || message_.content_length) {
+      LOG_WARNING() << "unsupported transfer encoding";
+      return false;
+    }
+    state_ = State::kChunkSize;
+    return true;
   }
-  return 0;
+
+  body_left_ = message_.content_length.value_or(0);
+  if (body_left_ == 0) return OnMessageComplete();
+  state_ = State::kBody;
+  return true;
 }
 
-int HttpRequestParser::OnMessageCompleteImpl(http_parser* p) {
+bool HttpRequestParser::OnMessageComplete() {
   UASSERT(request_constructor_);
-  if (p->upgrade) {
+  if (message_.method == HttpMethod::kConnect ||
+      (message_.has_upgrade && message_.connection_upgrade)) {
     LOG_WARNING() << "upgrade detected";
-    return -1;  // error
+    return false;
   }
-  request_constructor_->SetIsFinal(!http_should_keep_alive(p));
-  if (!CheckUrlComplete(p)) return -1;
+
+  const bool is_http11 = message_.http_major > 1 ||
+                         (message_.http_major == 1 && message_.http_minor > 0);
+  const bool keep_alive = is_http11 ? !message_.connection_close
+                                    : message_.connection_keep_alive;
+  request_constructor_->SetIsFinal(!keep_alive);
   LOG_TRACE() << "message complete";
-  if (!FinalizeRequest()) return -1;
-  return 0;
-}
 
-void HttpRequestParser::CreateRequestConstructor() {
-  ++stats_.parsing_request_count;
-  request_constructor_.emplace(request_constructor_config_, handler_info_index_,
-                               data_accounter_);
-  url_complete_ = false;
+  state_ = State::kRequestLine;
+  return FinalizeRequest();
 }
 
-bool HttpRequestParser::CheckUrlComplete(http_parser* p) {
-  if (url_complete_) return true;
-  url_complete_ = true;
-  request_constructor_->SetMethod(
-      ConvertHttpMethod(static_cast<http_method>(p->method)));
-  request_constructor_->SetHttpMajor(p->http_major);
-  request_constructor_->SetHttpMinor(p->http_minor);
+bool HttpRequestParser::AppendBody(std::string_view data) {
+  UASSERT(request_constructor_);
   try {
-    request_constructor_->ParseUrl();
+    request_constructor_->AppendBody(data.data(), data.size());
   } catch (const std::exception& ex) {
-    LOG_WARNING() << "can't parse url: " << ex;
+    LOG_WARNING() << "can't append body: " << ex;
     return false;
   }
   return true;
 }
 
+void HttpRequestParser::CreateRequestConstructor() {
+  ++stats_.parsing_request_count;
+  request_constructor_.emplace(request_constructor_config_, handler_info_index_,
+                               data_accounter_);
+  message_ = {};
+}
+
 bool HttpRequestParser::FinalizeRequest() {
   bool res = FinalizeRequestImpl();
   --stats_.parsing_request_count;
@@ -4,12 +4,13 @@
 #include <functional>
 #include <memory>
 #include <optional>
-
-#include <http_parser.h>
+#include <string>
+#include <string_view>
 
 #include <server/net/stats.hpp>
 #include <server/request/request_parser.hpp>
 
+#include <userver/server/http/http_method.hpp>
 #include <userver/server/request/request_config.hpp>
 
 #include "http_request_constructor.hpp"
@@ -18,6 +19,11 @@ USERVER_NAMESPACE_BEGIN
 
 namespace server::http {
 
+// HTTP/1.1 request parser.
+//
+// Parses the data in place: the request line, the headers and the body are
+// passed to the request constructor as views into the received data. Only
+// the lines split between the reads are gathered in a buffer of the parser.
 class HttpRequestParser final : public request::RequestParser {
  public:
   using OnNewRequestCb =
@@ -33,41 +39,82 @@ class HttpRequestParser final : public request::RequestParser {
 
   bool Parse(const char* data, size_t size) override;
 
+  // Whether a part of a request has been received
+  bool HasPartialRequest() const noexcept {
+    return request_constructor_.has_value();
+  }
+
  private:
-  static int OnMessageBegin(http_parser* p);
-  static int OnUrl(http_parser* p, const char* data, size_t size);
-  static int OnHeaderField(http_parser* p, const char* data, size_t size);
-  static int OnHeaderValue(http_parser* p, const char* data, size_t size);
-  static int OnHeadersComplete(http_parser* p);
-  static int OnBody(http_parser* p, const char* data, size_t size);
-  static int OnMessageComplete(http_parser* p);
-
-  int OnMessageBeginImpl(http_parser* p);
-  int OnUrlImpl(http_parser* p, const char* data, size_t size);
-  int OnHeaderFieldImpl(http_parser* p, const char* data, size_t size);
-  int OnHeaderValueImpl(http_parser* p, const char* data, size_t size);
-  int OnHeadersCompleteImpl(http_parser* p);
-  int OnBodyImpl(http_parser* p, const char* data, size_t size);
-  int OnMessageCompleteImpl(http_parser* p);
+  enum class State {
+    kRequestLine,
+    kHeaders,
+    kBody,
+    kChunkSize,
+    kChunkData,
+    kChunkDataEnd,
+    kTrailers,
+  };
+
+  // What the parser itself needs to know about the message being parsed
+  struct MessageInfo {
+    HttpMethod method{HttpMethod::kUnknown};
+    unsigned short http_major{0};
+    unsigned short http_minor{0};
+    std::optional<std::size_t> content_length;
+    bool is_chunked{false};
+    bool has_transfer_encoding{false};
+    bool has_upgrade{false};
+    bool connection_close{false};
+    bool connection_keep_alive{false};
+    bool connection_upgrade{false};
+  };
+
+  // Each step consumes a part of the input and returns false on error
+  bool ParseRequestLine(std::string_view& input);
+  bool ParseHeaders(std::string_view& input);
+  bool ParseBody(std::string_view& input);
+  bool ParseChunkSize(std::string_view& input);
+  bool ParseChunkData(std::string_view& input);
+  bool ParseChunkDataEnd(std::string_view& input);
+  bool ParseTrailers(std::string_view& input);
+
+  enum class LineStatus {
+    kComplete,
+    kPartial,
+    kInvalid,
+  };
+
+  // Takes the next complete line without the line ending from the input. The
+  // line points either into the input or into line_buffer_, where a line
+  // split between the reads is gathered.
+  LineStatus NextLine(std::string_view& input, std::string_view& line);
+  std::size_t MaxLineSize() const;
+  void OnLineTooLong();
+
+  bool ProcessRequestLine(std::string_view line);
+  bool ProcessHeader(std::string_view line);
+  bool OnHeadersComplete();
+  bool OnMessageComplete();
+  bool AppendBody(std::string_view data);
 
   void CreateRequestConstructor();
 
-  bool CheckUrlComplete(http_parser* p);
-
   bool FinalizeRequest();
   bool FinalizeRequestImpl();
 
   const HandlerInfoIndex& handler_info_index_;
   const HttpRequestConstructor::Config request_constructor_config_;
 
-  bool url_complete_ = false;
-
   OnNewRequestCb on_new_request_cb_;
 
-  http_parser parser_{};
+  State state_{State::kRequestLine};
+  MessageInfo message_;
+  std::size_t body_left_{0};
+  std::string line_buffer_;
+  bool is_line_buffer_consumed_{false};
+
   std::optional<HttpRequestConstructor> request_constructor_;
 
-  static const http_parser_settings parser_settings;
   net::ParserStats& stats_;
   request::ResponseDataAccounter& data_accounter_;
 };
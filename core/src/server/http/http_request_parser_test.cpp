@@ -0,0 +1,190 @@
+#include <userver/utest/utest.hpp>
+
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include <server/http/http_request_impl.hpp>
+#include <server/http/http_request_parser.hpp>
+#include <server/http/http_request_scanner.hpp>
+#include <userver/server/request/request_context.hpp>
+
+#include "create_parser_test.hpp"
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+using Requests = std::vector<std::shared_ptr<server::http::HttpRequestImpl>>;
+
+// Feeds the data to a parser by pieces of the step size
+bool ParseBySteps(const std::string& data, std::size_t step,
+                  Requests& requests) {
+  auto parser = server::CreateTestParser(
+      [&requests](std::shared_ptr<server::request::RequestBase>&& request) {
+        requests.push_back(
+            std::dynamic_pointer_cast<server::http::HttpRequestImpl>(request));
+      });
+
+  for (std::size_t pos = 0; pos < data.size(); pos += step) {
+    const auto size = std::min(step, data.size() - pos);
+    if (!parser.Parse(data.data() + pos, size)) return false;
+  }
+  return true;
+}
+
+constexpr std::size_t kSteps[] = {1, 2, 3, 7, 4096};
+
+}  // namespace
+
+UTEST(HttpRequestParser, Pipelined) {
+  const std::string data =
+      "\r\nGET /first?a=b HTTP/1.1\r\n"
+      "Host: localhost\r\n"
+      "X-Header:  with spaces \t\r\n"
+      "\r\n"
+      "POST /second HTTP/1.1\n"
+      "Content-Length: 5\n"
+      "Connection: close\n"
+      "\n"
+      "hello";
+
+  for (const auto step : kSteps) {
+    Requests requests;
+    EXPECT_TRUE(ParseBySteps(data, step, requests));
+    ASSERT_EQ(requests.size(), 2);
+
+    EXPECT_EQ(requests[0]->GetMethod(), server::http::HttpMethod::kGet);
+    EXPECT_EQ(requests[0]->GetUrl(), "/first?a=b");
+    EXPECT_EQ(requests[0]->GetArg("a"), "b");
+    EXPECT_EQ(requests[0]->GetHeader("Host"), "localhost");
+    EXPECT_EQ(requests[0]->GetHeader("X-Header"), "with spaces");
+    EXPECT_FALSE(requests[0]->IsFinal());
+
+    EXPECT_EQ(requests[1]->GetMethod(), server::http::HttpMethod::kPost);
+    EXPECT_EQ(requests[1]->GetUrl(), "/second");
+    EXPECT_EQ(requests[1]->RequestBody(), "hello");
+    EXPECT_TRUE(requests[1]->IsFinal());
+  }
+}
+
+UTEST(HttpRequestParser, Chunked) {
+  const std::string data =
+      "POST / HTTP/1.1\r\n"
+      "Transfer-Encoding: chunked\r\n"
+      "\r\n"
+      "5;name=value\r\nhello\r\n"
+      "A\r\n0123456789\r\n"
+      "0\r\n"
+      "Trailer: ignored\r\n"
+      "\r\n";
+
+  for (const auto step : kSteps) {
+    Requests requests;
+    EXPECT_TRUE(ParseBySteps(data, step, requests));
+    ASSERT_EQ(requests.size(), 1);
+    EXPECT_EQ(requests[0]->RequestBody(), "hello0123456789");
+  }
+}
+
+UTEST(HttpRequestParser, KeepAlive) {
+  const std::string data =
+      "GET / HTTP/1.0\r\n\r\n"
+      "GET / HTTP/1.0\r\nConnection: Keep-Alive\r\n\r\n"
+      "GET / HTTP/1.1\r\nConnection: keep-alive, close\r\n\r\n";
+
+  Requests requests;
+  EXPECT_TRUE(ParseBySteps(data, data.size(), requests));
+  ASSERT_EQ(requests.size(), 3);
+  EXPECT_TRUE(requests[0]->IsFinal());
+  EXPECT_FALSE(requests[1]->IsFinal());
+  EXPECT_TRUE(requests[2]->IsFinal());
+}
+
+UTEST(HttpRequestParser, Invalid) {
+  const std::string kInvalidRequests[] = {
+      "GET / HTTP/1.1\r\nBad Name: value\r\n\r\n",
+      "GET / HTTP/1.1\r\n Folded: value\r\n\r\n",
+      "GET / HTTP/1.1\r\nName: bare\rcr\r\n\r\n",
+      "GET / HTTP/1.1\r\nName: \x01\r\n\r\n",
+      "GET / HTTP/11\r\n\r\n",
+      "GET / HTTP/1.1\r\nContent-Length: 1\r\nContent-Length: 2\r\n\r\n",
+      "GET / HTTP/1.1\r\nContent-Length: -1\r\n\r\n",
+      "POST / HTTP/1.1\r\nContent-Length: 1\r\n"
+      "Transfer-Encoding: chunked\r\n\r\n",
+      "POST / HTTP/1.1\r\nTransfer-Encoding: gzip\r\n\r\n",
+      "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\nxyz\r\n",
+      "GET / HTTP/1.1\r\nUpgrade: websocket\r\nConnection: upgrade\r\n\r\n",
+  };
+
+  for (const auto& data : kInvalidRequests) {
+    for (const auto step : kSteps) {
+      Requests requests;
+      EXPECT_FALSE(ParseBySteps(data, step, requests)) << data;
+      // the request is passed on anyway, to respond with an error
+      EXPECT_EQ(requests.size(), 1) << data;
+    }
+  }
+}
+
+UTEST(HttpRequestParser, UriTooLong) {
+  const auto data = "GET /" + std::string(10000, 'a') + " HTTP/1.1\r\n\r\n";
+
+  for (const auto step : kSteps) {
+    Requests requests;
+    EXPECT_FALSE(ParseBySteps(data, step, requests));
+    ASSERT_EQ(requests.size(), 1);
+    EXPECT_EQ(requests[0]->GetHttpResponse().GetStatus(),
+              server::http::HttpStatus::kUriTooLong);
+  }
+}
+
+UTEST(HttpRequestParser, Arena) {
+  const server::http::HandlerInfoIndex handler_info_index;
+  server::request::HttpRequestConfig config;
+  config.arena_initial_size = 1024;
+  server::net::ParserStats stats;
+  server::request::ResponseDataAccounter accounter;
+  Requests requests;
+  server::http::HttpRequestParser parser(
+      handler_info_index, config,
+      [&requests](std::shared_ptr<server::request::RequestBase>&& request) {
+        requests.push_back(
+            std::dynamic_pointer_cast<server::http::HttpRequestImpl>(request));
+      },
+      stats, accounter);
+
+  const std::string data = "GET /path?a=1&b=2&a=3 HTTP/1.1\r\n\r\n";
+  EXPECT_TRUE(parser.Parse(data.data(), data.size()));
+  ASSERT_EQ(requests.size(), 1);
+  auto& request = *requests[0];
+  EXPECT_TRUE(request.HasArena());
+  EXPECT_EQ(request.GetArgVector("a"), (std::vector<std::string>{"1", "3"}));
+  EXPECT_EQ(request.GetArg("b"), "2");
+  EXPECT_EQ(request.ArgCount(), 2);
+
+  server::request::RequestContext context{request.GetMemoryResource()};
+  std::pmr::vector<int> values{context.GetAllocator<int>()};
+  values.assign(100, 42);
+  EXPECT_EQ(values.get_allocator().resource(), &request.GetMemoryResource());
+  EXPECT_NE(values.get_allocator().resource(),
+            std::pmr::get_default_resource());
+}
+
+TEST(HttpRequestScanner, FindControlChar) {
+  std::string data(100, 'a');
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    for (const char c : {'\t', '\n', '\r', '\0', '\x1f', '\x7f'}) {
+      data[i] = c;
+      const auto* begin = data.data();
+      const auto* end = begin + data.size();
+      EXPECT_EQ(server::http::impl::FindControlChar(begin, end), begin + i);
+      // not a control char, a part of UTF-8 for example
+      data[i] = '\x80';
+      EXPECT_EQ(server::http::impl::FindControlChar(begin, end), end);
+      data[i] = 'a';
+    }
+  }
+}
+
+USERVER_NAMESPACE_END
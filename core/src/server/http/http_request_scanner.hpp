@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#elif defined(__SSE4_2__)
+#include <nmmintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::http::impl {
+
+// 'char c' is a control char iff (c <= 0x1f || c == 0x7f). The line endings
+// and the TABs are control chars too, so a single scan finds both the end of
+// a line and the chars that are not allowed in it.
+inline bool IsControlChar(char c) noexcept {
+  const auto byte = static_cast<unsigned char>(c);
+  return byte <= 0x1f || byte == 0x7f;
+}
+
+namespace detail {
+
+inline const char* FindControlCharScalar(const char* begin,
+                                         const char* end) noexcept {
+  for (; begin != end; ++begin) {
+    if (IsControlChar(*begin)) break;
+  }
+  return begin;
+}
+
+#ifdef __AVX2__
+inline const char* FindControlCharSimd(const char* begin,
+                                       const char* end) noexcept {
+  const auto kMaxControl = _mm256_set1_epi8(0x1f);
+  const auto kDel = _mm256_set1_epi8(0x7f);
+  for (; end - begin >= 32; begin += 32) {
+    const auto block =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+    // unsigned (c <= 0x1f) is (min(c, 0x1f) == c)
+    const auto is_control = _mm256_or_si256(
+        _mm256_cmpeq_epi8(_mm256_min_epu8(block, kMaxControl), block),
+        _mm256_cmpeq_epi8(block, kDel));
+    const auto mask =
+        static_cast<std::uint32_t>(_mm256_movemask_epi8(is_control));
+    if (mask != 0) return begin + __builtin_ctz(mask);
+  }
+  return begin;
+}
+#elif defined(__SSE4_2__)
+inline const char* FindControlCharSimd(const char* begin,
+                                       const char* end) noexcept {
+  // pairs of the inclusive ranges for _SIDD_CMP_RANGES
+  alignas(16) static constexpr char kRanges[16] = "\x00\x1f\x7f\x7f";
+  const auto ranges = _mm_load_si128(reinterpret_cast<const __m128i*>(kRanges));
+  for (; end - begin >= 16; begin += 16) {
+    const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+    const int pos = _mm_cmpestri(ranges, 4, block, 16,
+                                 _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES |
+                                     _SIDD_LEAST_SIGNIFICANT);
+    if (pos != 16) return begin + pos;
+  }
+  return begin;
+}
+#elif defined(__SSE2__)
+inline const char* FindControlCharSimd(const char* begin,
+                                       const char* end) noexcept {
+  const auto kMaxControl = _mm_set1_epi8(0x1f);
+  const auto kDel = _mm_set1_epi8(0x7f);
+  for (; end - begin >= 16; begin += 16) {
+    const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+    // unsigned (c <= 0x1f) is (min(c, 0x1f) == c)
+    const auto is_control =
+        _mm_or_si128(_mm_cmpeq_epi8(_mm_min_epu8(block, kMaxControl), block),
+                     _mm_cmpeq_epi8(block, kDel));
+    const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(is_control));
+    if (mask != 0) return begin + __builtin_ctz(mask);
+  }
+  return begin;
+}
+#else
+inline const char* FindControlCharSimd(const char* begin,
+                                       const char*) noexcept {
+  return begin;
+}
+#endif
+
+}  // namespace detail
+
+// Returns the first control char in [begin, end), or end if there is none.
+//
+// The full blocks are scanned with AVX2, SSE4.2 or SSE2 depending on the
+// target, the tail and the other targets use the scalar loop. The loads never
+// go past the end.
+inline const char* FindControlChar(const char* begin,
+                                   const char* end) noexcept {
+  // the SIMD part stops either at the control char or at the tail
+  return detail::FindControlCharScalar(
+      detail::FindControlCharSimd(begin, end), end);
+}
+
+}  // namespace server::http::impl
+
+USERVER_NAMESPACE_END
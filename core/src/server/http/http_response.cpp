@@ -1,12 +1,22 @@
 #include <userver/server/http/http_response.hpp>
 
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+
+#include <algorithm>
 #include <array>
+#include <cerrno>
+#include <deque>
 
 #include <cctz/time_zone.h>
 #include <fmt/compile.h>
 
+#include <userver/engine/async.hpp>
 #include <userver/engine/deadline.hpp>
+#include <userver/engine/io/exception.hpp>
 #include <userver/engine/io/socket.hpp>
+#include <userver/fs/blocking/mapped_file.hpp>
 #include <userver/hostinfo/blocking/get_hostname.hpp>
 #include <userver/http/common_headers.hpp>
 #include <userver/http/content_type.hpp>
@@ -17,6 +27,7 @@
 #include <userver/utils/datetime/wall_coarse_clock.hpp>
 
 #include <server/http/http_cached_date.hpp>
+#include <server/net/response_writer.hpp>
 
 #include "http_request_impl.hpp"
 
@@ -27,11 +38,39 @@ namespace {
 constexpr std::string_view kCrlf = "\r\n";
 constexpr std::string_view kKeyValueHeaderSeparator = ": ";
 
-const auto kDefaultContentTypeString =
-    http::ContentType{"text/html; charset=utf-8"}.ToString();
-
-constexpr std::string_view kClose = "close";
-constexpr std::string_view kKeepAlive = "keep-alive";
+const auto kDefaultContentTypeHeader = fmt::format(
+    "{}: {}\r\n", std::string_view{http::headers::kContentType},
+    http::ContentType{"text/html; charset=utf-8"}.ToString());
+const auto kConnectionCloseHeader = fmt::format(
+    "{}: close\r\n", std::string_view{http::headers::kConnection});
+const auto kConnectionKeepAliveHeader = fmt::format(
+    "{}: keep-alive\r\n", std::string_view{http::headers::kConnection});
+
+// Closes the last chunk and the body
+constexpr std::string_view kTerminatingChunk = "\r\n0\r\n\r\n";
+
+// Limits the chunks of a streamed body sent with a single writev
+constexpr std::size_t kMaxChunksPerWrite = 64;
+
+#ifndef __linux__
+// The file bodies are copied by this size where sendfile is not available
+constexpr std::size_t kFileChunkSize = 64 * 1024;
+#endif
+
+constexpr int kMinCachedStatus = 100;
+constexpr int kMaxCachedStatus = 600;
+
+// "HTTP/1.1 200 OK\r\n" and so on for the most common protocol version
+const auto kHttp11StatusLines = [] {
+  std::array<std::string, kMaxCachedStatus - kMinCachedStatus> lines;
+  for (int status = kMinCachedStatus; status < kMaxCachedStatus; ++status) {
+    lines[status - kMinCachedStatus] = fmt::format(
+        "HTTP/1.1 {} {}\r\n", status,
+        server::http::HttpStatusString(
+            static_cast<server::http::HttpStatus>(status)));
+  }
+  return lines;
+}();
 
 const std::string kHostname = hostinfo::blocking::GetRealHostName();
 
@@ -74,6 +113,90 @@ bool IsBodyForbiddenForStatus(server::http::HttpStatus status) {
 
 const std::string kEmptyString{};
 
+void AppendStatusLine(std::string& header, int http_major, int http_minor,
+                      server::http::HttpStatus status) {
+  const auto code = static_cast<int>(status);
+  if (http_major == 1 && http_minor == 1 && code >= kMinCachedStatus &&
+      code < kMaxCachedStatus) {
+    header.append(kHttp11StatusLines[code - kMinCachedStatus]);
+    return;
+  }
+
+  header.append("HTTP/");
+  fmt::format_to(std::back_inserter(header), FMT_COMPILE("{}.{} {} "),
+                 http_major, http_minor, code);
+  header.append(server::http::HttpStatusString(status));
+  header.append(kCrlf);
+}
+
+void AppendChunk(server::net::ResponseWriter& writer,
+                 std::deque<std::string>& chunks, std::string&& chunk) {
+  if (chunk.empty()) {
+    LOG_DEBUG() << "Zero size body_part in http_response.cpp";
+    return;
+  }
+
+  // The CRLF that ends the previous chunk or the headers goes first
+  fmt::format_to(std::back_inserter(writer.Buffer()),
+                 FMT_COMPILE("\r\n{:x}\r\n"), chunk.size());
+  writer.WriteRef(chunks.emplace_back(std::move(chunk)));
+}
+
+// Returns the number of sent bytes
+std::size_t SendFileRange(engine::io::Socket& socket,
+                          const fs::blocking::MappedFile& file,
+                          std::size_t offset, std::size_t size) {
+  // The file is read with a descriptor, as the access to the mapping of a
+  // truncated file raises SIGBUS. The mapping of a replaced file stays intact.
+  auto fd = file.Reopen();
+  if (!fd) {
+    const auto data = file.GetData().substr(offset, size);
+    return socket.SendAll(data.data(), data.size(), engine::Deadline{});
+  }
+
+#ifdef __linux__
+  auto file_offset = static_cast<off_t>(offset);
+  std::size_t sent_bytes = 0;
+  while (sent_bytes < size) {
+    const auto result = ::sendfile(socket.Fd(), fd->GetNative(), &file_offset,
+                                   size - sent_bytes);
+    if (result > 0) {
+      sent_bytes += result;
+      continue;
+    }
+    if (result == 0) {
+      throw engine::io::IoException(
+          "the file was truncated while being sent");
+    }
+
+    const auto err_value = errno;
+    if (err_value == EINTR) continue;
+    if (err_value == EAGAIN || err_value == EWOULDBLOCK) {
+      if (!socket.WaitWriteable(engine::Deadline{})) {
+        throw engine::io::IoCancelled(sent_bytes);
+      }
+      continue;
+    }
+    throw engine::io::IoSystemError(err_value, "sendfile");
+  }
+  return sent_bytes;
+#else
+  std::array<char, kFileChunkSize> buffer{};
+  std::size_t sent_bytes = 0;
+  fd->Seek(offset);
+  while (sent_bytes < size) {
+    const auto read_bytes =
+        fd->Read(buffer.data(), std::min(buffer.size(), size - sent_bytes));
+    if (read_bytes == 0) {
+      throw engine::io::IoException(
+          "the file was truncated while being sent");
+    }
+    sent_bytes += socket.SendAll(buffer.data(), read_bytes, engine::Deadline{});
+  }
+  return sent_bytes;
+#endif
+}
+
 }  // namespace
 
 namespace server::http {
@@ -233,22 +356,43 @@ void HttpResponse::SetHeadersEnd() { headers_end_.Send(); }
 bool HttpResponse::WaitForHeadersEnd() { return headers_end_.WaitForEvent(); }
 
 void HttpResponse::SendResponse(engine::io::Socket& socket) {
+  net::ResponseWriter writer;
+  std::size_t sent_bytes{};
+
+  if (IsBodyStreamed() && GetData().empty()) {
+    SerializeHeaders(writer.Buffer());
+    sent_bytes = SendBodyStreamed(socket, writer);
+  } else if (HasFileBody()) {
+    SerializeHeaders(writer.Buffer());
+    sent_bytes = SendFileBody(socket, writer);
+  } else {
+    // e.g. a CustomHandlerException
+    SerializeResponse(writer);
+    sent_bytes = writer.Flush(socket, engine::Deadline{});
+  }
+
+  SetSent(sent_bytes, std::chrono::steady_clock::now());
+}
+
+bool HttpResponse::SerializeResponse(net::ResponseWriter& writer) {
+  if (IsBodyStreamed() && GetData().empty()) return false;
+  // sendfile goes after the headers are flushed
+  if (HasFileBody()) return false;
+
+  SerializeHeaders(writer.Buffer());
+  SerializeBodyNotStreamed(writer);
+  return true;
+}
+
+void HttpResponse::SerializeHeaders(std::string& header) {
   // According to https://www.chromium.org/spdy/spdy-whitepaper/
   // "typical header sizes of 700-800 bytes is common"
   // Adjusting it to 1KiB to fit jemalloc size class
   static constexpr auto kTypicalHeadersSize = 1024;
+  if (header.empty()) header.reserve(kTypicalHeadersSize);
 
-  // TODO : this could very well be small_vector<char> instead, or we could
-  // pass a string from connection and reuse it.
-  std::string header;
-  header.reserve(kTypicalHeadersSize);
-
-  header.append("HTTP/");
-  fmt::format_to(std::back_inserter(header), FMT_COMPILE("{}.{} {} "),
-                 request_.GetHttpMajor(), request_.GetHttpMinor(),
-                 static_cast<int>(status_));
-  header.append(HttpStatusString(status_));
-  header.append(kCrlf);
+  AppendStatusLine(header, request_.GetHttpMajor(), request_.GetHttpMinor(),
+                   status_);
 
   headers_.erase(USERVER_NAMESPACE::http::headers::kContentLength);
   const auto end = headers_.end();
@@ -258,13 +402,12 @@ void HttpResponse::SendResponse(engine::io::Socket& socket) {
                        impl::GetCachedDate());
   }
   if (headers_.find(USERVER_NAMESPACE::http::headers::kContentType) == end) {
-    impl::OutputHeader(header, USERVER_NAMESPACE::http::headers::kContentType,
-                       kDefaultContentTypeString);
+    header.append(kDefaultContentTypeHeader);
   }
   headers_.OutputInHttpFormat(header);
   if (headers_.find(USERVER_NAMESPACE::http::headers::kConnection) == end) {
-    impl::OutputHeader(header, USERVER_NAMESPACE::http::headers::kConnection,
-                       (request_.IsFinal() ? kClose : kKeepAlive));
+    header.append(request_.IsFinal() ? kConnectionCloseHeader
+                                     : kConnectionKeepAliveHeader);
   }
   for (const auto& cookie : cookies_) {
     header.append(USERVER_NAMESPACE::http::headers::kSetCookie);
@@ -272,24 +415,13 @@ void HttpResponse::SendResponse(engine::io::Socket& socket) {
     cookie.second.AppendToString(header);
     header.append(kCrlf);
   }
-
-  std::size_t sent_bytes{};
-
-  if (IsBodyStreamed() && GetData().empty()) {
-    sent_bytes = SetBodyStreamed(socket, header);
-  } else {
-    // e.g. a CustomHandlerException
-    sent_bytes = SetBodyNotStreamed(socket, header);
-  }
-
-  SetSent(sent_bytes, std::chrono::steady_clock::now());
 }
 
-std::size_t HttpResponse::SetBodyNotStreamed(engine::io::Socket& socket,
-                                             std::string& header) {
+void HttpResponse::SerializeBodyNotStreamed(net::ResponseWriter& writer) {
   const bool is_body_forbidden = IsBodyForbiddenForStatus(status_);
   const bool is_head_request = request_.GetOrigMethod() == HttpMethod::kHead;
   const auto& data = GetData();
+  auto& header = writer.Buffer();
 
   if (!is_body_forbidden) {
     impl::OutputHeader(header, USERVER_NAMESPACE::http::headers::kContentLength,
@@ -304,45 +436,46 @@ std::size_t HttpResponse::SetBodyNotStreamed(engine::io::Socket& socket,
         << " which does not allow one, it will be dropped";
   }
 
-  ssize_t sent_bytes = 0;
   if (!is_head_request && !is_body_forbidden) {
-    sent_bytes = socket.SendAll(
-        {{header.data(), header.size()}, {data.data(), data.size()}},
-        engine::Deadline{});
-  } else {
-    sent_bytes =
-        socket.SendAll(header.data(), header.size(), engine::Deadline{});
+    // The body is not copied, it is alive until the response is sent
+    writer.WriteRef(data);
   }
-
-  return sent_bytes;
 }
 
-std::size_t HttpResponse::SetBodyStreamed(engine::io::Socket& socket,
-                                          std::string& header) {
-  impl::OutputHeader(
-      header, USERVER_NAMESPACE::http::headers::kTransferEncoding, "chunked");
+std::size_t HttpResponse::SendBodyStreamed(engine::io::Socket& socket,
+                                           net::ResponseWriter& writer) {
+  // The chunks are referenced by the writer until it is flushed, deque keeps
+  // them in place
+  std::deque<std::string> chunks;
+  const auto append_ready_chunks = [this, &writer, &chunks] {
+    std::string chunk;
+    while (chunks.size() < kMaxChunksPerWrite &&
+           body_stream_->PopNoblock(chunk)) {
+      AppendChunk(writer, chunks, std::move(chunk));
+    }
+  };
 
-  // send HTTP headers
-  size_t sent_bytes = socket.SendAll(header.data(), header.size(), {});
-  std::string{}.swap(header);  // free memory before time-consuming operation
+  // The headers go together with the chunks that are already produced
+  impl::OutputHeader(writer.Buffer(),
+                     USERVER_NAMESPACE::http::headers::kTransferEncoding,
+                     "chunked");
+  append_ready_chunks();
+  std::size_t sent_bytes = writer.Flush(socket, engine::Deadline{});
+  chunks.clear();
 
   // Transmit HTTP response body
   std::string body_part;
   while (body_stream_->Pop(body_part)) {
-    if (body_part.empty()) {
-      LOG_DEBUG() << "Zero size body_part in http_response.cpp";
-      continue;
-    }
+    AppendChunk(writer, chunks, std::move(body_part));
+    append_ready_chunks();
+    if (writer.IsEmpty()) continue;
 
-    auto size = fmt::format("\r\n{:x}\r\n", body_part.size());
-    sent_bytes += socket.SendAll(
-        {{size.data(), size.size()}, {body_part.data(), body_part.size()}},
-        engine::Deadline{});
+    sent_bytes += writer.Flush(socket, engine::Deadline{});
+    chunks.clear();
   }
 
-  const constexpr std::string_view terminating_chunk{"\r\n0\r\n\r\n"};
-  sent_bytes +=
-      socket.SendAll(terminating_chunk.data(), terminating_chunk.size(), {});
+  writer.Buffer().append(kTerminatingChunk);
+  sent_bytes += writer.Flush(socket, engine::Deadline{});
 
   // TODO: exceptions?
   body_stream_producer_.reset();
@@ -351,6 +484,29 @@ std::size_t HttpResponse::SetBodyStreamed(engine::io::Socket& socket,
   return sent_bytes;
 }
 
+std::size_t HttpResponse::SendFileBody(engine::io::Socket& socket,
+                                       net::ResponseWriter& writer) {
+  const bool is_body_forbidden = IsBodyForbiddenForStatus(status_);
+  const bool is_head_request = request_.GetOrigMethod() == HttpMethod::kHead;
+  auto& header = writer.Buffer();
+
+  if (!is_body_forbidden) {
+    impl::OutputHeader(header, USERVER_NAMESPACE::http::headers::kContentLength,
+                       fmt::format(FMT_COMPILE("{}"), file_body_->size));
+  }
+  header.append(kCrlf);
+  std::size_t sent_bytes = writer.Flush(socket, engine::Deadline{});
+
+  if (!is_head_request && !is_body_forbidden) {
+    // Opening and reading the file may block on the disk
+    sent_bytes += engine::AsyncNoSpan(*file_body_->fs_task_processor, [&] {
+                    return SendFileRange(socket, *file_body_->file,
+                                         file_body_->offset, file_body_->size);
+                  }).Get();
+  }
+  return sent_bytes;
+}
+
 void SetThrottleReason(http::HttpResponse& http_response,
                        std::string log_reason, std::string http_header_reason) {
   http_response.SetHeader(
@@ -383,6 +539,32 @@ HttpResponse::Queue::Producer HttpResponse::GetBodyProducer() {
   return producer;
 }
 
+void HttpResponse::SetFileBody(
+    std::shared_ptr<const fs::blocking::MappedFile> file, std::size_t offset,
+    std::size_t size, engine::TaskProcessor& fs_task_processor) {
+  UASSERT(file);
+  UASSERT(offset + size <= file->GetData().size());
+  file_body_.emplace(
+      FileBody{std::move(file), offset, size, &fs_task_processor});
+}
+
+bool HttpResponse::HasFileBody() const {
+  return file_body_.has_value() && GetData().empty();
+}
+
+const HttpResponse::FileBody* HttpResponse::GetFileBody() const {
+  return HasFileBody() ? &*file_body_ : nullptr;
+}
+
+bool HttpResponse::PopBodyChunk(std::string& chunk) {
+  UASSERT(IsBodyStreamed());
+  if (body_stream_->Pop(chunk)) return true;
+
+  body_stream_producer_.reset();
+  body_stream_.reset();
+  return false;
+}
+
 }  // namespace server::http
 
 USERVER_NAMESPACE_END
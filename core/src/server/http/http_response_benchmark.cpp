@@ -1,9 +1,19 @@
 #include <benchmark/benchmark.h>
 
+#include <sys/socket.h>
+
 #include <fmt/compile.h>
+#include <fstream>
+#include <memory>
+#include <optional>
 #include <sstream>
+#include <vector>
 
+#include <server/http/http_request_impl.hpp>
+#include <server/net/response_writer.hpp>
+#include <userver/engine/run_standalone.hpp>
 #include <userver/http/common_headers.hpp>
+#include <userver/internal/net/net_listener.hpp>
 #include <userver/server/http/http_response.hpp>
 #include <userver/server/http/http_status.hpp>
 
@@ -67,9 +77,75 @@ void http_headers_serialization_ostreams(benchmark::State& state) {
   }
 }
 
+// Returns the write syscalls made by the process so far, or nullopt if the
+// kernel does not account the task IO
+std::optional<std::uint64_t> GetWriteSyscalls() {
+  std::ifstream io{"/proc/self/io"};
+  std::string name;
+  std::uint64_t value{};
+  while (io >> name >> value) {
+    if (name == "syscw:") return value;
+  }
+  return std::nullopt;
+}
+
+// Sends state.range(0) pipelined responses either each with a writev of its
+// own or all together with a single one (state.range(1) != 0)
+void http_response_send(benchmark::State& state) {
+  engine::RunStandalone([&] {
+    const auto deadline =
+        engine::Deadline::FromDuration(std::chrono::seconds{10});
+    auto [server, client] =
+        internal::net::TcpListener{}.MakeSocketPair(deadline);
+    // All the responses of an iteration fit into the socket buffers, so the
+    // data is sent and received without waiting in a single task
+    constexpr int kSocketBufferSize = 1024 * 1024;
+    server.SetOption(SOL_SOCKET, SO_SNDBUF, kSocketBufferSize);
+    client.SetOption(SOL_SOCKET, SO_RCVBUF, kSocketBufferSize);
+
+    server::request::ResponseDataAccounter accounter;
+    std::vector<std::unique_ptr<server::http::HttpRequestImpl>> requests;
+    for (std::int64_t i = 0; i < state.range(0); ++i) {
+      auto& request = *requests.emplace_back(
+          std::make_unique<server::http::HttpRequestImpl>(accounter));
+      auto& response = request.GetHttpResponse();
+      for (const auto& [name, value] : kHeaders) {
+        response.SetHeader(name, value);
+      }
+      response.SetData(std::string(1024, 'x'));
+    }
+    const bool is_batched = state.range(1) != 0;
+
+    server::net::ResponseWriter writer;
+    std::vector<char> buffer(1024 * 1024);
+    const auto syscalls_before = GetWriteSyscalls();
+    for (auto _ : state) {
+      std::size_t sent_bytes = 0;
+      for (const auto& request : requests) {
+        request->GetHttpResponse().SerializeResponse(writer);
+        if (!is_batched) sent_bytes += writer.Flush(server, deadline);
+      }
+      if (is_batched) sent_bytes += writer.Flush(server, deadline);
+
+      const auto received = client.RecvAll(buffer.data(), sent_bytes, deadline);
+      benchmark::DoNotOptimize(received);
+    }
+    const auto syscalls_after = GetWriteSyscalls();
+
+    if (syscalls_before && syscalls_after) {
+      state.counters["write_syscalls_per_response"] = benchmark::Counter(
+          static_cast<double>(*syscalls_after - *syscalls_before) /
+          static_cast<double>(state.iterations() * state.range(0)));
+    }
+  });
+}
+
 }  // namespace
 
 BENCHMARK(http_headers_serialization_no_ostreams);
 BENCHMARK(http_headers_serialization_ostreams);
+BENCHMARK(http_response_send)
+    ->ArgsProduct({{1, 8, 32}, {0, 1}})
+    ->ArgNames({"pipelined", "batched"});
 
 USERVER_NAMESPACE_END
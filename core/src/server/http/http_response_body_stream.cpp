@@ -1,5 +1,9 @@
 #include <userver/server/http/http_response_body_stream.hpp>
 
+#include <server/handlers/response_compression.hpp>
+
+#include <userver/http/common_headers.hpp>
+#include <userver/logging/log.hpp>
 #include <userver/utils/assert.hpp>
 
 USERVER_NAMESPACE_BEGIN
@@ -12,10 +16,33 @@ ResponseBodyStream::ResponseBodyStream(
     : queue_producer_(std::move(queue_producer)),
       http_response_(http_response) {}
 
+ResponseBodyStream::ResponseBodyStream(ResponseBodyStream&&) noexcept =
+    default;
+
+ResponseBodyStream::~ResponseBodyStream() {
+  if (!compressor_ || !headers_ended_) return;
+
+  // The end of the compressed stream has to be sent before the producer
+  // closes the queue
+  try {
+    auto chunk = compressor_->Finish();
+    if (!chunk.empty()) {
+      [[maybe_unused]] const auto success =
+          queue_producer_.Push(std::move(chunk), engine::Deadline{});
+    }
+  } catch (const std::exception& ex) {
+    LOG_ERROR() << "Failed to finish the compressed response body: " << ex;
+  }
+}
+
 void ResponseBodyStream::PushBodyChunk(std::string&& chunk,
                                        engine::Deadline deadline) {
   UASSERT_MSG(headers_ended_,
               "SetEndOfHeaders() was not called before PushBodyChunk()");
+  if (compressor_) {
+    chunk = compressor_->Compress(chunk);
+    if (chunk.empty()) return;
+  }
   const auto success = queue_producer_.Push(std::move(chunk), deadline);
   UASSERT(success);
 }
@@ -31,6 +58,22 @@ void ResponseBodyStream::SetHeader(std::string_view name,
 }
 
 void ResponseBodyStream::SetEndOfHeaders() {
+  if (compressor_) {
+    const auto status = http_response_.GetStatus();
+    if (status == HttpStatus::kNoContent ||
+        status == HttpStatus::kNotModified ||
+        status == HttpStatus::kPartialContent ||
+        http_response_.HasHeader(
+            USERVER_NAMESPACE::http::headers::kContentEncoding)) {
+      compressor_.reset();
+    } else {
+      handlers::AddVaryAcceptEncoding(http_response_);
+      http_response_.SetHeader(
+          USERVER_NAMESPACE::http::headers::kContentEncoding,
+          std::string{compression::ToString(compressor_->GetEncoding())});
+      handlers::WeakenETag(http_response_);
+    }
+  }
   headers_ended_ = true;
   http_response_.SetHeadersEnd();
 }
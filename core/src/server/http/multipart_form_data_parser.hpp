@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory_resource>
 #include <string>
 #include <string_view>
 #include <unordered_map>
@@ -12,8 +13,9 @@ USERVER_NAMESPACE_BEGIN
 
 namespace server::http {
 
-using FormDataArgs = std::unordered_map<std::string, std::vector<FormDataArg>,
-                                        utils::StrCaseHash>;
+using FormDataArgs =
+    std::pmr::unordered_map<std::string, std::vector<FormDataArg>,
+                            utils::StrCaseHash>;
 
 bool IsMultipartFormDataContentType(std::string_view content_type);
 bool ParseMultipartFormData(const std::string& content_type,
@@ -0,0 +1,154 @@
+#include <server/http/radix_path_tree.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::http::impl {
+
+namespace {
+
+constexpr std::string_view kAnySuffixMark = "*";
+
+constexpr char kWildcardStart = '{';
+constexpr char kWildcardFinish = '}';
+
+bool IsWildcard(std::string_view segment) {
+  if (segment.find(kWildcardStart) == std::string_view::npos &&
+      segment.find(kWildcardFinish) == std::string_view::npos) {
+    return false;
+  }
+  if (segment.size() < 2 || segment.front() != kWildcardStart ||
+      segment.back() != kWildcardFinish) {
+    throw std::runtime_error(fmt::format("Incorrect wildcard '{}'", segment));
+  }
+  return true;
+}
+
+}  // namespace
+
+struct RadixPathTree::BuildNode {
+  std::map<std::string, std::unique_ptr<BuildNode>, std::less<>> fixed;
+  std::unique_ptr<BuildNode> wildcard;
+  TerminalId terminal{kNone};
+  TerminalId any_suffix_terminal{kNone};
+
+  // Can be merged into the edge of its parent
+  bool IsPassThrough() const {
+    return fixed.size() == 1 && !wildcard && terminal == kNone &&
+           any_suffix_terminal == kNone;
+  }
+};
+
+RadixPathTree::RadixPathTree() : root_(std::make_unique<BuildNode>()) {}
+
+RadixPathTree::RadixPathTree(RadixPathTree&&) noexcept = default;
+
+RadixPathTree& RadixPathTree::operator=(RadixPathTree&&) noexcept = default;
+
+RadixPathTree::~RadixPathTree() = default;
+
+RadixPathTree::TerminalId RadixPathTree::Insert(std::string_view pattern) {
+  BuildNode* node = root_.get();
+  while (true) {
+    const auto slash = pattern.find('/');
+    const auto segment = pattern.substr(0, slash);
+    const bool is_last = slash == std::string_view::npos;
+
+    if (is_last && segment == kAnySuffixMark) {
+      if (node->any_suffix_terminal == kNone) {
+        node->any_suffix_terminal = terminals_count_++;
+      }
+      is_dirty_ = true;
+      return node->any_suffix_terminal;
+    }
+
+    auto& next = IsWildcard(segment) ? node->wildcard
+                                     : node->fixed[std::string{segment}];
+    if (!next) next = std::make_unique<BuildNode>();
+    node = next.get();
+
+    if (is_last) break;
+    pattern.remove_prefix(slash + 1);
+  }
+
+  if (node->terminal == kNone) node->terminal = terminals_count_++;
+  is_dirty_ = true;
+  return node->terminal;
+}
+
+void RadixPathTree::Build() {
+  nodes_.clear();
+  edges_.clear();
+  labels_.clear();
+  BuildNodes(*root_);
+
+  if (labels_.size() > std::numeric_limits<std::uint32_t>::max()) {
+    throw std::runtime_error("Too long handler paths");
+  }
+  is_dirty_ = false;
+}
+
+std::uint32_t RadixPathTree::BuildNodes(const BuildNode& node) {
+  const auto index = static_cast<std::uint32_t>(nodes_.size());
+  nodes_.emplace_back();
+  nodes_[index].terminal = node.terminal;
+  nodes_[index].any_suffix_terminal = node.any_suffix_terminal;
+
+  // The edges of a node are contiguous and sorted by the first segment
+  const auto edges_begin = static_cast<std::uint32_t>(edges_.size());
+  edges_.resize(edges_.size() + node.fixed.size());
+  nodes_[index].edges_begin = edges_begin;
+  nodes_[index].edges_end = static_cast<std::uint32_t>(edges_.size());
+
+  auto edge_index = edges_begin;
+  for (const auto& [segment, child] : node.fixed) {
+    Edge edge{};
+    edge.label_offset = static_cast<std::uint32_t>(labels_.size());
+    edge.first_segment_size = static_cast<std::uint32_t>(segment.size());
+    labels_ += segment;
+
+    const BuildNode* target = child.get();
+    while (target->IsPassThrough()) {
+      const auto& [next_segment, next] = *target->fixed.begin();
+      labels_ += '/';
+      labels_ += next_segment;
+      target = next.get();
+    }
+    edge.label_size =
+        static_cast<std::uint32_t>(labels_.size()) - edge.label_offset;
+
+    edge.child = BuildNodes(*target);
+    edges_[edge_index++] = edge;
+  }
+
+  if (node.wildcard) {
+    const auto wildcard_child = BuildNodes(*node.wildcard);
+    nodes_[index].wildcard_child = wildcard_child;
+  }
+  return index;
+}
+
+const RadixPathTree::Edge* RadixPathTree::FindEdge(
+    const Node& node, std::string_view segment) const {
+  const auto* begin = edges_.data() + node.edges_begin;
+  const auto* end = edges_.data() + node.edges_end;
+  const auto first_segment = [this](const Edge& edge) {
+    return GetLabel(edge).substr(0, edge.first_segment_size);
+  };
+  const auto* it = std::lower_bound(
+      begin, end, segment, [&first_segment](const Edge& edge, auto value) {
+        return first_segment(edge) < value;
+      });
+  if (it == end || first_segment(*it) != segment) return nullptr;
+  return it;
+}
+
+}  // namespace server::http::impl
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <boost/container/small_vector.hpp>
+
+#include <userver/utils/assert.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::http::impl {
+
+// The arguments extracted from the request path by the matched handler: the
+// names are owned by the handler index and the values point into the path
+using PathArg = std::pair<std::string_view, std::string_view>;
+using PathArgs = boost::container::small_vector<PathArg, 8>;
+
+// Matches the request paths against the handler path patterns. A pattern
+// consists of '/'-separated segments: fixed ones, wildcards "{name}" that
+// match any single segment, and the last segment may be '*' that matches
+// any non-empty tail of segments.
+//
+// The tree is compacted by Build() into flat arrays with the chains of
+// fixed segments merged into single edges, matching a path does not
+// allocate. The fixed segments are preferred to the wildcards and the
+// wildcards are preferred to '*', the next candidate is tried if the
+// previous one is rejected.
+class RadixPathTree final {
+ public:
+  using TerminalId = std::uint32_t;
+
+  RadixPathTree();
+  RadixPathTree(RadixPathTree&&) noexcept;
+  RadixPathTree& operator=(RadixPathTree&&) noexcept;
+  ~RadixPathTree();
+
+  // Returns the ID of the pattern, the patterns that differ only in the
+  // wildcard names share it. The IDs are sequential starting from 0.
+  // @throws std::runtime_error on malformed wildcards
+  TerminalId Insert(std::string_view pattern);
+
+  // Must be called after the last Insert() and before Match()
+  void Build();
+
+  // Calls `accept(terminal_id, matched_path_length)` for the matching
+  // patterns in the order of preference until it returns true. The values of
+  // the wildcards, followed by the segments matched by '*', are appended to
+  // `args` with empty names. Returns false if no pattern is accepted, `args`
+  // is left unchanged then.
+  template <typename Accept>
+  bool Match(std::string_view path, PathArgs& args, Accept&& accept) const {
+    UASSERT_MSG(!is_dirty_, "Build() must be called after Insert()");
+    if (nodes_.empty()) return false;
+    return MatchNode(0, path, 0, args, accept);
+  }
+
+ private:
+  static constexpr std::uint32_t kNone = -1;
+
+  struct BuildNode;
+
+  struct Edge {
+    std::uint32_t label_offset;
+    std::uint32_t label_size;
+    std::uint32_t first_segment_size;
+    std::uint32_t child;
+  };
+
+  struct Node {
+    std::uint32_t edges_begin{0};
+    std::uint32_t edges_end{0};
+    std::uint32_t wildcard_child{kNone};
+    TerminalId terminal{kNone};
+    TerminalId any_suffix_terminal{kNone};
+  };
+
+  std::uint32_t BuildNodes(const BuildNode& node);
+
+  std::string_view GetLabel(const Edge& edge) const {
+    return std::string_view{labels_}.substr(edge.label_offset,
+                                            edge.label_size);
+  }
+
+  const Edge* FindEdge(const Node& node, std::string_view segment) const;
+
+  template <typename Accept>
+  bool MatchNode(std::uint32_t node_index, std::string_view path,
+                 std::size_t pos, PathArgs& args, Accept& accept) const;
+
+  std::unique_ptr<BuildNode> root_;
+  TerminalId terminals_count_{0};
+  bool is_dirty_{false};
+
+  std::vector<Node> nodes_;
+  std::vector<Edge> edges_;
+  std::string labels_;
+};
+
+// `pos` is the beginning of the current segment or is past the end of the
+// path if all the segments are matched
+template <typename Accept>
+bool RadixPathTree::MatchNode(std::uint32_t node_index, std::string_view path,
+                              std::size_t pos, PathArgs& args,
+                              Accept& accept) const {
+  const auto& node = nodes_[node_index];
+  if (pos > path.size()) {
+    return node.terminal != kNone && accept(node.terminal, path.size());
+  }
+
+  const auto segment_end = std::min(path.find('/', pos), path.size());
+  const auto segment = path.substr(pos, segment_end - pos);
+
+  if (const auto* edge = FindEdge(node, segment)) {
+    const auto label = GetLabel(*edge);
+    const auto label_end = pos + label.size();
+    if (path.compare(pos, label.size(), label) == 0 &&
+        (label_end == path.size() || path[label_end] == '/')) {
+      if (MatchNode(edge->child, path, label_end + 1, args, accept)) {
+        return true;
+      }
+    }
+  }
+
+  if (node.wildcard_child != kNone) {
+    args.emplace_back(std::string_view{}, segment);
+    if (MatchNode(node.wildcard_child, path, segment_end + 1, args, accept)) {
+      return true;
+    }
+    args.pop_back();
+  }
+
+  if (node.any_suffix_terminal != kNone) {
+    const auto args_size = args.size();
+    for (auto tail = path.substr(pos);;) {
+      const auto slash = tail.find('/');
+      args.emplace_back(std::string_view{}, tail.substr(0, slash));
+      if (slash == std::string_view::npos) break;
+      tail.remove_prefix(slash + 1);
+    }
+    if (accept(node.any_suffix_terminal, pos)) return true;
+    args.erase(args.begin() + args_size, args.end());
+  }
+
+  return false;
+}
+
+}  // namespace server::http::impl
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,95 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include <server/http/radix_path_tree.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+constexpr std::string_view kResources[] = {
+    "users",   "orders", "drivers", "cars",     "parks",    "payments",
+    "tariffs", "zones",  "promos",  "invoices", "receipts", "feedback",
+};
+
+constexpr std::string_view kActions[] = {
+    "status", "history", "settings", "documents", "limits", "events",
+};
+
+// A typical API service: fixed paths, paths with IDs and static files
+std::vector<std::string> MakePatterns(std::size_t services_count) {
+  std::vector<std::string> patterns;
+  for (std::size_t service = 0; service < services_count; ++service) {
+    for (const auto resource : kResources) {
+      const auto prefix = fmt::format("/service-{}/v1/{}", service, resource);
+      patterns.push_back(prefix + "/list");
+      patterns.push_back(prefix + "/{id}");
+      for (const auto action : kActions) {
+        patterns.push_back(fmt::format("{}/{{id}}/{}", prefix, action));
+      }
+      patterns.push_back(prefix + "/{id}/items/{item_id}");
+    }
+    patterns.push_back(fmt::format("/service-{}/static/*", service));
+  }
+  return patterns;
+}
+
+std::vector<std::string> MakePaths(std::size_t services_count) {
+  std::vector<std::string> paths;
+  for (std::size_t service = 0; service < services_count; ++service) {
+    for (const auto resource : kResources) {
+      const auto prefix = fmt::format("/service-{}/v1/{}", service, resource);
+      paths.push_back(prefix + "/list");
+      paths.push_back(prefix + "/5f1e0c2a9b3d4e8f");
+      paths.push_back(prefix + "/5f1e0c2a9b3d4e8f/history");
+      paths.push_back(prefix + "/5f1e0c2a9b3d4e8f/items/42");
+      paths.push_back(prefix + "/5f1e0c2a9b3d4e8f/unknown");
+    }
+    paths.push_back(fmt::format("/service-{}/static/js/app.min.js", service));
+  }
+  return paths;
+}
+
+}  // namespace
+
+void radix_path_tree_match(benchmark::State& state) {
+  const auto services_count = static_cast<std::size_t>(state.range(0));
+  const auto patterns = MakePatterns(services_count);
+  server::http::impl::RadixPathTree tree;
+  for (const auto& pattern : patterns) tree.Insert(pattern);
+  tree.Build();
+  const auto paths = MakePaths(services_count);
+
+  std::size_t i = 0;
+  server::http::impl::PathArgs args;
+  for (auto _ : state) {
+    args.clear();
+    const auto matched = tree.Match(
+        paths[i], args, [](auto terminal_id, std::size_t matched_length) {
+          benchmark::DoNotOptimize(terminal_id);
+          benchmark::DoNotOptimize(matched_length);
+          return true;
+        });
+    benchmark::DoNotOptimize(matched);
+    if (++i == paths.size()) i = 0;
+  }
+  state.counters["patterns"] = static_cast<double>(patterns.size());
+}
+BENCHMARK(radix_path_tree_match)->RangeMultiplier(4)->Range(1, 64);
+
+void radix_path_tree_build(benchmark::State& state) {
+  const auto patterns = MakePatterns(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    server::http::impl::RadixPathTree tree;
+    for (const auto& pattern : patterns) tree.Insert(pattern);
+    tree.Build();
+    benchmark::DoNotOptimize(tree);
+  }
+}
+BENCHMARK(radix_path_tree_build)->RangeMultiplier(4)->Range(1, 64);
+
+USERVER_NAMESPACE_END
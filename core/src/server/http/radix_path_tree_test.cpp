@@ -0,0 +1,122 @@
+#include <server/http/radix_path_tree.hpp>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+using server::http::impl::PathArgs;
+using server::http::impl::RadixPathTree;
+
+struct MatchResult {
+  RadixPathTree::TerminalId id;
+  std::size_t matched_path_length;
+  std::vector<std::string> args;
+};
+
+std::optional<MatchResult> Match(const RadixPathTree& tree,
+                                 std::string_view path,
+                                 std::optional<RadixPathTree::TerminalId>
+                                     rejected = std::nullopt) {
+  PathArgs args;
+  std::optional<MatchResult> result;
+  tree.Match(path, args,
+             [&](RadixPathTree::TerminalId id, std::size_t length) {
+               if (id == rejected) return false;
+               result = MatchResult{id, length, {}};
+               return true;
+             });
+  if (!result) {
+    EXPECT_TRUE(args.empty());
+    return result;
+  }
+  for (const auto& [name, value] : args) result->args.emplace_back(value);
+  return result;
+}
+
+}  // namespace
+
+TEST(RadixPathTree, Fixed) {
+  RadixPathTree tree;
+  const auto users = tree.Insert("/api/v1/users");
+  const auto orders = tree.Insert("/api/v1/orders");
+  const auto api = tree.Insert("/api");
+  EXPECT_EQ(tree.Insert("/api/v1/users"), users);
+  tree.Build();
+
+  EXPECT_EQ(Match(tree, "/api/v1/users")->id, users);
+  EXPECT_EQ(Match(tree, "/api/v1/orders")->id, orders);
+  EXPECT_EQ(Match(tree, "/api")->id, api);
+  EXPECT_EQ(Match(tree, "/api/v1/users")->matched_path_length, 13);
+
+  EXPECT_FALSE(Match(tree, "/api/v1"));
+  EXPECT_FALSE(Match(tree, "/api/v1/users/"));
+  EXPECT_FALSE(Match(tree, "/api/v1/user"));
+  EXPECT_FALSE(Match(tree, "/api/v1/usersx"));
+  EXPECT_FALSE(Match(tree, ""));
+}
+
+TEST(RadixPathTree, Wildcards) {
+  RadixPathTree tree;
+  const auto user = tree.Insert("/users/{id}");
+  const auto me = tree.Insert("/users/me");
+  const auto order = tree.Insert("/users/{id}/orders/{}");
+  EXPECT_EQ(tree.Insert("/users/{name}"), user);
+  tree.Build();
+
+  const auto user_match = Match(tree, "/users/42");
+  EXPECT_EQ(user_match->id, user);
+  EXPECT_EQ(user_match->args, (std::vector<std::string>{"42"}));
+  EXPECT_EQ(Match(tree, "/users/")->args, (std::vector<std::string>{""}));
+
+  // the fixed segments are preferred
+  EXPECT_EQ(Match(tree, "/users/me")->id, me);
+  EXPECT_TRUE(Match(tree, "/users/me", me)->args.size() == 1);
+  EXPECT_EQ(Match(tree, "/users/me", me)->id, user);
+
+  const auto order_match = Match(tree, "/users/me/orders/7");
+  EXPECT_EQ(order_match->id, order);
+  EXPECT_EQ(order_match->args, (std::vector<std::string>{"me", "7"}));
+
+  EXPECT_FALSE(Match(tree, "/users/42/orders"));
+  EXPECT_FALSE(Match(tree, "/users/42/items/7"));
+  EXPECT_FALSE(Match(tree, "/users/42/orders/7", order));
+}
+
+TEST(RadixPathTree, AnySuffix) {
+  RadixPathTree tree;
+  const auto any = tree.Insert("/static/*");
+  const auto nested = tree.Insert("/static/{bucket}/*");
+  const auto exact = tree.Insert("/static/{bucket}/index");
+  tree.Build();
+
+  const auto nested_match = Match(tree, "/static/img/a/b.png");
+  EXPECT_EQ(nested_match->id, nested);
+  EXPECT_EQ(nested_match->matched_path_length, 12);
+  EXPECT_EQ(nested_match->args,
+            (std::vector<std::string>{"img", "a", "b.png"}));
+
+  EXPECT_EQ(Match(tree, "/static/img/index")->id, exact);
+  EXPECT_EQ(Match(tree, "/static/img/index", exact)->id, nested);
+
+  const auto any_match = Match(tree, "/static/img/a", nested);
+  EXPECT_EQ(any_match->id, any);
+  EXPECT_EQ(any_match->matched_path_length, 8);
+  EXPECT_EQ(any_match->args, (std::vector<std::string>{"img", "a"}));
+
+  EXPECT_EQ(Match(tree, "/static/")->id, any);
+  EXPECT_FALSE(Match(tree, "/static"));
+}
+
+TEST(RadixPathTree, IncorrectWildcard) {
+  RadixPathTree tree;
+  EXPECT_THROW(tree.Insert("/users/{id"), std::runtime_error);
+  EXPECT_THROW(tree.Insert("/users/x{id}"), std::runtime_error);
+}
+
+USERVER_NAMESPACE_END
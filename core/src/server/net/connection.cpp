@@ -2,10 +2,16 @@
 
 #include <algorithm>
 #include <array>
+#include <mutex>
+#include <optional>
 #include <stdexcept>
+#include <string>
+#include <string_view>
 #include <system_error>
+#include <utility>
 #include <vector>
 
+#include <server/http/http2_session.hpp>
 #include <server/http/http_request_parser.hpp>
 #include <server/http/request_handler_base.hpp>
 
@@ -23,6 +29,33 @@ USERVER_NAMESPACE_BEGIN
 
 namespace server::net {
 
+namespace {
+
+// Limits the pipelined responses sent with a single writev
+constexpr std::size_t kMaxBatchedResponses = 64;
+
+// Returns false if the data is not sent
+template <typename SendFunc>
+bool SendLogged(SendFunc&& send) {
+  try {
+    send();
+    return true;
+  } catch (const engine::io::IoSystemError& ex) {
+    // working with raw values because std::errc compares error_category
+    // default_error_category() fixed only in GCC 9.1 (PR libstdc++/60555)
+    auto log_level =
+        ex.Code().value() == static_cast<int>(std::errc::broken_pipe)
+            ? logging::Level::kWarning
+            : logging::Level::kError;
+    LOG(log_level) << "I/O error while sending data: " << ex;
+  } catch (const std::exception& ex) {
+    LOG_ERROR() << "Error while sending data: " << ex;
+  }
+  return false;
+}
+
+}  // namespace
+
 std::shared_ptr<Connection> Connection::Create(
     engine::TaskProcessor& task_processor, const ConnectionConfig& config,
     const request::HttpRequestConfig& handler_defaults_config,
@@ -62,6 +95,17 @@ void Connection::SetCloseCb(CloseCb close_cb) {
   close_cb_ = std::move(close_cb);
 }
 
+Connection::~Connection() {
+  if (parker_) parker_->RemoveConnection();
+}
+
+void Connection::SetParker(std::shared_ptr<ConnectionParker> parker) {
+  UASSERT(!parker_);
+  // Reserves the parking slot, so that Park() does not allocate
+  parker->AddConnection();
+  parker_ = std::move(parker);
+}
+
 void Connection::Start() {
   LOG_TRACE() << "Starting socket listener for fd " << Fd();
 
@@ -79,7 +123,7 @@ void Connection::Start() {
   // `response_sender_task_` always starts because it is a Critical task
 
   // NOLINTNEXTLINE(cppcoreguidelines-slicing)
-  response_sender_task_ = engine::CriticalAsyncNoSpan(
+  engine::Task response_sender_task = engine::CriticalAsyncNoSpan(
       task_processor_,
       [](std::shared_ptr<Connection> self, auto socket_listener) {
         auto consumer = self->request_tasks_->GetConsumer();
@@ -90,38 +134,90 @@ void Connection::Start() {
 
         socket_listener.SyncCancel();
         self->ProcessResponses(consumer);  // Consume remaining requests
-        self->Shutdown();
+        if (self->is_parking_ && !engine::current_task::ShouldCancel()) {
+          self->Park();
+        } else {
+          self->Shutdown();
+        }
       },
       shared_from_this(), std::move(socket_listener));
+  {
+    const std::lock_guard lock{response_sender_mutex_};
+    // Stop() may have been called while the connection was parked
+    if (is_stopped_) response_sender_task.RequestCancel();
+    response_sender_task_ = std::move(response_sender_task);
+  }
   response_sender_launched_event_.Send();
   response_sender_assigned_event_.Send();
 
   LOG_TRACE() << "Started socket listener for fd " << Fd();
 }
 
-void Connection::Stop() { response_sender_task_.RequestCancel(); }
+void Connection::Stop() {
+  // A parked connection has no tasks, it is closed by the parker
+  const std::lock_guard lock{response_sender_mutex_};
+  is_stopped_ = true;
+  if (response_sender_task_.IsValid()) response_sender_task_.RequestCancel();
+}
+
+void Connection::Resume() {
+  LOG_TRACE() << "Resuming parked connection for fd " << Fd();
+  --stats_->parked_connections;
+  Start();
+}
+
+void Connection::CloseParked() noexcept {
+  LOG_TRACE() << "Closing parked connection for fd " << Fd();
+  --stats_->parked_connections;
+  Close();
+}
 
 int Connection::Fd() const { return peer_socket_.Fd(); }
 
 void Connection::Shutdown() noexcept {
-  UASSERT(response_sender_task_.IsValid());
-
   LOG_TRACE() << "Terminating requests processing (canceling in-flight "
                  "requests) for fd "
               << Fd();
 
+  Close();
+
+  UASSERT(IsRequestTasksEmpty());
+
+  // `~Connection()` may be called from within the `response_sender_task_`.
+  // Without `Detach()` we get a deadlock.
+  const std::lock_guard lock{response_sender_mutex_};
+  UASSERT(response_sender_task_.IsValid());
+  std::move(response_sender_task_).Detach();
+}
+
+void Connection::Close() noexcept {
   peer_socket_.Close();  // should not throw
 
   --stats_->active_connections;
   ++stats_->connections_closed;
 
   if (close_cb_) close_cb_();  // should not throw
+}
 
+void Connection::Park() noexcept {
   UASSERT(IsRequestTasksEmpty());
+  UASSERT(parker_);
 
+  LOG_TRACE() << "Parking idle connection for fd " << Fd();
+  is_parking_ = false;
+
+  // The connection may be resumed with new tasks right after it is parked.
   // `~Connection()` may be called from within the `response_sender_task_`.
-  // Without `Detach()` we get a deadlock.
-  std::move(response_sender_task_).Detach();
+  {
+    const std::lock_guard lock{response_sender_mutex_};
+    UASSERT(response_sender_task_.IsValid());
+    std::move(response_sender_task_).Detach();
+  }
+
+  ++stats_->parked_connections;
+  if (!parker_->Park(shared_from_this(), parked_until_)) {
+    CloseParked();
+  }
 }
 
 bool Connection::IsRequestTasksEmpty() const noexcept {
@@ -135,13 +231,12 @@ void Connection::ListenForRequests(Queue::Producer producer) noexcept {
     // do not request cancel unless we're sure it's in valid state
     // this task can only normally be cancelled from response sender
     if (response_sender_launched_event_.WaitForEvent()) {
+      const std::lock_guard lock{response_sender_mutex_};
       response_sender_task_.RequestCancel();
     }
   });
 
   try {
-    request_tasks_->SetSoftMaxSize(config_.requests_queue_size_threshold);
-
     http::HttpRequestParser request_parser(
         request_handler_.GetHandlerInfoIndex(), handler_defaults_config_,
         [this, &producer](RequestBasePtr&& request_ptr) {
@@ -151,6 +246,13 @@ void Connection::ListenForRequests(Queue::Producer producer) noexcept {
         },
         stats_->parser_stats, data_accounter_);
 
+    // HTTP/2 is detected by the connection preface. The first bytes are
+    // buffered until the preface is received in full or a byte mismatches.
+    std::optional<http::Http2Session> http2_session;
+    request::RequestParser* parser = &request_parser;
+    bool is_protocol_detected = !config_.http2_enabled;
+    std::string preface_buffer;
+
     std::vector<char> buf(config_.in_buffer_size);
     std::size_t last_bytes_read = 0;
     while (is_accepting_requests_) {
@@ -168,7 +270,15 @@ void Connection::ListenForRequests(Queue::Producer producer) noexcept {
       //
       // So instead we just do 2. and 3., shaving off a whole recv syscall
       if (last_bytes_read != buf.size()) {
-        is_readable = peer_socket_.WaitReadable(deadline);
+        is_readable = WaitReadable(!http2_session && preface_buffer.empty() &&
+                                       !request_parser.HasPartialRequest(),
+                                   deadline);
+        if (is_parking_) {
+          // The buffer and the tasks are released, the response sender
+          // hands the connection over to the parker
+          send_stopper.Release();
+          return;
+        }
       }
 
       last_bytes_read =
@@ -190,7 +300,33 @@ void Connection::ListenForRequests(Queue::Producer producer) noexcept {
       LOG_TRACE() << "Received " << last_bytes_read << " byte(s) from "
                   << peer_socket_.Getpeername() << " on fd " << Fd();
 
-      if (!request_parser.Parse(buf.data(), last_bytes_read)) {
+      std::string_view data{buf.data(), last_bytes_read};
+      if (!is_protocol_detected) {
+        if (!preface_buffer.empty()) {
+          preface_buffer.append(data);
+          data = preface_buffer;
+        }
+
+        const auto match = http::Http2Session::MatchConnectionPreface(data);
+        if (match == http::Http2Session::PrefaceMatch::kIncomplete) {
+          if (preface_buffer.empty()) preface_buffer.assign(data);
+          continue;
+        }
+
+        is_protocol_detected = true;
+        if (match == http::Http2Session::PrefaceMatch::kMatch) {
+          LOG_TRACE() << "HTTP/2 connection preface on fd " << Fd();
+          parser = &http2_session.emplace(config_, handler_defaults_config_,
+                                          peer_socket_, request_handler_,
+                                          *stats_, data_accounter_,
+                                          remote_address_);
+          ++stats_->http2_connections_created;
+        }
+      }
+
+      const bool is_parsed = parser->Parse(data.data(), data.size());
+      preface_buffer = std::string{};
+      if (!is_parsed) {
         LOG_DEBUG() << "Malformed request from " << peer_socket_.Getpeername()
                     << " on fd " << Fd();
 
@@ -223,6 +359,28 @@ void Connection::ListenForRequests(Queue::Producer producer) noexcept {
   }
 }
 
+bool Connection::WaitReadable(bool can_park, engine::Deadline deadline) {
+  if (!parker_ || config_.idle_parking_timeout.count() <= 0) {
+    return peer_socket_.WaitReadable(deadline);
+  }
+
+  while (true) {
+    const auto parking_deadline = std::min(
+        deadline, engine::Deadline::FromDuration(config_.idle_parking_timeout));
+    if (peer_socket_.WaitReadable(parking_deadline)) return true;
+    if (deadline.IsReached() || engine::current_task::ShouldCancel()) {
+      return false;
+    }
+
+    // The requests in flight keep the connection active
+    if (can_park && pending_requests_.load() == 0) {
+      is_parking_ = true;
+      parked_until_ = deadline;
+      return false;
+    }
+  }
+}
+
 bool Connection::NewRequest(std::shared_ptr<request::RequestBase>&& request_ptr,
                             Queue::Producer& producer) {
   if (!is_accepting_requests_) {
@@ -237,44 +395,97 @@ bool Connection::NewRequest(std::shared_ptr<request::RequestBase>&& request_ptr,
     is_accepting_requests_ = false;
   }
 
+  if (!WaitForRequestsInFlight()) return false;
+
   ++stats_->active_request_count;
+  ++pending_requests_;
   auto task = request_handler_.StartRequestTask(request_ptr);
   return producer.Push({std::move(request_ptr), std::move(task)});
 }
 
+// The pipelined requests are handled concurrently, the reading of the next
+// requests pauses while too many of them are in flight
+bool Connection::WaitForRequestsInFlight() {
+  const auto max_requests =
+      std::max<std::size_t>(config_.requests_queue_size_threshold, 1);
+  while (pending_requests_.load() >= max_requests) {
+    if (!request_finished_event_.WaitForEvent()) return false;
+  }
+  return true;
+}
+
 void Connection::ProcessResponses(Queue::Consumer& consumer) noexcept {
   try {
+    ResponsesBatch batch;
     QueueItem item;
-    while (consumer.Pop(item)) {
+    bool has_item = consumer.Pop(item);
+    while (has_item) {
+      if (engine::current_task::IsCancelRequested()) {
+        SendBatch(batch);
+        CancelRequests(item, consumer);
+        has_item = consumer.Pop(item);
+        continue;
+      }
+
       HandleQueueItem(item);
 
-      // now we must complete processing
-      engine::TaskCancellationBlocker block_cancel;
+      {
+        // now we must complete processing
+        engine::TaskCancellationBlocker block_cancel;
+
+        if (!AddToBatch(item, batch)) {
+          SendBatch(batch);
+
+          /* In stream case we don't want a user task to exit
+           * until SendResponse() as the task produces body chunks.
+           */
+          SendResponse(*item.first);
+          item.first.reset();
+          item.second = {};
+        }
+
+        // The responses of the pipelined requests that are already handled
+        // go with the same writev
+        has_item = consumer.PopNoblock(item);
+        const bool is_item_handled =
+            has_item && item.second.IsFinished() &&
+            !item.first->GetResponse().IsBodyStreamed();
+        if (!is_item_handled || batch.items.size() >= kMaxBatchedResponses) {
+          SendBatch(batch);
+        }
+      }
 
-      /* In stream case we don't want a user task to exit
-       * until SendResponse() as the task produces body chunks.
-       */
-      SendResponse(*item.first);
-      item.first.reset();
-      item.second = {};
+      if (!has_item) has_item = consumer.Pop(item);
     }
+    SendBatch(batch);
   } catch (const std::exception& e) {
     LOG_ERROR() << "Exception for fd " << Fd() << ": " << e;
   }
 }
 
-void Connection::HandleQueueItem(QueueItem& item) noexcept {
-  auto& request = *item.first;
+void Connection::CancelRequests(QueueItem& item, Queue::Consumer& consumer) {
+  LOG_DEBUG() << "Request processing interrupted";
+  is_response_chain_valid_ = false;
 
-  if (engine::current_task::IsCancelRequested()) {
-    // We could've packed all remaining requests into a vector and cancel them
-    // in parallel. But pipelining is almost never used so why bother.
-    auto request_task = std::move(item.second);
-    request_task.SyncCancel();
-    LOG_DEBUG() << "Request processing interrupted";
-    is_response_chain_valid_ = false;
-    return;  // avoids throwing and catching exception down below
+  std::vector<QueueItem> items;
+  items.push_back(std::move(item));
+  QueueItem next_item;
+  while (consumer.PopNoblock(next_item)) items.push_back(std::move(next_item));
+
+  // All the pipelined requests are cancelled at once and finish concurrently
+  for (auto& [request, task] : items) {
+    if (task.IsValid()) task.RequestCancel();
+  }
+
+  engine::TaskCancellationBlocker block_cancel;
+  for (auto& [request, task] : items) {
+    if (task.IsValid()) task.SyncCancel();
+    SendResponse(*request);
   }
+}
+
+void Connection::HandleQueueItem(QueueItem& item) noexcept {
+  auto& request = *item.first;
 
   try {
     auto& response = request.GetResponse();
@@ -301,32 +512,58 @@ void Connection::HandleQueueItem(QueueItem& item) noexcept {
   }
 }
 
-void Connection::SendResponse(request::RequestBase& request) {
+bool Connection::AddToBatch(QueueItem& item, ResponsesBatch& batch) {
+  auto& request = *item.first;
   auto& response = request.GetResponse();
   UASSERT(!response.IsSent());
+  if (!is_response_chain_valid_ || !peer_socket_) return false;
+
   request.SetStartSendResponseTime();
-  if (is_response_chain_valid_ && peer_socket_) {
-    try {
-      // Might be a stream reading or a fully constructed response
-      response.SendResponse(peer_socket_);
-    } catch (const engine::io::IoSystemError& ex) {
-      // working with raw values because std::errc compares error_category
-      // default_error_category() fixed only in GCC 9.1 (PR libstdc++/60555)
-      auto log_level =
-          ex.Code().value() == static_cast<int>(std::errc::broken_pipe)
-              ? logging::Level::kWarning
-              : logging::Level::kError;
-      LOG(log_level) << "I/O error while sending data: " << ex;
-      response.SetSendFailed(std::chrono::steady_clock::now());
-    } catch (const std::exception& ex) {
-      LOG_ERROR() << "Error while sending data: " << ex;
+  const auto size_before = batch.writer.Size();
+  if (!response.SerializeResponse(batch.writer)) return false;
+
+  batch.items.emplace_back(std::move(item), batch.writer.Size() - size_before);
+  return true;
+}
+
+void Connection::SendBatch(ResponsesBatch& batch) {
+  if (batch.items.empty()) return;
+
+  const bool is_sent = SendLogged(
+      [this, &batch] { batch.writer.Flush(peer_socket_, engine::Deadline{}); });
+
+  for (auto& [item, size] : batch.items) {
+    auto& response = item.first->GetResponse();
+    if (is_sent) {
+      response.SetSentByConnection(size);
+    } else {
       response.SetSendFailed(std::chrono::steady_clock::now());
     }
+    FinishResponse(*item.first);
+  }
+  batch.items.clear();
+}
+
+void Connection::SendResponse(request::RequestBase& request) {
+  auto& response = request.GetResponse();
+  UASSERT(!response.IsSent());
+  request.SetStartSendResponseTime();
+  if (is_response_chain_valid_ && peer_socket_) {
+    // Might be a stream reading or a fully constructed response
+    const bool is_sent =
+        SendLogged([this, &response] { response.SendResponse(peer_socket_); });
+    if (!is_sent) response.SetSendFailed(std::chrono::steady_clock::now());
   } else {
     response.SetSendFailed(std::chrono::steady_clock::now());
   }
+  FinishResponse(request);
+}
+
+void Connection::FinishResponse(request::RequestBase& request) {
   request.SetFinishSendResponseTime();
   --stats_->active_request_count;
+  --pending_requests_;
+  request_finished_event_.Send();
   ++stats_->requests_processed_count;
 
   request.WriteAccessLogs(request_handler_.LoggerAccess(),
@@ -1,16 +1,23 @@
 #pragma once
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <server/http/request_handler_base.hpp>
 #include <server/net/connection_config.hpp>
+#include <server/net/connection_parker.hpp>
+#include <server/net/response_writer.hpp>
 #include <server/net/stats.hpp>
 #include <server/request/request_parser.hpp>
 
 #include <userver/concurrent/queue.hpp>
+#include <userver/engine/deadline.hpp>
 #include <userver/engine/io/socket.hpp>
+#include <userver/engine/mutex.hpp>
 #include <userver/engine/single_consumer_event.hpp>
 #include <userver/engine/task/task.hpp>
 #include <userver/engine/task/task_processor_fwd.hpp>
@@ -47,12 +54,24 @@ class Connection final : public std::enable_shared_from_this<Connection> {
              std::shared_ptr<Stats> stats,
              request::ResponseDataAccounter& data_accounter, EmplaceEnabler);
 
+  ~Connection();
+
   void SetCloseCb(CloseCb close_cb);
 
+  // Idle keep-alive connections are handed over to the parker
+  void SetParker(std::shared_ptr<ConnectionParker> parker);
+
   void Start();
 
   void Stop();  // Can be called after Start() has finished
 
+  // For ConnectionParker: the parked connection became readable
+  void Resume();
+
+  // For ConnectionParker: the parked connection is timed out or the parker
+  // is stopped
+  void CloseParked() noexcept;
+
   int Fd() const;
 
  private:
@@ -60,17 +79,31 @@ class Connection final : public std::enable_shared_from_this<Connection> {
                               engine::TaskWithResult<void>>;
   using Queue = concurrent::SpscQueue<QueueItem>;
 
+  // The serialized responses of the pipelined requests that are sent together
+  struct ResponsesBatch {
+    ResponseWriter writer;
+    std::vector<std::pair<QueueItem, std::size_t>> items;
+  };
+
   void Shutdown() noexcept;
+  void Close() noexcept;
+  void Park() noexcept;
 
   bool IsRequestTasksEmpty() const noexcept;
 
   void ListenForRequests(Queue::Producer) noexcept;
+  bool WaitReadable(bool can_park, engine::Deadline deadline);
   bool NewRequest(std::shared_ptr<request::RequestBase>&& request_ptr,
                   Queue::Producer&);
+  bool WaitForRequestsInFlight();
 
   void ProcessResponses(Queue::Consumer&) noexcept;
+  void CancelRequests(QueueItem& item, Queue::Consumer&);
   void HandleQueueItem(QueueItem& item) noexcept;
+  bool AddToBatch(QueueItem& item, ResponsesBatch& batch);
+  void SendBatch(ResponsesBatch& batch);
   void SendResponse(request::RequestBase& request);
+  void FinishResponse(request::RequestBase& request);
 
   engine::TaskProcessor& task_processor_;
   const ConnectionConfig& config_;
@@ -84,11 +117,24 @@ class Connection final : public std::enable_shared_from_this<Connection> {
   std::shared_ptr<Queue> request_tasks_;
   engine::SingleConsumerEvent response_sender_launched_event_;
   engine::SingleConsumerEvent response_sender_assigned_event_;
+  // Guards response_sender_task_ and is_stopped_: a parked connection is
+  // restarted by the parker concurrently with Stop()
+  engine::Mutex response_sender_mutex_;
   engine::Task response_sender_task_;
+  bool is_stopped_{false};
 
   bool is_accepting_requests_{true};
   bool is_response_chain_valid_{true};
   CloseCb close_cb_;
+
+  std::shared_ptr<ConnectionParker> parker_;
+  // Requests that are received but not responded yet
+  std::atomic<std::size_t> pending_requests_{0};
+  // Wakes up the listener waiting for the pending requests to go below the
+  // requests_queue_size_threshold
+  engine::SingleConsumerEvent request_finished_event_;
+  bool is_parking_{false};
+  engine::Deadline parked_until_;
 };
 
 }  // namespace server::net
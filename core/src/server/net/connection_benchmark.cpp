@@ -0,0 +1,242 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <server/handlers/http_handler_base_statistics.hpp>
+#include <server/http/http_request_impl.hpp>
+#include <server/http/request_handler_base.hpp>
+#include <server/net/connection.hpp>
+#include <userver/engine/async.hpp>
+#include <userver/engine/run_standalone.hpp>
+#include <userver/engine/sleep.hpp>
+#include <userver/internal/net/net_listener.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+// Handles every request for the given time, as if waiting for a database
+class SleepingRequestHandler final : public server::http::RequestHandlerBase {
+ public:
+  explicit SleepingRequestHandler(std::chrono::microseconds handling_time)
+      : handling_time_(handling_time) {}
+
+  engine::TaskWithResult<void> StartRequestTask(
+      std::shared_ptr<server::request::RequestBase> request) const override {
+    auto& http_request = static_cast<server::http::HttpRequestImpl&>(*request);
+    http_request.SetHttpHandlerStatistics(statistics_);
+
+    return engine::AsyncNoSpan([handling_time = handling_time_] {
+      if (handling_time.count()) engine::SleepFor(handling_time);
+    });
+  }
+
+  const server::http::HandlerInfoIndex& GetHandlerInfoIndex() const override {
+    return handler_info_index_;
+  }
+
+  const logging::LoggerPtr& LoggerAccess() const noexcept override {
+    return no_logger_;
+  }
+
+  const logging::LoggerPtr& LoggerAccessTskv() const noexcept override {
+    return no_logger_;
+  }
+
+ private:
+  const std::chrono::microseconds handling_time_;
+  mutable server::handlers::HttpRequestStatistics statistics_;
+  logging::LoggerPtr no_logger_;
+  server::http::HandlerInfoIndex handler_info_index_;
+};
+
+constexpr std::uint8_t kHttp2HeadersFrame = 0x1;
+constexpr std::uint8_t kHttp2SettingsFrame = 0x4;
+constexpr std::uint8_t kHttp2EndStreamFlag = 0x1;
+constexpr std::uint8_t kHttp2EndHeadersFlag = 0x4;
+constexpr std::size_t kHttp2FrameHeaderSize = 9;
+
+// GET http://localhost/, encoded with the HPACK static table
+constexpr std::string_view kHttp2RequestHeaders{
+    "\x82\x86\x84\x01\x09localhost", 14};
+
+void AppendHttp2Frame(std::string& out, std::uint8_t type, std::uint8_t flags,
+                      std::uint32_t stream_id, std::string_view payload) {
+  const auto length = static_cast<std::uint32_t>(payload.size());
+  const char header[kHttp2FrameHeaderSize] = {
+      static_cast<char>(length >> 16),    static_cast<char>(length >> 8),
+      static_cast<char>(length),          static_cast<char>(type),
+      static_cast<char>(flags),           static_cast<char>(stream_id >> 24),
+      static_cast<char>(stream_id >> 16), static_cast<char>(stream_id >> 8),
+      static_cast<char>(stream_id),
+  };
+  out.append(header, sizeof(header));
+  out.append(payload);
+}
+
+// Starts a connection that is destroyed once the client socket is closed
+std::weak_ptr<server::net::Connection> StartConnection(
+    engine::io::Socket&& peer, const server::net::ConnectionConfig& config,
+    const server::http::RequestHandlerBase& handler,
+    server::request::ResponseDataAccounter& data_accounter) {
+  static const server::request::HttpRequestConfig kHandlerDefaults;
+  auto connection = server::net::Connection::Create(
+      engine::current_task::GetTaskProcessor(), config, kHandlerDefaults,
+      std::move(peer), handler, std::make_shared<server::net::Stats>(),
+      data_accounter);
+  connection->Start();
+  return connection;
+}
+
+// Sends the range(0) pipelined requests at once and receives all the
+// responses, every request is handled for range(1) microseconds
+void connection_pipelined_requests(benchmark::State& state) {
+  engine::RunStandalone(4, [&] {
+    const auto deadline =
+        engine::Deadline::FromDuration(std::chrono::minutes{1});
+    auto [peer, client] = internal::net::TcpListener{}.MakeSocketPair(deadline);
+
+    const server::net::ConnectionConfig config;
+    const SleepingRequestHandler handler{
+        std::chrono::microseconds{state.range(1)}};
+    server::request::ResponseDataAccounter data_accounter;
+    const auto weak =
+        StartConnection(std::move(peer), config, handler, data_accounter);
+
+    std::string requests;
+    for (std::int64_t i = 0; i < state.range(0); ++i) {
+      requests += "GET /pipelined HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    }
+    const auto responses_count = static_cast<std::size_t>(state.range(0));
+
+    std::vector<char> buffer(64 * 1024);
+    std::string responses;
+    for (auto _ : state) {
+      if (client.SendAll(requests.data(), requests.size(), deadline) !=
+          requests.size()) {
+        state.SkipWithError("failed to send the requests");
+        break;
+      }
+
+      // Every response is a 404 with an empty body, so each one ends with
+      // an empty line
+      std::size_t received_count = 0;
+      responses.clear();
+      while (received_count < responses_count) {
+        const auto size =
+            client.RecvSome(buffer.data(), buffer.size(), deadline);
+        if (!size) {
+          state.SkipWithError("connection closed");
+          break;
+        }
+
+        const auto search_from = responses.size() >= 3 ? responses.size() - 3
+                                                       : std::size_t{0};
+        responses.append(buffer.data(), size);
+        for (auto pos = responses.find("\r\n\r\n", search_from);
+             pos != std::string::npos;
+             pos = responses.find("\r\n\r\n", pos + 4)) {
+          ++received_count;
+        }
+      }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+
+    client.Close();
+    while (weak.lock()) engine::Yield();
+  });
+}
+
+// The same load as connection_pipelined_requests over HTTP/2: sends the
+// range(0) requests at once as concurrent streams of a single connection and
+// receives all the responses, every request is handled for range(1)
+// microseconds
+void connection_http2_streams(benchmark::State& state) {
+  engine::RunStandalone(4, [&] {
+    const auto deadline =
+        engine::Deadline::FromDuration(std::chrono::minutes{1});
+    auto [peer, client] = internal::net::TcpListener{}.MakeSocketPair(deadline);
+
+    server::net::ConnectionConfig config;
+    config.http2_enabled = true;
+    const SleepingRequestHandler handler{
+        std::chrono::microseconds{state.range(1)}};
+    server::request::ResponseDataAccounter data_accounter;
+    const auto weak =
+        StartConnection(std::move(peer), config, handler, data_accounter);
+
+    // The server settings are not acknowledged, nothing depends on them here
+    std::string requests = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+    AppendHttp2Frame(requests, kHttp2SettingsFrame, 0, 0, {});
+    const auto responses_count = static_cast<std::size_t>(state.range(0));
+
+    std::uint32_t next_stream_id = 1;
+    std::vector<char> buffer(64 * 1024);
+    std::string responses;
+    for (auto _ : state) {
+      for (std::size_t i = 0; i < responses_count; ++i) {
+        AppendHttp2Frame(requests, kHttp2HeadersFrame,
+                         kHttp2EndStreamFlag | kHttp2EndHeadersFlag,
+                         next_stream_id, kHttp2RequestHeaders);
+        next_stream_id += 2;
+      }
+      if (client.SendAll(requests.data(), requests.size(), deadline) !=
+          requests.size()) {
+        state.SkipWithError("failed to send the requests");
+        break;
+      }
+      requests.clear();
+
+      // Every response ends with a frame of its stream that has the
+      // END_STREAM flag, the connection frames are skipped
+      std::size_t received_count = 0;
+      while (received_count < responses_count) {
+        const auto size =
+            client.RecvSome(buffer.data(), buffer.size(), deadline);
+        if (!size) {
+          state.SkipWithError("connection closed");
+          break;
+        }
+
+        responses.append(buffer.data(), size);
+        std::size_t pos = 0;
+        while (responses.size() - pos >= kHttp2FrameHeaderSize) {
+          const auto* header =
+              reinterpret_cast<const std::uint8_t*>(responses.data() + pos);
+          const std::size_t length = (header[0] << 16) | (header[1] << 8) |
+                                     header[2];
+          if (responses.size() - pos < kHttp2FrameHeaderSize + length) break;
+
+          const bool is_stream_frame = (header[5] & 0x7f) | header[6] |
+                                       header[7] | header[8];
+          if (is_stream_frame && (header[4] & kHttp2EndStreamFlag)) {
+            ++received_count;
+          }
+          pos += kHttp2FrameHeaderSize + length;
+        }
+        responses.erase(0, pos);
+      }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+
+    client.Close();
+    while (weak.lock()) engine::Yield();
+  });
+}
+
+}  // namespace
+
+BENCHMARK(connection_pipelined_requests)
+    ->ArgsProduct({{1, 8, 64}, {0, 100}})
+    ->ArgNames({"pipelined", "handling_us"});
+
+BENCHMARK(connection_http2_streams)
+    ->ArgsProduct({{1, 8, 64}, {0, 100}})
+    ->ArgNames({"streams", "handling_us"});
+
+USERVER_NAMESPACE_END
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -13,6 +15,13 @@ struct ConnectionConfig {
   size_t in_buffer_size = 32 * 1024;
   size_t requests_queue_size_threshold = 100;
   std::chrono::seconds keepalive_timeout{10 * 60};
+  // Zero disables parking of the idle keep-alive connections
+  std::chrono::milliseconds idle_parking_timeout{1000};
+
+  // HTTP/2 with prior knowledge, detected by the client connection preface
+  bool http2_enabled = false;
+  std::uint32_t http2_max_concurrent_streams = 100;
+  std::uint32_t http2_initial_window_size = 1024 * 1024;
 };
 
 ConnectionConfig Parse(const yaml_config::YamlConfig& value,
@@ -0,0 +1,159 @@
+#include <server/net/connection_parker.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <utility>
+
+#include <server/net/connection.hpp>
+
+#include <userver/engine/async.hpp>
+#include <userver/engine/task/cancel.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/utils/assert.hpp>
+#include <userver/utils/fast_scope_guard.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::net {
+
+namespace {
+
+// Grows the capacity geometrically, as the connections are added one by one
+template <typename T>
+void ReserveAtLeast(std::vector<T>& vector, std::size_t size) {
+  if (vector.capacity() < size) {
+    vector.reserve(std::max(size, vector.capacity() * 2));
+  }
+}
+
+}  // namespace
+
+ConnectionParker::ConnectionParker(engine::TaskProcessor& task_processor)
+    : watcher_task_(engine::CriticalAsyncNoSpan(task_processor,
+                                                [this] { Run(); })) {}
+
+ConnectionParker::~ConnectionParker() { Stop(); }
+
+void ConnectionParker::AddConnection() {
+  const std::lock_guard lock{mutex_};
+  ReserveAtLeast(parked_, connections_count_ + 1);
+  ++connections_count_;
+}
+
+void ConnectionParker::RemoveConnection() noexcept {
+  const std::lock_guard lock{mutex_};
+  UASSERT(connections_count_ > 0);
+  --connections_count_;
+}
+
+bool ConnectionParker::Park(std::shared_ptr<Connection> connection,
+                            engine::Deadline deadline) noexcept {
+  UASSERT(connection);
+  {
+    const std::lock_guard lock{mutex_};
+    if (is_stopped_) return false;
+    // Does not allocate, a connection is parked at most once at a time
+    UASSERT(parked_.size() < parked_.capacity());
+    parked_.push_back({std::move(connection), deadline});
+  }
+  poller_.Interrupt();
+  return true;
+}
+
+void ConnectionParker::Stop() noexcept {
+  {
+    const std::lock_guard lock{mutex_};
+    if (is_stopped_) return;
+    is_stopped_ = true;
+  }
+  watcher_task_.SyncCancel();
+}
+
+void ConnectionParker::Run() {
+  engine::io::Poller::Event event;
+  while (!engine::current_task::ShouldCancel()) {
+    WatchParked();
+
+    const auto deadline = expirations_.empty() ? engine::Deadline{}
+                                               : expirations_.begin()->first;
+    if (poller_.NextEvent(event, deadline) ==
+        engine::io::Poller::Status::kSuccess) {
+      Resume(event.fd);
+    }
+    CloseExpired();
+  }
+  CloseAll();
+}
+
+void ConnectionParker::WatchParked() {
+  {
+    const std::lock_guard lock{mutex_};
+    if (parked_.empty()) return;
+    ReserveAtLeast(watched_buffer_, connections_count_);
+    watched_buffer_.swap(parked_);
+  }
+
+  const utils::FastScopeGuard clear_guard{
+      [this]() noexcept { watched_buffer_.clear(); }};
+  for (auto& [connection, deadline] : watched_buffer_) {
+    const auto fd = connection->Fd();
+    UASSERT(!watched_.count(fd));
+    const auto expiration = expirations_.emplace(deadline, fd);
+    watched_.emplace(fd, WatchedConnection{std::move(connection), expiration});
+    poller_.Add(fd, engine::io::Poller::Event::kRead);
+  }
+}
+
+void ConnectionParker::Resume(int fd) {
+  const auto it = watched_.find(fd);
+  UASSERT(it != watched_.end());
+  if (it == watched_.end()) return;
+
+  // The poller does not watch the fd after the event, no need to Remove it
+  auto connection = std::move(it->second.connection);
+  expirations_.erase(it->second.expiration);
+  watched_.erase(it);
+
+  try {
+    connection->Resume();
+  } catch (const std::exception& ex) {
+    LOG_ERROR() << "Failed to resume a parked connection: " << ex;
+    connection->CloseParked();
+  }
+}
+
+void ConnectionParker::CloseExpired() {
+  while (!expirations_.empty() && expirations_.begin()->first.IsReached()) {
+    const auto fd = expirations_.begin()->second;
+    expirations_.erase(expirations_.begin());
+
+    const auto it = watched_.find(fd);
+    UASSERT(it != watched_.end());
+    LOG_INFO() << "Closing idle connection on timeout";
+    poller_.Remove(fd);
+    it->second.connection->CloseParked();
+    watched_.erase(it);
+  }
+}
+
+void ConnectionParker::CloseAll() noexcept {
+  const engine::TaskCancellationBlocker block_cancel;
+
+  std::vector<ParkedConnection> parked;
+  {
+    const std::lock_guard lock{mutex_};
+    parked.swap(parked_);
+  }
+  for (auto& item : parked) item.connection->CloseParked();
+
+  for (auto& [fd, watched] : watched_) {
+    poller_.Remove(fd);
+    watched.connection->CloseParked();
+  }
+  watched_.clear();
+  expirations_.clear();
+}
+
+}  // namespace server::net
+
+USERVER_NAMESPACE_END
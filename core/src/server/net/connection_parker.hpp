@@ -0,0 +1,83 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <engine/io/poller.hpp>
+
+#include <userver/engine/deadline.hpp>
+#include <userver/engine/mutex.hpp>
+#include <userver/engine/task/task.hpp>
+#include <userver/engine/task/task_processor_fwd.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::net {
+
+class Connection;
+
+// Keeps the idle keep-alive connections of a listener without tasks and
+// buffers of their own. A single task watches the parked sockets, resumes a
+// connection once its socket becomes readable and closes it on the keep-alive
+// timeout.
+class ConnectionParker final {
+ public:
+  explicit ConnectionParker(engine::TaskProcessor& task_processor);
+
+  ConnectionParker(const ConnectionParker&) = delete;
+  ConnectionParker& operator=(const ConnectionParker&) = delete;
+
+  ~ConnectionParker();
+
+  // Reserve and release a parking slot for a connection, so that Park does
+  // not allocate
+  void AddConnection();
+  void RemoveConnection() noexcept;
+
+  // Returns false if the parker is stopped, the connection is not taken then.
+  // The connection must have a slot reserved with AddConnection.
+  bool Park(std::shared_ptr<Connection> connection,
+            engine::Deadline deadline) noexcept;
+
+  // Closes the parked connections, the following Park calls fail
+  void Stop() noexcept;
+
+ private:
+  struct ParkedConnection {
+    std::shared_ptr<Connection> connection;
+    engine::Deadline deadline;
+  };
+
+  struct WatchedConnection {
+    std::shared_ptr<Connection> connection;
+    std::multimap<engine::Deadline, int>::iterator expiration;
+  };
+
+  void Run();
+  void WatchParked();
+  void Resume(int fd);
+  void CloseExpired();
+  void CloseAll() noexcept;
+
+  // Guards parked_, connections_count_ and is_stopped_. The capacity of
+  // parked_ covers all the connections that may be parked.
+  engine::Mutex mutex_;
+  std::vector<ParkedConnection> parked_;
+  std::size_t connections_count_{0};
+  bool is_stopped_{false};
+
+  // Are used by the watcher task only. The buffer of the newly parked
+  // connections is swapped with parked_, so it is reserved likewise.
+  std::vector<ParkedConnection> watched_buffer_;
+  engine::io::Poller poller_;
+  std::unordered_map<int, WatchedConnection> watched_;
+  std::multimap<engine::Deadline, int> expirations_;
+
+  engine::Task watcher_task_;
+};
+
+}  // namespace server::net
+
+USERVER_NAMESPACE_END
@@ -1,5 +1,9 @@
 #include <server/net/connection.hpp>
 
+#include <string>
+#include <string_view>
+#include <vector>
+
 #include <fmt/format.h>
 
 #include <server/handlers/http_handler_base_statistics.hpp>
@@ -9,6 +13,7 @@
 #include <userver/clients/http/client.hpp>
 #include <userver/engine/io/sockaddr.hpp>
 #include <userver/engine/sleep.hpp>
+#include <userver/internal/net/net_listener.hpp>
 
 #include <userver/utest/http_client.hpp>
 #include <userver/utest/utest.hpp>
@@ -23,7 +28,7 @@ constexpr auto kAcceptTimeout = utest::kMaxTestWaitTime;
 
 class TestHttprequestHandler : public server::http::RequestHandlerBase {
  public:
-  enum class Behaviors { kNoop, kHang };
+  enum class Behaviors { kNoop, kHang, kWaitRelease };
 
   explicit TestHttprequestHandler(Behaviors behavior = Behaviors::kNoop)
       : behavior_(behavior) {}
@@ -45,6 +50,14 @@ class TestHttprequestHandler : public server::http::RequestHandlerBase {
           ASSERT_TRUE(engine::current_task::IsCancelRequested());
           ++asyncs_finished;
         });
+      case Behaviors::kWaitRelease:
+        return engine::AsyncNoSpan([this]() {
+          ++asyncs_started;
+          while (!is_released && !engine::current_task::ShouldCancel()) {
+            engine::Yield();
+          }
+          ++asyncs_finished;
+        });
     }
 
     UINVARIANT(false, "Unexpected behavior");
@@ -61,8 +74,12 @@ class TestHttprequestHandler : public server::http::RequestHandlerBase {
     return no_logger_;
   };
 
+  // NOLINTNEXTLINE(misc-non-private-member-variables-in-classes)
+  mutable std::atomic<std::size_t> asyncs_started{0};
   // NOLINTNEXTLINE(misc-non-private-member-variables-in-classes)
   mutable std::atomic<std::size_t> asyncs_finished{0};
+  // NOLINTNEXTLINE(misc-non-private-member-variables-in-classes)
+  std::atomic<bool> is_released{false};
 
  private:
   const Behaviors behavior_;
@@ -92,6 +109,16 @@ clients::http::ResponseFuture CreateRequest(
   return ret.async_perform();
 }
 
+clients::http::ResponseFuture CreateHttp2Request(
+    clients::http::Client& http_client, engine::io::Socket& request_socket) {
+  return http_client.CreateRequest()
+      .get(HttpConnectionUriFromSocket(request_socket))
+      .http_version(clients::http::HttpVersion::k2PriorKnowledge)
+      .retry(1)
+      .timeout(utest::kMaxTestWaitTime)
+      .async_perform();
+}
+
 net::ListenerConfig CreateConfig() {
   net::ListenerConfig config;
   config.handler_defaults = server::request::HttpRequestConfig{};
@@ -339,4 +366,190 @@ UTEST(ServerNetConnection, CancelMultipleInFlight) {
   FAIL() << "Failed to simulate cancellation of multiple requests";
 }
 
+UTEST(ServerNetConnection, IdleParking) {
+  net::ListenerConfig config = CreateConfig();
+  config.connection_config.idle_parking_timeout = std::chrono::milliseconds{10};
+  auto request_socket = net::CreateSocket(config);
+
+  auto http_client_ptr = utest::CreateHttpClient();
+  http_client_ptr->SetMaxHostConnections(1);
+
+  auto request = CreateRequest(*http_client_ptr, request_socket,
+                               ConnectionHeader::kKeepAlive);
+
+  auto peer = request_socket.Accept(Deadline::FromDuration(kAcceptTimeout));
+  ASSERT_TRUE(peer.IsValid());
+  auto stats = std::make_shared<net::Stats>();
+  server::request::ResponseDataAccounter data_accounter;
+  TestHttprequestHandler handler;
+  auto parker = std::make_shared<net::ConnectionParker>(
+      engine::current_task::GetTaskProcessor());
+
+  auto connection_ptr = net::Connection::Create(
+      engine::current_task::GetTaskProcessor(), config.connection_config,
+      config.handler_defaults, std::move(peer), handler, stats, data_accounter);
+  connection_ptr->SetParker(parker);
+  std::weak_ptr<net::Connection> weak = connection_ptr;
+
+  connection_ptr->Start();
+  connection_ptr.reset();
+  EXPECT_EQ(request.Get()->status_code(), 404);
+
+  const auto deadline = Deadline::FromDuration(utest::kMaxTestWaitTime);
+  while (stats->parked_connections.load() == 0 && !deadline.IsReached()) {
+    engine::SleepFor(std::chrono::milliseconds{1});
+  }
+  ASSERT_EQ(stats->parked_connections.load(), 1);
+  EXPECT_TRUE(weak.lock()) << "Parked connection is owned by the parker";
+
+  // The parked connection is resumed by the next request
+  request = CreateRequest(*http_client_ptr, request_socket,
+                          ConnectionHeader::kKeepAlive);
+  EXPECT_EQ(request.Get()->status_code(), 404);
+  EXPECT_EQ(handler.asyncs_finished, 2);
+  EXPECT_EQ(stats->connections_closed.load(), 0);
+}
+
+UTEST(ServerNetConnection, Http2) {
+  constexpr std::size_t kRequests = 10;
+  net::ListenerConfig config = CreateConfig();
+  config.connection_config.http2_enabled = true;
+  auto request_socket = net::CreateSocket(config);
+
+  auto http_client_ptr = utest::CreateHttpClient();
+  http_client_ptr->SetMaxHostConnections(1);
+
+  auto request = CreateHttp2Request(*http_client_ptr, request_socket);
+
+  auto peer = request_socket.Accept(Deadline::FromDuration(kAcceptTimeout));
+  ASSERT_TRUE(peer.IsValid());
+  auto stats = std::make_shared<net::Stats>();
+  server::request::ResponseDataAccounter data_accounter;
+  TestHttprequestHandler handler;
+
+  auto connection_ptr = net::Connection::Create(
+      engine::current_task::GetTaskProcessor(), config.connection_config,
+      config.handler_defaults, std::move(peer), handler, stats, data_accounter);
+
+  connection_ptr->Start();
+  EXPECT_EQ(request.Get()->status_code(), 404);
+  EXPECT_EQ(stats->http2_connections_created.load(), 1);
+
+  // Concurrent requests are multiplexed over the same connection
+  std::vector<clients::http::ResponseFuture> requests;
+  for (std::size_t i = 0; i < kRequests; ++i) {
+    requests.push_back(CreateHttp2Request(*http_client_ptr, request_socket));
+  }
+  for (auto& future : requests) {
+    EXPECT_EQ(future.Get()->status_code(), 404);
+  }
+  EXPECT_EQ(handler.asyncs_finished, kRequests + 1);
+}
+
+UTEST(ServerNetConnection, PipelinedInFlightLimit) {
+  constexpr std::size_t kRequests = 5;
+  constexpr std::size_t kMaxInFlight = 2;
+  net::ListenerConfig config = CreateConfig();
+  config.connection_config.requests_queue_size_threshold = kMaxInFlight;
+
+  auto [peer, client] = internal::net::TcpListener{}.MakeSocketPair(
+      Deadline::FromDuration(utest::kMaxTestWaitTime));
+  auto stats = std::make_shared<net::Stats>();
+  server::request::ResponseDataAccounter data_accounter;
+  TestHttprequestHandler handler{
+      TestHttprequestHandler::Behaviors::kWaitRelease};
+
+  auto connection_ptr = net::Connection::Create(
+      engine::current_task::GetTaskProcessor(), config.connection_config,
+      config.handler_defaults, std::move(peer), handler, stats, data_accounter);
+  connection_ptr->Start();
+  std::weak_ptr<net::Connection> weak = connection_ptr;
+  connection_ptr.reset();
+
+  std::string requests;
+  for (std::size_t i = 0; i < kRequests; ++i) {
+    requests += fmt::format("GET /{} HTTP/1.1\r\nHost: localhost\r\n\r\n", i);
+  }
+  const auto deadline = Deadline::FromDuration(utest::kMaxTestWaitTime);
+  ASSERT_EQ(client.SendAll(requests.data(), requests.size(), deadline),
+            requests.size());
+
+  // The pipelined requests run concurrently up to the limit
+  while (handler.asyncs_started < kMaxInFlight && !deadline.IsReached()) {
+    engine::Yield();
+  }
+  engine::SleepFor(std::chrono::milliseconds{10});
+  EXPECT_EQ(handler.asyncs_started, kMaxInFlight);
+
+  handler.is_released = true;
+  std::string responses;
+  std::size_t responses_count = 0;
+  std::vector<char> buf(4096);
+  while (responses_count < kRequests && !deadline.IsReached()) {
+    const auto size = client.RecvSome(buf.data(), buf.size(), deadline);
+    ASSERT_NE(size, 0);
+    responses.append(buf.data(), size);
+    responses_count = 0;
+    for (auto pos = responses.find("HTTP/1.1 404"); pos != std::string::npos;
+         pos = responses.find("HTTP/1.1 404", pos + 1)) {
+      ++responses_count;
+    }
+  }
+  EXPECT_EQ(responses_count, kRequests);
+  EXPECT_EQ(handler.asyncs_finished, kRequests);
+
+  client.Close();
+  auto task = engine::AsyncNoSpan([weak]() {
+    while (weak.lock()) engine::Yield();
+  });
+  task.WaitFor(utest::kMaxTestWaitTime);
+  EXPECT_TRUE(task.IsFinished());
+}
+
+UTEST(ServerNetConnection, Http2EnabledSplitHttp1Request) {
+  net::ListenerConfig config = CreateConfig();
+  config.connection_config.http2_enabled = true;
+
+  auto [peer, client] = internal::net::TcpListener{}.MakeSocketPair(
+      Deadline::FromDuration(utest::kMaxTestWaitTime));
+  auto stats = std::make_shared<net::Stats>();
+  server::request::ResponseDataAccounter data_accounter;
+  TestHttprequestHandler handler;
+
+  auto connection_ptr = net::Connection::Create(
+      engine::current_task::GetTaskProcessor(), config.connection_config,
+      config.handler_defaults, std::move(peer), handler, stats, data_accounter);
+  connection_ptr->Start();
+  std::weak_ptr<net::Connection> weak = connection_ptr;
+  connection_ptr.reset();
+
+  // "P" is also the first byte of the HTTP/2 connection preface
+  const auto deadline = Deadline::FromDuration(utest::kMaxTestWaitTime);
+  ASSERT_EQ(client.SendAll("P", 1, deadline), 1);
+  // Lets the connection receive the first byte alone
+  engine::SleepFor(std::chrono::milliseconds{10});
+  const std::string_view rest =
+      "OST / HTTP/1.1\r\nHost: localhost\r\nContent-Length: 0\r\n\r\n";
+  ASSERT_EQ(client.SendAll(rest.data(), rest.size(), deadline), rest.size());
+
+  std::string response;
+  std::vector<char> buf(4096);
+  while (response.find("\r\n\r\n") == std::string::npos &&
+         !deadline.IsReached()) {
+    const auto size = client.RecvSome(buf.data(), buf.size(), deadline);
+    ASSERT_NE(size, 0);
+    response.append(buf.data(), size);
+  }
+  EXPECT_EQ(response.rfind("HTTP/1.1 404", 0), 0) << response;
+  EXPECT_EQ(stats->http2_connections_created.load(), 0);
+  EXPECT_EQ(handler.asyncs_finished, 1);
+
+  client.Close();
+  auto task = engine::AsyncNoSpan([weak]() {
+    while (weak.lock()) engine::Yield();
+  });
+  task.WaitFor(utest::kMaxTestWaitTime);
+  EXPECT_TRUE(task.IsFinished());
+}
+
 USERVER_NAMESPACE_END
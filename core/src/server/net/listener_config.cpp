@@ -32,6 +32,10 @@ ListenerConfig Parse(const yaml_config::YamlConfig& value,
     throw std::runtime_error(
         "Either non-zero 'port' or non-empty 'unix-socket' fields must be set");
 
+  if (config.shards && *config.shards == 0) {
+    throw std::runtime_error("Invalid shards value in " + value.GetPath());
+  }
+
   if (config.backlog <= 0) {
     throw std::runtime_error("Invalid backlog value in " + value.GetPath());
   }
@@ -22,6 +22,16 @@ USERVER_NAMESPACE_BEGIN
 
 namespace server::net {
 
+namespace {
+
+std::shared_ptr<ConnectionParker> MakeConnectionParker(
+    engine::TaskProcessor& task_processor, const ConnectionConfig& config) {
+  if (config.idle_parking_timeout.count() <= 0) return nullptr;
+  return std::make_shared<ConnectionParker>(task_processor);
+}
+
+}  // namespace
+
 ListenerImpl::ListenerImpl(engine::TaskProcessor& task_processor,
                            std::shared_ptr<EndpointInfo> endpoint_info,
                            request::ResponseDataAccounter& data_accounter)
@@ -29,6 +39,8 @@ ListenerImpl::ListenerImpl(engine::TaskProcessor& task_processor,
       endpoint_info_(std::move(endpoint_info)),
       stats_(std::make_shared<Stats>()),
       data_accounter_(data_accounter),
+      connection_parker_(MakeConnectionParker(
+          task_processor_, endpoint_info_->listener_config.connection_config)),
       socket_listener_task_(engine::CriticalAsyncNoSpan(
           task_processor_,
           [this](engine::io::Socket&& request_socket) {
@@ -38,6 +50,7 @@ ListenerImpl::ListenerImpl(engine::TaskProcessor& task_processor,
               } catch (const engine::io::IoCancelled&) {
                 break;
               } catch (const std::exception& ex) {
+                ++stats_->accept_errors;
                 LOG_ERROR() << "can't accept connection: " << ex;
 
                 // If we're out of files, allow other coroutines to close old
@@ -53,6 +66,8 @@ ListenerImpl::~ListenerImpl() {
   socket_listener_task_.SyncCancel();
   LOG_TRACE() << "Stopped socket listener task";
 
+  // Parked connections have no tasks to be stopped
+  if (connection_parker_) connection_parker_->Stop();
   CloseConnections();
 }
 
@@ -64,6 +79,7 @@ engine::TaskProcessor& ListenerImpl::GetTaskProcessor() const {
 
 void ListenerImpl::AcceptConnection(engine::io::Socket& request_socket) {
   auto peer_socket = request_socket.Accept({});
+  ++stats_->accepted_connections;
 
   auto new_connection_count = ++endpoint_info_->connection_count;
   if (new_connection_count > endpoint_info_->listener_config.max_connections) {
@@ -73,6 +89,7 @@ void ListenerImpl::AcceptConnection(engine::io::Socket& request_socket) {
                           << ", dropping connection #" << new_connection_count;
     peer_socket.Close();
     --endpoint_info_->connection_count;
+    ++stats_->dropped_connections;
     return;
   }
 
@@ -97,6 +114,7 @@ void ListenerImpl::SetupConnection(engine::io::Socket peer_socket) {
   connection_ptr->SetCloseCb([endpoint_info = endpoint_info_]() {
     --endpoint_info->connection_count;
   });
+  if (connection_parker_) connection_ptr->SetParker(connection_parker_);
 
   AddConnection(connection_ptr);
 
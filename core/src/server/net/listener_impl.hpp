@@ -10,6 +10,7 @@
 #include <userver/engine/task/task_with_result.hpp>
 
 #include "connection.hpp"
+#include "connection_parker.hpp"
 #include "endpoint_info.hpp"
 #include "stats.hpp"
 
@@ -43,6 +44,9 @@ class ListenerImpl final {
   std::shared_ptr<Stats> stats_;
   request::ResponseDataAccounter& data_accounter_;
 
+  // Is null if parking of idle connections is disabled
+  std::shared_ptr<ConnectionParker> connection_parker_;
+
   engine::TaskWithResult<void> socket_listener_task_;
 
   // connections_ are added in socket_listener_task_ and removed
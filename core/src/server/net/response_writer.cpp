@@ -0,0 +1,74 @@
+#include <server/net/response_writer.hpp>
+
+#include <climits>
+
+#include <algorithm>
+
+#include <userver/utils/scope_guard.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::net {
+
+namespace {
+
+// The buffer of a connection is kept between the batches unless it has grown
+// too large
+constexpr std::size_t kMaxKeptBufferSize = 64 * 1024;
+
+}  // namespace
+
+void ResponseWriter::WriteRef(std::string_view data) {
+  if (data.size() < kMinReferencedSize) {
+    buffer_.append(data);
+    return;
+  }
+
+  CloseBufferFragment();
+  fragments_.push_back({data.data(), 0, data.size()});
+  referenced_size_ += data.size();
+}
+
+std::size_t ResponseWriter::Size() const {
+  return buffer_.size() + referenced_size_;
+}
+
+std::size_t ResponseWriter::Flush(engine::io::Socket& socket,
+                                  engine::Deadline deadline) {
+  const utils::ScopeGuard clear([this] {
+    fragments_.clear();
+    buffer_.clear();
+    if (buffer_.capacity() > kMaxKeptBufferSize) std::string{}.swap(buffer_);
+    buffer_fragment_begin_ = 0;
+    referenced_size_ = 0;
+  });
+
+  CloseBufferFragment();
+  iovecs_.clear();
+  for (const auto& fragment : fragments_) {
+    const char* data =
+        fragment.data ? fragment.data : buffer_.data() + fragment.buffer_offset;
+    // writev does not modify the data
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    iovecs_.push_back({const_cast<char*>(data), fragment.size});
+  }
+
+  std::size_t sent_bytes = 0;
+  for (std::size_t pos = 0; pos < iovecs_.size(); pos += IOV_MAX) {
+    const auto count = std::min<std::size_t>(IOV_MAX, iovecs_.size() - pos);
+    sent_bytes += socket.SendAll(iovecs_.data() + pos, count, deadline);
+  }
+  return sent_bytes;
+}
+
+void ResponseWriter::CloseBufferFragment() {
+  if (buffer_.size() == buffer_fragment_begin_) return;
+
+  fragments_.push_back({nullptr, buffer_fragment_begin_,
+                        buffer_.size() - buffer_fragment_begin_});
+  buffer_fragment_begin_ = buffer_.size();
+}
+
+}  // namespace server::net
+
+USERVER_NAMESPACE_END
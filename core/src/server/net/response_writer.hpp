@@ -0,0 +1,62 @@
+#pragma once
+
+#include <sys/uio.h>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <userver/engine/deadline.hpp>
+#include <userver/engine/io/socket.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace server::net {
+
+// Collects the serialized responses of a connection to send them with a
+// single writev. The data written to Buffer() is copied, the large bodies
+// are referenced by WriteRef() and are not copied at all, the order of the
+// writes is kept.
+class ResponseWriter final {
+ public:
+  // The smaller referenced data is copied into the buffer, an iovec entry
+  // costs more than copying a few hundred bytes
+  static constexpr std::size_t kMinReferencedSize = 512;
+
+  // The data appended to the buffer is sent as is
+  std::string& Buffer() { return buffer_; }
+
+  // The data must stay alive and unchanged until Flush()
+  void WriteRef(std::string_view data);
+
+  // Total size of the data to send
+  std::size_t Size() const;
+
+  bool IsEmpty() const { return Size() == 0; }
+
+  // Sends all the data, usually with a single writev, and clears the writer
+  // for reuse. Returns the number of sent bytes.
+  std::size_t Flush(engine::io::Socket& socket, engine::Deadline deadline);
+
+ private:
+  // Either references external data or a range of the buffer, the buffer
+  // may reallocate until Flush() so the pointers are resolved there
+  struct Fragment {
+    const char* data;
+    std::size_t buffer_offset;
+    std::size_t size;
+  };
+
+  void CloseBufferFragment();
+
+  std::string buffer_;
+  std::size_t buffer_fragment_begin_{0};
+  std::size_t referenced_size_{0};
+  std::vector<Fragment> fragments_;
+  std::vector<struct ::iovec> iovecs_;
+};
+
+}  // namespace server::net
+
+USERVER_NAMESPACE_END
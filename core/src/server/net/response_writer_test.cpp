@@ -0,0 +1,88 @@
+#include <server/net/response_writer.hpp>
+
+#include <climits>
+#include <string>
+
+#include <server/http/http_request_impl.hpp>
+#include <userver/engine/async.hpp>
+#include <userver/internal/net/net_listener.hpp>
+#include <userver/server/http/http_response.hpp>
+#include <userver/utest/utest.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace {
+
+std::string Receive(engine::io::Socket& socket, std::size_t size) {
+  std::string result(size, '\0');
+  const auto received = socket.RecvAll(
+      result.data(), result.size(),
+      engine::Deadline::FromDuration(utest::kMaxTestWaitTime));
+  result.resize(received);
+  return result;
+}
+
+}  // namespace
+
+UTEST(ResponseWriter, KeepsOrder) {
+  auto [server, client] = internal::net::TcpListener{}.MakeSocketPair(
+      engine::Deadline::FromDuration(utest::kMaxTestWaitTime));
+
+  const std::string large(server::net::ResponseWriter::kMinReferencedSize,
+                          'x');
+  std::string expected;
+  server::net::ResponseWriter writer;
+  // more fragments than a single writev takes
+  for (int i = 0; i < IOV_MAX; ++i) {
+    writer.Buffer().append("head");
+    writer.WriteRef("small");
+    writer.WriteRef(large);
+    expected += "headsmall" + large;
+  }
+  EXPECT_EQ(writer.Size(), expected.size());
+
+  // does not fit into the socket buffers
+  auto send_task = engine::AsyncNoSpan(
+      [&writer, &server = server] { return writer.Flush(server, {}); });
+  EXPECT_EQ(Receive(client, expected.size()), expected);
+  EXPECT_EQ(send_task.Get(), expected.size());
+  EXPECT_TRUE(writer.IsEmpty());
+
+  // the writer is reusable
+  writer.WriteRef(large);
+  writer.Buffer().append("tail");
+  EXPECT_EQ(writer.Flush(server, {}), large.size() + 4);
+  EXPECT_EQ(Receive(client, large.size() + 4), large + "tail");
+}
+
+UTEST(ResponseWriter, PipelinedResponses) {
+  auto [server, client] = internal::net::TcpListener{}.MakeSocketPair(
+      engine::Deadline::FromDuration(utest::kMaxTestWaitTime));
+
+  server::request::ResponseDataAccounter accounter;
+  const server::http::HttpRequestImpl first_request{accounter};
+  const server::http::HttpRequestImpl second_request{accounter};
+  auto& first = first_request.GetHttpResponse();
+  auto& second = second_request.GetHttpResponse();
+  first.SetData("first");
+  second.SetData(std::string(1000, 'b'));
+  second.SetStatus(server::http::HttpStatus::kNotFound);
+
+  server::net::ResponseWriter writer;
+  ASSERT_TRUE(first.SerializeResponse(writer));
+  const auto first_size = writer.Size();
+  ASSERT_TRUE(second.SerializeResponse(writer));
+  const auto size = writer.Size();
+  ASSERT_EQ(writer.Flush(server, {}), size);
+
+  const auto reply = Receive(client, size);
+  const auto first_reply = reply.substr(0, first_size);
+  const auto second_reply = reply.substr(first_size);
+  EXPECT_EQ(first_reply.rfind("HTTP/1.1 200 OK\r\n", 0), 0);
+  EXPECT_EQ(first_reply.substr(first_reply.size() - 9), "\r\n\r\nfirst");
+  EXPECT_EQ(second_reply.rfind("HTTP/1.1 404 Not Found\r\n", 0), 0);
+  EXPECT_EQ(second_reply.substr(second_reply.size() - 1004),
+            "\r\n\r\n" + std::string(1000, 'b'));
+}
+
+USERVER_NAMESPACE_END
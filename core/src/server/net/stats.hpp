@@ -27,6 +27,11 @@ struct Stats {
       : active_connections(other.active_connections.load()),
         connections_created(other.connections_created.load()),
         connections_closed(other.connections_closed.load()),
+        http2_connections_created(other.http2_connections_created.load()),
+        parked_connections(other.parked_connections.load()),
+        accepted_connections(other.accepted_connections.load()),
+        dropped_connections(other.dropped_connections.load()),
+        accept_errors(other.accept_errors.load()),
         parser_stats(other.parser_stats),
         active_request_count(other.active_request_count.load()),
         requests_processed_count(other.requests_processed_count.load()) {}
@@ -37,6 +42,14 @@ struct Stats {
   std::atomic<size_t> active_connections{0};
   std::atomic<size_t> connections_created{0};
   std::atomic<size_t> connections_closed{0};
+  std::atomic<size_t> http2_connections_created{0};
+  // the idle ones without tasks, included into active_connections
+  std::atomic<size_t> parked_connections{0};
+  // accepted from the listener socket, including the dropped ones
+  std::atomic<size_t> accepted_connections{0};
+  // closed right away because of max_connections
+  std::atomic<size_t> dropped_connections{0};
+  std::atomic<size_t> accept_errors{0};
 
   // per connection
   ParserStats parser_stats;
@@ -48,6 +61,11 @@ inline Stats& operator+=(Stats& lhs, const Stats& rhs) {
   lhs.active_connections += rhs.active_connections;
   lhs.connections_created += rhs.connections_created;
   lhs.connections_closed += rhs.connections_closed;
+  lhs.http2_connections_created += rhs.http2_connections_created;
+  lhs.parked_connections += rhs.parked_connections;
+  lhs.accepted_connections += rhs.accepted_connections;
+  lhs.dropped_connections += rhs.dropped_connections;
+  lhs.accept_errors += rhs.accept_errors;
 
   lhs.parser_stats += rhs.parser_stats;
   lhs.active_request_count += rhs.active_request_count;
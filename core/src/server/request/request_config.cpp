@@ -33,6 +33,9 @@ HttpRequestConfig Parse(const yaml_config::YamlConfig& value,
       value["deadline_expired_status_code"].As<http::HttpStatus>(
           conf.deadline_expired_status_code);
 
+  conf.arena_initial_size =
+      value["arena_initial_size"].As<size_t>(conf.arena_initial_size);
+
   return conf;
 }
 
@@ -1,6 +1,7 @@
 #include <userver/server/request/request_context.hpp>
 
 #include <memory>
+#include <memory_resource>
 #include <stdexcept>
 #include <unordered_map>
 
@@ -10,6 +11,13 @@ namespace server::request {
 
 class RequestContext::Impl final {
  public:
+  explicit Impl(std::pmr::memory_resource& memory_resource)
+      : memory_resource_(memory_resource) {}
+
+  std::pmr::memory_resource& GetMemoryResource() const {
+    return memory_resource_;
+  }
+
   utils::AnyMovable& SetUserAnyData(utils::AnyMovable&& data);
   utils::AnyMovable& GetUserAnyData();
   utils::AnyMovable* GetUserAnyDataOptional();
@@ -21,6 +29,7 @@ class RequestContext::Impl final {
   void EraseAnyData(const std::string& name);
 
  private:
+  std::pmr::memory_resource& memory_resource_;
   utils::AnyMovable user_data_;
   std::unordered_map<std::string, utils::AnyMovable> named_datum_;
 };
@@ -78,10 +87,18 @@ void RequestContext::Impl::EraseAnyData(const std::string& name) {
   named_datum_.erase(it);
 }
 
-RequestContext::RequestContext() = default;
+RequestContext::RequestContext()
+    : RequestContext(*std::pmr::get_default_resource()) {}
+
+RequestContext::RequestContext(std::pmr::memory_resource& memory_resource)
+    : impl_(memory_resource) {}
 
 RequestContext::~RequestContext() = default;
 
+std::pmr::memory_resource& RequestContext::GetMemoryResource() const {
+  return impl_->GetMemoryResource();
+}
+
 utils::AnyMovable& RequestContext::SetUserAnyData(utils::AnyMovable&& data) {
   return impl_->SetUserAnyData(std::move(data));
 }
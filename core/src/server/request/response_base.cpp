@@ -76,6 +76,12 @@ void ResponseBase::SetSendFailed(
   SetSent(0, failure_time);
 }
 
+bool ResponseBase::SerializeResponse(net::ResponseWriter&) { return false; }
+
+void ResponseBase::SetSentByConnection(std::size_t bytes_sent) {
+  SetSent(bytes_sent, std::chrono::steady_clock::now());
+}
+
 void ResponseBase::SetSent(std::size_t bytes_sent,
                            std::chrono::steady_clock::time_point sent_time) {
   UASSERT(!is_sent_);
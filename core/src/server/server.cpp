@@ -123,6 +123,7 @@ class ServerImpl final {
   std::chrono::milliseconds GetAvgRequestTimeMs() const;
   const http::HttpRequestHandler& GetHttpRequestHandler(bool is_monitor) const;
   net::Stats GetServerStats() const;
+  std::vector<net::Stats> GetListenerShardsStats() const;
   const ServerConfig& GetServerConfig() const { return config_; }
 
   RequestsView& GetRequestsView();
@@ -261,6 +262,19 @@ net::Stats ServerImpl::GetServerStats() const {
   return summary;
 }
 
+std::vector<net::Stats> ServerImpl::GetListenerShardsStats() const {
+  std::vector<net::Stats> result;
+
+  std::shared_lock lock{on_stop_mutex_};
+  if (is_stopping_) return result;
+  result.reserve(main_port_info_.listeners_.size());
+  for (const auto& listener : main_port_info_.listeners_) {
+    result.push_back(listener.GetStats());
+  }
+
+  return result;
+}
+
 RequestsView& ServerImpl::GetRequestsView() {
   UASSERT(!main_port_info_.IsRunning() || has_requests_view_watchers_.load());
 
@@ -323,6 +337,26 @@ void Server::WriteMonitorData(utils::statistics::Writer& writer) const {
     conn_stats["active"] = server_stats.active_connections;
     conn_stats["opened"] = server_stats.connections_created;
     conn_stats["closed"] = server_stats.connections_closed;
+    conn_stats["http2-opened"] = server_stats.http2_connections_created;
+    conn_stats["parked"] = server_stats.parked_connections;
+    conn_stats["accepted"] = server_stats.accepted_connections;
+    conn_stats["dropped"] = server_stats.dropped_connections;
+    conn_stats["accept-errors"] = server_stats.accept_errors;
+  }
+
+  if (auto shards_stats = writer["listener-shards"]) {
+    const auto listener_shards_stats = pimpl->GetListenerShardsStats();
+    for (size_t shard = 0; shard < listener_shards_stats.size(); ++shard) {
+      const auto& stats = listener_shards_stats[shard];
+      const auto shard_label = std::to_string(shard);
+      const utils::statistics::LabelView label{"listener_shard", shard_label};
+      shards_stats["accepted"].ValueWithLabels(
+          stats.accepted_connections.load(), label);
+      shards_stats["dropped"].ValueWithLabels(stats.dropped_connections.load(),
+                                              label);
+      shards_stats["active"].ValueWithLabels(stats.active_connections.load(),
+                                             label);
+    }
   }
 
   if (auto request_stats = writer["requests"]) {
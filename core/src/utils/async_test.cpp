@@ -7,6 +7,7 @@
 
 #include <userver/concurrent/variable.hpp>
 #include <userver/engine/task/task_with_result.hpp>
+#include <userver/tracing/span.hpp>
 #include <userver/utest/utest.hpp>
 
 #include <engine/ev/thread_control.hpp>
@@ -18,6 +19,20 @@ UTEST(UtilsAsync, Base) {
   EXPECT_EQ(1, task.Get());
 }
 
+UTEST_MT(UtilsAsync, AsyncBatch, 4) {
+  const auto& parent_span_id = tracing::Span::CurrentSpan().GetSpanId();
+  auto tasks = utils::AsyncBatch(
+      "async-batch", 100, [&parent_span_id](std::size_t index) {
+        EXPECT_EQ(tracing::Span::CurrentSpan().GetParentId(), parent_span_id);
+        return index;
+      });
+
+  ASSERT_EQ(tasks.size(), 100);
+  for (std::size_t i = 0; i < tasks.size(); ++i) {
+    EXPECT_EQ(tasks[i].Get(), i);
+  }
+}
+
 UTEST(UtilsAsync, WithDeadlineNotReached) {
   auto task = utils::Async(
       "async", engine::Deadline::FromDuration(utest::kMaxTestWaitTime),
@@ -4,18 +4,27 @@
 #include <sys/socket.h>
 #include <sys/types.h>
 
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <boost/program_options.hpp>
+#include <fmt/format.h>
 
 #include <userver/clients/dns/config.hpp>
 #include <userver/clients/dns/exception.hpp>
 #include <userver/clients/dns/resolver.hpp>
 #include <userver/engine/async.hpp>
+#include <userver/engine/io/exception.hpp>
+#include <userver/engine/io/socket.hpp>
 #include <userver/engine/run_standalone.hpp>
 #include <userver/engine/sleep.hpp>
 #include <userver/logging/log.hpp>
@@ -31,6 +40,10 @@ struct Config {
   size_t worker_threads = 1;
   int timeout_ms = 1000;
   int attempts = 1;
+  double prefetch_ratio = 0.9;
+  size_t requests = 0;
+  size_t concurrency = 1;
+  int stub_ttl_s = 60;
   std::vector<std::string> names;
 };
 
@@ -50,8 +63,20 @@ Config ParseConfig(int argc, char** argv) {
       po::value(&config.timeout_ms)->default_value(config.timeout_ms),
       "network timeout (ms)")(
       "attempts", po::value(&config.attempts)->default_value(config.attempts),
-      "network resolution attempts")("names", po::value(&config.names),
-                                     "list of names to resolve");
+      "network resolution attempts")(
+      "prefetch-ratio",
+      po::value(&config.prefetch_ratio)->default_value(config.prefetch_ratio),
+      "part of the reply TTL after which the record is updated in background")(
+      "requests", po::value(&config.requests)->default_value(config.requests),
+      "resolve the names this many times with an in-process stub DNS server "
+      "and print the latencies")(
+      "concurrency",
+      po::value(&config.concurrency)->default_value(config.concurrency),
+      "parallel resolving tasks count for --requests")(
+      "stub-ttl",
+      po::value(&config.stub_ttl_s)->default_value(config.stub_ttl_s),
+      "TTL of the stub DNS server replies for --requests (s)")(
+      "names", po::value(&config.names), "list of names to resolve");
 
   po::positional_options_description pos_desc;
   pos_desc.add("names", -1);
@@ -77,6 +102,184 @@ Config ParseConfig(int argc, char** argv) {
   return config;
 }
 
+// A minimal DNS server for --requests, so that the load is not put on the
+// system DNS servers. Every A query is answered with 127.0.0.1, the other
+// queries get no records. See RFC 1035 for the message format.
+class StubServer final {
+ public:
+  explicit StubServer(std::chrono::seconds ttl)
+      : ttl_(ttl),
+        socket_(engine::io::AddrDomain::kInet,
+                engine::io::SocketType::kDgram) {
+    engine::io::Sockaddr addr;
+    auto* sa = addr.As<sockaddr_in>();
+    sa->sin_family = AF_INET;
+    // may be implemented as a macro
+    // NOLINTNEXTLINE(hicpp-no-assembler, readability-isolate-declaration)
+    sa->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socket_.Bind(addr);
+    address_ = fmt::to_string(socket_.Getsockname());
+    serve_task_ = engine::AsyncNoSpan([this] { Serve(); });
+  }
+
+  ~StubServer() { serve_task_.SyncCancel(); }
+
+  const std::string& GetAddress() const { return address_; }
+
+ private:
+  static constexpr std::size_t kMaxMessageSize = 512;
+  static constexpr std::size_t kHeaderSize = 12;
+  static constexpr std::uint16_t kResponseFlags = 0x8080;  // QR and RA
+  static constexpr std::uint16_t kQuestionNamePointer = 0xC00C;
+  static constexpr std::uint16_t kTypeA = 1;
+  static constexpr std::uint16_t kClassIn = 1;
+
+  static std::uint16_t GetUint16(std::string_view data, std::size_t pos) {
+    return static_cast<std::uint16_t>(
+        (static_cast<unsigned char>(data[pos]) << 8) |
+        static_cast<unsigned char>(data[pos + 1]));
+  }
+
+  static void SetUint16(std::string& data, std::size_t pos,
+                        std::uint16_t value) {
+    data[pos] = static_cast<char>(value >> 8);
+    data[pos + 1] = static_cast<char>(value);
+  }
+
+  static void AppendUint16(std::string& data, std::uint16_t value) {
+    data.push_back(static_cast<char>(value >> 8));
+    data.push_back(static_cast<char>(value));
+  }
+
+  // Returns false for the malformed queries, they are not answered
+  bool MakeReply(std::string_view query, std::string& reply) const {
+    if (query.size() < kHeaderSize || GetUint16(query, 4) != 1) return false;
+
+    // The question is the name labels, QTYPE and QCLASS
+    auto pos = kHeaderSize;
+    while (pos < query.size() && query[pos] != 0) {
+      pos += static_cast<unsigned char>(query[pos]) + 1;
+    }
+    pos += 1 + 4;
+    if (pos > query.size()) return false;
+    const bool is_a_query = GetUint16(query, pos - 4) == kTypeA;
+
+    // The header and the question are echoed, the other sections are dropped
+    reply.assign(query.substr(0, pos));
+    SetUint16(reply, 2, GetUint16(query, 2) | kResponseFlags);
+    SetUint16(reply, 6, is_a_query ? 1 : 0);
+    SetUint16(reply, 8, 0);
+    SetUint16(reply, 10, 0);
+    if (!is_a_query) return true;
+
+    const auto ttl = static_cast<std::uint32_t>(ttl_.count());
+    AppendUint16(reply, kQuestionNamePointer);
+    AppendUint16(reply, kTypeA);
+    AppendUint16(reply, kClassIn);
+    AppendUint16(reply, static_cast<std::uint16_t>(ttl >> 16));
+    AppendUint16(reply, static_cast<std::uint16_t>(ttl));
+    AppendUint16(reply, 4);
+    reply.append({127, 0, 0, 1});
+    return true;
+  }
+
+  void Serve() {
+    std::array<char, kMaxMessageSize> query{};
+    std::string reply;
+    while (!engine::current_task::ShouldCancel()) {
+      try {
+        const auto result = socket_.RecvSomeFrom(query.data(), query.size(),
+                                                 engine::Deadline{});
+        if (!MakeReply({query.data(), result.bytes_received}, reply)) continue;
+        [[maybe_unused]] const auto sent = socket_.SendAllTo(
+            result.src_addr, reply.data(), reply.size(), engine::Deadline{});
+      } catch (const engine::io::IoCancelled&) {
+        return;
+      } catch (const std::exception& ex) {
+        LOG_ERROR() << "Stub DNS server failed to reply: " << ex;
+      }
+    }
+  }
+
+  const std::chrono::seconds ttl_;
+  engine::io::Socket socket_;
+  std::string address_;
+  engine::Task serve_task_;
+};
+
+void ResolveOnce(clients::dns::Resolver& resolver, const Config& config) {
+  for (const auto& name : config.names) {
+    try {
+      auto response = resolver.Resolve(
+          name, engine::Deadline::FromDuration(
+                    std::chrono::milliseconds{config.timeout_ms}));
+      std::cerr << "Got response for '" << name << "'\n";
+      for (const auto& addr : response) {
+        std::cerr << "  - " << addr.PrimaryAddressString() << '\n';
+      }
+    } catch (const std::exception& ex) {
+      LOG_ERROR() << "Resolution failed: " << ex;
+    }
+  }
+}
+
+// Resolves the names config.requests times in config.concurrency tasks and
+// prints the latencies together with the lookup sources
+void ResolveLoad(clients::dns::Resolver& resolver, const Config& config) {
+  using Latencies = std::vector<std::chrono::microseconds>;
+  if (config.names.empty() || !config.concurrency) return;
+
+  std::vector<engine::TaskWithResult<Latencies>> tasks;
+  tasks.reserve(config.concurrency);
+  for (size_t i = 0; i < config.concurrency; ++i) {
+    const auto requests = config.requests / config.concurrency +
+                          (i < config.requests % config.concurrency ? 1 : 0);
+    tasks.push_back(engine::AsyncNoSpan([&resolver, &config, requests, i] {
+      Latencies latencies;
+      latencies.reserve(requests);
+      for (size_t j = 0; j < requests; ++j) {
+        const auto& name = config.names[(i + j) % config.names.size()];
+        const auto start = std::chrono::steady_clock::now();
+        try {
+          resolver.Resolve(name, engine::Deadline::FromDuration(
+                                     std::chrono::milliseconds{
+                                         config.timeout_ms}));
+        } catch (const std::exception& ex) {
+          LOG_ERROR() << "Resolution failed: " << ex;
+        }
+        latencies.push_back(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start));
+      }
+      return latencies;
+    }));
+  }
+
+  Latencies latencies;
+  for (auto& task : tasks) {
+    const auto task_latencies = task.Get();
+    latencies.insert(latencies.end(), task_latencies.begin(),
+                     task_latencies.end());
+  }
+  if (latencies.empty()) return;
+  std::sort(latencies.begin(), latencies.end());
+  const auto percentile = [&latencies](size_t percent) {
+    return latencies[(latencies.size() - 1) * percent / 100].count();
+  };
+
+  const auto& counters = resolver.GetLookupSourceCounters();
+  std::cerr << "Requests: " << latencies.size() << '\n'
+            << "Latency (us): p50=" << percentile(50)
+            << " p99=" << percentile(99) << " max=" << latencies.back().count()
+            << '\n'
+            << "Sources: file=" << counters.file.Load()
+            << " cached=" << counters.cached.Load()
+            << " cached_stale=" << counters.cached_stale.Load()
+            << " cached_failure=" << counters.cached_failure.Load()
+            << " network=" << counters.network.Load()
+            << " network_failure=" << counters.network_failure.Load() << '\n';
+}
+
 }  // namespace
 
 int main(int argc, char** argv) {
@@ -93,20 +296,21 @@ int main(int argc, char** argv) {
     resolver_config.network_timeout =
         std::chrono::milliseconds{config.timeout_ms};
     resolver_config.network_attempts = config.attempts;
+    resolver_config.cache_prefetch_ratio = config.prefetch_ratio;
+
+    // Outlives the resolver that sends queries to it
+    std::optional<StubServer> stub_server;
+    if (config.requests) {
+      stub_server.emplace(std::chrono::seconds{config.stub_ttl_s});
+      resolver_config.network_custom_servers = {stub_server->GetAddress()};
+    }
+
     clients::dns::Resolver resolver{engine::current_task::GetTaskProcessor(),
                                     resolver_config};
-    for (const auto& name : config.names) {
-      try {
-        auto response = resolver.Resolve(
-            name, engine::Deadline::FromDuration(
-                      std::chrono::milliseconds{config.timeout_ms}));
-        std::cerr << "Got response for '" << name << "'\n";
-        for (const auto& addr : response) {
-          std::cerr << "  - " << addr.PrimaryAddressString() << '\n';
-        }
-      } catch (const std::exception& ex) {
-        LOG_ERROR() << "Resolution failed: " << ex;
-      }
+    if (config.requests) {
+      ResolveLoad(resolver, config);
+    } else {
+      ResolveOnce(resolver, config);
     }
   });
 }
@@ -22,6 +22,7 @@ struct Config {
   size_t io_threads = 1;
   size_t cycle = 1000;
   size_t memory = 1000;
+  bool work_stealing = false;
 };
 
 struct WorkerContext {
@@ -59,6 +60,8 @@ Config ParseConfig(int argc, char* argv[]) {
        "cycle iterations")  //
       ("memory,m", po::value(&config.memory)->default_value(config.memory),
        "memory used in each coro")  //
+      ("work-stealing", po::bool_switch(&config.work_stealing),
+       "use per-worker task queues with work stealing")  //
       ;
 
   po::variables_map vm;
@@ -137,7 +140,13 @@ int main(int argc, char* argv[]) {
   logging::DefaultLoggerGuard guard{logger};
 
   LOG_WARNING() << "Starting using requests=" << config.count
-                << " coroutines=" << config.coroutines;
+                << " coroutines=" << config.coroutines
+                << " work_stealing=" << config.work_stealing;
 
-  engine::RunStandalone(config.worker_threads, [&]() { DoWork(config); });
+  engine::TaskProcessorPoolsConfig pools_config;
+  pools_config.ev_threads_num = config.io_threads;
+  pools_config.work_stealing_task_queue = config.work_stealing;
+
+  engine::RunStandalone(config.worker_threads, pools_config,
+                        [&]() { DoWork(config); });
 }
@@ -26,16 +26,19 @@ struct Config {
   size_t io_threads = 1;
   long timeout_ms = 1000;
   bool multiplexing = false;
+  size_t max_concurrent_streams = 100;
   size_t max_host_connections = 0;
   http::HttpVersion http_version = http::HttpVersion::k11;
   std::string url_file;
   bool defer_events = false;
+  bool destination_affinity = true;
 };
 
 struct WorkerContext {
   std::atomic<uint64_t> counter{0};
   const uint64_t print_each_counter;
   uint64_t response_len;
+  std::atomic<uint64_t> reused_connections{0};
 
   http::Client& http_client;
   const Config& config;
@@ -75,9 +78,17 @@ Config ParseConfig(int argc, char* argv[]) {
       po::value(&config.max_host_connections)
           ->default_value(config.max_host_connections),
       "maximum HTTP connection number to a single host")(
+      "max-concurrent-streams",
+      po::value(&config.max_concurrent_streams)
+          ->default_value(config.max_concurrent_streams),
+      "maximum HTTP/2 streams over a single connection")(
       "defer-events",
       po::value(&config.defer_events)->default_value(config.defer_events),
-      "whether to defer curl events to a periodic timer");
+      "whether to defer curl events to a periodic timer")(
+      "destination-affinity",
+      po::value(&config.destination_affinity)
+          ->default_value(config.destination_affinity),
+      "whether to perform requests to a host in the same IO thread");
 
   po::variables_map vm;
   po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -160,6 +171,9 @@ void Worker(WorkerContext& context) {
 
       auto response = request.perform();
       context.response_len += response->body().size();
+      if (response->GetStats().open_socket_count == 0) {
+        ++context.reused_connections;
+      }
       LOG_DEBUG() << "Got response body_size=" << response->body().size();
       auto ts3 = std::chrono::system_clock::now();
       LOG_INFO() << "timings create="
@@ -185,9 +199,14 @@ void DoWork(const Config& config, const std::vector<std::string>& urls) {
   LOG_INFO() << "Starting thread " << std::this_thread::get_id();
 
   auto& tp = engine::current_task::GetTaskProcessor();
+  http::impl::ClientSettings settings;
+  settings.io_threads = config.io_threads;
+  settings.defer_events = config.defer_events;
+  settings.destination_affinity = config.destination_affinity;
+  settings.http2_multiplexing = config.multiplexing;
+  settings.http2_max_concurrent_streams = config.max_concurrent_streams;
   http::Client http_client{
-      {"", config.io_threads, config.defer_events},
-      tp,
+      std::move(settings), tp,
       std::vector<utils::NotNull<clients::http::Plugin*>>{}};
   LOG_INFO() << "Client created";
 
@@ -195,8 +214,8 @@ void DoWork(const Config& config, const std::vector<std::string>& urls) {
   if (config.max_host_connections > 0)
     http_client.SetMaxHostConnections(config.max_host_connections);
 
-  WorkerContext worker_context{{0},    2000, 0, std::ref(http_client),
-                               config, urls};
+  WorkerContext worker_context{
+      {0}, 2000, 0, {0}, std::ref(http_client), config, urls};
 
   std::vector<engine::TaskWithResult<void>> tasks;
   tasks.resize(config.coroutines);
@@ -218,7 +237,8 @@ void DoWork(const Config& config, const std::vector<std::string>& urls) {
   std::cerr << std::endl;
   LOG_CRITICAL() << "counter = " << worker_context.counter.load()
                  << " sum response body size = " << worker_context.response_len
-                 << " average RPS = " << rps;
+                 << " average RPS = " << rps << " reused connections = "
+                 << worker_context.reused_connections.load();
 }
 
 }  // namespace
@@ -242,7 +262,9 @@ int main(int argc, char* argv[]) {
                 << " timeout=" << config.timeout_ms << "ms";
   LOG_WARNING() << "multiplexing ="
                 << (config.multiplexing ? "enabled" : "disabled")
-                << " max_host_connections=" << config.max_host_connections;
+                << " max_concurrent_streams=" << config.max_concurrent_streams
+                << " max_host_connections=" << config.max_host_connections
+                << " destination_affinity=" << config.destination_affinity;
 
   const std::vector<std::string> urls = ReadUrls(config);
 
@@ -0,0 +1,74 @@
+#pragma once
+
+/// @file userver/fs/blocking/mapped_file.hpp
+/// @brief @copybrief fs::blocking::MappedFile
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <userver/fs/blocking/file_descriptor.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace fs::blocking {
+
+/// @ingroup userver_containers
+///
+/// @brief A read-only memory mapping of a whole file
+/// @details The file descriptor is closed once the file is mapped. A mapped
+/// file must be replaced (e.g. renamed over) rather than modified in place,
+/// the access to the truncated pages of a mapping raises SIGBUS. To read the
+/// file safely regardless, e.g. to send it with `sendfile`, use Reopen().
+class MappedFile final {
+ public:
+  /// @brief Opens and maps the file
+  /// @throws std::system_error
+  static MappedFile Open(const std::string& path);
+
+  MappedFile() = delete;
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+  ~MappedFile();
+
+  /// Returns the file contents
+  std::string_view GetData() const noexcept { return {data_, size_}; }
+
+  /// @brief Opens the mapped file again. Reading with the file descriptor
+  /// reports a concurrent truncation as a short read instead of SIGBUS.
+  /// @returns std::nullopt if the file was replaced or removed, the mapping
+  /// keeps the mapped contents intact then
+  /// @throws std::system_error
+  std::optional<FileDescriptor> Reopen() const;
+
+  /// @brief Checks whether the file at the path is not the mapped one
+  /// anymore: it was replaced, removed, resized or modified
+  /// @throws std::system_error
+  bool IsModified() const;
+
+ private:
+  struct Identity {
+    std::uint64_t device{0};
+    std::uint64_t inode{0};
+    // In nanoseconds
+    std::int64_t modified{0};
+    std::size_t size{0};
+
+    bool operator==(const Identity& other) const noexcept;
+  };
+
+  MappedFile(std::string path, Identity identity, const char* data) noexcept;
+
+  void Unmap() noexcept;
+
+  std::string path_;
+  Identity identity_;
+  const char* data_;
+  std::size_t size_;
+};
+
+}  // namespace fs::blocking
+
+USERVER_NAMESPACE_END
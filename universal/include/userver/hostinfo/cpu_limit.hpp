@@ -3,7 +3,9 @@
 /// @file userver/hostinfo/cpu_limit.hpp
 /// @brief Information about CPU limits in container.
 
+#include <cstddef>
 #include <optional>
+#include <vector>
 
 USERVER_NAMESPACE_BEGIN
 
@@ -24,6 +26,35 @@ std::optional<double> CpuLimit();
 /// environment variable is set).
 bool IsInRtc();
 
+/// @brief CPUs available to the current process, grouped by NUMA nodes
+struct CpuTopology final {
+  struct NumaNode final {
+    std::size_t id{0};
+    /// Sorted ids of the CPUs of the node the current process may run on
+    std::vector<std::size_t> cpus;
+  };
+
+  /// @brief Returns the node with the specified id or nullptr if there is no
+  /// such node or none of its CPUs are available to the process
+  const NumaNode* FindNumaNode(std::size_t id) const;
+
+  /// @brief Returns the sorted ids of the CPUs available to the process
+  std::vector<std::size_t> GetCpus() const;
+
+  /// Nodes with at least one available CPU, sorted by id
+  std::vector<NumaNode> numa_nodes;
+};
+
+/// @brief Returns the CPU topology as seen by the current process.
+///
+/// Uses:
+///   * sched_getaffinity(2) for the CPUs the process may run on;
+///   * /sys/devices/system/node for the NUMA nodes of the CPUs.
+///
+/// If the NUMA information is unavailable, all the CPUs are reported as
+/// belonging to the node 0. The topology is detected once, on the first call.
+const CpuTopology& GetCpuTopology();
+
 }  // namespace hostinfo
 
 USERVER_NAMESPACE_END
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstddef>
+#include <vector>
+
 USERVER_NAMESPACE_BEGIN
 
 namespace utils {
@@ -10,6 +13,13 @@ void SetCurrentThreadIdleScheduling();
 
 void SetCurrentThreadLowPriorityScheduling();
 
+// Restricts the current thread to the specified CPUs. Linux only.
+void SetCurrentThreadCpuAffinity(const std::vector<std::size_t>& cpus);
+
+// Makes the kernel allocate the memory for the current thread from the
+// specified NUMA node while it has free memory. Linux only.
+void SetCurrentThreadPreferredNumaNode(std::size_t numa_node);
+
 }  // namespace utils
 
 USERVER_NAMESPACE_END
@@ -0,0 +1,131 @@
+#include <userver/fs/blocking/mapped_file.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <utility>
+
+#include <userver/logging/log.hpp>
+#include <utils/check_syscall.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace fs::blocking {
+
+namespace {
+
+// A file rewritten within the same second is modified too
+std::int64_t GetModificationTimeNs(const struct ::stat& stats) noexcept {
+#ifdef __APPLE__
+  const auto& modified = stats.st_mtimespec;
+#else
+  const auto& modified = stats.st_mtim;
+#endif
+  return static_cast<std::int64_t>(modified.tv_sec) * 1'000'000'000 +
+         modified.tv_nsec;
+}
+
+// The identity type is private to MappedFile
+template <typename Identity>
+Identity MakeIdentity(const struct ::stat& stats) {
+  return {static_cast<std::uint64_t>(stats.st_dev),
+          static_cast<std::uint64_t>(stats.st_ino),
+          GetModificationTimeNs(stats),
+          static_cast<std::size_t>(stats.st_size)};
+}
+
+}  // namespace
+
+bool MappedFile::Identity::operator==(const Identity& other) const noexcept {
+  return device == other.device && inode == other.inode &&
+         modified == other.modified && size == other.size;
+}
+
+MappedFile MappedFile::Open(const std::string& path) {
+  auto fd = FileDescriptor::Open(path, OpenFlag::kRead);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
+  struct ::stat stats;
+  utils::CheckSyscall(::fstat(fd.GetNative(), &stats), "calling ::fstat");
+  const auto identity = MakeIdentity<Identity>(stats);
+  // an empty file can not be mapped
+  if (identity.size == 0) return MappedFile{path, identity, nullptr};
+
+  // the mapping stays valid after the file descriptor is closed
+  void* data = utils::CheckSyscallNotEquals(
+      ::mmap(nullptr, identity.size, PROT_READ, MAP_PRIVATE, fd.GetNative(),
+             0),
+      MAP_FAILED, "mapping file '{}'", path);
+  return MappedFile{path, identity, static_cast<const char*>(data)};
+}
+
+MappedFile::MappedFile(std::string path, Identity identity,
+                       const char* data) noexcept
+    : path_(std::move(path)),
+      identity_(identity),
+      data_(data),
+      size_(data ? identity.size : 0) {}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : path_(std::move(other.path_)),
+      identity_(other.identity_),
+      data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (&other != this) {
+    Unmap();
+    path_ = std::move(other.path_);
+    identity_ = other.identity_;
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+  }
+  return *this;
+}
+
+MappedFile::~MappedFile() { Unmap(); }
+
+std::optional<FileDescriptor> MappedFile::Reopen() const {
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+  const int fd = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1 && errno == ENOENT) return std::nullopt;
+  auto file = FileDescriptor::AdoptFd(
+      utils::CheckSyscall(fd, "opening file '{}'", path_));
+
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
+  struct ::stat stats;
+  utils::CheckSyscall(::fstat(file.GetNative(), &stats), "calling ::fstat");
+  const auto identity = MakeIdentity<Identity>(stats);
+  if (identity.device != identity_.device ||
+      identity.inode != identity_.inode) {
+    return std::nullopt;
+  }
+  return file;
+}
+
+bool MappedFile::IsModified() const {
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
+  struct ::stat stats;
+  if (::stat(path_.c_str(), &stats) == -1) {
+    if (errno == ENOENT) return true;
+    utils::CheckSyscall(-1, "calling ::stat for '{}'", path_);
+  }
+  return !(MakeIdentity<Identity>(stats) == identity_);
+}
+
+void MappedFile::Unmap() noexcept {
+  if (!data_) return;
+
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+  if (::munmap(const_cast<char*>(data_), size_) == -1) {
+    LOG_ERROR() << "Failed to unmap a file: "
+                << std::error_code(errno, std::system_category()).message();
+  }
+  data_ = nullptr;
+  size_ = 0;
+}
+
+}  // namespace fs::blocking
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include <userver/fs/blocking/mapped_file.hpp>
+#include <userver/fs/blocking/temp_directory.hpp>
+#include <userver/fs/blocking/write.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+using MappedFile = fs::blocking::MappedFile;
+
+TEST(MappedFile, Contents) {
+  const auto dir = fs::blocking::TempDirectory::Create();
+  const auto path = dir.GetPath() + "/foo";
+  fs::blocking::RewriteFileContents(path, "contents");
+
+  auto file = MappedFile::Open(path);
+  EXPECT_EQ(file.GetData(), "contents");
+  EXPECT_FALSE(file.IsModified());
+
+  auto moved = std::move(file);
+  EXPECT_EQ(moved.GetData(), "contents");
+}
+
+TEST(MappedFile, Empty) {
+  const auto dir = fs::blocking::TempDirectory::Create();
+  const auto path = dir.GetPath() + "/empty";
+  fs::blocking::RewriteFileContents(path, "");
+
+  const auto file = MappedFile::Open(path);
+  EXPECT_TRUE(file.GetData().empty());
+}
+
+TEST(MappedFile, Missing) {
+  const auto dir = fs::blocking::TempDirectory::Create();
+  EXPECT_THROW(MappedFile::Open(dir.GetPath() + "/missing"), std::system_error);
+}
+
+TEST(MappedFile, Reopen) {
+  const auto dir = fs::blocking::TempDirectory::Create();
+  const auto path = dir.GetPath() + "/foo";
+  fs::blocking::RewriteFileContents(path, "contents");
+  const auto file = MappedFile::Open(path);
+
+  auto fd = file.Reopen();
+  ASSERT_TRUE(fd);
+  std::string buffer(8, '\0');
+  EXPECT_EQ(fd->Read(buffer.data(), buffer.size()), 8);
+  EXPECT_EQ(buffer, "contents");
+}
+
+TEST(MappedFile, Replaced) {
+  const auto dir = fs::blocking::TempDirectory::Create();
+  const auto path = dir.GetPath() + "/foo";
+  fs::blocking::RewriteFileContents(path, "contents");
+  const auto file = MappedFile::Open(path);
+
+  fs::blocking::RewriteFileContents(path + ".tmp", "new contents");
+  fs::blocking::Rename(path + ".tmp", path);
+
+  EXPECT_TRUE(file.IsModified());
+  EXPECT_FALSE(file.Reopen());
+  EXPECT_EQ(file.GetData(), "contents");
+}
+
+TEST(MappedFile, ModifiedWithinSecond) {
+  const auto dir = fs::blocking::TempDirectory::Create();
+  const auto path = dir.GetPath() + "/foo";
+  fs::blocking::RewriteFileContents(path, "contents");
+
+  const auto set_modification_time = [&path](long nanoseconds) {
+    const struct ::timespec times[2] = {{1000, nanoseconds},
+                                        {1000, nanoseconds}};
+    ASSERT_EQ(::utimensat(AT_FDCWD, path.c_str(), times, 0), 0);
+  };
+  set_modification_time(1);
+  const auto file = MappedFile::Open(path);
+  EXPECT_FALSE(file.IsModified());
+
+  set_modification_time(2);
+  EXPECT_TRUE(file.IsModified());
+}
+
+USERVER_NAMESPACE_END
@@ -1,8 +1,17 @@
 #include <userver/hostinfo/cpu_limit.hpp>
 
+#include <sched.h>
+
+#include <algorithm>
+#include <iterator>
 #include <optional>
 #include <string>
+#include <thread>
+
+#include <fmt/format.h>
 
+#include <hostinfo/cpu_list.hpp>
+#include <userver/fs/blocking/read.hpp>
 #include <userver/logging/log.hpp>
 
 USERVER_NAMESPACE_BEGIN
@@ -38,6 +47,68 @@ std::optional<double> CpuLimitRtc() {
   return {};
 }
 
+std::vector<std::size_t> GetAvailableCpus() {
+  std::vector<std::size_t> cpus;
+#ifdef __linux__
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  if (::sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0) {
+    for (std::size_t cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &cpu_set)) cpus.push_back(cpu);
+    }
+    return cpus;
+  }
+  LOG_WARNING() << "sched_getaffinity failed, assuming all the CPUs are "
+                   "available";
+#endif
+
+  const auto hw_concurrency = std::max(std::thread::hardware_concurrency(), 1U);
+  for (std::size_t cpu = 0; cpu < hw_concurrency; ++cpu) cpus.push_back(cpu);
+  return cpus;
+}
+
+std::vector<CpuTopology::NumaNode> ReadNumaNodes(
+    const std::vector<std::size_t>& available_cpus) {
+  static const std::string kNodesPath = "/sys/devices/system/node/";
+
+  std::vector<CpuTopology::NumaNode> nodes;
+#ifdef __linux__
+  try {
+    const auto node_ids = impl::ParseCpuList(
+        fs::blocking::ReadFileContents(kNodesPath + "online"));
+    for (const auto node_id : node_ids) {
+      const auto node_cpus =
+          impl::ParseCpuList(fs::blocking::ReadFileContents(
+              fmt::format("{}node{}/cpulist", kNodesPath, node_id)));
+
+      CpuTopology::NumaNode node{node_id, {}};
+      std::set_intersection(node_cpus.begin(), node_cpus.end(),
+                            available_cpus.begin(), available_cpus.end(),
+                            std::back_inserter(node.cpus));
+      if (!node.cpus.empty()) nodes.push_back(std::move(node));
+    }
+  } catch (const std::exception& ex) {
+    LOG_INFO() << "Failed to read NUMA topology, assuming a single node: "
+               << ex;
+    nodes.clear();
+  }
+#endif
+
+  if (nodes.empty()) nodes.push_back({0, available_cpus});
+  return nodes;
+}
+
+CpuTopology DetectCpuTopology() {
+  CpuTopology topology;
+  topology.numa_nodes = ReadNumaNodes(GetAvailableCpus());
+
+  for (const auto& node : topology.numa_nodes) {
+    LOG_INFO() << "NUMA node " << node.id
+               << " available CPUs: " << impl::ToCpuList(node.cpus);
+  }
+  return topology;
+}
+
 }  // namespace
 
 std::optional<double> CpuLimit() {
@@ -47,6 +118,27 @@ std::optional<double> CpuLimit() {
 
 bool IsInRtc() { return !!CpuLimitRtc(); }
 
+const CpuTopology::NumaNode* CpuTopology::FindNumaNode(std::size_t id) const {
+  const auto it =
+      std::find_if(numa_nodes.begin(), numa_nodes.end(),
+                   [id](const NumaNode& node) { return node.id == id; });
+  return it == numa_nodes.end() ? nullptr : &*it;
+}
+
+std::vector<std::size_t> CpuTopology::GetCpus() const {
+  std::vector<std::size_t> cpus;
+  for (const auto& node : numa_nodes) {
+    cpus.insert(cpus.end(), node.cpus.begin(), node.cpus.end());
+  }
+  std::sort(cpus.begin(), cpus.end());
+  return cpus;
+}
+
+const CpuTopology& GetCpuTopology() {
+  static const auto topology = DetectCpuTopology();
+  return topology;
+}
+
 }  // namespace hostinfo
 
 USERVER_NAMESPACE_END
@@ -0,0 +1,78 @@
+#include <hostinfo/cpu_list.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include <userver/utils/from_string.hpp>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace hostinfo::impl {
+
+namespace {
+
+constexpr std::string_view kWhitespace = " \t\n";
+
+std::string_view Trim(std::string_view value) {
+  const auto begin = value.find_first_not_of(kWhitespace);
+  if (begin == std::string_view::npos) return {};
+  const auto end = value.find_last_not_of(kWhitespace);
+  return value.substr(begin, end - begin + 1);
+}
+
+}  // namespace
+
+std::vector<std::size_t> ParseCpuList(std::string_view cpu_list) {
+  std::vector<std::size_t> result;
+
+  cpu_list = Trim(cpu_list);
+  while (!cpu_list.empty()) {
+    const auto comma_pos = cpu_list.find(',');
+    const auto range = Trim(cpu_list.substr(0, comma_pos));
+    cpu_list = (comma_pos == std::string_view::npos)
+                   ? std::string_view{}
+                   : cpu_list.substr(comma_pos + 1);
+
+    try {
+      const auto dash_pos = range.find('-');
+      const auto first =
+          utils::FromString<std::size_t>(range.substr(0, dash_pos));
+      const auto last =
+          (dash_pos == std::string_view::npos)
+              ? first
+              : utils::FromString<std::size_t>(range.substr(dash_pos + 1));
+      if (first > last) throw std::runtime_error("descending range");
+      for (auto cpu = first; cpu <= last; ++cpu) result.push_back(cpu);
+    } catch (const std::exception& ex) {
+      throw std::runtime_error(
+          fmt::format("Invalid CPU list range '{}': {}", range, ex.what()));
+    }
+  }
+
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+  return result;
+}
+
+std::string ToCpuList(const std::vector<std::size_t>& cpus) {
+  std::string result;
+  for (std::size_t i = 0; i < cpus.size();) {
+    auto last = i;
+    while (last + 1 < cpus.size() && cpus[last + 1] == cpus[last] + 1) ++last;
+
+    if (!result.empty()) result += ',';
+    if (last == i) {
+      result += fmt::format("{}", cpus[i]);
+    } else {
+      result += fmt::format("{}-{}", cpus[i], cpus[last]);
+    }
+    i = last + 1;
+  }
+  return result;
+}
+
+}  // namespace hostinfo::impl
+
+USERVER_NAMESPACE_END
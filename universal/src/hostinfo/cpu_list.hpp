@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+USERVER_NAMESPACE_BEGIN
+
+namespace hostinfo::impl {
+
+// Parses a list of CPU or NUMA node ids in the Linux cpulist format, e.g.
+// "0-3,8,10-11". Returns the sorted unique ids, throws std::runtime_error on
+// invalid input.
+std::vector<std::size_t> ParseCpuList(std::string_view cpu_list);
+
+// Formats the sorted ids in the Linux cpulist format
+std::string ToCpuList(const std::vector<std::size_t>& cpus);
+
+}  // namespace hostinfo::impl
+
+USERVER_NAMESPACE_END
@@ -0,0 +1,34 @@
+#include <hostinfo/cpu_list.hpp>
+
+#include <gtest/gtest.h>
+
+USERVER_NAMESPACE_BEGIN
+
+using hostinfo::impl::ParseCpuList;
+using hostinfo::impl::ToCpuList;
+
+TEST(CpuList, Parse) {
+  using Cpus = std::vector<std::size_t>;
+  EXPECT_EQ(ParseCpuList(""), Cpus{});
+  EXPECT_EQ(ParseCpuList("\n"), Cpus{});
+  EXPECT_EQ(ParseCpuList("5"), Cpus{5});
+  EXPECT_EQ(ParseCpuList("0-3\n"), (Cpus{0, 1, 2, 3}));
+  EXPECT_EQ(ParseCpuList("8, 0-1,10-11"), (Cpus{0, 1, 8, 10, 11}));
+  EXPECT_EQ(ParseCpuList("2,1-2"), (Cpus{1, 2}));
+}
+
+TEST(CpuList, ParseInvalid) {
+  EXPECT_THROW(ParseCpuList("a"), std::runtime_error);
+  EXPECT_THROW(ParseCpuList("3-1"), std::runtime_error);
+  EXPECT_THROW(ParseCpuList("1,,2"), std::runtime_error);
+  EXPECT_THROW(ParseCpuList("-1"), std::runtime_error);
+}
+
+TEST(CpuList, Format) {
+  EXPECT_EQ(ToCpuList({}), "");
+  EXPECT_EQ(ToCpuList({3}), "3");
+  EXPECT_EQ(ToCpuList({0, 1, 2, 3, 8, 10, 11}), "0-3,8,10-11");
+  EXPECT_EQ(ToCpuList(ParseCpuList("0-7,16-23")), "0-7,16-23");
+}
+
+USERVER_NAMESPACE_END
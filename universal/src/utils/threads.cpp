@@ -11,12 +11,15 @@
 #include <sys/time.h>
 #include <unistd.h>
 #else
+#include <linux/mempolicy.h>
 #include <sys/syscall.h>
 #include <sys/types.h>
 #include <unistd.h>
 #endif
 
 #include <algorithm>
+#include <climits>
+#include <stdexcept>
 
 #include <fmt/format.h>
 
@@ -79,6 +82,45 @@ void SetCurrentThreadLowPriorityScheduling() {
                       "setting thread scheduling parameters");
 }
 
+void SetCurrentThreadCpuAffinity(const std::vector<std::size_t>& cpus) {
+#ifdef __linux__
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (const auto cpu : cpus) {
+    if (cpu >= CPU_SETSIZE) {
+      throw std::runtime_error(fmt::format("CPU id {} is too big", cpu));
+    }
+    CPU_SET(cpu, &cpu_set);
+  }
+  utils::CheckSyscall(::sched_setaffinity(0, sizeof(cpu_set), &cpu_set),
+                      "setting thread CPU affinity");
+#else
+  (void)cpus;
+  throw std::runtime_error("Thread CPU affinity is only supported on Linux");
+#endif
+}
+
+void SetCurrentThreadPreferredNumaNode(std::size_t numa_node) {
+#ifdef __linux__
+  constexpr std::size_t kMaskBits = sizeof(unsigned long) * CHAR_BIT;
+  if (numa_node >= kMaskBits) {
+    throw std::runtime_error(
+        fmt::format("NUMA node id {} is too big", numa_node));
+  }
+  const unsigned long node_mask = 1UL << numa_node;
+  // The kernel reads one bit less than maxnode, so it is the mask size plus
+  // one, same as in libnuma. Otherwise the highest node of the mask is lost.
+  constexpr unsigned long kMaxNode = kMaskBits + 1;
+  // No glibc wrapper without libnuma
+  utils::CheckSyscall(
+      ::syscall(SYS_set_mempolicy, MPOL_PREFERRED, &node_mask, kMaxNode),
+      "setting thread memory policy");
+#else
+  (void)numa_node;
+  throw std::runtime_error("NUMA memory policy is only supported on Linux");
+#endif
+}
+
 }  // namespace utils
 
 USERVER_NAMESPACE_END